@@ -53,6 +53,11 @@ class idMaterial;
 	A translation with start == end or a rotation with angle == 0 performs
 	a position test and fills in the trace_t structure accordingly.
 
+	Translation, Rotation, Contents, Contacts and SetupTrmModel may be called
+	from several threads at once while no models are loaded or freed. The
+	trace model set up with SetupTrmModel belongs to the calling thread and
+	is only used by collision queries from that same thread.
+
 ===============================================================================
 */
 
@@ -103,7 +108,7 @@ public:
 
 	// Gets the clip handle for a model.
 	virtual cmHandle_t		LoadModel( const char *modelName, const bool precache ) = 0;
-	// Sets up a trace model for collision with other trace models.
+	// Sets up a trace model for collision with other trace models, the handle is only valid on the calling thread.
 	virtual cmHandle_t		SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) = 0;
 	// Creates a trace model from a collision model, returns true if succesfull.
 	virtual bool			TrmFromModel( const char *modelName, idTraceModel &trm ) = 0;
@@ -58,10 +58,10 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_b
 	float d, bestd;
 	idVec3 *p;
 
-	if ( b->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( tw->brushMarks[b->markNum] == tw->checkCount ) {
 		return false;
 	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
+	tw->brushMarks[b->markNum] = tw->checkCount;
 
 	if ( !(b->contents & tw->contents) ) {
 		return false;
@@ -130,10 +130,10 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {								\
+#define CM_SetTrmPolygonSidedness( v, point, plane, bitNum ) {						\
 	if ( !((v)->sideSet & (1<<bitNum)) ) {											\
 		float fl;																	\
-		fl = plane.Distance( (v)->p );												\
+		fl = plane.Distance( point );												\
 		/* cannot use float sign bit because it is undetermined when fl == 0.0f */	\
 		if ( fl < 0.0f ) {															\
 			(v)->side |= (1 << bitNum);												\
@@ -158,13 +158,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	float d, bestd;
 	cm_trmEdge_t *trmEdge;
 	cm_edge_t *edge;
-	cm_vertex_t *v, *v1, *v2;
+	cm_vertex_t *v;
+	cm_featureMark_t *em, *vm, *v1, *v2;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( tw->polygonMarks[p->markNum] == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	tw->polygonMarks[p->markNum] = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -196,14 +197,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
 			// if this edge is already tested
-			if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( tw->edgeMarks[abs(edgeNum)].checkcount == tw->checkCount ) {
 				continue;
 			}
 
 			for ( j = 0; j < 2; j++ ) {
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( tw->vertexMarks[edge->vertexNum[j]].checkcount == tw->checkCount ) {
 					continue;
 				}
 
@@ -238,19 +239,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		em = tw->edgeMarks + abs(edgeNum);
 		// reset sidedness cache if this is the first time we encounter this edge
-		if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			edge->sideSet = 0;
+		if ( em->checkcount != tw->checkCount ) {
+			em->sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 													tw->model->vertices[edge->vertexNum[1]].p );
-		v = &tw->model->vertices[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
+		vm = &tw->vertexMarks[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			v->sideSet = 0;
+		if ( vm->checkcount != tw->checkCount ) {
+			vm->sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		vm->checkcount = tw->checkCount;
 	}
 
 	// get side of polygon for each trm vertex
@@ -270,10 +272,10 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 		// test if trm edge goes through the polygon between the polygon edges
 		for ( j = 0; j < p->numEdges; j++ ) {
 			edgeNum = p->edges[j];
-			edge = tw->model->edges + abs(edgeNum);
+			em = tw->edgeMarks + abs(edgeNum);
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if ( INTSIGNBITSET(edgeNum) ^ ((edge->side >> i) & 1) ^ flip ) {
+			CM_SetTrmEdgeSidedness( em, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
+			if ( INTSIGNBITSET(edgeNum) ^ ((em->side >> i) & 1) ^ flip ) {
 				break;
 			}
 #else
@@ -311,17 +313,18 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		em = tw->edgeMarks + abs(edgeNum);
+		if ( em->checkcount == tw->checkCount ) {
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		em->checkcount = tw->checkCount;
 
 		for ( j = 0; j < tw->numPolys; j++ ) {
 #if 1
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			v1 = tw->vertexMarks + edge->vertexNum[0];
+			CM_SetTrmPolygonSidedness( v1, tw->model->vertices[edge->vertexNum[0]].p, tw->polys[j].plane, j );
+			v2 = tw->vertexMarks + edge->vertexNum[1];
+			CM_SetTrmPolygonSidedness( v2, tw->model->vertices[edge->vertexNum[1]].p, tw->polys[j].plane, j );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( !(((v1->side ^ v2->side) >> j) & 1) ) {
 				continue;
@@ -330,10 +333,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 #else
 			float d1, d2;
 
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			d1 = tw->polys[j].plane.Distance( v1->p );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			d2 = tw->polys[j].plane.Distance( v2->p );
+			d1 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[0]].p );
+			d2 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[1]].p );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( (d1 >= 0.0f && d2 >= 0.0f) || (d1 <= 0.0f && d2 <= 0.0f) ) {
 				continue;
@@ -349,8 +350,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 				trmEdge = tw->edges + abs(trmEdgeNum);
 #if 1
 				bitNum = abs(trmEdgeNum);
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if ( INTSIGNBITSET(trmEdgeNum) ^ ((edge->side >> bitNum) & 1) ^ flip ) {
+				CM_SetTrmEdgeSidedness( em, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
+				if ( INTSIGNBITSET(trmEdgeNum) ^ ((em->side >> bitNum) & 1) ^ flip ) {
 					break;
 				}
 #else
@@ -422,7 +423,7 @@ int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t mode
 	cm_brush_t *b;
 	idPlane *plane;
 
-	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::models[model] );
+	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::TraceModelForHandle( model ) );
 	for ( bref = node->brushes; bref; bref = bref->next ) {
 		b = bref->b;
 		// test if the point is within the brush bounds
@@ -496,7 +497,12 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		return results->c.contents;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	tw.model = idCollisionModelManagerLocal::TraceModelForHandle( model );
+	if ( !tw.model ) {
+		common->Printf("idCollisionModelManagerLocal::ContentsTrm: invalid model\n");
+		return 0;
+	}
+	idCollisionModelManagerLocal::SetupTraceMarks( &tw, idCollisionModelManagerLocal::GetTraceContext() );
 
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
@@ -508,7 +514,6 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 
@@ -631,7 +636,7 @@ int idCollisionModelManagerLocal::Contents( const idVec3 &start,
 		common->Printf("idCollisionModelManagerLocal::Contents: invalid model handle\n");
 		return 0;
 	}
-	if ( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::models[model] ) {
+	if ( !idCollisionModelManagerLocal::TraceModelForHandle( model ) ) {
 		common->Printf("idCollisionModelManagerLocal::Contents: invalid model\n");
 		return 0;
 	}
@@ -354,6 +354,7 @@ static idCVar cm_testWalk(			"cm_testWalk",			"1",					CVAR_GAME | CVAR_BOOL,		"
 static idCVar cm_testLength(		"cm_testLength",		"1024",					CVAR_GAME | CVAR_FLOAT,		"" );
 static idCVar cm_testRadius(		"cm_testRadius",		"64",					CVAR_GAME | CVAR_FLOAT,		"" );
 static idCVar cm_testAngle(			"cm_testAngle",			"60",					CVAR_GAME | CVAR_FLOAT,		"" );
+static idCVar cm_testThreads(		"cm_testThreads",		"0",					CVAR_GAME | CVAR_BOOL,		"compare collision queries run on the worker threads with the same queries run serially" );
 
 static unsigned int total_translation;
 static unsigned int min_translation = 999999;
@@ -366,6 +367,131 @@ static int num_rotation = 0;
 static idVec3 start;
 static idVec3 *testend;
 
+typedef struct {
+	idVec3					start;
+	const idVec3 *			ends;
+	const idTraceModel *	trm;
+	idMat3					trmAxis;
+	idMat3					modelAxis;
+	cmHandle_t				model;
+	idRotation				rotation;
+	bool					testRotation;
+	// results, four per test
+	trace_t *				traces;
+	int *					contents;
+} cm_testThreads_t;
+
+/*
+================
+CM_TestThreadsJob
+
+  runs a translation, rotation, position test and a translation against a trace model
+================
+*/
+static void CM_TestThreadsJob( void *data, int index ) {
+	cm_testThreads_t *test = (cm_testThreads_t *) data;
+	trace_t *traces = &test->traces[index * 4];
+	idRotation rotation;
+	cmHandle_t trmModel;
+
+	memset( traces, 0, 4 * sizeof( traces[0] ) );
+
+	collisionModelManager->Translation( &traces[0], test->start, test->ends[index], test->trm, test->trmAxis,
+			CONTENTS_SOLID|CONTENTS_PLAYERCLIP, test->model, vec3_origin, test->modelAxis );
+
+	if ( test->testRotation ) {
+		rotation = test->rotation;
+		rotation.SetOrigin( test->ends[index] );
+		collisionModelManager->Rotation( &traces[1], test->start, rotation, test->trm, test->trmAxis,
+				CONTENTS_SOLID|CONTENTS_PLAYERCLIP, test->model, vec3_origin, test->modelAxis );
+	}
+
+	test->contents[index] = collisionModelManager->Contents( traces[0].endpos, test->trm, test->trmAxis,
+			-1, test->model, vec3_origin, test->modelAxis );
+
+	// the trm model belongs to this thread, use a different size for every test
+	idTraceModel itm( idBounds( idVec3( -4.0f, -4.0f, -4.0f ) ).Expand( (float)( index & 15 ) ) );
+	trmModel = collisionModelManager->SetupTrmModel( itm, NULL );
+	collisionModelManager->Translation( &traces[2], test->start, test->ends[index], test->trm, test->trmAxis,
+			-1, trmModel, ( test->start + test->ends[index] ) * 0.5f, mat3_identity );
+	collisionModelManager->Translation( &traces[3], test->ends[index], test->start, test->trm, test->trmAxis,
+			-1, trmModel, ( test->start + test->ends[index] ) * 0.5f, mat3_identity );
+}
+
+/*
+================
+CM_TracesEqual
+================
+*/
+static bool CM_TracesEqual( const trace_t &a, const trace_t &b ) {
+	return a.fraction == b.fraction && a.endpos == b.endpos && a.c.type == b.c.type &&
+			a.c.contents == b.c.contents && a.c.normal == b.c.normal && a.c.dist == b.c.dist &&
+			a.c.modelFeature == b.c.modelFeature && a.c.trmFeature == b.c.trmFeature;
+}
+
+/*
+================
+CM_TestThreads
+
+  runs the test queries serially and on the worker threads and compares the results
+================
+*/
+static void CM_TestThreads( cm_testThreads_t &test, int numTests ) {
+	int i, j, numErrors;
+	unsigned int serialTime, threadTime;
+	trace_t *serialTraces;
+	int *serialContents;
+	idTimer timer;
+
+	serialTraces = (trace_t *) Mem_Alloc( numTests * 4 * sizeof( trace_t ) );
+	serialContents = (int *) Mem_Alloc( numTests * sizeof( int ) );
+
+	test.traces = serialTraces;
+	test.contents = serialContents;
+	timer.Start();
+	for ( i = 0; i < numTests; i++ ) {
+		CM_TestThreadsJob( &test, i );
+	}
+	timer.Stop();
+	serialTime = timer.Milliseconds();
+
+	test.traces = (trace_t *) Mem_Alloc( numTests * 4 * sizeof( trace_t ) );
+	test.contents = (int *) Mem_Alloc( numTests * sizeof( int ) );
+	timer.Clear();
+	timer.Start();
+	Sys_ParallelFor( CM_TestThreadsJob, &test, numTests, "cm_testThreads" );
+	timer.Stop();
+	threadTime = timer.Milliseconds();
+
+	numErrors = 0;
+	for ( i = 0; i < numTests; i++ ) {
+		for ( j = 0; j < 4; j++ ) {
+			if ( !CM_TracesEqual( serialTraces[i * 4 + j], test.traces[i * 4 + j] ) ) {
+				if ( numErrors < 10 ) {
+					common->Printf( "test %d query %d: fraction %f on the worker threads, %f serially\n", i, j,
+							test.traces[i * 4 + j].fraction, serialTraces[i * 4 + j].fraction );
+				}
+				numErrors++;
+			}
+		}
+		if ( serialContents[i] != test.contents[i] ) {
+			if ( numErrors < 10 ) {
+				common->Printf( "test %d: contents %d on the worker threads, %d serially\n", i, test.contents[i], serialContents[i] );
+			}
+			numErrors++;
+		}
+	}
+	common->Printf( "%d thread tests: %u milliseconds serially, %u milliseconds on %d worker threads, %d mismatches\n",
+			numTests, serialTime, threadTime, Sys_NumWorkerThreads(), numErrors );
+
+	Mem_Free( test.traces );
+	Mem_Free( test.contents );
+	Mem_Free( serialTraces );
+	Mem_Free( serialContents );
+	test.traces = NULL;
+	test.contents = NULL;
+}
+
 void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 	int i, k;
 	unsigned int t;
@@ -443,6 +569,25 @@ void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 	}
 	common->Printf("%s translations: %4u milliseconds, (min = %u, max = %u, av = %1.1f)\n", buf, t, min_translation, max_translation, (float) total_translation / num_translation );
 
+	if ( cm_testThreads.GetBool() ) {
+		// collision queries from several threads at once
+		cm_testThreads_t test;
+		idVec3 vec( random.CRandomFloat(), random.CRandomFloat(), random.RandomFloat() );
+		vec.Normalize();
+
+		test.start = start;
+		test.ends = testend;
+		test.trm = &itm;
+		test.trmAxis = boxAxis;
+		test.modelAxis = modelAxis;
+		test.model = cm_testModel.GetInteger();
+		test.rotation = idRotation( vec3_origin, vec, cm_testAngle.GetFloat() );
+		test.testRotation = cm_testRotation.GetBool();
+		test.traces = NULL;
+		test.contents = NULL;
+		CM_TestThreads( test, cm_testTimes.GetInteger() );
+	}
+
 	if ( cm_testRandomMany.GetBool() ) {
 		// if many traces in one random direction
 		for ( i = 0; i < 3; i++ ) {
@@ -45,6 +45,12 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+#define CM_BINARY_FILE_EXT		"bcm"
+#define CM_BINARY_FILEID		( ( '1' << 24 ) + ( 'M' << 16 ) + ( 'C' << 8 ) + 'B' )
+#define CM_BINARY_FILEVERSION	2
+
+idCVar cm_binaryFiles( "cm_binaryFiles", "1", CVAR_GAME | CVAR_BOOL, "load map collision models from .bcm files under fs_savepath, written when missing or out of date" );
+
 /*
 ===============================================================================
 
@@ -259,6 +265,10 @@ void idCollisionModelManagerLocal::WriteCollisionModelsToFile( const char *filen
 	}
 
 	fileSystem->CloseFile( fp );
+
+	if ( cm_binaryFiles.GetBool() ) {
+		WriteBinaryCollisionModelsToFile( filename, firstModel, lastModel, mapFileCRC );
+	}
 }
 
 /*
@@ -329,8 +339,6 @@ void idCollisionModelManagerLocal::ParseVertices( idLexer *src, cm_model_t *mode
 	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
 	for ( i = 0; i < model->numVertices; i++ ) {
 		src->Parse1DMatrix( 3, model->vertices[i].p.ToFloatPtr() );
-		model->vertices[i].side = 0;
-		model->vertices[i].sideSet = 0;
 		model->vertices[i].checkcount = 0;
 	}
 	src->ExpectTokenString( "}" );
@@ -353,8 +361,6 @@ void idCollisionModelManagerLocal::ParseEdges( idLexer *src, cm_model_t *model )
 		model->edges[i].vertexNum[0] = src->ParseInt();
 		model->edges[i].vertexNum[1] = src->ParseInt();
 		src->ExpectTokenString( ")" );
-		model->edges[i].side = 0;
-		model->edges[i].sideSet = 0;
 		model->edges[i].internal = src->ParseInt();
 		model->edges[i].numUsers = src->ParseInt();
 		model->edges[i].normal = vec3_origin;
@@ -558,6 +564,12 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	idToken token;
 	idLexer *src;
 	unsigned int crc;
+	int firstModel;
+
+	// a map can use the binary file if it was built from the same map
+	if ( mapFileCRC && cm_binaryFiles.GetBool() && LoadBinaryCollisionModelFile( name, mapFileCRC ) ) {
+		return true;
+	}
 
 	// load it
 	fileName = name;
@@ -594,6 +606,8 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 		return false;
 	}
 
+	firstModel = numModels;
+
 	// parse the file
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
@@ -613,5 +627,581 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 
 	delete src;
 
+	if ( mapFileCRC && cm_binaryFiles.GetBool() ) {
+		WriteBinaryCollisionModelsToFile( name, firstModel, numModels, mapFileCRC );
+	}
+
+	return true;
+}
+
+
+/*
+===============================================================================
+
+Binary collision model file
+
+With cm_binaryFiles the collision models of a map are also kept in a .bcm
+file under fs_savepath, tagged with the same map file CRC as the .cm file.
+Every model is stored as flat arrays: the vertices, edges and the packed
+polygon and brush memory as they are in memory, the nodes in depth first
+order and the polygon and brush references as indexes. Loading reads the
+file in one go and copies every array into a single allocation, instead of
+parsing, allocating and filtering every polygon and brush into the tree.
+
+The collision detection writes into all of these structures, so they can't
+be used straight from a read only mapping.
+
+The file is written in native byte order for the machine that built it.
+
+===============================================================================
+*/
+
+typedef struct cm_binaryNode_s {
+	int						planeType;
+	float					planeDist;
+	int						children[2];		// indexes into the node array
+	int						firstPolygonRef;	// into the polygon reference array
+	int						numPolygonRefs;
+	int						firstBrushRef;		// into the brush reference array
+	int						numBrushRefs;
+} cm_binaryNode_t;
+
+/*
+================
+CM_BinaryFits
+
+Returns true if count elements can still be read from the file
+================
+*/
+static bool CM_BinaryFits( idFile *fp, int count, int elementSize ) {
+	return ( count >= 0 && count <= ( fp->Length() - fp->Tell() ) / elementSize );
+}
+
+/*
+================
+CM_BinaryIndex
+
+Returns the index of ptr in list, appending it if it is a new one
+================
+*/
+template< class type >
+static int CM_BinaryIndex( type *ptr, idList<type *> &list, idHashIndex &hash ) {
+	int key = (int)( (intptr_t)ptr >> 4 );
+
+	for ( int i = hash.First( key ); i != -1; i = hash.Next( i ) ) {
+		if ( list[i] == ptr ) {
+			return i;
+		}
+	}
+	int index = list.Append( ptr );
+	hash.Add( key, index );
+	return index;
+}
+
+/*
+================
+CM_BinaryNodes_r
+================
+*/
+static int CM_BinaryNodes_r( cm_node_t *node, idList<cm_node_t *> &nodes, idList<cm_binaryNode_t> &binaryNodes ) {
+	cm_binaryNode_t bnode;
+	int index;
+
+	memset( &bnode, 0, sizeof( bnode ) );
+	bnode.planeType = node->planeType;
+	bnode.planeDist = node->planeDist;
+	bnode.children[0] = bnode.children[1] = -1;
+
+	index = nodes.Append( node );
+	binaryNodes.Append( bnode );
+	if ( node->planeType != -1 ) {
+		int child = CM_BinaryNodes_r( node->children[0], nodes, binaryNodes );
+		binaryNodes[index].children[0] = child;
+		child = CM_BinaryNodes_r( node->children[1], nodes, binaryNodes );
+		binaryNodes[index].children[1] = child;
+	}
+	return index;
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, cm_model_t *model ) {
+	idList<cm_node_t *>			nodes;
+	idList<cm_binaryNode_t>		binaryNodes;
+	idList<cm_polygon_t *>		polygons;
+	idList<cm_brush_t *>		brushes;
+	idList<int>					polygonRefs, brushRefs;
+	idList<const idMaterial *>	materials;
+	idList<int>					materialRemap;
+	idHashIndex					polygonHash( EDGE_HASH_SIZE, 1024 ), brushHash( EDGE_HASH_SIZE, 1024 );
+	cm_polygonRef_t *			pref;
+	cm_brushRef_t *				bref;
+	int							i, polygonMemory, brushMemory;
+
+	nodes.SetGranularity( 1024 );
+	binaryNodes.SetGranularity( 1024 );
+	polygons.SetGranularity( 1024 );
+	brushes.SetGranularity( 1024 );
+	polygonRefs.SetGranularity( 1024 );
+	brushRefs.SetGranularity( 1024 );
+
+	// flatten the tree, the polygons and brushes are numbered in the order they are first referenced
+	CM_BinaryNodes_r( model->node, nodes, binaryNodes );
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		binaryNodes[i].firstPolygonRef = polygonRefs.Num();
+		for ( pref = nodes[i]->polygons; pref; pref = pref->next ) {
+			polygonRefs.Append( CM_BinaryIndex( pref->p, polygons, polygonHash ) );
+		}
+		binaryNodes[i].numPolygonRefs = polygonRefs.Num() - binaryNodes[i].firstPolygonRef;
+
+		binaryNodes[i].firstBrushRef = brushRefs.Num();
+		for ( bref = nodes[i]->brushes; bref; bref = bref->next ) {
+			brushRefs.Append( CM_BinaryIndex( bref->b, brushes, brushHash ) );
+		}
+		binaryNodes[i].numBrushRefs = brushRefs.Num() - binaryNodes[i].firstBrushRef;
+	}
+
+	materialRemap.SetNum( declManager->GetNumDecls( DECL_MATERIAL ) );
+	for ( i = 0; i < materialRemap.Num(); i++ ) {
+		materialRemap[i] = -1;
+	}
+
+	polygonMemory = 0;
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		const idMaterial *material = polygons[i]->material;
+		if ( material && materialRemap[material->Index()] == -1 ) {
+			materialRemap[material->Index()] = materials.Append( material );
+		}
+		polygonMemory += sizeof( cm_polygon_t ) + ( polygons[i]->numEdges - 1 ) * sizeof( polygons[i]->edges[0] );
+	}
+
+	brushMemory = 0;
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		brushMemory += sizeof( cm_brush_t ) + ( brushes[i]->numPlanes - 1 ) * sizeof( brushes[i]->planes[0] );
+	}
+
+	fp->WriteString( model->name );
+	fp->WriteVec3( model->bounds[0] );
+	fp->WriteVec3( model->bounds[1] );
+	fp->WriteInt( model->contents );
+	fp->WriteInt( model->numVertices );
+	fp->WriteInt( model->numEdges );
+	fp->WriteInt( nodes.Num() );
+	fp->WriteInt( polygons.Num() );
+	fp->WriteInt( polygonMemory );
+	fp->WriteInt( brushes.Num() );
+	fp->WriteInt( brushMemory );
+	fp->WriteInt( polygonRefs.Num() );
+	fp->WriteInt( brushRefs.Num() );
+	fp->WriteInt( model->numInternalEdges );
+	fp->WriteInt( model->numSharpEdges );
+	fp->WriteInt( materials.Num() );
+	for ( i = 0; i < materials.Num(); i++ ) {
+		fp->WriteString( materials[i]->GetName() );
+	}
+
+	fp->Write( model->vertices, model->numVertices * sizeof( model->vertices[0] ) );
+	fp->Write( model->edges, model->numEdges * sizeof( model->edges[0] ) );
+	fp->Write( binaryNodes.Ptr(), binaryNodes.Num() * sizeof( binaryNodes[0] ) );
+	fp->Write( polygonRefs.Ptr(), polygonRefs.Num() * sizeof( polygonRefs[0] ) );
+	fp->Write( brushRefs.Ptr(), brushRefs.Num() * sizeof( brushRefs[0] ) );
+
+	// the polygons and brushes are packed like in the memory blocks, the material
+	// pointer of a polygon is replaced by its index in the material list
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		cm_polygon_t p = *polygons[i];
+		p.material = (const idMaterial *)(intptr_t)( p.material ? materialRemap[p.material->Index()] : -1 );
+		p.checkcount = 0;
+		p.markNum = 0;
+		fp->Write( &p, sizeof( p ) );
+		fp->Write( &polygons[i]->edges[1], ( p.numEdges - 1 ) * sizeof( p.edges[0] ) );
+	}
+	// brush materials aren't kept in the .cm file either
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		cm_brush_t b = *brushes[i];
+		b.material = NULL;
+		b.checkcount = 0;
+		b.markNum = 0;
+		fp->Write( &b, sizeof( b ) );
+		fp->Write( &brushes[i]->planes[1], ( b.numPlanes - 1 ) * sizeof( b.planes[0] ) );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC ) {
+	int i;
+	idFile *fp;
+	idStr name;
+
+	name = filename;
+	name.SetFileExtension( CM_BINARY_FILE_EXT );
+
+	fp = fileSystem->OpenFileWrite( name, "fs_savepath" );
+	if ( !fp ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile: Error opening file %s\n", name.c_str() );
+		return;
+	}
+
+	fp->WriteInt( CM_BINARY_FILEID );
+	fp->WriteInt( CM_BINARY_FILEVERSION );
+	fp->WriteUnsignedInt( mapFileCRC );
+	// the arrays are only valid for builds with the same structure layout
+	fp->WriteInt( sizeof( cm_vertex_t ) );
+	fp->WriteInt( sizeof( cm_edge_t ) );
+	fp->WriteInt( sizeof( cm_polygon_t ) );
+	fp->WriteInt( sizeof( cm_brush_t ) );
+	fp->WriteInt( lastModel - firstModel );
+
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( fp, models[ i ] );
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryCollisionModel
+
+Returns NULL if the model doesn't read back completely
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::ReadBinaryCollisionModel( idFile *fp ) {
+	cm_model_t *model;
+	idList<cm_binaryNode_t> binaryNodes;
+	idList<int> polygonRefs, brushRefs;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idList<const idMaterial *> materials;
+	cm_node_t *nodes;
+	cm_polygonRef_t *prefs;
+	cm_brushRef_t *brefs;
+	int i, j, size, length, numNodes, numPolygons, numBrushes, numPolygonRefs, numBrushRefs, numMaterials;
+	idStr string;
+
+	model = AllocModel();
+
+	if ( !CM_BinaryFits( fp, 1, sizeof( int ) ) ) {
+		FreeModel( model );
+		return NULL;
+	}
+	fp->ReadInt( length );
+	// the name, bounds and counts
+	if ( !CM_BinaryFits( fp, length, 1 ) || !CM_BinaryFits( fp, length + 6 * sizeof( float ) + 13 * sizeof( int ), 1 ) ) {
+		FreeModel( model );
+		return NULL;
+	}
+	model->name.Fill( ' ', length );
+	fp->Read( &model->name[0], length );
+
+	fp->ReadVec3( model->bounds[0] );
+	fp->ReadVec3( model->bounds[1] );
+	fp->ReadInt( model->contents );
+	fp->ReadInt( model->numVertices );
+	fp->ReadInt( model->numEdges );
+	fp->ReadInt( numNodes );
+	fp->ReadInt( numPolygons );
+	fp->ReadInt( model->polygonMemory );
+	fp->ReadInt( numBrushes );
+	fp->ReadInt( model->brushMemory );
+	fp->ReadInt( numPolygonRefs );
+	fp->ReadInt( numBrushRefs );
+	fp->ReadInt( model->numInternalEdges );
+	fp->ReadInt( model->numSharpEdges );
+	fp->ReadInt( numMaterials );
+
+	if ( numNodes < 1 || numMaterials < 0 ) {
+		FreeModel( model );
+		return NULL;
+	}
+	for ( i = 0; i < numMaterials; i++ ) {
+		if ( !CM_BinaryFits( fp, 1, sizeof( int ) ) ) {
+			FreeModel( model );
+			return NULL;
+		}
+		fp->ReadInt( length );
+		if ( !CM_BinaryFits( fp, length, 1 ) ) {
+			FreeModel( model );
+			return NULL;
+		}
+		string.Fill( ' ', length );
+		fp->Read( &string[0], length );
+		materials.Append( declManager->FindMaterial( string ) );
+	}
+
+	if ( !CM_BinaryFits( fp, model->numVertices, sizeof( cm_vertex_t ) )
+			|| !CM_BinaryFits( fp, model->numEdges, sizeof( cm_edge_t ) )
+			|| !CM_BinaryFits( fp, numNodes, sizeof( cm_binaryNode_t ) )
+			|| !CM_BinaryFits( fp, numPolygonRefs, sizeof( int ) )
+			|| !CM_BinaryFits( fp, numBrushRefs, sizeof( int ) )
+			|| !CM_BinaryFits( fp, model->polygonMemory, 1 )
+			|| !CM_BinaryFits( fp, model->brushMemory, 1 )
+			|| numPolygons < 0 || numPolygons > model->polygonMemory / (int)sizeof( cm_polygon_t )
+			|| numBrushes < 0 || numBrushes > model->brushMemory / (int)sizeof( cm_brush_t ) ) {
+		FreeModel( model );
+		return NULL;
+	}
+	polygons.Resize( numPolygons );
+	brushes.Resize( numBrushes );
+
+	// vertices and edges
+	model->maxVertices = model->numVertices;
+	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
+	fp->Read( model->vertices, model->numVertices * sizeof( cm_vertex_t ) );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		model->vertices[i].checkcount = 0;
+	}
+	model->maxEdges = model->numEdges;
+	model->edges = (cm_edge_t *) Mem_Alloc( model->maxEdges * sizeof( cm_edge_t ) );
+	fp->Read( model->edges, model->numEdges * sizeof( cm_edge_t ) );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		for ( j = 0; j < 2; j++ ) {
+			if ( model->edges[i].vertexNum[j] < 0 || model->edges[i].vertexNum[j] >= model->numVertices ) {
+				FreeModel( model );
+				return NULL;
+			}
+		}
+		model->edges[i].checkcount = 0;
+	}
+
+	binaryNodes.SetNum( numNodes );
+	fp->Read( binaryNodes.Ptr(), numNodes * sizeof( cm_binaryNode_t ) );
+	polygonRefs.SetNum( numPolygonRefs );
+	fp->Read( polygonRefs.Ptr(), numPolygonRefs * sizeof( int ) );
+	brushRefs.SetNum( numBrushRefs );
+	fp->Read( brushRefs.Ptr(), numBrushRefs * sizeof( int ) );
+
+	// polygons, packed in one block
+	model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + model->polygonMemory );
+	model->polygonBlock->bytesRemaining = 0;
+	model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t ) + model->polygonMemory;
+	byte *polygonBytes = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+	fp->Read( polygonBytes, model->polygonMemory );
+	for ( i = 0; i < model->polygonMemory; i += size ) {
+		cm_polygon_t *p = (cm_polygon_t *)( polygonBytes + i );
+		if ( model->polygonMemory - i < (int)sizeof( cm_polygon_t ) || p->numEdges < 1
+				|| p->numEdges > ( model->polygonMemory - i - (int)sizeof( cm_polygon_t ) ) / (int)sizeof( p->edges[0] ) + 1 ) {
+			FreeModel( model );
+			return NULL;
+		}
+		size = sizeof( cm_polygon_t ) + ( p->numEdges - 1 ) * sizeof( p->edges[0] );
+		int materialNum = (int)(intptr_t)p->material;
+		if ( materialNum < -1 || materialNum >= materials.Num() ) {
+			FreeModel( model );
+			return NULL;
+		}
+		for ( j = 0; j < p->numEdges; j++ ) {
+			if ( abs( p->edges[j] ) >= model->numEdges ) {
+				FreeModel( model );
+				return NULL;
+			}
+		}
+		p->material = ( materialNum >= 0 ) ? materials[materialNum] : NULL;
+		if ( p->material ) {
+			p->contents = p->material->GetContentFlags();
+		}
+		p->checkcount = 0;
+		p->markNum = polygons.Num();
+		polygons.Append( p );
+	}
+
+	// brushes, packed in one block
+	model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + model->brushMemory );
+	model->brushBlock->bytesRemaining = 0;
+	model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t ) + model->brushMemory;
+	byte *brushBytes = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t );
+	fp->Read( brushBytes, model->brushMemory );
+	for ( i = 0; i < model->brushMemory; i += size ) {
+		cm_brush_t *b = (cm_brush_t *)( brushBytes + i );
+		if ( model->brushMemory - i < (int)sizeof( cm_brush_t ) || b->numPlanes < 1
+				|| b->numPlanes > ( model->brushMemory - i - (int)sizeof( cm_brush_t ) ) / (int)sizeof( b->planes[0] ) + 1 ) {
+			FreeModel( model );
+			return NULL;
+		}
+		size = sizeof( cm_brush_t ) + ( b->numPlanes - 1 ) * sizeof( b->planes[0] );
+		b->material = NULL;
+		b->checkcount = 0;
+		b->markNum = brushes.Num();
+		brushes.Append( b );
+	}
+
+	model->numPolygons = polygons.Num();
+	model->numBrushes = brushes.Num();
+	model->numPolygonMarks = polygons.Num();
+	model->numBrushMarks = brushes.Num();
+	if ( model->numPolygons != numPolygons || model->numBrushes != numBrushes ) {
+		FreeModel( model );
+		return NULL;
+	}
+
+	// nodes and references, each in a single block
+	cm_nodeBlock_t *nodeBlock = (cm_nodeBlock_t *) Mem_ClearedAlloc( sizeof( cm_nodeBlock_t ) + numNodes * sizeof( cm_node_t ) );
+	nodeBlock->nextNode = NULL;
+	nodeBlock->next = NULL;
+	model->nodeBlocks = nodeBlock;
+	nodes = (cm_node_t *) ( ( (byte *) nodeBlock ) + sizeof( cm_nodeBlock_t ) );
+
+	cm_polygonRefBlock_t *prefBlock = (cm_polygonRefBlock_t *) Mem_Alloc( sizeof( cm_polygonRefBlock_t ) + numPolygonRefs * sizeof( cm_polygonRef_t ) );
+	prefBlock->nextRef = NULL;
+	prefBlock->next = NULL;
+	model->polygonRefBlocks = prefBlock;
+	prefs = (cm_polygonRef_t *) ( ( (byte *) prefBlock ) + sizeof( cm_polygonRefBlock_t ) );
+
+	cm_brushRefBlock_t *brefBlock = (cm_brushRefBlock_t *) Mem_Alloc( sizeof( cm_brushRefBlock_t ) + numBrushRefs * sizeof( cm_brushRef_t ) );
+	brefBlock->nextRef = NULL;
+	brefBlock->next = NULL;
+	model->brushRefBlocks = brefBlock;
+	brefs = (cm_brushRef_t *) ( ( (byte *) brefBlock ) + sizeof( cm_brushRefBlock_t ) );
+
+	for ( i = 0; i < numNodes; i++ ) {
+		const cm_binaryNode_t &bnode = binaryNodes[i];
+		cm_node_t *node = &nodes[i];
+
+		node->planeType = bnode.planeType;
+		node->planeDist = bnode.planeDist;
+
+		// every node but the head is the child of exactly one node before it
+		if ( node->planeType != -1 ) {
+			if ( node->planeType < 0 || node->planeType > 2 ) {
+				FreeModel( model );
+				return NULL;
+			}
+			for ( j = 0; j < 2; j++ ) {
+				if ( bnode.children[j] <= i || bnode.children[j] >= numNodes || nodes[bnode.children[j]].parent ) {
+					FreeModel( model );
+					return NULL;
+				}
+				node->children[j] = &nodes[bnode.children[j]];
+				node->children[j]->parent = node;
+			}
+		}
+
+		if ( bnode.firstPolygonRef < 0 || bnode.numPolygonRefs < 0 || bnode.numPolygonRefs > numPolygonRefs - bnode.firstPolygonRef
+				|| bnode.firstBrushRef < 0 || bnode.numBrushRefs < 0 || bnode.numBrushRefs > numBrushRefs - bnode.firstBrushRef ) {
+			FreeModel( model );
+			return NULL;
+		}
+		for ( j = bnode.numPolygonRefs - 1; j >= 0; j-- ) {
+			cm_polygonRef_t *pref = &prefs[bnode.firstPolygonRef + j];
+			if ( polygonRefs[bnode.firstPolygonRef + j] < 0 || polygonRefs[bnode.firstPolygonRef + j] >= numPolygons ) {
+				FreeModel( model );
+				return NULL;
+			}
+			pref->p = polygons[polygonRefs[bnode.firstPolygonRef + j]];
+			pref->next = node->polygons;
+			node->polygons = pref;
+		}
+		for ( j = bnode.numBrushRefs - 1; j >= 0; j-- ) {
+			cm_brushRef_t *bref = &brefs[bnode.firstBrushRef + j];
+			if ( brushRefs[bnode.firstBrushRef + j] < 0 || brushRefs[bnode.firstBrushRef + j] >= numBrushes ) {
+				FreeModel( model );
+				return NULL;
+			}
+			bref->b = brushes[brushRefs[bnode.firstBrushRef + j]];
+			bref->next = node->brushes;
+			node->brushes = bref;
+		}
+	}
+
+	model->node = &nodes[0];
+	model->numNodes = numNodes;
+	model->numPolygonRefs = numPolygonRefs;
+	model->numBrushRefs = numBrushRefs;
+
+	// total memory used by this model
+	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
+						model->numEdges * sizeof(cm_edge_t) +
+						model->polygonMemory +
+						model->brushMemory +
+						model->numNodes * sizeof(cm_node_t) +
+						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
+						model->numBrushRefs * sizeof(cm_brushRef_t);
+
+	return model;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC ) {
+	idStr fileName;
+	void *buffer;
+	int i, length, ident, version, vertexSize, edgeSize, polygonSize, brushSize, numFileModels, firstModel;
+	unsigned int crc;
+
+	fileName = name;
+	fileName.SetFileExtension( CM_BINARY_FILE_EXT );
+	length = fileSystem->ReadFile( fileName, &buffer );
+	if ( length < 0 ) {
+		return false;
+	}
+
+	idFile_Memory fp( fileName, (const char *)buffer, length );
+
+	if ( !CM_BinaryFits( &fp, 9, sizeof( int ) ) ) {
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	fp.ReadInt( ident );
+	fp.ReadInt( version );
+	fp.ReadUnsignedInt( crc );
+	fp.ReadInt( vertexSize );
+	fp.ReadInt( edgeSize );
+	fp.ReadInt( polygonSize );
+	fp.ReadInt( brushSize );
+	fp.ReadInt( numFileModels );
+
+	if ( ident != CM_BINARY_FILEID || version != CM_BINARY_FILEVERSION
+			|| vertexSize != sizeof( cm_vertex_t ) || edgeSize != sizeof( cm_edge_t )
+			|| polygonSize != sizeof( cm_polygon_t ) || brushSize != sizeof( cm_brush_t ) ) {
+		common->DPrintf( "%s was written by a different build\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( crc != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( numFileModels < 0 || numFileModels > MAX_SUBMODELS - numModels ) {
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	firstModel = numModels;
+	for ( i = 0; i < numFileModels; i++ ) {
+		cm_model_t *model = ReadBinaryCollisionModel( &fp );
+		if ( !model ) {
+			break;
+		}
+		models[numModels] = model;
+		numModels++;
+	}
+
+	if ( i < numFileModels || fp.Tell() != length ) {
+		common->Warning( "%s is corrupt", fileName.c_str() );
+		for ( i = firstModel; i < numModels; i++ ) {
+			FreeModel( models[i] );
+			models[i] = NULL;
+		}
+		numModels = firstModel;
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	fileSystem->FreeFile( buffer );
+
 	return true;
 }
@@ -185,15 +185,9 @@ void idCollisionModelManagerLocal::Clear( void ) {
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
 	trmMaterial = NULL;
 	numProcNodes = 0;
 	procNodes = NULL;
-	getContacts = false;
-	contacts = NULL;
-	maxContacts = 0;
-	numContacts = 0;
 }
 
 /*
@@ -421,7 +415,7 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 		FreeModel( models[i] );
 	}
 
-	FreeTrmModelStructure();
+	FreeTraceContexts();
 
 	Mem_Free( models );
 
@@ -435,22 +429,27 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 idCollisionModelManagerLocal::FreeTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::FreeTrmModelStructure( void ) {
+void idCollisionModelManagerLocal::FreeTrmModelStructure( cm_traceContext_t *context ) {
 	int i;
+	cm_model_t *model;
 
-	assert( models );
-	if ( !models[MAX_SUBMODELS] ) {
+	model = context->trmModel;
+	if ( !model ) {
 		return;
 	}
 
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
+		FreePolygon( model, context->trmPolygons[i]->p );
 	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
+	FreeBrush( model, context->trmBrushes[0]->b );
+
+	model->node->polygons = NULL;
+	model->node->brushes = NULL;
+	FreeModel( model );
 
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+	context->trmModel = NULL;
+	memset( context->trmPolygons, 0, sizeof( context->trmPolygons ) );
+	context->trmBrushes[0] = NULL;
 }
 
 
@@ -555,6 +554,7 @@ cm_model_t *idCollisionModelManagerLocal::AllocModel( void ) {
 	model->brushRefBlocks = NULL;
 	model->polygonBlock = NULL;
 	model->brushBlock = NULL;
+	model->numPolygonMarks = model->numBrushMarks = 0;
 	model->numPolygons = model->polygonMemory =
 	model->numBrushes = model->brushMemory =
 	model->numNodes = model->numBrushRefs =
@@ -672,6 +672,7 @@ cm_polygon_t *idCollisionModelManagerLocal::AllocPolygon( cm_model_t *model, int
 	} else {
 		poly = (cm_polygon_t *) Mem_Alloc( size );
 	}
+	poly->markNum = model->numPolygonMarks++;
 	return poly;
 }
 
@@ -694,6 +695,7 @@ cm_brush_t *idCollisionModelManagerLocal::AllocBrush( cm_model_t *model, int num
 	} else {
 		brush = (cm_brush_t *) Mem_Alloc( size );
 	}
+	brush->markNum = model->numBrushMarks++;
 	return brush;
 }
 
@@ -732,16 +734,19 @@ void idCollisionModelManagerLocal::AddBrushToNode( cm_model_t *model, cm_node_t
 idCollisionModelManagerLocal::SetupTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
+void idCollisionModelManagerLocal::SetupTrmModelStructure( cm_traceContext_t *context ) {
 	int i;
 	cm_node_t *node;
 	cm_model_t *model;
+	cm_polygonRef_t **trmPolygons;
+	cm_brushRef_t **trmBrushes;
 
 	// setup model
 	model = AllocModel();
 
-	assert( models );
-	models[MAX_SUBMODELS] = model;
+	context->trmModel = model;
+	trmPolygons = context->trmPolygons;
+	trmBrushes = context->trmBrushes;
 	// create node to hold the collision data
 	node = (cm_node_t *) AllocNode( model, 1 );
 	node->planeType = -1;
@@ -753,11 +758,6 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
 	model->numEdges = 0;
 	model->maxEdges = MAX_TRACEMODEL_EDGES+1;
 	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t) );
-	// create a material for the trace model polygons
-	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
-	if ( !trmMaterial ) {
-		common->FatalError( "_tracemodel material not found" );
-	}
 
 	// allocate polygons
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
@@ -784,8 +784,8 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
 ================
 idCollisionModelManagerLocal::SetupTrmModel
 
-Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+Trace models (item boxes, etc) are converted to collision models on the fly, using the trm model
+of the calling thread as a reusable temporary buffer
 ================
 */
 cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
@@ -797,6 +797,9 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	const traceModelVert_t *trmVert;
 	const traceModelEdge_t *trmEdge;
 	const traceModelPoly_t *trmPoly;
+	cm_traceContext_t *context;
+	cm_polygonRef_t **trmPolygons;
+	cm_brushRef_t **trmBrushes;
 
 	assert( models );
 
@@ -804,7 +807,14 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		material = trmMaterial;
 	}
 
-	model = models[MAX_SUBMODELS];
+	context = GetTraceContext();
+	if ( !context->trmModel ) {
+		SetupTrmModelStructure( context );
+	}
+	trmPolygons = context->trmPolygons;
+	trmBrushes = context->trmBrushes;
+
+	model = context->trmModel;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
@@ -817,7 +827,6 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	trmVert = trm.verts;
 	for ( i = 0; i < trm.numVerts; i++, vertex++, trmVert++ ) {
 		vertex->p = *trmVert;
-		vertex->sideSet = 0;
 	}
 	// edges
 	model->numEdges = trm.numEdges;
@@ -828,7 +837,6 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		edge->vertexNum[1] = trmEdge->v[1];
 		edge->normal = trmEdge->normal;
 		edge->internal = false;
-		edge->sideSet = 0;
 	}
 	// polygons
 	model->numPolygons = trm.numPolys;
@@ -3369,8 +3377,11 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 	// setup hash to speed up finding shared vertices and edges
 	SetupHash();
 
-	// setup trace model structure
-	SetupTrmModelStructure();
+	// material for the trace model polygons
+	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
+	if ( !trmMaterial ) {
+		common->FatalError( "_tracemodel material not found" );
+	}
 
 	// build collision models
 	BuildModels( mapFile );
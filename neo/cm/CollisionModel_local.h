@@ -34,6 +34,8 @@ If you have questions concerning this license or the applicable additional terms
 ===============================================================================
 */
 
+#include <atomic>
+
 #include "idlib/math/Pluecker.h"
 #include "cm/CollisionModel.h"
 
@@ -44,6 +46,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #define	MAX_SUBMODELS						2048
 #define	TRACE_MODEL_HANDLE					MAX_SUBMODELS
+#define MAX_TRACE_CONTEXTS					64		// threads doing collision queries
 
 #define VERTEX_HASH_BOXSIZE					(1<<6)	// must be power of 2
 #define VERTEX_HASH_SIZE					(VERTEX_HASH_BOXSIZE*VERTEX_HASH_BOXSIZE)
@@ -81,17 +84,13 @@ Collision model
 
 typedef struct cm_vertex_s {
 	idVec3					p;					// vertex point
-	int						checkcount;			// for multi-check avoidance
-	unsigned int			side;				// each bit tells at which side this vertex passes one of the trace model edges
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model edge has been calculated yet
+	int						checkcount;			// for multi-check avoidance while building and drawing
 } cm_vertex_t;
 
 typedef struct cm_edge_s {
-	int						checkcount;			// for multi-check avoidance
+	int						checkcount;			// for multi-check avoidance while building and drawing
 	unsigned short			internal;			// a trace model can never collide with internal edges
 	unsigned short			numUsers;			// number of polygons using this edge
-	unsigned int			side;				// each bit tells at which side of this edge one of the trace model vertices passes
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model vertex has been calculated yet
 	int						vertexNum[2];		// start and end point of edge
 	idVec3					normal;				// edge normal
 } cm_edge_t;
@@ -103,7 +102,8 @@ typedef struct cm_polygonBlock_s {
 
 typedef struct cm_polygon_s {
 	idBounds				bounds;				// polygon bounds
-	int						checkcount;			// for multi-check avoidance
+	int						checkcount;			// for multi-check avoidance while building and drawing
+	int						markNum;			// index into the polygon marks of a trace context
 	int						contents;			// contents behind polygon
 	const idMaterial *		material;			// material
 	idPlane					plane;				// polygon plane
@@ -127,7 +127,8 @@ typedef struct cm_brushBlock_s {
 } cm_brushBlock_t;
 
 typedef struct cm_brush_s {
-	int						checkcount;			// for multi-check avoidance
+	int						checkcount;			// for multi-check avoidance while building
+	int						markNum;			// index into the brush marks of a trace context
 	idBounds				bounds;				// brush bounds
 	int						contents;			// contents of brush
 	const idMaterial *		material;			// material
@@ -179,6 +180,8 @@ typedef struct cm_model_s {
 	cm_brushRefBlock_t *	brushRefBlocks;		// list with blocks of brush references
 	cm_polygonBlock_t *		polygonBlock;		// memory block with all polygons
 	cm_brushBlock_t *		brushBlock;			// memory block with all brushes
+	int						numPolygonMarks;	// number of polygon mark numbers handed out
+	int						numBrushMarks;		// number of brush mark numbers handed out
 	// statistics
 	int						numPolygons;
 	int						polygonMemory;
@@ -232,6 +235,39 @@ typedef struct cm_trmPolygon_s {
 	idBounds rotationBounds;						// rotation bounds for this polygon
 } cm_trmPolygon_t;
 
+/*
+	Each thread doing collision queries has its own trace context. It holds
+	the trace model set up by SetupTrmModel on that thread and the marks for
+	multi-check avoidance and the sidedness caches of the model features, so
+	queries on different threads never write to the shared collision models.
+*/
+
+typedef struct cm_featureMark_s {
+	int checkcount;									// for multi-check avoidance
+	unsigned int side;								// each bit tells at which side of a trm edge/vertex the vertex/edge passes
+	unsigned int sideSet;							// each bit tells if sidedness for the trm edge/vertex has been calculated yet
+} cm_featureMark_t;
+
+typedef struct cm_traceContext_s {
+	std::atomic<bool> inUse;						// owned by a running thread
+	int checkCount;									// for multi-check avoidance
+	int maxVertexMarks;
+	cm_featureMark_t *vertexMarks;					// marks for model vertices
+	int maxEdgeMarks;
+	cm_featureMark_t *edgeMarks;					// marks for model edges
+	int maxPolygonMarks;
+	int *polygonMarks;								// check counts for polygons, indexed with markNum
+	int maxBrushMarks;
+	int *brushMarks;								// check counts for brushes, indexed with markNum
+	cm_model_t *trmModel;							// model for collision with trace models
+	cm_polygonRef_t *trmPolygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t *trmBrushes[1];
+	bool getContacts;								// for retrieving contact points
+	contactInfo_t *contacts;
+	int maxContacts;
+	int numContacts;
+} cm_traceContext_t;
+
 typedef struct cm_traceWork_s {
 	int numVerts;
 	cm_trmVertex_t vertices[MAX_TRACEMODEL_VERTS];	// trm vertices
@@ -240,6 +276,11 @@ typedef struct cm_traceWork_s {
 	int numPolys;
 	cm_trmPolygon_t polys[MAX_TRACEMODEL_POLYS];	// trm polygons
 	cm_model_t *model;								// model colliding with
+	int checkCount;									// for multi-check avoidance
+	cm_featureMark_t *vertexMarks;					// marks of the trace context for the model
+	cm_featureMark_t *edgeMarks;
+	int *polygonMarks;
+	int *brushMarks;
 	idVec3 start;									// start of trace
 	idVec3 end;										// end of trace
 	idVec3 dir;										// trace direction
@@ -395,6 +436,11 @@ private:			// CollisionMap_contents.cpp
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 
 private:			// CollisionMap_trace.cpp
+					// per thread trace contexts
+	cm_traceContext_t *GetTraceContext( void );
+	void			FreeTraceContexts( void );
+	cm_model_t *	TraceModelForHandle( cmHandle_t model );
+	void			SetupTraceMarks( cm_traceWork_t *tw, cm_traceContext_t *context );
 	void			TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node );
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
 	void			TraceThroughModel( cm_traceWork_t *tw );
@@ -402,7 +448,7 @@ private:			// CollisionMap_trace.cpp
 
 private:			// CollisionMap_load.cpp
 	void			Clear( void );
-	void			FreeTrmModelStructure( void );
+	void			FreeTrmModelStructure( cm_traceContext_t *context );
 					// model deallocation
 	void			RemovePolygonReferences_r( cm_node_t *node, cm_polygon_t *p );
 	void			RemoveBrushReferences_r( cm_node_t *node, cm_brush_t *b );
@@ -442,7 +488,7 @@ private:			// CollisionMap_load.cpp
 	cm_brush_t *	AllocBrush( cm_model_t *model, int numPlanes );
 	void			AddPolygonToNode( cm_model_t *model, cm_node_t *node, cm_polygon_t *p );
 	void			AddBrushToNode( cm_model_t *model, cm_node_t *node, cm_brush_t *b );
-	void			SetupTrmModelStructure( void );
+	void			SetupTrmModelStructure( cm_traceContext_t *context );
 	void			R_FilterPolygonIntoTree( cm_model_t *model, cm_node_t *node, cm_polygonRef_t *pref, cm_polygon_t *p );
 	void			R_FilterBrushIntoTree( cm_model_t *model, cm_node_t *node, cm_brushRef_t *pref, cm_brush_t *b );
 	cm_node_t *		R_CreateAxialBSPTree( cm_model_t *model, cm_node_t *node, const idBounds &bounds );
@@ -490,6 +536,11 @@ private:			// CollisionMap_files.cpp
 	void			ParseBrushes( idLexer *src, cm_model_t *model );
 	bool			ParseCollisionModel( idLexer *src );
 	bool			LoadCollisionModelFile( const char *name, unsigned int mapFileCRC );
+					// binary files
+	void			WriteBinaryCollisionModel( idFile *fp, cm_model_t *model );
+	void			WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
+	cm_model_t *	ReadBinaryCollisionModel( idFile *fp );
+	bool			LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC );
 
 private:			// CollisionMap_debug
 	int				ContentsFromString( const char *string ) const;
@@ -504,24 +555,20 @@ private:			// collision map data
 	idStr			mapName;
 	ID_TIME_T			mapFileTime;
 	int				loaded;
-					// for multi-check avoidance
+					// for multi-check avoidance while building and drawing
 	int				checkCount;
 					// models
 	int				maxModels;
 	int				numModels;
 	cm_model_t **	models;
-					// polygons and brush for trm model
-	cm_polygonRef_t*trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t *	trmBrushes[1];
+					// material for trm model polygons
 	const idMaterial *trmMaterial;
 					// for data pruning
 	int				numProcNodes;
 	cm_procNode_t *	procNodes;
-					// for retrieving contact points
-	bool			getContacts;
-	contactInfo_t *	contacts;
-	int				maxContacts;
-	int				numContacts;
+					// per thread state for collision queries
+	cm_traceContext_t *traceContexts[MAX_TRACE_CONTEXTS];
+	std::atomic<int> numTraceContexts;
 };
 
 // for debugging
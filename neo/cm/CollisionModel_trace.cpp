@@ -35,12 +35,183 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "framework/Common.h"
+#include "sys/sys_public.h"
 
 #include "cm/CollisionModel_local.h"
 
 /*
 ===============================================================================
 
+Per thread trace contexts
+
+A thread takes a trace context the first time it does a collision query and
+releases it when it exits, the next new thread adopts it. The contexts are
+never freed, FreeMap only releases the memory they hold.
+
+===============================================================================
+*/
+
+// releases the trace context of a thread when it exits
+class idTraceContextRef {
+public:
+	cm_traceContext_t *		context;
+
+							~idTraceContextRef( void ) {
+								if ( context ) {
+									context->inUse.store( false, std::memory_order_release );
+								}
+							}
+};
+
+static thread_local idTraceContextRef traceContextRef;
+
+/*
+================
+idCollisionModelManagerLocal::GetTraceContext
+================
+*/
+cm_traceContext_t *idCollisionModelManagerLocal::GetTraceContext( void ) {
+	cm_traceContext_t *context;
+	int i, num;
+
+	context = traceContextRef.context;
+	if ( context ) {
+		return context;
+	}
+
+	// adopt the context of a thread that has exited
+	num = numTraceContexts.load( std::memory_order_acquire );
+	for ( i = 0; i < num; i++ ) {
+		bool expected = false;
+		if ( traceContexts[i]->inUse.compare_exchange_strong( expected, true, std::memory_order_acquire ) ) {
+			traceContextRef.context = traceContexts[i];
+			return traceContexts[i];
+		}
+	}
+
+	context = new cm_traceContext_t;
+	context->inUse.store( true, std::memory_order_relaxed );
+	context->checkCount = 0;
+	context->maxVertexMarks = 0;
+	context->vertexMarks = NULL;
+	context->maxEdgeMarks = 0;
+	context->edgeMarks = NULL;
+	context->maxPolygonMarks = 0;
+	context->polygonMarks = NULL;
+	context->maxBrushMarks = 0;
+	context->brushMarks = NULL;
+	context->trmModel = NULL;
+	memset( context->trmPolygons, 0, sizeof( context->trmPolygons ) );
+	context->trmBrushes[0] = NULL;
+	context->getContacts = false;
+	context->contacts = NULL;
+	context->maxContacts = 0;
+	context->numContacts = 0;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	num = numTraceContexts.load( std::memory_order_relaxed );
+	if ( num >= MAX_TRACE_CONTEXTS ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+		common->FatalError( "idCollisionModelManagerLocal::GetTraceContext: more than %d threads", MAX_TRACE_CONTEXTS );
+	}
+	traceContexts[num] = context;
+	numTraceContexts.store( num + 1, std::memory_order_release );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	traceContextRef.context = context;
+	return context;
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeTraceContexts
+
+  only called while no collision queries are running
+================
+*/
+void idCollisionModelManagerLocal::FreeTraceContexts( void ) {
+	cm_traceContext_t *context;
+	int i, num;
+
+	num = numTraceContexts.load( std::memory_order_acquire );
+	for ( i = 0; i < num; i++ ) {
+		context = traceContexts[i];
+		FreeTrmModelStructure( context );
+		Mem_Free( context->vertexMarks );
+		Mem_Free( context->edgeMarks );
+		Mem_Free( context->polygonMarks );
+		Mem_Free( context->brushMarks );
+		context->maxVertexMarks = 0;
+		context->vertexMarks = NULL;
+		context->maxEdgeMarks = 0;
+		context->edgeMarks = NULL;
+		context->maxPolygonMarks = 0;
+		context->polygonMarks = NULL;
+		context->maxBrushMarks = 0;
+		context->brushMarks = NULL;
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceModelForHandle
+
+  the trace model handle refers to the trm model of the calling thread
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::TraceModelForHandle( cmHandle_t model ) {
+	if ( model < 0 || model > MAX_SUBMODELS || model > maxModels || !models ) {
+		return NULL;
+	}
+	if ( model == TRACE_MODEL_HANDLE ) {
+		return GetTraceContext()->trmModel;
+	}
+	return models[model];
+}
+
+/*
+================
+CM_GrowMarks
+================
+*/
+template< class type >
+static ID_INLINE void CM_GrowMarks( type *&marks, int &maxMarks, int num ) {
+	if ( num > maxMarks ) {
+		Mem_Free( marks );
+		maxMarks = num + ( num >> 2 );
+		marks = (type *) Mem_ClearedAlloc( maxMarks * sizeof( type ) );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::SetupTraceMarks
+
+  starts a new collision query with tw->model on the thread of the context
+================
+*/
+void idCollisionModelManagerLocal::SetupTraceMarks( cm_traceWork_t *tw, cm_traceContext_t *context ) {
+	cm_model_t *model = tw->model;
+
+	// the marks only have to be valid during the query, when they grow the old stamps are dropped
+	CM_GrowMarks( context->vertexMarks, context->maxVertexMarks, model->numVertices );
+	CM_GrowMarks( context->edgeMarks, context->maxEdgeMarks, model->numEdges + 1 );
+	CM_GrowMarks( context->polygonMarks, context->maxPolygonMarks, model->numPolygonMarks );
+	CM_GrowMarks( context->brushMarks, context->maxBrushMarks, model->numBrushMarks );
+
+	context->checkCount++;
+
+	tw->checkCount = context->checkCount;
+	tw->vertexMarks = context->vertexMarks;
+	tw->edgeMarks = context->edgeMarks;
+	tw->polygonMarks = context->polygonMarks;
+	tw->brushMarks = context->brushMarks;
+}
+
+/*
+===============================================================================
+
 Trace through the spatial subdivision
 
 ===============================================================================
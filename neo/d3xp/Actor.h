@@ -164,6 +164,10 @@ public:
 	void					SetFOV( float fov );
 	bool					CheckFOV( const idVec3 &pos ) const;
 	bool					CanSee( idEntity *ent, bool useFOV ) const;
+							// split up CanSee so the traces of several checks can be batched,
+							// returns false when ent can't be seen without tracing
+	bool					SetupCanSeeTrace( idEntity *ent, bool useFOV, clipTrace_t &trace ) const;
+	static bool				CanSeeTraceResult( idEntity *ent, const trace_t &tr );
 	bool					PointVisible( const idVec3 &point ) const;
 	virtual void			GetAIAimTargets( const idVec3 &lastSightPos, idVec3 &headPos, idVec3 &chestPos );
 
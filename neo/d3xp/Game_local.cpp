@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
 #include "idlib/Timer.h"
+#include "idlib/hashing/CRC32.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/BuildVersion.h"
 #include "framework/DeclEntityDef.h"
@@ -78,6 +79,7 @@ idCollisionModelManager *	collisionModelManager = NULL;
 idCVar *					idCVar::staticVars = NULL;
 
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL|CVAR_SYSTEM, "force generic platform independent SIMD" );
+idCVar com_useNEON( "com_useNEON", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_ARCHIVE, "use the NEON SIMD processor on ARM CPUs that have it, the generic one is used otherwise" );
 
 #endif
 
@@ -88,6 +90,7 @@ static gameExport_t			gameExport;
 
 // global animation lib
 idAnimManager				animationLib;
+idAnimPoseCache				animPoseCache;
 
 // the rest of the engine will only reference the "game" variable, while all local aspects stay hidden
 idGameLocal					gameLocal;
@@ -284,6 +287,8 @@ void idGameLocal::Clear( void ) {
 	newInfo.Clear();
 	lastGUIEnt = NULL;
 	lastGUI = 0;
+	benchRagdolls.Clear();
+	benchRagdollFrames = 0;
 
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
@@ -336,7 +341,7 @@ void idGameLocal::Init( void ) {
 	idCVar::RegisterStaticVars();
 
 	// initialize processor specific SIMD
-	idSIMD::InitProcessor( "game", com_forceGenericSIMD.GetBool() );
+	idSIMD::InitProcessor( "game", com_forceGenericSIMD.GetBool(), com_useNEON.GetBool() );
 
 #endif
 
@@ -483,6 +488,7 @@ void idGameLocal::Shutdown( void ) {
 
 	// shut down the animation manager
 	animationLib.Shutdown();
+	animPoseCache.Shutdown();
 
 #ifdef GAME_DLL
 
@@ -1003,6 +1009,8 @@ void idGameLocal::LoadMap( const char *mapName, int randseed ) {
 	sortPushers = false;
 	lastGUIEnt = NULL;
 	lastGUI = 0;
+	benchRagdolls.Clear();
+	benchRagdollFrames = 0;
 
 	globalMaterial = NULL;
 
@@ -1705,6 +1713,8 @@ void idGameLocal::MapShutdown( void ) {
 
 	MapClear( true );
 
+	animPoseCache.Shutdown();
+
 	// reset the script to the state it was before the map was started
 	program.Restart();
 
@@ -2419,6 +2429,83 @@ void idGameLocal::SortActiveEntityList( void ) {
 	sortPushers = false;
 }
 
+/*
+================
+idGameLocal::UpdateAnimatorJob
+================
+*/
+void idGameLocal::UpdateAnimatorJob( void *data, int index ) {
+	const animatorUpdate_t &update = ( (const animatorUpdate_t *)data )[ index ];
+
+	update.animator->CreateFrame( update.time, false );
+}
+
+/*
+================
+idGameLocal::UpdateAnimators
+
+  Builds the frames of the animating entities in the player PVS on the job
+  threads, instead of one by one in the render callbacks. This runs after
+  the think pass and the events, so the frames are the same ones the
+  callbacks would have built, the callbacks then find them up to date.
+  Every job only touches its own animator and the shared anim data is read
+  only, so the result doesn't depend on how the jobs get scheduled.
+
+  The other think phases stay serial even though the collision queries can
+  now run on any thread. The islands that can be split off, the moving
+  articulated figures, are solved by SolveArticulatedFigures. Every other
+  physics step relinks its clip model and the next entity collides against
+  the moved one, so the think order is part of the result the demos and the
+  snapshots depend on. Scripts share the program globals and the event
+  queue, and can spawn and remove entities.
+
+  g_parallelAnim is off by default because the frames are built for every
+  animating entity in the PVS, including the ones the renderer would have
+  culled and never called back for, and on two or three cores that costs
+  more than it saves.
+================
+*/
+void idGameLocal::UpdateAnimators( void ) {
+	idEntity *ent;
+
+	if ( !g_parallelAnim.GetBool() || !sys->NumWorkerThreads() ) {
+		return;
+	}
+
+	// the anim debug output isn't thread safe
+	if ( g_debugAnim.GetInteger() != -1 ) {
+		return;
+	}
+
+	if ( inCinematic && skipCinematic ) {
+		return;
+	}
+
+	animatorUpdates.Clear();
+	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !( ent->thinkFlags & TH_ANIMATE ) || ent->IsHidden() || ent->GetModelDefHandle() == -1 ) {
+			continue;
+		}
+		idAnimator *animator = ent->GetAnimator();
+		if ( !animator || !animator->ModelHandle() ) {
+			continue;
+		}
+		if ( !InPlayerPVS( ent ) ) {
+			continue;
+		}
+
+		animatorUpdate_t *update = animatorUpdates.Alloc();
+		update->animator = animator;
+#ifdef _D3XP
+		// the callbacks build the frame in the time group of the entity
+		SetTimeState ts( ent->timeGroup );
+#endif
+		update->time = time;
+	}
+
+	sys->ParallelFor( UpdateAnimatorJob, animatorUpdates.Ptr(), animatorUpdates.Num(), "UpdateAnimators" );
+}
+
 #ifdef _D3XP
 /*
 ================
@@ -2445,6 +2532,134 @@ void idGameLocal::RunTimeGroup2() {
 }
 #endif
 
+/*
+================
+idGameLocal::SolveArticulatedFigureJob
+================
+*/
+void idGameLocal::SolveArticulatedFigureJob( void *data, int index ) {
+	( (idPhysics_AF **)data )[ index ]->SolveIsland();
+}
+
+/*
+================
+idGameLocal::SolveArticulatedFigures
+
+  Solves the constraints of the moving articulated figures on the job threads
+  before the think pass. The contacts are found one figure after the other in
+  the active entity order, with the team disabled for collision detection like
+  RunPhysics does. Every figure is then solved on its own and the think
+  finishes the step with the collision checks in the usual order. The solve
+  only reads the figure itself, so the result is the same for any number of
+  job threads. See idPhysics_AF::PrepareIsland for the figures that are left
+  to the think.
+
+  Rigid bodies stay in the think, they have no constraints to solve and are
+  all contacts and collision checks.
+================
+*/
+void idGameLocal::SolveArticulatedFigures( void ) {
+	idEntity *ent, *part;
+	idPhysics_AF *af;
+	bool prepared;
+
+	if ( !af_parallelIslands.GetBool() || !sys->NumWorkerThreads() ) {
+		return;
+	}
+
+	if ( inCinematic ) {
+		return;
+	}
+
+	islandFigures.Clear();
+	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !( ent->thinkFlags & TH_PHYSICS ) || ent->fl.solidForTeam ) {
+			continue;
+		}
+		// team slaves are moved by the team master
+		if ( ent->GetTeamMaster() != NULL && ent->GetTeamMaster() != ent ) {
+			continue;
+		}
+#ifdef _D3XP
+		// the slow motion entities think with another time
+		if ( ent->timeGroup != TIME_GROUP1 ) {
+			continue;
+		}
+#endif
+		if ( !ent->GetPhysics()->IsType( idPhysics_AF::Type ) ) {
+			continue;
+		}
+		af = static_cast<idPhysics_AF *>( ent->GetPhysics() );
+
+		for ( part = ent; part != NULL; part = part->GetNextTeamEntity() ) {
+			if ( part->GetPhysics() && !part->fl.solidForTeam ) {
+				part->GetPhysics()->DisableClip();
+			}
+		}
+
+		prepared = af->PrepareIsland( time - previousTime, time );
+
+		for ( part = ent; part != NULL; part = part->GetNextTeamEntity() ) {
+			if ( part->GetPhysics() && !part->fl.solidForTeam ) {
+				part->GetPhysics()->EnableClip();
+			}
+		}
+
+		if ( prepared ) {
+			islandFigures.Append( af );
+		}
+	}
+
+	sys->ParallelFor( SolveArticulatedFigureJob, islandFigures.Ptr(), islandFigures.Num(), "SolveArticulatedFigures" );
+}
+
+/*
+================
+idGameLocal::RunRagdollBench
+
+  Measures the think pass while the ragdolls spawned by benchRagdolls fall.
+  The checksum of the final body positions tells if two runs of the same map
+  gave the same result.
+================
+*/
+void idGameLocal::RunRagdollBench( double thinkTime ) {
+	int i, j, numMoving;
+	unsigned int crc;
+	idEntity *ent;
+	idPhysics *phys;
+
+	benchRagdollTime += thinkTime;
+	if ( thinkTime > benchRagdollMaxTime ) {
+		benchRagdollMaxTime = thinkTime;
+	}
+	if ( ++benchRagdollFrame < benchRagdollFrames ) {
+		return;
+	}
+
+	numMoving = 0;
+	CRC32_InitChecksum( crc );
+	for ( i = 0; i < benchRagdolls.Num(); i++ ) {
+		ent = benchRagdolls[i].GetEntity();
+		if ( !ent ) {
+			continue;
+		}
+		phys = ent->GetPhysics();
+		if ( !phys->IsAtRest() ) {
+			numMoving++;
+		}
+		for ( j = 0; j < phys->GetNumClipModels(); j++ ) {
+			CRC32_UpdateChecksum( crc, phys->GetOrigin( j ).ToFloatPtr(), sizeof( idVec3 ) );
+			CRC32_UpdateChecksum( crc, phys->GetAxis( j ).ToFloatPtr(), sizeof( idMat3 ) );
+		}
+	}
+	CRC32_FinishChecksum( crc );
+
+	Printf( "benchRagdolls: %d ragdolls (%d still moving), %d frames, think %.2f ms average %.2f ms max, checksum %08x\n",
+		benchRagdolls.Num(), numMoving, benchRagdollFrame, benchRagdollTime / benchRagdollFrame, benchRagdollMaxTime, crc );
+
+	benchRagdollFrames = 0;
+}
+
 /*
 ================
 idGameLocal::RunFrame
@@ -2454,7 +2669,7 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 	idEntity* ent;
 	int					num;
 	float				ms;
-	idTimer				timer_think, timer_events, timer_singlethink;
+	idTimer				timer_think, timer_events, timer_anim, timer_singlethink;
 	gameReturn_t		ret;
 	idPlayer* player;
 	const renderView_t* view;
@@ -2497,8 +2712,8 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 
 #ifdef GAME_DLL
 		// allow changing SIMD usage on the fly
-		if ( com_forceGenericSIMD.IsModified() ) {
-			idSIMD::InitProcessor( "game", com_forceGenericSIMD.GetBool() );
+		if ( com_forceGenericSIMD.IsModified() || com_useNEON.IsModified() ) {
+			idSIMD::InitProcessor( "game", com_forceGenericSIMD.GetBool(), com_useNEON.GetBool() );
 		}
 #endif
 
@@ -2526,6 +2741,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 		// free old smoke particles
 		smokeParticles->FreeSmokes();
 
+		// the shared poses of the last frame are out of date
+		animPoseCache.BeginFrame();
+
 		// process events on the server
 		ServerProcessEntityNetworkEventQueue();
 
@@ -2541,6 +2759,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 		timer_think.Clear();
 		timer_think.Start();
 
+		// solve the moving articulated figures on the job threads
+		SolveArticulatedFigures();
+
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
@@ -2604,6 +2825,12 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 		}
 
 		timer_think.Stop();
+
+		// measure the ragdolls spawned by benchRagdolls
+		if ( benchRagdollFrames ) {
+			RunRagdollBench( timer_think.Milliseconds() );
+		}
+
 		timer_events.Clear();
 		timer_events.Start();
 
@@ -2618,6 +2845,13 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 #endif
 
 		timer_events.Stop();
+		timer_anim.Clear();
+		timer_anim.Start();
+
+		// build the frames of the visible animating entities on the job threads
+		UpdateAnimators();
+
+		timer_anim.Stop();
 
 		// free the player pvs
 		FreePlayerPVS();
@@ -2629,9 +2863,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 
 		// display how long it took to calculate the current game frame
 		if ( g_frametime.GetBool() ) {
-			Printf( "game %d: all:%u th:%u ev:%u %d ents \n",
-				time, timer_think.Milliseconds() + timer_events.Milliseconds(),
-				timer_think.Milliseconds(), timer_events.Milliseconds(), num );
+			Printf( "game %d: all:%u th:%u ev:%u an:%u %d ents \n",
+				time, timer_think.Milliseconds() + timer_events.Milliseconds() + timer_anim.Milliseconds(),
+				timer_think.Milliseconds(), timer_events.Milliseconds(), timer_anim.Milliseconds(), num );
 		}
 
 		// build the return value
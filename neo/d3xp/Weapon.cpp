@@ -3394,14 +3394,24 @@ void idWeapon::Event_LaunchProjectiles( int num_projectiles, float spread, float
 		if ( projectileDict.GetBool( "net_instanthit" ) ) {
 			float spreadRad = DEG2RAD( spread );
 			muzzle_pos = muzzleOrigin + playerViewAxis[ 0 ] * 2.0f;
+			clipTrace_t *traces = (clipTrace_t *)_alloca16( num_projectiles * sizeof( traces[0] ) );
+			trace_t *results = (trace_t *)_alloca16( num_projectiles * sizeof( results[0] ) );
 			for( i = 0; i < num_projectiles; i++ ) {
 				ang = idMath::Sin( spreadRad * gameLocal.random.RandomFloat() );
 				spin = (float)DEG2RAD( 360.0f ) * gameLocal.random.RandomFloat();
 				dir = playerViewAxis[ 0 ] + playerViewAxis[ 2 ] * ( ang * idMath::Sin( spin ) ) - playerViewAxis[ 1 ] * ( ang * idMath::Cos( spin ) );
 				dir.Normalize();
-				gameLocal.clip.Translation( tr, muzzle_pos, muzzle_pos + dir * 4096.0f, NULL, mat3_identity, MASK_SHOT_RENDERMODEL, owner );
-				if ( tr.fraction < 1.0f ) {
-					idProjectile::ClientPredictionCollide( this, projectileDict, tr, vec3_origin, true );
+				traces[i].start = muzzle_pos;
+				traces[i].end = muzzle_pos + dir * 4096.0f;
+				traces[i].bounds.Clear();
+				traces[i].contentMask = MASK_SHOT_RENDERMODEL;
+				traces[i].passEntity = owner;
+			}
+			// all pellets are traced together
+			gameLocal.clip.TraceBatch( results, traces, num_projectiles );
+			for( i = 0; i < num_projectiles; i++ ) {
+				if ( results[i].fraction < 1.0f ) {
+					idProjectile::ClientPredictionCollide( this, projectileDict, results[i], vec3_origin, true );
 				}
 			}
 		}
@@ -372,24 +372,55 @@ void idAI::Event_FindEnemy( int useFOV ) {
 	idThread::ReturnEntity( NULL );
 }
 
+// sight lines traced together by Event_FindEnemyAI before it looks at the results
+const int FIND_ENEMY_TRACES = 8;
+
+typedef struct {
+	idActor *	actor;
+	float		dist;
+	int			index;
+} enemyCandidate_t;
+
+/*
+=====================
+EnemyCandidateCompare
+
+  Nearest first, the active entity order decides between equal distances.
+=====================
+*/
+static int EnemyCandidateCompare( const enemyCandidate_t *a, const enemyCandidate_t *b ) {
+	if ( a->dist < b->dist ) {
+		return -1;
+	}
+	if ( a->dist > b->dist ) {
+		return 1;
+	}
+	return a->index - b->index;
+}
+
 /*
 =====================
 idAI::Event_FindEnemyAI
+
+  The candidates are sorted by distance and traced a few at a time, nearest
+  first, until one of them is seen. The candidates farther away than the
+  nearest visible one are only traced if they share its batch.
 =====================
 */
 void idAI::Event_FindEnemyAI( int useFOV ) {
 	idEntity	*ent;
 	idActor		*actor;
 	idActor		*bestEnemy;
-	float		bestDist;
-	float		dist;
 	idVec3		delta;
 	pvsHandle_t pvs;
+	int			i, first, numTraces;
+	idStaticList<enemyCandidate_t, MAX_GENTITIES> candidates;
+	idActor		*traced[FIND_ENEMY_TRACES];
+	clipTrace_t	traces[FIND_ENEMY_TRACES];
+	trace_t		results[FIND_ENEMY_TRACES];
 
 	pvs = gameLocal.pvs.SetupCurrentPVS( GetPVSAreas(), GetNumPVSAreas() );
 
-	bestDist = idMath::INFINITY;
-	bestEnemy = NULL;
 	for ( ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
 		if ( ent->fl.hidden || ent->fl.isDormant || !ent->IsType( idActor::Type ) ) {
 			continue;
@@ -404,15 +435,36 @@ void idAI::Event_FindEnemyAI( int useFOV ) {
 			continue;
 		}
 
+		enemyCandidate_t *candidate = candidates.Alloc();
 		delta = physicsObj.GetOrigin() - actor->GetPhysics()->GetOrigin();
-		dist = delta.LengthSqr();
-		if ( ( dist < bestDist ) && CanSee( actor, useFOV != 0 ) ) {
-			bestDist = dist;
-			bestEnemy = actor;
-		}
+		candidate->actor = actor;
+		candidate->dist = delta.LengthSqr();
+		candidate->index = candidates.Num() - 1;
 	}
 
 	gameLocal.pvs.FreeCurrentPVS( pvs );
+
+	qsort( candidates.Ptr(), candidates.Num(), sizeof( enemyCandidate_t ), ( int (*)( const void *, const void * ) )EnemyCandidateCompare );
+
+	bestEnemy = NULL;
+	for ( first = 0; first < candidates.Num() && bestEnemy == NULL; first += FIND_ENEMY_TRACES ) {
+		numTraces = 0;
+		for ( i = first; i < candidates.Num() && i < first + FIND_ENEMY_TRACES; i++ ) {
+			if ( SetupCanSeeTrace( candidates[i].actor, useFOV != 0, traces[numTraces] ) ) {
+				traced[numTraces++] = candidates[i].actor;
+			}
+		}
+
+		gameLocal.clip.TraceBatch( results, traces, numTraces );
+
+		for ( i = 0; i < numTraces; i++ ) {
+			if ( CanSeeTraceResult( traced[i], results[i] ) ) {
+				bestEnemy = traced[i];
+				break;
+			}
+		}
+	}
+
 	idThread::ReturnEntity( bestEnemy );
 }
 
@@ -79,6 +79,12 @@ typedef struct {
 	int						firstComponent;
 } jointAnimInfo_t;
 
+typedef struct {
+	int						firstComponent;		// where the joint's animated quaternion components go in a decoded frame
+	int						animBits;
+	int						firstQuantized;		// three smallest components of the quaternion, the index of the largest is in their low bits
+} quantizedRotation_t;
+
 typedef struct {
 	jointHandle_t			num;
 	jointHandle_t			parentNum;
@@ -245,6 +251,23 @@ private:
 	idVec3					totaldelta;
 	mutable int				ref_count;
 
+	// with g_quantizeAnims the componentFrames are replaced by 16 bit values
+	bool					quantized;
+	int						numQuantizedComponents;
+	int						numRootComponents;
+	idList<unsigned short>	quantizedFrames;			// numQuantizedComponents per frame
+	idList<float>			quantizedBias;
+	idList<float>			quantizedScale;
+	idList<float>			constantComponents;			// tracks that are the same in every frame
+	idList<int>				componentSource;			// dequantized or constant value of each animated component, -1 for rotations and the root
+	idList<quantizedRotation_t>	quantizedRotations;
+	idList<float>			rootFrames;					// the root joint isn't quantized so the move deltas stay exact
+
+	void					Quantize( void );
+	void					CheckQuantization( const idList<int> &rotationJoints ) const;
+	const float *			DecodeFrame( int framenum, float *buffer ) const;
+	const float *			RootComponents( int framenum ) const;
+
 public:
 							idMD5Anim();
 							~idMD5Anim();
@@ -253,6 +276,8 @@ public:
 	bool					Reload( void );
 	size_t					Allocated( void ) const;
 	size_t					Size( void ) const { return sizeof( *this ) + Allocated(); };
+	bool					IsQuantized( void ) const { return quantized; }
+	size_t					QuantizedSavings( void ) const;
 	bool					LoadAnim( const char *filename );
 
 	void					IncreaseRefs( void ) const;
@@ -388,6 +413,19 @@ private:
 ==============================================================================================
 */
 
+// everything BlendAnim looks at, so blends with the same key give the same pose
+typedef struct {
+	int							animNum;			// -1 when nothing is playing
+	int							frame;
+	int							frame1;
+	int							frame2;
+	float						backlerp;
+	float						weight;
+	float						animWeights[ ANIM_MaxSyncedAnims ];
+	int							ended;
+	int							allowMove;
+} animPoseBlend_t;
+
 class idAnimBlend {
 private:
 	const class idDeclModelDef	*modelDef;
@@ -420,6 +458,7 @@ private:
 	void						BlendDelta( int fromtime, int totime, idVec3 &blendDelta, float &blendWeight ) const;
 	void						BlendDeltaRotation( int fromtime, int totime, idQuat &blendDelta, float &blendWeight ) const;
 	bool						AddBounds( int currentTime, idBounds &bounds, bool removeOriginOffset ) const;
+	void						GetPoseKey( int currentTime, animPoseBlend_t &key ) const;
 
 public:
 								idAnimBlend();
@@ -575,6 +614,7 @@ public:
 private:
 	void						FreeData( void );
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						BlendChannels( int currentTime, idJointQuat *jointFrame, bool debugInfo ) const;
 
 private:
 	const idDeclModelDef *		modelDef;
@@ -600,6 +640,51 @@ private:
 	int							AFPoseTime;
 };
 
+/*
+==============================================================================================
+
+	idAnimPoseCache
+
+	Animators of the same model that are in the same state in a frame share the
+	blended joints.  The cache keeps the joints before the joint modifiers, which
+	are different for every entity because of the IK, and the model space joints
+	for the animators that don't have any.
+
+==============================================================================================
+*/
+
+typedef struct {
+	const idDeclModelDef *		modelDef;
+	int							removeOriginOffset;
+	animPoseBlend_t				blends[ ANIM_NumAnimChannels ][ ANIM_MaxAnimsPerChannel ];
+} animPoseKey_t;
+
+typedef struct {
+	animPoseKey_t				key;
+	int							numJoints;
+	int							maxJoints;
+	idJointMat *				localJoints;		// parent space, the joint modifiers are applied to these
+	idJointMat *				modelJoints;		// model space with the visual offset
+} animPose_t;
+
+class idAnimPoseCache {
+public:
+								idAnimPoseCache();
+								~idAnimPoseCache();
+
+	void						Shutdown( void );
+	void						BeginFrame( void );
+	const animPose_t *			FindPose( const animPoseKey_t &key );
+	const animPose_t *			AddPose( const animPoseKey_t &key, const idJointMat *localJoints, int numJoints );
+
+private:
+	idList<animPose_t *>		poses;
+	int							numPoses;			// poses in use this frame
+	idHashIndex					poseHash;
+	int							numHits;
+	int							numMisses;
+};
+
 /*
 ==============================================================================================
 
@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "gamesys/SaveGame.h"
+#include "gamesys/SysCvar.h"
 #include "Entity.h"
 #include "Game_local.h"
 
@@ -730,6 +731,10 @@ void idClip::Shutdown( void ) {
 		defaultClipModel.traceModelIndex = -1;
 	}
 
+	batchTraces.Clear();
+	batchTraceModels.Clear();
+	batchClipModels.Clear();
+
 	clipLinkAllocator.Shutdown();
 }
 
@@ -1125,6 +1130,282 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 	return ( results.fraction < 1.0f );
 }
 
+/*
+============
+idClip::TraceBatchWorldJob
+============
+*/
+void idClip::TraceBatchWorldJob( void *data, int index ) {
+	clipBatchTrace_t &batch = ( (idClip *)data )->batchTraces[index];
+	const clipTrace_t &trace = *batch.trace;
+	trace_t &results = *batch.results;
+
+	if ( batch.done ) {
+		return;
+	}
+
+	if ( !trace.passEntity || trace.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		batch.numTranslations++;
+		collisionModelManager->Translation( &results, trace.start, trace.end, batch.trm, mat3_identity, trace.contentMask, 0, vec3_origin, mat3_default );
+		results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+		if ( results.fraction == 0.0f ) {
+			batch.done = true;		// blocked immediately by the world
+		}
+	} else {
+		memset( &results, 0, sizeof( results ) );
+		results.fraction = 1.0f;
+		results.endpos = trace.end;
+		results.endAxis = mat3_identity;
+	}
+}
+
+/*
+============
+idClip::TraceBatchEntitiesJob
+
+  The render model traces are left for the main thread, the render world isn't thread safe.
+============
+*/
+void idClip::TraceBatchEntitiesJob( void *data, int index ) {
+	idClip *clip = (idClip *)data;
+	clipBatchTrace_t &batch = clip->batchTraces[index];
+	const clipTrace_t &trace = *batch.trace;
+	trace_t &results = *batch.results;
+	idClipModel *touch;
+	trace_t tr;
+	int i;
+
+	if ( batch.done ) {
+		return;
+	}
+
+	for ( i = 0; i < batch.numClipModels; i++ ) {
+		touch = clip->batchClipModels[batch.firstClipModel + i];
+
+		if ( touch->renderModelHandle != -1 ) {
+			continue;
+		}
+
+		// the trace model handle is set up for the calling thread so get it here
+		batch.numTranslations++;
+		collisionModelManager->Translation( &tr, trace.start, trace.end, batch.trm, mat3_identity, trace.contentMask,
+								touch->Handle(), touch->origin, touch->axis );
+
+		if ( tr.fraction < results.fraction ) {
+			results = tr;
+			results.c.entityNum = touch->entity->entityNumber;
+			results.c.id = touch->id;
+			batch.hitClipModel = i;
+			if ( results.fraction == 0.0f ) {
+				break;
+			}
+		}
+	}
+}
+
+/*
+============
+TraceBatchSortCompare
+============
+*/
+static int TraceBatchSortCompare( const clipBatchTrace_t *a, const clipBatchTrace_t *b ) {
+	return a->sortKey - b->sortKey;
+}
+
+/*
+============
+TraceBatchSortKey
+
+  Morton order of the start point in the world bounds, so traces that are
+  close together also end up close together in the batch and are run by
+  the same job, which then walks the same clip sectors and collision nodes.
+============
+*/
+static int TraceBatchSortKey( const idVec3 &point, const idBounds &worldBounds ) {
+	int i, j, key, cell[3];
+
+	for ( i = 0; i < 3; i++ ) {
+		float size = worldBounds[1][i] - worldBounds[0][i];
+		if ( size <= 0.0f ) {
+			cell[i] = 0;
+			continue;
+		}
+		cell[i] = idMath::Ftoi( ( point[i] - worldBounds[0][i] ) * ( 1024.0f / size ) );
+		cell[i] = idMath::ClampInt( 0, 1023, cell[i] );
+	}
+
+	key = 0;
+	for ( j = 9; j >= 0; j-- ) {
+		for ( i = 0; i < 3; i++ ) {
+			key = ( key << 1 ) | ( ( cell[i] >> j ) & 1 );
+		}
+	}
+	return key;
+}
+
+/*
+============
+idClip::TraceBatch
+
+  Gives the same results as calling TracePoint or TraceBounds for every
+  trace. The traces are run in three passes: the world, then gathering the
+  clip models touched by what is left of each trace, then the entities.
+  The world and entity passes go through the collision model manager,
+  which is re-entrant, so they are spread over the job threads. Gathering
+  the clip models uses the clip sector touch counts and the render model
+  traces use the render world, so those stay on the calling thread.
+============
+*/
+void idClip::TraceBatch( trace_t *results, const clipTrace_t *traces, const int numTraces ) {
+	int i, j, num, numTraceModels;
+	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	idBounds traceBounds;
+	trace_t tr;
+	bool parallel;
+
+	if ( numTraces <= 0 ) {
+		return;
+	}
+
+	numTraceModels = 0;
+	for ( i = 0; i < numTraces; i++ ) {
+		if ( !traces[i].bounds.IsCleared() ) {
+			numTraceModels++;
+		}
+	}
+
+	// the trace models must not move once they are pointed to
+	batchTraces.SetNum( numTraces, false );
+	batchTraceModels.SetNum( numTraceModels, false );
+	batchClipModels.SetNum( 0, false );
+
+	numTraceModels = 0;
+	for ( i = 0; i < numTraces; i++ ) {
+		const clipTrace_t &trace = traces[i];
+		clipBatchTrace_t &batch = batchTraces[i];
+
+		batch.trace = &trace;
+		batch.results = &results[i];
+		batch.sortKey = TraceBatchSortKey( trace.start, worldBounds );
+		batch.firstClipModel = 0;
+		batch.numClipModels = 0;
+		batch.hitClipModel = -1;
+		batch.numTranslations = 0;
+		batch.done = false;
+
+		if ( trace.bounds.IsCleared() ) {
+			batch.trm = NULL;
+			batch.radius = 0.0f;
+			continue;
+		}
+
+		idTraceModel &trm = batchTraceModels[numTraceModels++];
+		trm.SetupBox( trace.bounds );
+		batch.trm = &trm;
+		batch.radius = trm.bounds.GetRadius();
+
+		if ( ( trace.end - trace.start ).LengthSqr() > Square( CM_MAX_TRACE_DIST ) ) {
+			trace_t &huge = results[i];
+			huge.fraction = 0.0f;
+			huge.endpos = trace.start;
+			huge.endAxis = mat3_identity;
+			memset( &huge.c, 0, sizeof( huge.c ) );
+			huge.c.point = trace.start;
+			huge.c.entityNum = ENTITYNUM_WORLD;
+			batch.done = true;
+
+			gameLocal.Printf( "huge translation for batched trace\n" );
+			gameLocal.Printf( "  from (%.2f %.2f %.2f) to (%.2f %.2f %.2f)\n", trace.start.x, trace.start.y, trace.start.z, trace.end.x, trace.end.y, trace.end.z );
+		}
+	}
+
+	batchTraces.Sort( TraceBatchSortCompare );
+
+	parallel = g_parallelTraces.GetBool() && sys->NumWorkerThreads() > 0;
+
+	if ( parallel ) {
+		sys->ParallelFor( TraceBatchWorldJob, this, numTraces, "TraceBatchWorld" );
+	} else {
+		for ( i = 0; i < numTraces; i++ ) {
+			TraceBatchWorldJob( this, i );
+		}
+	}
+
+	// gather the clip models for the part of each trace that isn't blocked by the world
+	for ( i = 0; i < numTraces; i++ ) {
+		clipBatchTrace_t &batch = batchTraces[i];
+
+		if ( batch.done ) {
+			continue;
+		}
+
+		const clipTrace_t &trace = *batch.trace;
+
+		if ( !batch.trm ) {
+			traceBounds.FromPointTranslation( trace.start, batch.results->endpos - trace.start );
+		} else {
+			traceBounds.FromBoundsTranslation( batch.trm->bounds, trace.start, mat3_identity, batch.results->endpos - trace.start );
+		}
+
+		num = GetTraceClipModels( traceBounds, trace.contentMask, trace.passEntity, clipModelList );
+
+		batch.firstClipModel = batchClipModels.Num();
+		for ( j = 0; j < num; j++ ) {
+			if ( clipModelList[j] ) {
+				batchClipModels.Append( clipModelList[j] );
+			}
+		}
+		batch.numClipModels = batchClipModels.Num() - batch.firstClipModel;
+	}
+
+	if ( batchClipModels.Num() ) {
+		if ( parallel ) {
+			sys->ParallelFor( TraceBatchEntitiesJob, this, numTraces, "TraceBatchEntities" );
+		} else {
+			for ( i = 0; i < numTraces; i++ ) {
+				TraceBatchEntitiesJob( this, i );
+			}
+		}
+	}
+
+	for ( i = 0; i < numTraces; i++ ) {
+		clipBatchTrace_t &batch = batchTraces[i];
+		const clipTrace_t &trace = *batch.trace;
+		trace_t &result = *batch.results;
+
+		idClip::numTranslations += batch.numTranslations;
+
+		if ( batch.done ) {
+			continue;
+		}
+
+		// the render models are merged in clip model list order, like Translation does, so
+		// one that comes before the collision model hit also wins when the fractions are equal
+		for ( j = 0; j < batch.numClipModels; j++ ) {
+			touch = batchClipModels[batch.firstClipModel + j];
+
+			if ( result.fraction == 0.0f && j > batch.hitClipModel ) {
+				break;
+			}
+
+			if ( touch->renderModelHandle == -1 ) {
+				continue;
+			}
+
+			idClip::numRenderModelTraces++;
+			TraceRenderModel( tr, trace.start, trace.end, batch.radius, mat3_identity, touch );
+
+			if ( tr.fraction < result.fraction || ( tr.fraction == result.fraction && j < batch.hitClipModel ) ) {
+				result = tr;
+				result.c.entityNum = touch->entity->entityNumber;
+				result.c.id = touch->id;
+				batch.hitClipModel = j;
+			}
+		}
+	}
+}
+
 /*
 ============
 idClip::Rotation
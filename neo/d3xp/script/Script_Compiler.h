@@ -198,6 +198,17 @@ enum {
 	NUM_OPCODES
 };
 
+// superinstructions the interpreter runs in place of a few statements, see idProgram::DecodeStatements
+enum {
+	OP_SUPER_EVENTCALL = NUM_OPCODES,	// argument pushes and the event or sys call
+	OP_SUPER_STORE_F,					// float arithmetic into a temporary and the store of it
+	OP_SUPER_STORE_V,					// vector arithmetic into a temporary and the store of it
+	OP_SUPER_MULADD_V,					// scaled vector into a temporary and the add of it
+	OP_SUPER_IFNOT,						// float comparison and the branch on its result
+
+	NUM_SCRIPT_INSTRUCTIONS
+};
+
 class idCompiler {
 private:
 	static bool		punctuationValid[ 256 ];
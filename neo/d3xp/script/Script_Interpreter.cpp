@@ -38,6 +38,8 @@ If you have questions concerning this license or the applicable additional terms
 // HvG: Debugger support
 extern bool updateGameDebugger( idInterpreter *interpreter, idProgram *program, int instructionPointer );
 
+int idInterpreter::executedStatements = 0;
+
 /*
 ================
 idInterpreter::idInterpreter()
@@ -968,18 +970,77 @@ void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
 	popParms = 0;
 }
 
+/*
+====================
+idInterpreter::DebugStatement
+
+Lets the debugger look at the statement about to run, prints the script
+line when g_debugScript is set and the debugger didn't handle it
+====================
+*/
+void idInterpreter::DebugStatement( void ) {
+	if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
+		&& g_debugScript.GetBool( ) ) 
+	{
+		static int lastLineNumber = -1;
+		if (lastLineNumber != gameLocal.program.GetStatement(instructionPointer).linenumber) {
+			gameLocal.Printf("%s (%d)\n",
+				gameLocal.program.GetFilename(gameLocal.program.GetStatement(instructionPointer).file),
+				gameLocal.program.GetStatement(instructionPointer).linenumber
+			);
+			lastLineNumber = gameLocal.program.GetStatement(instructionPointer).linenumber;
+		}
+	}
+}
+
 /*
 ====================
 idInterpreter::Execute
+
+Runs the instructions idProgram::DecodeStatements made from the statements.
+With gcc and clang every instruction jumps straight to the next one through
+a table of label addresses, other compilers go through the switch.
 ====================
 */
+
+#if defined( __GNUC__ )
+#define INTERP_COMPUTED_GOTO
+#endif
+
+// gets the next instruction, the debugger has to see every statement
+#define INTERP_FETCH													\
+	if ( doneProcessing || threadDying ) {								\
+		goto finished;													\
+	}																	\
+	instructionPointer++;												\
+	if ( --runaway <= 0 ) {												\
+		Error( "runaway loop error" );									\
+	}																	\
+	inst = &gameLocal.program.GetInstruction( instructionPointer );		\
+	if ( debugging ) {													\
+		DebugStatement();												\
+	}
+
+#ifdef INTERP_COMPUTED_GOTO
+#define INTERP_CASE( op )		label_##op:
+#define INTERP_DEFAULT			label_default:
+#define INTERP_NEXT				do { INTERP_FETCH goto *dispatchTable[ inst->op[ mode ] ]; } while( 0 )
+#else
+#define INTERP_CASE( op )		case op:
+#define INTERP_DEFAULT			default:
+#define INTERP_NEXT				continue
+#endif
+
 bool idInterpreter::Execute( void ) {
 	varEval_t	var_a;
 	varEval_t	var_b;
 	varEval_t	var_c;
 	varEval_t	var;
-	statement_t	*st;
+	const scriptInstruction_t *inst;
 	int			runaway;
+	int			mode;
+	int			i;
+	bool		debugging;
 	idThread	*newThread;
 	float		floatVal;
 	idScriptObject *obj;
@@ -994,52 +1055,311 @@ bool idInterpreter::Execute( void ) {
 		instructionPointer--;
 	}
 
+	// the debugger and g_debugScript step through the plain statements
+	debugging = g_debugScript.GetBool() || cvarSystem->GetCVarBool( "com_enableDebuggerServer" );
+	mode = ( debugging || !g_scriptSuperInstructions.GetBool() ) ? 1 : 0;
+
 	runaway = 5000000;
 
 	doneProcessing = false;
-	while( !doneProcessing && !threadDying ) {
-		instructionPointer++;
 
-		if ( !--runaway ) {
-			Error( "runaway loop error" );
-		}
+#ifdef INTERP_COMPUTED_GOTO
+	static const void *dispatchTable[ NUM_SCRIPT_INSTRUCTIONS ];
+	static bool dispatchTableInitialized = false;
 
-		// next statement
-		st = &gameLocal.program.GetStatement( instructionPointer );
+	if ( !dispatchTableInitialized ) {
+		for( i = 0; i < NUM_SCRIPT_INSTRUCTIONS; i++ ) {
+			dispatchTable[ i ] = &&label_default;
+		}
+#define INTERP_DISPATCH( op )	dispatchTable[ op ] = &&label_##op;
+		INTERP_DISPATCH( OP_SUPER_EVENTCALL )
+		INTERP_DISPATCH( OP_SUPER_STORE_F )
+		INTERP_DISPATCH( OP_SUPER_STORE_V )
+		INTERP_DISPATCH( OP_SUPER_MULADD_V )
+		INTERP_DISPATCH( OP_SUPER_IFNOT )
+		INTERP_DISPATCH( OP_RETURN )
+		INTERP_DISPATCH( OP_THREAD )
+		INTERP_DISPATCH( OP_OBJTHREAD )
+		INTERP_DISPATCH( OP_CALL )
+		INTERP_DISPATCH( OP_EVENTCALL )
+		INTERP_DISPATCH( OP_OBJECTCALL )
+		INTERP_DISPATCH( OP_SYSCALL )
+		INTERP_DISPATCH( OP_IFNOT )
+		INTERP_DISPATCH( OP_IF )
+		INTERP_DISPATCH( OP_GOTO )
+		INTERP_DISPATCH( OP_ADD_F )
+		INTERP_DISPATCH( OP_ADD_V )
+		INTERP_DISPATCH( OP_ADD_S )
+		INTERP_DISPATCH( OP_ADD_FS )
+		INTERP_DISPATCH( OP_ADD_SF )
+		INTERP_DISPATCH( OP_ADD_VS )
+		INTERP_DISPATCH( OP_ADD_SV )
+		INTERP_DISPATCH( OP_SUB_F )
+		INTERP_DISPATCH( OP_SUB_V )
+		INTERP_DISPATCH( OP_MUL_F )
+		INTERP_DISPATCH( OP_MUL_V )
+		INTERP_DISPATCH( OP_MUL_FV )
+		INTERP_DISPATCH( OP_MUL_VF )
+		INTERP_DISPATCH( OP_DIV_F )
+		INTERP_DISPATCH( OP_MOD_F )
+		INTERP_DISPATCH( OP_BITAND )
+		INTERP_DISPATCH( OP_BITOR )
+		INTERP_DISPATCH( OP_GE )
+		INTERP_DISPATCH( OP_LE )
+		INTERP_DISPATCH( OP_GT )
+		INTERP_DISPATCH( OP_LT )
+		INTERP_DISPATCH( OP_AND )
+		INTERP_DISPATCH( OP_AND_BOOLF )
+		INTERP_DISPATCH( OP_AND_FBOOL )
+		INTERP_DISPATCH( OP_AND_BOOLBOOL )
+		INTERP_DISPATCH( OP_OR )
+		INTERP_DISPATCH( OP_OR_BOOLF )
+		INTERP_DISPATCH( OP_OR_FBOOL )
+		INTERP_DISPATCH( OP_OR_BOOLBOOL )
+		INTERP_DISPATCH( OP_NOT_BOOL )
+		INTERP_DISPATCH( OP_NOT_F )
+		INTERP_DISPATCH( OP_NOT_V )
+		INTERP_DISPATCH( OP_NOT_S )
+		INTERP_DISPATCH( OP_NOT_ENT )
+		INTERP_DISPATCH( OP_NEG_F )
+		INTERP_DISPATCH( OP_NEG_V )
+		INTERP_DISPATCH( OP_INT_F )
+		INTERP_DISPATCH( OP_EQ_F )
+		INTERP_DISPATCH( OP_EQ_V )
+		INTERP_DISPATCH( OP_EQ_S )
+		INTERP_DISPATCH( OP_EQ_E )
+		INTERP_DISPATCH( OP_EQ_EO )
+		INTERP_DISPATCH( OP_EQ_OE )
+		INTERP_DISPATCH( OP_EQ_OO )
+		INTERP_DISPATCH( OP_NE_F )
+		INTERP_DISPATCH( OP_NE_V )
+		INTERP_DISPATCH( OP_NE_S )
+		INTERP_DISPATCH( OP_NE_E )
+		INTERP_DISPATCH( OP_NE_EO )
+		INTERP_DISPATCH( OP_NE_OE )
+		INTERP_DISPATCH( OP_NE_OO )
+		INTERP_DISPATCH( OP_UADD_F )
+		INTERP_DISPATCH( OP_UADD_V )
+		INTERP_DISPATCH( OP_USUB_F )
+		INTERP_DISPATCH( OP_USUB_V )
+		INTERP_DISPATCH( OP_UMUL_F )
+		INTERP_DISPATCH( OP_UMUL_V )
+		INTERP_DISPATCH( OP_UDIV_F )
+		INTERP_DISPATCH( OP_UDIV_V )
+		INTERP_DISPATCH( OP_UMOD_F )
+		INTERP_DISPATCH( OP_UOR_F )
+		INTERP_DISPATCH( OP_UAND_F )
+		INTERP_DISPATCH( OP_UINC_F )
+		INTERP_DISPATCH( OP_UINCP_F )
+		INTERP_DISPATCH( OP_UDEC_F )
+		INTERP_DISPATCH( OP_UDECP_F )
+		INTERP_DISPATCH( OP_COMP_F )
+		INTERP_DISPATCH( OP_STORE_F )
+		INTERP_DISPATCH( OP_STORE_ENT )
+		INTERP_DISPATCH( OP_STORE_BOOL )
+		INTERP_DISPATCH( OP_STORE_OBJENT )
+		INTERP_DISPATCH( OP_STORE_OBJ )
+		INTERP_DISPATCH( OP_STORE_ENTOBJ )
+		INTERP_DISPATCH( OP_STORE_S )
+		INTERP_DISPATCH( OP_STORE_V )
+		INTERP_DISPATCH( OP_STORE_FTOS )
+		INTERP_DISPATCH( OP_STORE_BTOS )
+		INTERP_DISPATCH( OP_STORE_VTOS )
+		INTERP_DISPATCH( OP_STORE_FTOBOOL )
+		INTERP_DISPATCH( OP_STORE_BOOLTOF )
+		INTERP_DISPATCH( OP_STOREP_F )
+		INTERP_DISPATCH( OP_STOREP_ENT )
+		INTERP_DISPATCH( OP_STOREP_FLD )
+		INTERP_DISPATCH( OP_STOREP_BOOL )
+		INTERP_DISPATCH( OP_STOREP_S )
+		INTERP_DISPATCH( OP_STOREP_V )
+		INTERP_DISPATCH( OP_STOREP_FTOS )
+		INTERP_DISPATCH( OP_STOREP_BTOS )
+		INTERP_DISPATCH( OP_STOREP_VTOS )
+		INTERP_DISPATCH( OP_STOREP_FTOBOOL )
+		INTERP_DISPATCH( OP_STOREP_BOOLTOF )
+		INTERP_DISPATCH( OP_STOREP_OBJ )
+		INTERP_DISPATCH( OP_STOREP_OBJENT )
+		INTERP_DISPATCH( OP_ADDRESS )
+		INTERP_DISPATCH( OP_INDIRECT_F )
+		INTERP_DISPATCH( OP_INDIRECT_ENT )
+		INTERP_DISPATCH( OP_INDIRECT_BOOL )
+		INTERP_DISPATCH( OP_INDIRECT_S )
+		INTERP_DISPATCH( OP_INDIRECT_V )
+		INTERP_DISPATCH( OP_INDIRECT_OBJ )
+		INTERP_DISPATCH( OP_PUSH_F )
+		INTERP_DISPATCH( OP_PUSH_FTOS )
+		INTERP_DISPATCH( OP_PUSH_BTOF )
+		INTERP_DISPATCH( OP_PUSH_FTOB )
+		INTERP_DISPATCH( OP_PUSH_VTOS )
+		INTERP_DISPATCH( OP_PUSH_BTOS )
+		INTERP_DISPATCH( OP_PUSH_ENT )
+		INTERP_DISPATCH( OP_PUSH_S )
+		INTERP_DISPATCH( OP_PUSH_V )
+		INTERP_DISPATCH( OP_PUSH_OBJ )
+		INTERP_DISPATCH( OP_PUSH_OBJENT )
+		INTERP_DISPATCH( OP_BREAK )
+		INTERP_DISPATCH( OP_CONTINUE )
+#undef INTERP_DISPATCH
+		dispatchTableInitialized = true;
+	}
 
-		if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
-			&& g_debugScript.GetBool( ) ) 
-		{
-			static int lastLineNumber = -1;
-			if (lastLineNumber != gameLocal.program.GetStatement(instructionPointer).linenumber) {
-				gameLocal.Printf("%s (%d)\n",
-					gameLocal.program.GetFilename(gameLocal.program.GetStatement(instructionPointer).file),
-					gameLocal.program.GetStatement(instructionPointer).linenumber
-				);
-				lastLineNumber = gameLocal.program.GetStatement(instructionPointer).linenumber;
+	INTERP_NEXT;
+#else
+	for( ;; ) {
+		INTERP_FETCH
+
+		switch( inst->op[ mode ] ) {
+#endif
+
+		INTERP_CASE( OP_SUPER_EVENTCALL )
+			// argument pushes and the event call
+			runaway -= inst->numStatements - 1;
+			for( i = inst->numStatements - 1; i > 0; i--, inst++ ) {
+				var_a = GetOperand( inst->a, inst->stackA );
+				switch( inst->op[ 1 ] ) {
+				case OP_PUSH_F :
+					Push( *var_a.intPtr );
+					break;
+				case OP_PUSH_V :
+					PushVector( *var_a.vectorPtr );
+					break;
+				case OP_PUSH_S :
+					PushString( var_a.stringPtr );
+					break;
+				default :
+					Push( *var_a.entityNumberPtr );
+					break;
+				}
+				instructionPointer++;
 			}
-		}
+			if ( inst->op[ 1 ] == OP_EVENTCALL ) {
+				CallEvent( ( const function_t * )inst->a, ( int )inst->b );
+			} else {
+				CallSysEvent( ( const function_t * )inst->a, ( int )inst->b );
+			}
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_SUPER_STORE_F )
+			// float arithmetic into a temporary and the store of it
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
+			switch( inst->op[ 1 ] ) {
+			case OP_ADD_F :
+				*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
+				break;
+			case OP_SUB_F :
+				*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
+				break;
+			default :
+				*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
+				break;
+			}
+			inst++;
+			var_b = GetOperand( inst->b, inst->stackB );
+			*var_b.floatPtr = *var_c.floatPtr;
+			instructionPointer++;
+			runaway--;
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_SUPER_STORE_V )
+			// vector arithmetic into a temporary and the store of it
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
+			switch( inst->op[ 1 ] ) {
+			case OP_ADD_V :
+				*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
+				break;
+			case OP_SUB_V :
+				*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
+				break;
+			case OP_MUL_FV :
+				*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
+				break;
+			default :
+				*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
+				break;
+			}
+			inst++;
+			var_b = GetOperand( inst->b, inst->stackB );
+			*var_b.vectorPtr = *var_c.vectorPtr;
+			instructionPointer++;
+			runaway--;
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_SUPER_MULADD_V )
+			// scaled vector into a temporary and the add of it
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
+			if ( inst->op[ 1 ] == OP_MUL_FV ) {
+				*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
+			} else {
+				*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
+			}
+			inst++;
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
+			*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
+			instructionPointer++;
+			runaway--;
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_SUPER_IFNOT )
+			// float comparison and the branch on its result
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
+			switch( inst->op[ 1 ] ) {
+			case OP_EQ_F :
+				*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+				break;
+			case OP_NE_F :
+				*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+				break;
+			case OP_LE :
+				*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+				break;
+			case OP_GE :
+				*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+				break;
+			case OP_LT :
+				*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+				break;
+			default :
+				*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+				break;
+			}
+			inst++;
+			instructionPointer++;
+			runaway--;
+			if ( *var_c.intPtr == 0 ) {
+				NextInstruction( instructionPointer + ( int )inst->b );
+			}
+			INTERP_NEXT;
 
-		switch( st->op ) {
-		case OP_RETURN:
-			LeaveFunction( st->a );
-			break;
+		INTERP_CASE( OP_RETURN )
+			LeaveFunction( gameLocal.program.GetStatement( instructionPointer ).a );
+			INTERP_NEXT;
 
-		case OP_THREAD:
-			newThread = new idThread( this, st->a->value.functionPtr, st->b->value.argSize );
+		INTERP_CASE( OP_THREAD )
+			newThread = new idThread( this, ( const function_t * )inst->a, ( int )inst->b );
 			newThread->Start();
 
 			// return the thread number to the script
 			gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
-			PopParms( st->b->value.argSize );
-			break;
+			PopParms( ( int )inst->b );
+			INTERP_NEXT;
 
-		case OP_OBJTHREAD:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_OBJTHREAD )
+			var_a = GetOperand( inst->a, inst->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
-				assert( st->c->value.argSize == func->parmTotal );
+				func = obj->GetTypeDef()->GetFunction( ( int )inst->b );
+				assert( ( int )inst->c == func->parmTotal );
 				newThread = new idThread( this, GetEntity( *var_a.entityNumberPtr ), func, func->parmTotal );
 				newThread->Start();
 
@@ -1049,142 +1369,142 @@ bool idInterpreter::Execute( void ) {
 				// return a null thread to the script
 				gameLocal.program.ReturnFloat( 0.0f );
 			}
-			PopParms( st->c->value.argSize );
-			break;
+			PopParms( ( int )inst->c );
+			INTERP_NEXT;
 
-		case OP_CALL:
-			EnterFunction( st->a->value.functionPtr, false );
-			break;
+		INTERP_CASE( OP_CALL )
+			EnterFunction( ( const function_t * )inst->a, false );
+			INTERP_NEXT;
 
-		case OP_EVENTCALL:
-			CallEvent( st->a->value.functionPtr, st->b->value.argSize );
-			break;
+		INTERP_CASE( OP_EVENTCALL )
+			CallEvent( ( const function_t * )inst->a, ( int )inst->b );
+			INTERP_NEXT;
 
-		case OP_OBJECTCALL:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_OBJECTCALL )
+			var_a = GetOperand( inst->a, inst->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
+				func = obj->GetTypeDef()->GetFunction( ( int )inst->b );
 				EnterFunction( func, false );
 			} else {
 				// return a 'safe' value
 				gameLocal.program.ReturnVector( vec3_zero );
 				gameLocal.program.ReturnString( "" );
-				PopParms( st->c->value.argSize );
+				PopParms( ( int )inst->c );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_SYSCALL:
-			CallSysEvent( st->a->value.functionPtr, st->b->value.argSize );
-			break;
+		INTERP_CASE( OP_SYSCALL )
+			CallSysEvent( ( const function_t * )inst->a, ( int )inst->b );
+			INTERP_NEXT;
 
-		case OP_IFNOT:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_IFNOT )
+			var_a = GetOperand( inst->a, inst->stackA );
 			if ( *var_a.intPtr == 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
+				NextInstruction( instructionPointer + ( int )inst->b );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_IF:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_IF )
+			var_a = GetOperand( inst->a, inst->stackA );
 			if ( *var_a.intPtr != 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
+				NextInstruction( instructionPointer + ( int )inst->b );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_GOTO:
-			NextInstruction( instructionPointer + st->a->value.jumpOffset );
-			break;
+		INTERP_CASE( OP_GOTO )
+			NextInstruction( instructionPointer + ( int )inst->a );
+			INTERP_NEXT;
 
-		case OP_ADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_ADD_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_ADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_ADD_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
-			break;
-
-		case OP_ADD_S:
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, GetString( st->b ) );
-			break;
-
-		case OP_ADD_FS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, FloatToString( *var_a.floatPtr ) );
-			AppendString( st->c, GetString( st->b ) );
-			break;
-
-		case OP_ADD_SF:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, FloatToString( *var_b.floatPtr ) );
-			break;
-
-		case OP_ADD_VS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, var_a.vectorPtr->ToString() );
-			AppendString( st->c, GetString( st->b ) );
-			break;
-
-		case OP_ADD_SV:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, var_b.vectorPtr->ToString() );
-			break;
-
-		case OP_SUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_ADD_S )
+			idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, GetOperand( inst->a, inst->stackA ).stringPtr, MAX_STRING_LEN );
+			idStr::Append( GetOperand( inst->c, inst->stackC ).stringPtr, MAX_STRING_LEN, GetOperand( inst->b, inst->stackB ).stringPtr );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_ADD_FS )
+			var_a = GetOperand( inst->a, inst->stackA );
+			idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
+			idStr::Append( GetOperand( inst->c, inst->stackC ).stringPtr, MAX_STRING_LEN, GetOperand( inst->b, inst->stackB ).stringPtr );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_ADD_SF )
+			var_b = GetOperand( inst->b, inst->stackB );
+			idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, GetOperand( inst->a, inst->stackA ).stringPtr, MAX_STRING_LEN );
+			idStr::Append( GetOperand( inst->c, inst->stackC ).stringPtr, MAX_STRING_LEN, FloatToString( *var_b.floatPtr ) );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_ADD_VS )
+			var_a = GetOperand( inst->a, inst->stackA );
+			idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
+			idStr::Append( GetOperand( inst->c, inst->stackC ).stringPtr, MAX_STRING_LEN, GetOperand( inst->b, inst->stackB ).stringPtr );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_ADD_SV )
+			var_b = GetOperand( inst->b, inst->stackB );
+			idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, GetOperand( inst->a, inst->stackA ).stringPtr, MAX_STRING_LEN );
+			idStr::Append( GetOperand( inst->c, inst->stackC ).stringPtr, MAX_STRING_LEN, var_b.vectorPtr->ToString() );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_SUB_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_SUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_SUB_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_MUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_MUL_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_MUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_MUL_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_MUL_FV:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_MUL_FV )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_MUL_VF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_MUL_VF )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_DIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_DIV_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 
 			if ( *var_b.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1192,12 +1512,12 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_c.floatPtr = *var_a.floatPtr / *var_b.floatPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_MOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable ( st->c );
+		INTERP_CASE( OP_MOD_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 
 			if ( *var_b.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1205,252 +1525,252 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) % static_cast<int>( *var_b.floatPtr );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_BITAND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_BITAND )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_BITOR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_BITOR )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_GE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_GE )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_LE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_LE )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_GT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_GT )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_LT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_LT )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_AND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_AND )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
-			break;
+			INTERP_NEXT;
 
-		case OP_AND_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_AND_BOOLF )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
-			break;
+			INTERP_NEXT;
 
-		case OP_AND_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_AND_FBOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
-			break;
+			INTERP_NEXT;
 
-		case OP_AND_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_AND_BOOLBOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
-			break;
+			INTERP_NEXT;
 
-		case OP_OR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_OR )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
-			break;
+			INTERP_NEXT;
 
-		case OP_OR_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_OR_BOOLF )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
-			break;
+			INTERP_NEXT;
 
-		case OP_OR_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_OR_FBOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
-			break;
+			INTERP_NEXT;
 
-		case OP_OR_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_OR_BOOLBOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
-			break;
+			INTERP_NEXT;
 
-		case OP_NOT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NOT_BOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr == 0 );
-			break;
+			INTERP_NEXT;
 
-		case OP_NOT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NOT_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
-			break;
+			INTERP_NEXT;
 
-		case OP_NOT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NOT_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
-			break;
+			INTERP_NEXT;
 
-		case OP_NOT_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( strlen( GetString( st->a ) ) == 0 );
-			break;
+		INTERP_CASE( OP_NOT_S )
+			var_c = GetOperand( inst->c, inst->stackC );
+			*var_c.floatPtr = ( strlen( GetOperand( inst->a, inst->stackA ).stringPtr ) == 0 );
+			INTERP_NEXT;
 
-		case OP_NOT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NOT_ENT )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
-			break;
+			INTERP_NEXT;
 
-		case OP_NEG_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NEG_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = -*var_a.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_NEG_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NEG_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.vectorPtr = -*var_a.vectorPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_INT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_INT_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_EQ_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_EQ_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_EQ_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_EQ_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
-			break;
-
-		case OP_EQ_S:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) == 0 );
-			break;
-
-		case OP_EQ_E:
-		case OP_EQ_EO:
-		case OP_EQ_OE:
-		case OP_EQ_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_EQ_S )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
+			*var_c.floatPtr = ( idStr::Cmp( GetOperand( inst->a, inst->stackA ).stringPtr, GetOperand( inst->b, inst->stackB ).stringPtr ) == 0 );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_EQ_E )
+		INTERP_CASE( OP_EQ_EO )
+		INTERP_CASE( OP_EQ_OE )
+		INTERP_CASE( OP_EQ_OO )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_NE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NE_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_NE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_NE_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
-			break;
-
-		case OP_NE_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) != 0 );
-			break;
-
-		case OP_NE_E:
-		case OP_NE_EO:
-		case OP_NE_OE:
-		case OP_NE_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_NE_S )
+			var_c = GetOperand( inst->c, inst->stackC );
+			*var_c.floatPtr = ( idStr::Cmp( GetOperand( inst->a, inst->stackA ).stringPtr, GetOperand( inst->b, inst->stackB ).stringPtr ) != 0 );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_NE_E )
+		INTERP_CASE( OP_NE_EO )
+		INTERP_CASE( OP_NE_OE )
+		INTERP_CASE( OP_NE_OO )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_UADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UADD_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr += *var_a.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_UADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UADD_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.vectorPtr += *var_a.vectorPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_USUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_USUB_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr -= *var_a.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_USUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_USUB_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.vectorPtr -= *var_a.vectorPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_UMUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UMUL_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr *= *var_a.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_UMUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UMUL_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.vectorPtr *= *var_a.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_UDIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UDIV_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1458,11 +1778,11 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_b.floatPtr = *var_b.floatPtr / *var_a.floatPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_UDIV_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UDIV_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1470,11 +1790,11 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_b.vectorPtr = *var_b.vectorPtr / *var_a.floatPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_UMOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UMOD_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1482,241 +1802,241 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) % static_cast<int>( *var_a.floatPtr );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_UOR_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UOR_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_UAND_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_UAND_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_UINC_F:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_UINC_F )
+			var_a = GetOperand( inst->a, inst->stackA );
 			( *var_a.floatPtr )++;
-			break;
+			INTERP_NEXT;
 
-		case OP_UINCP_F:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_UINCP_F )
+			var_a = GetOperand( inst->a, inst->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				( *var.floatPtr )++;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_UDEC_F:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_UDEC_F )
+			var_a = GetOperand( inst->a, inst->stackA );
 			( *var_a.floatPtr )--;
-			break;
+			INTERP_NEXT;
 
-		case OP_UDECP_F:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_UDECP_F )
+			var_a = GetOperand( inst->a, inst->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				( *var.floatPtr )--;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_COMP_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_COMP_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr = *var_a.floatPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_ENT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_ENT )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_BOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_BOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.intPtr = *var_a.intPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_OBJENT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_OBJENT )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
 				*var_b.entityNumberPtr = 0;
-			} else if ( !obj->GetTypeDef()->Inherits( st->b->TypeDef() ) ) {
-				//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->b->TypeDef()->Name() );
+			} else if ( !obj->GetTypeDef()->Inherits( gameLocal.program.GetStatement( instructionPointer ).b->TypeDef() ) ) {
+				//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), gameLocal.program.GetStatement( instructionPointer ).b->TypeDef()->Name() );
 				*var_b.entityNumberPtr = 0;
 			} else {
 				*var_b.entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_OBJ:
-		case OP_STORE_ENTOBJ:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_OBJ )
+		INTERP_CASE( OP_STORE_ENTOBJ )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_S:
-			SetString( st->b, GetString( st->a ) );
-			break;
+		INTERP_CASE( OP_STORE_S )
+			idStr::Copynz( GetOperand( inst->b, inst->stackB ).stringPtr, GetOperand( inst->a, inst->stackA ).stringPtr, MAX_STRING_LEN );
+			INTERP_NEXT;
 
-		case OP_STORE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.vectorPtr = *var_a.vectorPtr;
-			break;
-
-		case OP_STORE_FTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, FloatToString( *var_a.floatPtr ) );
-			break;
-
-		case OP_STORE_BTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, *var_a.intPtr ? "true" : "false" );
-			break;
-
-		case OP_STORE_VTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, var_a.vectorPtr->ToString() );
-			break;
-
-		case OP_STORE_FTOBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_STORE_FTOS )
+			var_a = GetOperand( inst->a, inst->stackA );
+			idStr::Copynz( GetOperand( inst->b, inst->stackB ).stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_STORE_BTOS )
+			var_a = GetOperand( inst->a, inst->stackA );
+			idStr::Copynz( GetOperand( inst->b, inst->stackB ).stringPtr, *var_a.intPtr ? "true" : "false", MAX_STRING_LEN );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_STORE_VTOS )
+			var_a = GetOperand( inst->a, inst->stackA );
+			idStr::Copynz( GetOperand( inst->b, inst->stackB ).stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_STORE_FTOBOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( *var_a.floatPtr != 0.0f ) {
 				*var_b.intPtr = 1;
 			} else {
 				*var_b.intPtr = 0;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STORE_BOOLTOF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STORE_BOOLTOF )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_b = GetOperand( inst->b, inst->stackB );
 			*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_F:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_F )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->floatPtr = *var_a.floatPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_ENT:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_ENT )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_FLD:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_FLD )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->intPtr = *var_a.intPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_BOOL:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_BOOL )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->intPtr = *var_a.intPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_S:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_S )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a ), MAX_STRING_LEN );
+				idStr::Copynz( var_b.evalPtr->stringPtr, GetOperand( inst->a, inst->stackA ).stringPtr, MAX_STRING_LEN );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_V:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_V )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_FTOS:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_FTOS )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_BTOS:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_BTOS )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				if ( *var_a.floatPtr != 0.0f ) {
 					idStr::Copynz( var_b.evalPtr->stringPtr, "true", MAX_STRING_LEN );
 				} else {
 					idStr::Copynz( var_b.evalPtr->stringPtr, "false", MAX_STRING_LEN );
 				}
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_VTOS:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_VTOS )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_FTOBOOL:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_FTOBOOL )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				if ( *var_a.floatPtr != 0.0f ) {
 					*var_b.evalPtr->intPtr = 1;
 				} else {
 					*var_b.evalPtr->intPtr = 0;
 				}
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_BOOLTOF:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_BOOLTOF )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_OBJ:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_OBJ )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_STOREP_OBJENT:
-			var_b = GetVariable( st->b );
+		INTERP_CASE( OP_STOREP_OBJENT )
+			var_b = GetOperand( inst->b, inst->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetOperand( inst->a, inst->stackA );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if ( !obj ) {
 					*var_b.evalPtr->entityNumberPtr = 0;
@@ -1724,167 +2044,176 @@ bool idInterpreter::Execute( void ) {
 				// st->b points to type_pointer, which is just a temporary that gets its type reassigned, so we store the real type in st->c
 				// so that we can do a type check during run time since we don't know what type the script object is at compile time because it
 				// comes from an entity
-				} else if ( !obj->GetTypeDef()->Inherits( st->c->TypeDef() ) ) {
-					//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->c->TypeDef()->Name() );
+				} else if ( !obj->GetTypeDef()->Inherits( gameLocal.program.GetStatement( instructionPointer ).c->TypeDef() ) ) {
+					//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), gameLocal.program.GetStatement( instructionPointer ).c->TypeDef()->Name() );
 					*var_b.evalPtr->entityNumberPtr = 0;
 				} else {
 					*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 				}
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_ADDRESS:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_ADDRESS )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var_c.evalPtr->bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var_c.evalPtr->bytePtr = &obj->data[ ( int )inst->b ];
 			} else {
 				var_c.evalPtr->bytePtr = NULL;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_INDIRECT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_INDIRECT_F )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				*var_c.floatPtr = *var.floatPtr;
 			} else {
 				*var_c.floatPtr = 0.0f;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_INDIRECT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_INDIRECT_ENT )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				*var_c.entityNumberPtr = *var.entityNumberPtr;
 			} else {
 				*var_c.entityNumberPtr = 0;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_INDIRECT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_INDIRECT_BOOL )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				*var_c.intPtr = *var.intPtr;
 			} else {
 				*var_c.intPtr = 0;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_INDIRECT_S:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_INDIRECT_S )
+			var_a = GetOperand( inst->a, inst->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				SetString( st->c, var.stringPtr );
+				var.bytePtr = &obj->data[ ( int )inst->b ];
+				idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, var.stringPtr, MAX_STRING_LEN );
 			} else {
-				SetString( st->c, "" );
+				idStr::Copynz( GetOperand( inst->c, inst->stackC ).stringPtr, "", MAX_STRING_LEN );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_INDIRECT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_INDIRECT_V )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				*var_c.vectorPtr = *var.vectorPtr;
 			} else {
 				var_c.vectorPtr->Zero();
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_INDIRECT_OBJ:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		INTERP_CASE( OP_INDIRECT_OBJ )
+			var_a = GetOperand( inst->a, inst->stackA );
+			var_c = GetOperand( inst->c, inst->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
 				*var_c.entityNumberPtr = 0;
 			} else {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ ( int )inst->b ];
 				*var_c.entityNumberPtr = *var.entityNumberPtr;
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_F:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_F )
+			var_a = GetOperand( inst->a, inst->stackA );
 			Push( *var_a.intPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_FTOS:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_FTOS )
+			var_a = GetOperand( inst->a, inst->stackA );
 			PushString( FloatToString( *var_a.floatPtr ) );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_BTOF:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_BTOF )
+			var_a = GetOperand( inst->a, inst->stackA );
 			floatVal = *var_a.intPtr;
 			Push( *reinterpret_cast<int *>( &floatVal ) );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_FTOB:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_FTOB )
+			var_a = GetOperand( inst->a, inst->stackA );
 			if ( *var_a.floatPtr != 0.0f ) {
 				Push( 1 );
 			} else {
 				Push( 0 );
 			}
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_VTOS:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_VTOS )
+			var_a = GetOperand( inst->a, inst->stackA );
 			PushString( var_a.vectorPtr->ToString() );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_BTOS:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_BTOS )
+			var_a = GetOperand( inst->a, inst->stackA );
 			PushString( *var_a.intPtr ? "true" : "false" );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_ENT:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_ENT )
+			var_a = GetOperand( inst->a, inst->stackA );
 			Push( *var_a.entityNumberPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_S:
-			PushString( GetString( st->a ) );
-			break;
+		INTERP_CASE( OP_PUSH_S )
+			PushString( GetOperand( inst->a, inst->stackA ).stringPtr );
+			INTERP_NEXT;
 
-		case OP_PUSH_V:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_V )
+			var_a = GetOperand( inst->a, inst->stackA );
 			PushVector(*var_a.vectorPtr);
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_OBJ:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_OBJ )
+			var_a = GetOperand( inst->a, inst->stackA );
 			Push( *var_a.entityNumberPtr );
-			break;
+			INTERP_NEXT;
 
-		case OP_PUSH_OBJENT:
-			var_a = GetVariable( st->a );
+		INTERP_CASE( OP_PUSH_OBJENT )
+			var_a = GetOperand( inst->a, inst->stackA );
 			Push( *var_a.entityNumberPtr );
-			break;
-
-		case OP_BREAK:
-		case OP_CONTINUE:
-		default:
-			Error( "Bad opcode %i", st->op );
-			break;
+			INTERP_NEXT;
+
+		INTERP_CASE( OP_BREAK )
+		INTERP_CASE( OP_CONTINUE )
+		INTERP_DEFAULT
+			Error( "Bad opcode %i", inst->op[ mode ] );
+			INTERP_NEXT;
+#ifndef INTERP_COMPUTED_GOTO
 		}
 	}
+#endif
+
+finished:
+	executedStatements += 5000000 - runaway;
 
 	return threadDying;
 }
 
+#undef INTERP_FETCH
+#undef INTERP_CASE
+#undef INTERP_DEFAULT
+#undef INTERP_NEXT
 
 bool idGameEditExt::CheckForBreakPointHit(const idInterpreter* interpreter, const function_t* function1, const function_t* function2, int depth) const
 {
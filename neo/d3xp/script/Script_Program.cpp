@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/hashing/MD4.h"
+#include "idlib/Timer.h"
 #include "framework/FileSystem.h"
 
 #include "gamesys/Event.h"
@@ -1639,6 +1640,190 @@ statement_t *idProgram::AllocStatement( void ) {
 	return ret;
 }
 
+/*
+================
+Program_DecodeOperand
+
+Returns the address of the variable, the offset in the function's locals
+for stack variables, or the value for the operands that only hold a number
+================
+*/
+static intptr_t Program_DecodeOperand( const idVarDef *def, byte &stack ) {
+	stack = 0;
+	if ( !def ) {
+		return 0;
+	}
+
+	if ( def->initialized == idVarDef::stackVariable ) {
+		stack = 1;
+		return def->value.stackOffset;
+	}
+
+	switch( def->Type() ) {
+	case ev_jumpoffset :
+		return def->value.jumpOffset;
+
+	case ev_argsize :
+		return def->value.argSize;
+
+	case ev_virtualfunction :
+		return def->value.virtualFunction;
+
+	case ev_function :
+		return ( intptr_t )def->value.functionPtr;
+
+	default :
+		break;
+	}
+
+	if ( def->scope->TypeDef()->Inherits( &type_object ) ) {
+		// object field
+		return def->value.ptrOffset;
+	}
+
+	return ( intptr_t )def->value.bytePtr;
+}
+
+/*
+================
+Program_SameOperand
+================
+*/
+static ID_INLINE bool Program_SameOperand( intptr_t a, byte stackA, intptr_t b, byte stackB ) {
+	return ( a == b && stackA == stackB );
+}
+
+/*
+================
+idProgram::DecodeStatements
+
+Rebuilds the instructions the interpreter runs from the statements. Every
+statement has an instruction at the same index, with the operands resolved
+so the interpreter doesn't have to look at the defs. Where a few statements
+always run in a row, the first instruction also gets a superinstruction
+that runs all of them at once, the interpreter falls back to the plain
+instructions when it is debugging.
+
+A jump can't land inside a superinstruction, and it ends on a plain
+statement at the index of the last statement it covers, so the instruction
+pointer stays a statement index for savegames and the debugger.
+================
+*/
+void idProgram::DecodeStatements( void ) {
+	idList<bool>	jumpTarget;
+	int				i, j, target;
+
+	instructions.SetGranularity( 1024 );
+	instructions.SetNum( statements.Num(), false );
+	jumpTarget.SetNum( statements.Num() );
+
+	for( i = 0; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[ i ];
+		scriptInstruction_t &inst = instructions[ i ];
+
+		inst.op[ 0 ]		= st.op;
+		inst.op[ 1 ]		= st.op;
+		inst.numStatements	= 1;
+		inst.a				= Program_DecodeOperand( st.a, inst.stackA );
+		inst.b				= Program_DecodeOperand( st.b, inst.stackB );
+		inst.c				= Program_DecodeOperand( st.c, inst.stackC );
+		jumpTarget[ i ]		= false;
+	}
+
+	for( i = 0; i < statements.Num(); i++ ) {
+		const scriptInstruction_t &inst = instructions[ i ];
+
+		switch( inst.op[ 1 ] ) {
+		case OP_IF :
+		case OP_IFNOT :
+			target = i + ( int )inst.b;
+			break;
+		case OP_GOTO :
+			target = i + ( int )inst.a;
+			break;
+		default :
+			target = -1;
+			break;
+		}
+		if ( target >= 0 && target < statements.Num() ) {
+			jumpTarget[ target ] = true;
+		}
+	}
+
+	for( i = 0; i < statements.Num() - 1; i++ ) {
+		scriptInstruction_t &inst = instructions[ i ];
+		const scriptInstruction_t &next = instructions[ i + 1 ];
+
+		if ( jumpTarget[ i + 1 ] ) {
+			continue;
+		}
+
+		switch( inst.op[ 1 ] ) {
+		case OP_PUSH_F :
+		case OP_PUSH_V :
+		case OP_PUSH_S :
+		case OP_PUSH_ENT :
+		case OP_PUSH_OBJ :
+		case OP_PUSH_OBJENT :
+			// the arguments of an event call
+			for( j = i + 1; j < statements.Num() && j - i < 255 && !jumpTarget[ j ]; j++ ) {
+				const unsigned short op = instructions[ j ].op[ 1 ];
+				if ( op != OP_PUSH_F && op != OP_PUSH_V && op != OP_PUSH_S && op != OP_PUSH_ENT && op != OP_PUSH_OBJ && op != OP_PUSH_OBJENT ) {
+					break;
+				}
+			}
+			if ( j < statements.Num() && j - i < 255 && !jumpTarget[ j ] && ( instructions[ j ].op[ 1 ] == OP_EVENTCALL || instructions[ j ].op[ 1 ] == OP_SYSCALL ) ) {
+				inst.op[ 0 ] = OP_SUPER_EVENTCALL;
+				inst.numStatements = j - i + 1;
+			}
+			break;
+
+		case OP_ADD_F :
+		case OP_SUB_F :
+		case OP_MUL_F :
+			if ( next.op[ 1 ] == OP_STORE_F && Program_SameOperand( inst.c, inst.stackC, next.a, next.stackA ) ) {
+				inst.op[ 0 ] = OP_SUPER_STORE_F;
+				inst.numStatements = 2;
+			}
+			break;
+
+		case OP_ADD_V :
+		case OP_SUB_V :
+			if ( next.op[ 1 ] == OP_STORE_V && Program_SameOperand( inst.c, inst.stackC, next.a, next.stackA ) ) {
+				inst.op[ 0 ] = OP_SUPER_STORE_V;
+				inst.numStatements = 2;
+			}
+			break;
+
+		case OP_MUL_FV :
+		case OP_MUL_VF :
+			if ( next.op[ 1 ] == OP_STORE_V && Program_SameOperand( inst.c, inst.stackC, next.a, next.stackA ) ) {
+				inst.op[ 0 ] = OP_SUPER_STORE_V;
+				inst.numStatements = 2;
+			} else if ( next.op[ 1 ] == OP_ADD_V && ( Program_SameOperand( inst.c, inst.stackC, next.a, next.stackA ) || Program_SameOperand( inst.c, inst.stackC, next.b, next.stackB ) ) ) {
+				inst.op[ 0 ] = OP_SUPER_MULADD_V;
+				inst.numStatements = 2;
+			}
+			break;
+
+		case OP_EQ_F :
+		case OP_NE_F :
+		case OP_LE :
+		case OP_GE :
+		case OP_LT :
+		case OP_GT :
+			if ( next.op[ 1 ] == OP_IFNOT && Program_SameOperand( inst.c, inst.stackC, next.a, next.stackA ) ) {
+				inst.op[ 0 ] = OP_SUPER_IFNOT;
+				inst.numStatements = 2;
+			}
+			break;
+
+		default :
+			break;
+		}
+	}
+}
+
 /*
 ==============
 idProgram::BeginCompilation
@@ -1850,6 +2035,7 @@ bool idProgram::CompileText( const char *source, const char *text, bool console
 	}
 
 	catch( idCompileError &err ) {
+		DecodeStatements();
 		if ( console ) {
 			gameLocal.Printf( "%s\n", err.error );
 			return false;
@@ -1858,6 +2044,8 @@ bool idProgram::CompileText( const char *source, const char *text, bool console
 		}
 	};
 
+	DecodeStatements();
+
 	if ( !console ) {
 		CompileStats();
 	}
@@ -1945,6 +2133,7 @@ void idProgram::FreeData( void ) {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	instructions.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -1956,6 +2145,707 @@ void idProgram::FreeData( void ) {
 	filename = "";
 }
 
+/*
+===============================================================================
+
+Binary program file
+
+With g_binaryScripts the compiled program is also kept in a .bcs file under
+fs_savepath, named after the default script. It holds the types, defs,
+functions, statements and global variables exactly as the compiler left
+them, with every pointer replaced by an index. The file lists the MD4
+checksum of every script it was compiled from and the program checksum used
+by the savegames, so it is only used if none of the scripts changed and it
+reads back into the same program a compile would have made.
+
+The built-in types and defs aren't in the program's lists, they are numbered
+before the allocated ones.
+
+The file is written in native byte order for the machine that built it.
+
+===============================================================================
+*/
+
+#define PROGRAM_BINARY_FILE_EXT		"bcs"
+#define PROGRAM_BINARY_FILEID		( ( '1' << 24 ) + ( 'S' << 16 ) + ( 'C' << 8 ) + 'B' )
+#define PROGRAM_BINARY_FILEVERSION	1
+#define PROGRAM_BINARY_BADREF		-2
+
+static idTypeDef * const binaryTypes[] = {
+	&type_void, &type_scriptevent, &type_namespace, &type_string, &type_float, &type_vector, &type_entity, &type_field,
+	&type_function, &type_virtualfunction, &type_pointer, &type_object, &type_jumpoffset, &type_argsize, &type_boolean
+};
+
+static idVarDef * const binaryDefs[] = {
+	&def_void, &def_scriptevent, &def_namespace, &def_string, &def_float, &def_vector, &def_entity, &def_field,
+	&def_function, &def_virtualfunction, &def_pointer, &def_object, &def_jumpoffset, &def_argsize, &def_boolean
+};
+
+static const int NUM_BINARY_BUILTINS = sizeof( binaryTypes ) / sizeof( binaryTypes[ 0 ] );
+
+typedef enum {
+	BINARY_VALUE_INT,				// stack and object offsets, jump offsets, argument sizes and virtual function numbers
+	BINARY_VALUE_VARIABLE,			// offset in the global variables
+	BINARY_VALUE_FUNCTION			// function number
+} binaryValue_t;
+
+typedef struct {
+	unsigned short	op;
+	unsigned short	flags;
+	unsigned short	linenumber;
+	unsigned short	file;
+	int				a;
+	int				b;
+	int				c;
+} binaryStatement_t;
+
+/*
+================
+Program_BinaryFits
+
+Returns true if count elements can still be read from the file
+================
+*/
+static bool Program_BinaryFits( idFile *fp, int count, int elementSize ) {
+	return ( count >= 0 && count <= ( fp->Length() - fp->Tell() ) / elementSize );
+}
+
+/*
+================
+Program_BinaryReadString
+================
+*/
+static bool Program_BinaryReadString( idFile *fp, idStr &string ) {
+	int length;
+
+	if ( !Program_BinaryFits( fp, 1, sizeof( int ) ) ) {
+		return false;
+	}
+	fp->ReadInt( length );
+	if ( !Program_BinaryFits( fp, length, 1 ) ) {
+		return false;
+	}
+	string.Fill( ' ', length );
+	fp->Read( &string[ 0 ], length );
+	return true;
+}
+
+/*
+================
+Program_BinaryTypeNum
+================
+*/
+static int Program_BinaryTypeNum( const idTypeDef *type, const idList<idTypeDef *> &types, const idHashIndex &typeHash ) {
+	int i;
+
+	if ( !type ) {
+		return -1;
+	}
+	for ( i = 0; i < NUM_BINARY_BUILTINS; i++ ) {
+		if ( binaryTypes[ i ] == type ) {
+			return i;
+		}
+	}
+	for ( i = typeHash.First( (int)( (intptr_t)type >> 4 ) ); i != -1; i = typeHash.Next( i ) ) {
+		if ( types[ i ] == type ) {
+			return NUM_BINARY_BUILTINS + i;
+		}
+	}
+	return PROGRAM_BINARY_BADREF;
+}
+
+/*
+================
+Program_BinaryDefNum
+================
+*/
+static int Program_BinaryDefNum( const idVarDef *def, const idList<idVarDef *> &varDefs ) {
+	int i;
+
+	if ( !def ) {
+		return -1;
+	}
+	for ( i = 0; i < NUM_BINARY_BUILTINS; i++ ) {
+		if ( binaryDefs[ i ] == def ) {
+			return i;
+		}
+	}
+	if ( def->num >= 0 && def->num < varDefs.Num() && varDefs[ def->num ] == def ) {
+		return NUM_BINARY_BUILTINS + def->num;
+	}
+	return PROGRAM_BINARY_BADREF;
+}
+
+/*
+================
+Program_BinaryType
+
+Returns false if num isn't a type in the file
+================
+*/
+static bool Program_BinaryType( int num, const idList<idTypeDef *> &types, idTypeDef *&type ) {
+	if ( num < -1 || num >= NUM_BINARY_BUILTINS + types.Num() ) {
+		return false;
+	}
+	if ( num == -1 ) {
+		type = NULL;
+	} else if ( num < NUM_BINARY_BUILTINS ) {
+		type = binaryTypes[ num ];
+	} else {
+		type = types[ num - NUM_BINARY_BUILTINS ];
+	}
+	return true;
+}
+
+/*
+================
+Program_BinaryDef
+
+Returns false if num isn't a def in the file
+================
+*/
+static bool Program_BinaryDef( int num, const idList<idVarDef *> &varDefs, idVarDef *&def ) {
+	if ( num < -1 || num >= NUM_BINARY_BUILTINS + varDefs.Num() ) {
+		return false;
+	}
+	if ( num == -1 ) {
+		def = NULL;
+	} else if ( num < NUM_BINARY_BUILTINS ) {
+		def = binaryDefs[ num ];
+	} else {
+		def = varDefs[ num - NUM_BINARY_BUILTINS ];
+	}
+	return true;
+}
+
+/*
+================
+idProgram::WriteBinaryProgram
+
+Doesn't write anything if some part of the program can't be stored as an index
+================
+*/
+void idProgram::WriteBinaryProgram( const char *defaultScript ) const {
+	idFile_Memory		fp;
+	idStrList			sourceFiles;
+	idFileList			*files;
+	idHashIndex			typeHash( 1024, types.Num() );
+	idStr				name;
+	binaryStatement_t	bst;
+	void				*buffer;
+	intptr_t			offset;
+	int					i, j, num, length, kind, value;
+	bool				valid;
+
+	// every script the program was compiled from and the ones it could include
+	sourceFiles = fileList;
+	files = fileSystem->ListFilesTree( "script", ".script", true );
+	for ( i = 0; i < files->GetNumFiles(); i++ ) {
+		sourceFiles.AddUnique( files->GetFile( i ) );
+	}
+	fileSystem->FreeFileList( files );
+
+	fp.WriteInt( PROGRAM_BINARY_FILEID );
+	fp.WriteInt( PROGRAM_BINARY_FILEVERSION );
+	fp.WriteInt( CalculateChecksum( false ) );
+	// the program is only valid for builds with the same opcodes and memory layout
+	fp.WriteInt( NUM_OPCODES );
+	fp.WriteInt( sizeof( intptr_t ) );
+	fp.WriteInt( MAX_STRING_LEN );
+	fp.WriteInt( NUM_BINARY_BUILTINS );
+
+	fp.WriteInt( sourceFiles.Num() );
+	for ( i = 0; i < sourceFiles.Num(); i++ ) {
+		length = fileSystem->ReadFile( sourceFiles[ i ], &buffer );
+		if ( length < 0 ) {
+			return;
+		}
+		fp.WriteString( sourceFiles[ i ] );
+		fp.WriteUnsignedInt( MD4_BlockChecksum( buffer, length ) );
+		fileSystem->FreeFile( buffer );
+	}
+
+	fp.WriteInt( fileList.Num() );
+	fp.WriteInt( numVariables );
+	fp.WriteInt( types.Num() );
+	fp.WriteInt( varDefs.Num() );
+	fp.WriteInt( functions.Num() );
+	fp.WriteInt( statements.Num() );
+
+	for ( i = 0; i < fileList.Num(); i++ ) {
+		fp.WriteString( fileList[ i ] );
+	}
+	fp.Write( variables, numVariables );
+
+	for ( i = 0; i < types.Num(); i++ ) {
+		typeHash.Add( (int)( (intptr_t)types[ i ] >> 4 ), i );
+	}
+
+	valid = true;
+
+	// the compiler changes the return and pointer types of the built-in types
+	for ( i = 0; i < NUM_BINARY_BUILTINS; i++ ) {
+		num = Program_BinaryTypeNum( binaryTypes[ i ]->auxType, types, typeHash );
+		valid &= ( num != PROGRAM_BINARY_BADREF );
+		fp.WriteInt( num );
+	}
+
+	for ( i = 0; i < types.Num(); i++ ) {
+		const idTypeDef *type = types[ i ];
+
+		fp.WriteInt( type->type );
+		fp.WriteString( type->name );
+		fp.WriteInt( type->size );
+		num = Program_BinaryDefNum( type->def, varDefs );
+		valid &= ( num != PROGRAM_BINARY_BADREF );
+		fp.WriteInt( num );
+		num = Program_BinaryTypeNum( type->auxType, types, typeHash );
+		valid &= ( num != PROGRAM_BINARY_BADREF );
+		fp.WriteInt( num );
+
+		fp.WriteInt( type->parmTypes.Num() );
+		for ( j = 0; j < type->parmTypes.Num(); j++ ) {
+			num = Program_BinaryTypeNum( type->parmTypes[ j ], types, typeHash );
+			valid &= ( num != PROGRAM_BINARY_BADREF );
+			fp.WriteInt( num );
+			fp.WriteString( type->parmNames[ j ] );
+		}
+
+		fp.WriteInt( type->functions.Num() );
+		for ( j = 0; j < type->functions.Num(); j++ ) {
+			offset = type->functions[ j ] - functions.Ptr();
+			valid &= ( offset >= 0 && offset < functions.Num() );
+			fp.WriteInt( (int)offset );
+		}
+	}
+
+	for ( i = 0; i < varDefs.Num(); i++ ) {
+		const idVarDef *def = varDefs[ i ];
+		etype_t etype = def->Type();
+
+		fp.WriteString( def->Name() );
+		num = Program_BinaryTypeNum( def->TypeDef(), types, typeHash );
+		valid &= ( num != PROGRAM_BINARY_BADREF );
+		fp.WriteInt( num );
+		num = Program_BinaryDefNum( def->scope, varDefs );
+		valid &= ( num != PROGRAM_BINARY_BADREF && def->scope != NULL );
+		fp.WriteInt( num );
+		fp.WriteInt( def->numUsers );
+		fp.WriteInt( def->initialized );
+
+		// same cases as in AllocDef
+		if ( etype == ev_function ) {
+			kind = BINARY_VALUE_FUNCTION;
+			offset = def->value.functionPtr ? def->value.functionPtr - functions.Ptr() : -1;
+			valid &= ( offset >= -1 && offset < functions.Num() );
+			value = (int)offset;
+		} else if ( etype == ev_jumpoffset || etype == ev_argsize || etype == ev_virtualfunction
+				|| def->initialized == idVarDef::stackVariable || ( def->scope && def->scope->TypeDef()->Inherits( &type_object ) ) ) {
+			kind = BINARY_VALUE_INT;
+			value = def->value.ptrOffset;
+		} else {
+			kind = BINARY_VALUE_VARIABLE;
+			offset = def->value.bytePtr - variables;
+			valid &= ( offset >= 0 && offset <= numVariables );
+			value = (int)offset;
+		}
+		fp.WriteInt( kind );
+		fp.WriteInt( value );
+	}
+
+	for ( i = 0; i < functions.Num(); i++ ) {
+		const function_t &func = functions[ i ];
+
+		fp.WriteString( func.Name() );
+		fp.WriteString( func.eventdef ? func.eventdef->GetName() : "" );
+		num = Program_BinaryDefNum( func.def, varDefs );
+		valid &= ( num != PROGRAM_BINARY_BADREF );
+		fp.WriteInt( num );
+		num = Program_BinaryTypeNum( func.type, types, typeHash );
+		valid &= ( num != PROGRAM_BINARY_BADREF );
+		fp.WriteInt( num );
+		fp.WriteInt( func.firstStatement );
+		fp.WriteInt( func.numStatements );
+		fp.WriteInt( func.parmTotal );
+		fp.WriteInt( func.locals );
+		fp.WriteInt( func.filenum );
+		fp.WriteInt( func.parmSize.Num() );
+		for ( j = 0; j < func.parmSize.Num(); j++ ) {
+			fp.WriteInt( func.parmSize[ j ] );
+		}
+	}
+
+	for ( i = 0; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[ i ];
+
+		bst.op = st.op;
+		bst.flags = st.flags;
+		bst.linenumber = st.linenumber;
+		bst.file = st.file;
+		bst.a = Program_BinaryDefNum( st.a, varDefs );
+		bst.b = Program_BinaryDefNum( st.b, varDefs );
+		bst.c = Program_BinaryDefNum( st.c, varDefs );
+		valid &= ( bst.a != PROGRAM_BINARY_BADREF && bst.b != PROGRAM_BINARY_BADREF && bst.c != PROGRAM_BINARY_BADREF );
+		fp.Write( &bst, sizeof( bst ) );
+	}
+
+	num = Program_BinaryDefNum( returnDef, varDefs );
+	valid &= ( num != PROGRAM_BINARY_BADREF );
+	fp.WriteInt( num );
+	num = Program_BinaryDefNum( returnStringDef, varDefs );
+	valid &= ( num != PROGRAM_BINARY_BADREF );
+	fp.WriteInt( num );
+	num = Program_BinaryDefNum( sysDef, varDefs );
+	valid &= ( num != PROGRAM_BINARY_BADREF );
+	fp.WriteInt( num );
+
+	if ( !valid ) {
+		gameLocal.Warning( "idProgram::WriteBinaryProgram: %s can't be stored in a binary file", defaultScript );
+		return;
+	}
+
+	name = defaultScript;
+	name.SetFileExtension( PROGRAM_BINARY_FILE_EXT );
+	fileSystem->WriteFile( name, fp.GetDataPtr(), fp.Length(), "fs_savepath" );
+}
+
+/*
+================
+idProgram::LoadBinaryProgram
+
+Returns false and leaves the program empty if there's no binary file, or if
+it doesn't match the scripts or doesn't read back completely.
+================
+*/
+bool idProgram::LoadBinaryProgram( const char *defaultScript ) {
+	idTimer		load_time;
+	idStr		name;
+	void		*buffer;
+	int			length;
+
+	load_time.Start();
+
+	FreeData();
+
+	name = defaultScript;
+	name.SetFileExtension( PROGRAM_BINARY_FILE_EXT );
+	length = fileSystem->ReadFile( name, &buffer );
+	if ( length < 0 ) {
+		return false;
+	}
+
+	idFile_Memory fp( name, (const char *)buffer, length );
+
+	if ( !ReadBinaryProgram( &fp ) ) {
+		fileSystem->FreeFile( buffer );
+		FreeData();
+		return false;
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	DecodeStatements();
+
+	load_time.Stop();
+	gameLocal.Printf( "Loaded '%s': %u ms\n", name.c_str(), load_time.Milliseconds() );
+
+	CompileStats();
+
+	return true;
+}
+
+/*
+================
+idProgram::ReadBinaryProgram
+================
+*/
+bool idProgram::ReadBinaryProgram( idFile *fp ) {
+	idStr				string;
+	binaryStatement_t	bst;
+	void				*buffer;
+	unsigned int		sourceChecksum;
+	idTypeDef			*builtinAuxTypes[ NUM_BINARY_BUILTINS ];
+	int					i, j, num, length, ident, version, checksum, numOpcodes, ptrSize, stringLen, numBuiltins;
+	int					numSourceFiles, numFiles, numVars, numTypes, numDefs, numFuncs, numStatements;
+	int					etype, aux, numParms, numTypeFuncs, initialized, kind, value;
+
+	if ( !Program_BinaryFits( fp, 8, sizeof( int ) ) ) {
+		return false;
+	}
+	fp->ReadInt( ident );
+	fp->ReadInt( version );
+	fp->ReadInt( checksum );
+	fp->ReadInt( numOpcodes );
+	fp->ReadInt( ptrSize );
+	fp->ReadInt( stringLen );
+	fp->ReadInt( numBuiltins );
+	fp->ReadInt( numSourceFiles );
+	if ( ident != PROGRAM_BINARY_FILEID || version != PROGRAM_BINARY_FILEVERSION || numOpcodes != NUM_OPCODES
+			|| ptrSize != sizeof( intptr_t ) || stringLen != MAX_STRING_LEN || numBuiltins != NUM_BINARY_BUILTINS ) {
+		return false;
+	}
+
+	// any change to the scripts needs a compile
+	if ( !Program_BinaryFits( fp, numSourceFiles, sizeof( int ) + sizeof( unsigned int ) ) ) {
+		return false;
+	}
+	for ( i = 0; i < numSourceFiles; i++ ) {
+		if ( !Program_BinaryReadString( fp, string ) || !Program_BinaryFits( fp, 1, sizeof( unsigned int ) ) ) {
+			return false;
+		}
+		fp->ReadUnsignedInt( sourceChecksum );
+		length = fileSystem->ReadFile( string, &buffer );
+		if ( length < 0 ) {
+			return false;
+		}
+		if ( MD4_BlockChecksum( buffer, length ) != sourceChecksum ) {
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+		fileSystem->FreeFile( buffer );
+	}
+
+	if ( !Program_BinaryFits( fp, 6, sizeof( int ) ) ) {
+		return false;
+	}
+	fp->ReadInt( numFiles );
+	fp->ReadInt( numVars );
+	fp->ReadInt( numTypes );
+	fp->ReadInt( numDefs );
+	fp->ReadInt( numFuncs );
+	fp->ReadInt( numStatements );
+	if ( numFiles < 0 || numVars < 0 || numVars > (int)sizeof( variables ) || numTypes < 0 || numDefs < 0
+			|| numFuncs < 0 || numFuncs > functions.Max() || numStatements < 0 || numStatements > statements.Max() ) {
+		return false;
+	}
+
+	for ( i = 0; i < numFiles; i++ ) {
+		if ( !Program_BinaryReadString( fp, string ) ) {
+			return false;
+		}
+		fileList.Append( string );
+	}
+
+	if ( !Program_BinaryFits( fp, numVars, 1 ) ) {
+		return false;
+	}
+	fp->Read( variables, numVars );
+	numVariables = numVars;
+
+	// allocate everything first, so the indexes can be resolved while reading
+	for ( i = 0; i < numTypes; i++ ) {
+		AllocType( ev_void, NULL, "", 0, NULL );
+	}
+	for ( i = 0; i < numDefs; i++ ) {
+		idVarDef *def = new idVarDef();
+		def->num = varDefs.Append( def );
+	}
+	functions.SetNum( numFuncs );
+	for ( i = 0; i < numFuncs; i++ ) {
+		functions[ i ].Clear();
+		functions[ i ].parmSize.SetGranularity( 1 );
+	}
+
+	if ( !Program_BinaryFits( fp, NUM_BINARY_BUILTINS, sizeof( int ) ) ) {
+		return false;
+	}
+	for ( i = 0; i < NUM_BINARY_BUILTINS; i++ ) {
+		fp->ReadInt( aux );
+		if ( !Program_BinaryType( aux, types, builtinAuxTypes[ i ] ) ) {
+			return false;
+		}
+	}
+
+	for ( i = 0; i < numTypes; i++ ) {
+		idTypeDef *newtype = types[ i ];
+
+		if ( !Program_BinaryFits( fp, 1, sizeof( int ) ) ) {
+			return false;
+		}
+		fp->ReadInt( etype );
+		if ( !Program_BinaryReadString( fp, newtype->name ) || !Program_BinaryFits( fp, 4, sizeof( int ) ) ) {
+			return false;
+		}
+		fp->ReadInt( newtype->size );
+		fp->ReadInt( num );
+		fp->ReadInt( aux );
+		fp->ReadInt( numParms );
+		newtype->type = (etype_t)etype;
+		if ( !Program_BinaryDef( num, varDefs, newtype->def ) || !Program_BinaryType( aux, types, newtype->auxType ) || numParms < 0 ) {
+			return false;
+		}
+
+		for ( j = 0; j < numParms; j++ ) {
+			idTypeDef *parmType;
+
+			if ( !Program_BinaryFits( fp, 1, sizeof( int ) ) ) {
+				return false;
+			}
+			fp->ReadInt( num );
+			if ( !Program_BinaryType( num, types, parmType ) || !Program_BinaryReadString( fp, string ) ) {
+				return false;
+			}
+			newtype->parmTypes.Append( parmType );
+			newtype->parmNames.Append( string );
+		}
+
+		if ( !Program_BinaryFits( fp, 1, sizeof( int ) ) ) {
+			return false;
+		}
+		fp->ReadInt( numTypeFuncs );
+		if ( !Program_BinaryFits( fp, numTypeFuncs, sizeof( int ) ) ) {
+			return false;
+		}
+		for ( j = 0; j < numTypeFuncs; j++ ) {
+			fp->ReadInt( num );
+			if ( num < 0 || num >= numFuncs ) {
+				return false;
+			}
+			newtype->functions.Append( &functions[ num ] );
+		}
+	}
+
+	for ( i = 0; i < numDefs; i++ ) {
+		idVarDef *def = varDefs[ i ];
+		idTypeDef *defType;
+
+		if ( !Program_BinaryReadString( fp, string ) || !Program_BinaryFits( fp, 6, sizeof( int ) ) ) {
+			return false;
+		}
+		fp->ReadInt( num );
+		if ( !Program_BinaryType( num, types, defType ) || !defType ) {
+			return false;
+		}
+		def->SetTypeDef( defType );
+		fp->ReadInt( num );
+		if ( !Program_BinaryDef( num, varDefs, def->scope ) || !def->scope ) {
+			return false;
+		}
+		fp->ReadInt( def->numUsers );
+		fp->ReadInt( initialized );
+		fp->ReadInt( kind );
+		fp->ReadInt( value );
+		if ( initialized < idVarDef::uninitialized || initialized > idVarDef::stackVariable ) {
+			return false;
+		}
+		def->initialized = (idVarDef::initialized_t)initialized;
+
+		switch( kind ) {
+		case BINARY_VALUE_INT:
+			def->value.ptrOffset = value;
+			break;
+		case BINARY_VALUE_VARIABLE:
+			if ( value < 0 || value > numVariables ) {
+				return false;
+			}
+			def->value.bytePtr = &variables[ value ];
+			break;
+		case BINARY_VALUE_FUNCTION:
+			if ( value < -1 || value >= numFuncs ) {
+				return false;
+			}
+			def->value.functionPtr = ( value >= 0 ) ? &functions[ value ] : NULL;
+			break;
+		default:
+			return false;
+		}
+
+		// in the same order as the compiler added them, so the name lists come out the same
+		AddDefToNameList( def, string );
+	}
+
+	for ( i = 0; i < numFuncs; i++ ) {
+		function_t &func = functions[ i ];
+		idTypeDef *funcType;
+
+		if ( !Program_BinaryReadString( fp, string ) ) {
+			return false;
+		}
+		func.SetName( string );
+		if ( !Program_BinaryReadString( fp, string ) ) {
+			return false;
+		}
+		if ( string.Length() ) {
+			// the events are numbered when the game starts, the script only knows them by name
+			func.eventdef = idEventDef::FindEvent( string );
+			if ( !func.eventdef ) {
+				return false;
+			}
+		}
+		if ( !Program_BinaryFits( fp, 8, sizeof( int ) ) ) {
+			return false;
+		}
+		fp->ReadInt( num );
+		if ( !Program_BinaryDef( num, varDefs, func.def ) ) {
+			return false;
+		}
+		fp->ReadInt( num );
+		if ( !Program_BinaryType( num, types, funcType ) ) {
+			return false;
+		}
+		func.type = funcType;
+		fp->ReadInt( func.firstStatement );
+		fp->ReadInt( func.numStatements );
+		fp->ReadInt( func.parmTotal );
+		fp->ReadInt( func.locals );
+		fp->ReadInt( func.filenum );
+		fp->ReadInt( num );
+		if ( func.firstStatement < 0 || func.numStatements < 0 || func.numStatements > numStatements - func.firstStatement
+				|| !Program_BinaryFits( fp, num, sizeof( int ) ) ) {
+			return false;
+		}
+		func.parmSize.SetNum( num );
+		for ( j = 0; j < num; j++ ) {
+			fp->ReadInt( func.parmSize[ j ] );
+		}
+	}
+
+	if ( !Program_BinaryFits( fp, numStatements, sizeof( bst ) ) ) {
+		return false;
+	}
+	statements.SetNum( numStatements );
+	for ( i = 0; i < numStatements; i++ ) {
+		statement_t &st = statements[ i ];
+
+		fp->Read( &bst, sizeof( bst ) );
+		st.op = bst.op;
+		st.flags = bst.flags;
+		st.linenumber = bst.linenumber;
+		st.file = bst.file;
+		if ( st.op >= NUM_OPCODES || st.file >= numFiles || !Program_BinaryDef( bst.a, varDefs, st.a )
+				|| !Program_BinaryDef( bst.b, varDefs, st.b ) || !Program_BinaryDef( bst.c, varDefs, st.c ) ) {
+			return false;
+		}
+	}
+
+	if ( !Program_BinaryFits( fp, 3, sizeof( int ) ) ) {
+		return false;
+	}
+	fp->ReadInt( num );
+	if ( !Program_BinaryDef( num, varDefs, returnDef ) ) {
+		return false;
+	}
+	fp->ReadInt( num );
+	if ( !Program_BinaryDef( num, varDefs, returnStringDef ) ) {
+		return false;
+	}
+	fp->ReadInt( num );
+	if ( !Program_BinaryDef( num, varDefs, sysDef ) ) {
+		return false;
+	}
+
+	// make sure it came out as the program it was written from
+	if ( fp->Tell() != fp->Length() || CalculateChecksum( false ) != checksum ) {
+		return false;
+	}
+
+	for ( i = 0; i < NUM_BINARY_BUILTINS; i++ ) {
+		binaryTypes[ i ]->auxType = builtinAuxTypes[ i ];
+	}
+
+	return true;
+}
+
 /*
 ================
 idProgram::Startup
@@ -1967,6 +2857,16 @@ void idProgram::Startup( const char *defaultScript ) {
 	// make sure all data is freed up
 	idThread::Restart();
 
+	// the scripts haven't changed since the binary file was written
+	if ( defaultScript && *defaultScript && g_binaryScripts.GetBool() && LoadBinaryProgram( defaultScript ) ) {
+		FinishCompilation();
+
+		if ( g_disasm.GetBool() ) {
+			Disassemble();
+		}
+		return;
+	}
+
 	// get ready for loading scripts
 	BeginCompilation();
 
@@ -1976,6 +2876,10 @@ void idProgram::Startup( const char *defaultScript ) {
 	}
 
 	FinishCompilation();
+
+	if ( defaultScript && *defaultScript && g_binaryScripts.GetBool() ) {
+		WriteBinaryProgram( defaultScript );
+	}
 }
 
 /*
@@ -2156,6 +3060,7 @@ void idProgram::Restart( void ) {
 	functions.SetNum( top_functions	);
 
 	statements.SetNum( top_statements );
+	instructions.SetNum( top_statements, false );
 	fileList.SetNum( top_files, false );
 	filename.Clear();
 
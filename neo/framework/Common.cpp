@@ -85,7 +85,9 @@ idCVar com_preciseTic( "com_preciseTic", "1", CVAR_BOOL|CVAR_SYSTEM, "run one ga
 idCVar com_asyncInput( "com_asyncInput", "0", CVAR_BOOL|CVAR_SYSTEM, "sample input from the async thread" );
 #define ASYNCSOUND_INFO "0: mix sound inline, 1 or 3: async update every 16ms 2: async update about every 100ms (original behavior)"
 idCVar com_asyncSound( "com_asyncSound", "1", CVAR_INTEGER|CVAR_SYSTEM, ASYNCSOUND_INFO, 0, 3 );
+idCVar com_jobThreads( "com_jobThreads", "-1", CVAR_INTEGER | CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_INIT, "number of job system worker threads, -1 = one per core besides the main thread", -1, MAX_WORKER_THREADS );
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "force generic platform independent SIMD" );
+idCVar com_useNEON( "com_useNEON", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_NOCHEAT, "use the NEON SIMD processor on ARM CPUs that have it, the generic one is used otherwise" );
 idCVar com_developer( "developer", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "developer mode" );
 idCVar com_allowConsole( "com_allowConsole", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "allow toggling console with the tilde key" );
 idCVar com_speeds( "com_speeds", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "show engine timings" );
@@ -1177,6 +1179,15 @@ static void Com_MaterialEditor_f( const idCmdArgs &args ) {
 }
 #endif // ID_ALLOW_TOOLS
 
+/*
+=============
+Com_ListJobThreads_f
+=============
+*/
+static void Com_ListJobThreads_f( const idCmdArgs &args ) {
+	Sys_PrintJobThreads();
+}
+
 /*
 ============
 idCmdSystemLocal::PrintMemInfo_f
@@ -2338,6 +2349,7 @@ void idCommonLocal::InitCommands( void ) {
 	cmdSystem->AddCommand( "listDictKeys", idDict::ListKeys_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all keys used by dictionaries" );
 	cmdSystem->AddCommand( "listDictValues", idDict::ListValues_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all values used by dictionaries" );
 	cmdSystem->AddCommand( "testSIMD", idSIMD::Test_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "test SIMD code" );
+	cmdSystem->AddCommand( "listJobThreads", Com_ListJobThreads_f, CMD_FL_SYSTEM, "lists the job system worker threads" );
 
 	// localization
 	cmdSystem->AddCommand( "localizeGuis", Com_LocalizeGuis_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "localize guis" );
@@ -2393,8 +2405,9 @@ idCommonLocal::InitSIMD
 =================
 */
 void idCommonLocal::InitSIMD( void ) {
-	idSIMD::InitProcessor( "doom", com_forceGenericSIMD.GetBool() );
+	idSIMD::InitProcessor( "doom", com_forceGenericSIMD.GetBool(), com_useNEON.GetBool() );
 	com_forceGenericSIMD.ClearModified();
+	com_useNEON.ClearModified();
 }
 
 /*
@@ -2412,7 +2425,7 @@ void idCommonLocal::Frame( void ) {
 		WriteConfiguration();
 
 		// change SIMD implementation if required
-		if ( com_forceGenericSIMD.IsModified() ) {
+		if ( com_forceGenericSIMD.IsModified() || com_useNEON.IsModified() ) {
 			InitSIMD();
 		}
 
@@ -2999,6 +3012,9 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		// initialize processor specific SIMD implementation
 		InitSIMD();
 
+		// start the job system worker threads
+		Sys_StartWorkerThreads( com_jobThreads.GetInteger() );
+
 		// init commands
 		InitCommands();
 
@@ -1287,8 +1287,6 @@ Vertex order is:
 ================
 */
 int idParticleStage::CreateParticle( particleGen_t *g, idDrawVert *verts ) const {
-	idVec3	origin;
-
 	verts[0].Clear();
 	verts[1].Clear();
 	verts[2].Clear();
@@ -1301,6 +1299,19 @@ int idParticleStage::CreateParticle( particleGen_t *g, idDrawVert *verts ) const
 		return 0;
 	}
 
+	return ParticleGeometry( g, verts );
+}
+
+/*
+================
+idParticleStage::ParticleGeometry
+
+Everything CreateParticle does after the colors are set
+================
+*/
+int idParticleStage::ParticleGeometry( particleGen_t *g, idDrawVert *verts ) const {
+	idVec3	origin;
+
 	ParticleOrigin( g, origin );
 
 	ParticleTexCoords( g, verts );
@@ -1334,6 +1345,100 @@ int idParticleStage::CreateParticle( particleGen_t *g, idDrawVert *verts ) const
 	return numVerts * 2;
 }
 
+/*
+================
+idParticleStage::CreateParticles
+
+Same output as calling CreateParticle for every particle of the batch,
+but the fades and colors are done a whole range at a time.  Every
+particle gets its own fixed slot in verts, so ranges can be created on
+different threads and compacted afterwards using batch->numVerts.
+================
+*/
+void idParticleStage::CreateParticles( const particleGen_t *g, particleBatch_t *batch, int first, int last, idDrawVert *verts ) const {
+	const int	vertsPerParticle = 4 * NumQuadsPerParticle();
+	const float	*frac = batch->frac;
+	float		*fade = batch->fade;
+	int			i, j;
+
+	// most particles fade in at the beginning and fade out at the end
+	for ( i = first; i < last; i++ ) {
+		float fadeFraction = 1.0f;
+		if ( frac[i] < fadeInFraction ) {
+			fadeFraction *= ( frac[i] / fadeInFraction );
+		}
+		if ( 1.0f - frac[i] < fadeOutFraction ) {
+			fadeFraction *= ( ( 1.0f - frac[i] ) / fadeOutFraction );
+		}
+		fade[i] = fadeFraction;
+	}
+
+	if ( fadeIndexFraction ) {
+		for ( i = first; i < last; i++ ) {
+			float	indexFrac = ( totalParticles - batch->index[i] ) / (float)totalParticles;
+			if ( indexFrac < fadeIndexFraction ) {
+				fade[i] *= indexFrac / fadeIndexFraction;
+			}
+		}
+	}
+
+	// baseColor * fade + fadeColor * ( 1 - fade ) in 0-255, one channel at a time
+	// both products are rounded before the add like in ParticleColors, MulAdd
+	// keeps the product in double precision with the generic processor
+	const int	count = last - first;
+	float		*colors[4];
+	float		*fadeOut = batch->colors + 4 * batch->numParticles + first;
+	float		*faded = batch->colors + 5 * batch->numParticles + first;
+
+	SIMDProcessor->Sub( fadeOut, 1.0f, fade + first, count );
+	for ( j = 0; j < 4; j++ ) {
+		float baseColor = ( entityColor ) ? g->renderEnt->shaderParms[j] : color[j];
+
+		colors[j] = batch->colors + j * batch->numParticles + first;
+		SIMDProcessor->Mul( colors[j], baseColor, fade + first, count );
+		SIMDProcessor->Mul( faded, fadeColor[j], fadeOut, count );
+		SIMDProcessor->Add( colors[j], colors[j], faded, count );
+		SIMDProcessor->Mul( colors[j], 255.0f, colors[j], count );
+		SIMDProcessor->Clamp( colors[j], colors[j], 0.0f, 255.0f, count );
+	}
+
+	particleGen_t	gen = *g;
+
+	for ( i = first; i < last; i++ ) {
+		idDrawVert *v = verts + i * vertsPerParticle;
+
+		v[0].Clear();
+		v[1].Clear();
+		v[2].Clear();
+		v[3].Clear();
+
+		// clamping before the conversion gives the same bytes as ParticleColors
+		int	visible = 0;
+		for ( j = 0; j < 4; j++ ) {
+			int		icolor = idMath::FtoiFast( colors[j][i - first] );
+			v[0].color[j] =
+			v[1].color[j] =
+			v[2].color[j] =
+			v[3].color[j] = icolor;
+			visible |= icolor;
+		}
+
+		// if we are completely faded out, kill the particle
+		if ( !visible ) {
+			batch->numVerts[i] = 0;
+			continue;
+		}
+
+		gen.index = batch->index[i];
+		gen.frac = frac[i];
+		gen.age = batch->age[i];
+		gen.random.SetSeed( batch->randomSeed[i] );
+		gen.originalRandom.SetSeed( batch->randomSeed[i] );
+
+		batch->numVerts[i] = ParticleGeometry( &gen, v );
+	}
+}
+
 /*
 ==================
 idParticleStage::GetCustomPathName
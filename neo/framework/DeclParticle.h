@@ -105,6 +105,20 @@ typedef struct {
 	float					animationFrameFrac;	// set by ParticleTexCoords, used to make the cross faded version
 } particleGen_t;
 
+//
+// the live particles of a stage as a structure of arrays, so the whole
+// stage can be handed to idParticleStage::CreateParticles in chunks
+//
+typedef struct {
+	int						numParticles;
+	int *					index;
+	float *					frac;
+	float *					age;
+	int *					randomSeed;			// seed of both random and originalRandom
+	float *					fade;				// filled in by CreateParticles
+	float *					colors;				// 6 * numParticles scratch for CreateParticles, the 4 channels and 2 temporaries
+	int *					numVerts;			// filled in by CreateParticles, 0 if the particle faded out
+} particleBatch_t;
 
 //
 // single particle stage
@@ -118,11 +132,14 @@ public:
 	virtual int				NumQuadsPerParticle() const;	// includes trails and cross faded animations
 	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()
 	virtual int				CreateParticle( particleGen_t *g, idDrawVert *verts ) const;
+	// creates the batch particles first to last-1, particle i goes to verts + i * 4*NumQuadsPerParticle()
+	void					CreateParticles( const particleGen_t *g, particleBatch_t *batch, int first, int last, idDrawVert *verts ) const;
 
 	void					ParticleOrigin( particleGen_t *g, idVec3 &origin ) const;
 	int						ParticleVerts( particleGen_t *g, const idVec3 origin, idDrawVert *verts ) const;
 	void					ParticleTexCoords( particleGen_t *g, idDrawVert *verts ) const;
 	void					ParticleColors( particleGen_t *g, idDrawVert *verts ) const;
+	int						ParticleGeometry( particleGen_t *g, idDrawVert *verts ) const;
 
 	const char *			GetCustomPathName();
 	const char *			GetCustomPathDesc();
@@ -2918,11 +2918,17 @@ idFile_InZip * idFileSystemLocal::ReadFileFromZip( pack_t *pak, fileInPack_t *pa
 	// relativePath == pakFile->name according to FilenameCompare()
 	// pakFile->Pos is position of that file within the zip
 
+	// the pak handle is shared, image load jobs open files as well
+	Sys_EnterCriticalSection( CRITICAL_SECTION_FILESYSTEM );
+
 	// set position in pk4 file to the file (in the zip/pk4) we want a handle on
 	unzSetOffset64( pak->handle, pakFile->pos );
 
 	// clone handle and assign a new internal filestream to zip file to it
 	unzFile uf = unzReOpen( pak->pakFilename, pak->handle );
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_FILESYSTEM );
+
 	if ( uf == NULL ) {
 		common->FatalError( "Couldn't reopen %s", pak->pakFilename.c_str() );
 	}
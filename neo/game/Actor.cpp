@@ -1456,7 +1456,22 @@ idActor::CanSee
 */
 bool idActor::CanSee( idEntity *ent, bool useFov ) const {
 	trace_t		tr;
-	idVec3		eye;
+	clipTrace_t	trace;
+
+	if ( !SetupCanSeeTrace( ent, useFov, trace ) ) {
+		return false;
+	}
+
+	gameLocal.clip.TracePoint( tr, trace.start, trace.end, trace.contentMask, trace.passEntity );
+	return CanSeeTraceResult( ent, tr );
+}
+
+/*
+=====================
+idActor::SetupCanSeeTrace
+=====================
+*/
+bool idActor::SetupCanSeeTrace( idEntity *ent, bool useFov, clipTrace_t &trace ) const {
 	idVec3		toPos;
 
 	if ( ent->IsHidden() ) {
@@ -1473,9 +1488,20 @@ bool idActor::CanSee( idEntity *ent, bool useFov ) const {
 		return false;
 	}
 
-	eye = GetEyePosition();
+	trace.start = GetEyePosition();
+	trace.end = toPos;
+	trace.bounds.Clear();
+	trace.contentMask = MASK_OPAQUE;
+	trace.passEntity = this;
+	return true;
+}
 
-	gameLocal.clip.TracePoint( tr, eye, toPos, MASK_OPAQUE, this );
+/*
+=====================
+idActor::CanSeeTraceResult
+=====================
+*/
+bool idActor::CanSeeTraceResult( idEntity *ent, const trace_t &tr ) {
 	if ( tr.fraction >= 1.0f || ( gameLocal.GetTraceEntity( tr ) == ent ) ) {
 		return true;
 	}
@@ -68,6 +68,7 @@ extern idSoundWorld *				gameSoundWorld;
 
 // classes used by idGameLocal
 class idEntity;
+class idAnimator;
 class idActor;
 class idPlayer;
 class idCamera;
@@ -79,6 +80,7 @@ class idTypeInfo;
 class idThread;
 class idEditEntities;
 class idLocationEntity;
+class idPhysics_AF;
 
 //============================================================================
 extern const int NUM_RENDER_PORTAL_BITS;
@@ -163,6 +165,12 @@ typedef struct {
 	int			dist;
 } spawnSpot_t;
 
+// an animator whose frame is built on the job threads
+typedef struct {
+	idAnimator	*animator;
+	int			time;
+} animatorUpdate_t;
+
 //============================================================================
 
 class idEventQueue {
@@ -294,6 +302,12 @@ public:
 	idEntityPtr<idEntity>	lastGUIEnt;				// last entity with a GUI, used by Cmd_NextGUI_f
 	int						lastGUI;				// last GUI on the lastGUIEnt
 
+	idList< idEntityPtr<idEntity> >	benchRagdolls;	// ragdolls spawned by Cmd_BenchRagdolls_f
+	int						benchRagdollFrames;		// number of frames to measure the ragdolls
+	int						benchRagdollFrame;		// frames measured so far
+	double					benchRagdollTime;		// think time of the measured frames
+	double					benchRagdollMaxTime;	// think time of the slowest measured frame
+
 	// ---------------------- Public idGame Interface -------------------
 
 							idGameLocal();
@@ -491,6 +505,9 @@ private:
 	idEventQueue			eventQueue;
 	idEventQueue			savedEventQueue;
 
+	idStaticList<animatorUpdate_t, MAX_GENTITIES> animatorUpdates;
+	idStaticList<idPhysics_AF *, MAX_GENTITIES> islandFigures;
+
 	idStaticList<spawnSpot_t, MAX_GENTITIES> spawnSpots;
 	idStaticList<idEntity *, MAX_GENTITIES> initialSpots;
 	int						currentInitialSpot;
@@ -515,6 +532,11 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	void					UpdateAnimators( void );
+	static void				UpdateAnimatorJob( void *data, int index );
+	void					SolveArticulatedFigures( void );
+	static void				SolveArticulatedFigureJob( void *data, int index );
+	void					RunRagdollBench( double thinkTime );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
 
@@ -559,6 +581,7 @@ private:
 
 extern idGameLocal			gameLocal;
 extern idAnimManager		animationLib;
+extern idAnimPoseCache	animPoseCache;
 
 //============================================================================
 
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/geometry/JointTransform.h"
 #include "idlib/math/Quat.h"
 
+#include "gamesys/SysCvar.h"
 #include "Game_local.h"
 
 #include "anim/Anim.h"
@@ -54,6 +55,10 @@ idMD5Anim::idMD5Anim() {
 	frameRate	= 24;
 	animLength	= 0;
 	totaldelta.Zero();
+
+	quantized				= false;
+	numQuantizedComponents	= 0;
+	numRootComponents		= 0;
 }
 
 /*
@@ -82,6 +87,17 @@ void idMD5Anim::Free( void ) {
 	jointInfo.Clear();
 	bounds.Clear();
 	componentFrames.Clear();
+
+	quantized				= false;
+	numQuantizedComponents	= 0;
+	numRootComponents		= 0;
+	quantizedFrames.Clear();
+	quantizedBias.Clear();
+	quantizedScale.Clear();
+	constantComponents.Clear();
+	componentSource.Clear();
+	quantizedRotations.Clear();
+	rootFrames.Clear();
 }
 
 /*
@@ -150,9 +166,28 @@ idMD5Anim::Allocated
 */
 size_t idMD5Anim::Allocated( void ) const {
 	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size += quantizedFrames.Allocated() + quantizedBias.Allocated() + quantizedScale.Allocated() + constantComponents.Allocated();
+	size += componentSource.Allocated() + quantizedRotations.Allocated() + rootFrames.Allocated();
 	return size;
 }
 
+/*
+====================
+idMD5Anim::QuantizedSavings
+
+  how much less memory the frames take than they would as floats
+====================
+*/
+size_t idMD5Anim::QuantizedSavings( void ) const {
+	if ( !quantized ) {
+		return 0;
+	}
+
+	size_t	size = quantizedFrames.Allocated() + quantizedBias.Allocated() + quantizedScale.Allocated() + constantComponents.Allocated();
+	size += componentSource.Allocated() + quantizedRotations.Allocated() + rootFrames.Allocated();
+	return numFrames * numAnimatedComponents * sizeof( float ) - size;
+}
+
 /*
 ====================
 idMD5Anim::LoadAnim
@@ -326,10 +361,366 @@ bool idMD5Anim::LoadAnim( const char *filename ) {
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 
+	if ( g_quantizeAnims.GetBool() ) {
+		Quantize();
+	}
+
 	// done
 	return true;
 }
 
+/*
+====================
+QuantizeComponent
+
+  nearest 16 bit step of the value in [0, range]
+====================
+*/
+static unsigned short QuantizeComponent( float value, float range ) {
+	int q = idMath::Ftoi( value / range * 65535.0f + 0.5f );
+	return idMath::ClampInt( 0, 65535, q );
+}
+
+/*
+====================
+QuantizeComponentLowBit
+
+  nearest 16 bit step of the value in [0, range] that has the given low bit
+====================
+*/
+static unsigned short QuantizeComponentLowBit( float value, float range, int lowBit ) {
+	int q = idMath::Ftoi( ( value / range * 65535.0f - lowBit ) * 0.5f + 0.5f ) * 2 + lowBit;
+	if ( q < lowBit ) {
+		q = lowBit;
+	} else if ( q > 65534 + lowBit ) {
+		q = 65534 + lowBit;
+	}
+	return q;
+}
+
+/*
+====================
+idMD5Anim::Quantize
+
+  Replaces the float frames with 16 bit values.  Translations are stored relative
+  to the bounds of the joint's movement, rotations as the three smallest components
+  of the quaternion with the index of the largest one in the low bits of the first
+  two, and tracks that never change are kept once.  The anim stays unquantized
+  when that wouldn't save memory.
+====================
+*/
+void idMD5Anim::Quantize( void ) {
+	int				i, j, k, c;
+	int				numRotationComponents;
+	idList<int>		rotationJoints;
+
+	if ( !numAnimatedComponents ) {
+		return;
+	}
+
+	componentSource.SetGranularity( 1 );
+	componentSource.SetNum( numAnimatedComponents );
+	for ( i = 0; i < numAnimatedComponents; i++ ) {
+		componentSource[ i ] = -1;
+	}
+
+	// the root joint drives the movement of the entity, keep it exact
+	numRootComponents = 0;
+	for ( c = 0; c < 6; c++ ) {
+		if ( jointInfo[ 0 ].animBits & BIT( c ) ) {
+			numRootComponents++;
+		}
+	}
+
+	// constants get a source of -2 - index until the number of quantized components is known
+	for ( j = 1; j < numJoints; j++ ) {
+		const jointAnimInfo_t *infoPtr = &jointInfo[ j ];
+		if ( !infoPtr->animBits ) {
+			continue;
+		}
+
+		k = infoPtr->firstComponent;
+		for ( c = 0; c < 3; c++ ) {
+			if ( !( infoPtr->animBits & BIT( c ) ) ) {
+				continue;
+			}
+			float minValue = componentFrames[ k ];
+			float maxValue = minValue;
+			for ( i = 1; i < numFrames; i++ ) {
+				const float value = componentFrames[ i * numAnimatedComponents + k ];
+				minValue = Min( minValue, value );
+				maxValue = Max( maxValue, value );
+			}
+			if ( minValue == maxValue ) {
+				componentSource[ k ] = -2 - constantComponents.Append( minValue );
+			} else {
+				componentSource[ k ] = quantizedBias.Append( minValue );
+				quantizedScale.Append( ( maxValue - minValue ) / 65535.0f );
+			}
+			k++;
+		}
+
+		numRotationComponents = 0;
+		for ( c = 3; c < 6; c++ ) {
+			if ( infoPtr->animBits & BIT( c ) ) {
+				numRotationComponents++;
+			}
+		}
+		if ( !numRotationComponents ) {
+			continue;
+		}
+
+		bool constant = true;
+		for ( i = 1; i < numFrames && constant; i++ ) {
+			for ( c = 0; c < numRotationComponents; c++ ) {
+				if ( componentFrames[ i * numAnimatedComponents + k + c ] != componentFrames[ k + c ] ) {
+					constant = false;
+					break;
+				}
+			}
+		}
+
+		if ( constant ) {
+			for ( c = 0; c < numRotationComponents; c++ ) {
+				componentSource[ k + c ] = -2 - constantComponents.Append( componentFrames[ k + c ] );
+			}
+			continue;
+		}
+
+		quantizedRotation_t &rotation = quantizedRotations.Alloc();
+		rotation.firstComponent = k;
+		rotation.animBits = infoPtr->animBits;
+		rotation.firstQuantized = quantizedBias.Num();
+		rotationJoints.Append( j );
+		for ( c = 0; c < 3; c++ ) {
+			quantizedBias.Append( -idMath::SQRT_1OVER2 );
+			quantizedScale.Append( idMath::SQRT_TWO / 65535.0f );
+		}
+	}
+
+	numQuantizedComponents = quantizedBias.Num();
+	for ( i = 0; i < numAnimatedComponents; i++ ) {
+		if ( componentSource[ i ] <= -2 ) {
+			componentSource[ i ] = numQuantizedComponents - 2 - componentSource[ i ];
+		}
+	}
+
+	// don't bother when the tables take more than the frames save
+	size_t size = numFrames * ( numQuantizedComponents * sizeof( unsigned short ) + numRootComponents * sizeof( float ) );
+	size += ( numQuantizedComponents * 2 + constantComponents.Num() ) * sizeof( float );
+	size += componentSource.Num() * sizeof( int ) + quantizedRotations.Num() * sizeof( quantizedRotation_t );
+	if ( size >= numFrames * numAnimatedComponents * sizeof( float ) ) {
+		numQuantizedComponents = 0;
+		numRootComponents = 0;
+		quantizedBias.Clear();
+		quantizedScale.Clear();
+		constantComponents.Clear();
+		componentSource.Clear();
+		quantizedRotations.Clear();
+		return;
+	}
+
+	quantizedBias.Condense();
+	quantizedScale.Condense();
+	constantComponents.Condense();
+	quantizedRotations.Condense();
+
+	quantizedFrames.SetGranularity( 1 );
+	quantizedFrames.SetNum( numFrames * numQuantizedComponents );
+	rootFrames.SetGranularity( 1 );
+	rootFrames.SetNum( numFrames * numRootComponents );
+
+	for ( i = 0; i < numFrames; i++ ) {
+		const float *frame = &componentFrames[ i * numAnimatedComponents ];
+		unsigned short *dest = quantizedFrames.Ptr() + i * numQuantizedComponents;
+
+		for ( k = 0; k < numRootComponents; k++ ) {
+			rootFrames[ i * numRootComponents + k ] = frame[ jointInfo[ 0 ].firstComponent + k ];
+		}
+
+		for ( k = 0; k < numAnimatedComponents; k++ ) {
+			const int source = componentSource[ k ];
+			if ( source >= 0 && source < numQuantizedComponents ) {
+				dest[ source ] = QuantizeComponent( frame[ k ] - quantizedBias[ source ], quantizedScale[ source ] * 65535.0f );
+			}
+		}
+
+		for ( j = 0; j < quantizedRotations.Num(); j++ ) {
+			const quantizedRotation_t &rotation = quantizedRotations[ j ];
+			const float *jointframe = frame + rotation.firstComponent;
+			idQuat q = baseFrame[ rotationJoints[ j ] ].q;
+
+			for ( c = 0; c < 3; c++ ) {
+				if ( rotation.animBits & ( ANIM_QX << c ) ) {
+					q[ c ] = *jointframe++;
+				}
+			}
+			q.w = q.CalcW();
+			q.Normalize();
+
+			int largest = 0;
+			for ( c = 1; c < 4; c++ ) {
+				if ( idMath::Fabs( q[ c ] ) > idMath::Fabs( q[ largest ] ) ) {
+					largest = c;
+				}
+			}
+			if ( q[ largest ] < 0.0f ) {
+				q = -q;
+			}
+
+			unsigned short *rotationDest = dest + rotation.firstQuantized;
+			for ( k = 0, c = 0; c < 4; c++ ) {
+				if ( c != largest ) {
+					if ( k < 2 ) {
+						rotationDest[ k ] = QuantizeComponentLowBit( q[ c ] + idMath::SQRT_1OVER2, idMath::SQRT_TWO, ( largest >> k ) & 1 );
+					} else {
+						rotationDest[ k ] = QuantizeComponent( q[ c ] + idMath::SQRT_1OVER2, idMath::SQRT_TWO );
+					}
+					k++;
+				}
+			}
+		}
+	}
+
+	quantized = true;
+
+	CheckQuantization( rotationJoints );
+
+	componentFrames.Clear();
+}
+
+/*
+====================
+idMD5Anim::CheckQuantization
+
+  Compares the decoded frames with the float frames they were made from.  A
+  translation has to come back within half a quantization step, a rotation
+  within a few steps because the largest component is rebuilt from the others.
+====================
+*/
+void idMD5Anim::CheckQuantization( const idList<int> &rotationJoints ) const {
+	int		i, j, k, c;
+	float	maxTranslationSteps = 0.0f;
+	float	maxRotationSteps = 0.0f;
+	float	*buffer = (float *)_alloca16( numAnimatedComponents * sizeof( float ) );
+
+	for ( i = 0; i < numFrames; i++ ) {
+		const float *frame = &componentFrames[ i * numAnimatedComponents ];
+		const float *decoded = DecodeFrame( i, buffer );
+
+		for ( k = 0; k < numAnimatedComponents; k++ ) {
+			const int source = componentSource[ k ];
+			if ( source < 0 || source >= numQuantizedComponents || quantizedScale[ source ] <= 0.0f ) {
+				continue;
+			}
+			// leave room for the float rounding of big values
+			float error = idMath::Fabs( decoded[ k ] - frame[ k ] ) - ( idMath::Fabs( frame[ k ] ) + idMath::Fabs( quantizedBias[ source ] ) ) * 4.0f * idMath::FLT_EPSILON;
+			maxTranslationSteps = Max( maxTranslationSteps, error / quantizedScale[ source ] );
+		}
+
+		for ( j = 0; j < quantizedRotations.Num(); j++ ) {
+			const quantizedRotation_t &rotation = quantizedRotations[ j ];
+			idQuat original = baseFrame[ rotationJoints[ j ] ].q;
+			idQuat result = original;
+
+			for ( k = 0, c = 0; c < 3; c++ ) {
+				if ( rotation.animBits & ( ANIM_QX << c ) ) {
+					original[ c ] = frame[ rotation.firstComponent + k ];
+					result[ c ] = decoded[ rotation.firstComponent + k ];
+					k++;
+				}
+			}
+			original.w = original.CalcW();
+			original.Normalize();
+			result.w = result.CalcW();
+
+			float error = Min( ( result - original ).Length(), ( result + original ).Length() );
+			maxRotationSteps = Max( maxRotationSteps, error / ( idMath::SQRT_TWO / 65535.0f ) );
+		}
+	}
+
+	if ( maxTranslationSteps > 0.501f || maxRotationSteps > 6.0f ) {
+		gameLocal.Warning( "quantized anim '%s' is off by %.2f translation steps and %.2f rotation steps", name.c_str(), maxTranslationSteps, maxRotationSteps );
+	}
+}
+
+/*
+====================
+idMD5Anim::DecodeFrame
+
+  Returns the animated components of a frame.  A quantized frame is decoded into
+  the buffer, which needs room for numAnimatedComponents floats.
+====================
+*/
+const float *idMD5Anim::DecodeFrame( int framenum, float *buffer ) const {
+	int i, c;
+
+	if ( !quantized ) {
+		return &componentFrames[ framenum * numAnimatedComponents ];
+	}
+
+	// the constants go after the dequantized values so both are found through componentSource
+	float *values = (float *)_alloca16( ( numQuantizedComponents + constantComponents.Num() ) * sizeof( float ) );
+	const unsigned short *src = quantizedFrames.Ptr() + framenum * numQuantizedComponents;
+	SIMDProcessor->Dequantize( values, src, quantizedBias.Ptr(), quantizedScale.Ptr(), numQuantizedComponents );
+	SIMDProcessor->Memcpy( values + numQuantizedComponents, constantComponents.Ptr(), constantComponents.Num() * sizeof( float ) );
+
+	for ( i = 0; i < numAnimatedComponents; i++ ) {
+		if ( componentSource[ i ] >= 0 ) {
+			buffer[ i ] = values[ componentSource[ i ] ];
+		}
+	}
+
+	for ( i = 0; i < quantizedRotations.Num(); i++ ) {
+		const quantizedRotation_t &rotation = quantizedRotations[ i ];
+		const float *v = values + rotation.firstQuantized;
+		const unsigned short *s = src + rotation.firstQuantized;
+		const int largest = ( s[0] & 1 ) | ( ( s[1] & 1 ) << 1 );
+		idQuat q;
+
+		q[ largest ] = idMath::Sqrt( Max( 0.0f, 1.0f - v[0] * v[0] - v[1] * v[1] - v[2] * v[2] ) );
+		for ( c = 0; c < 3; c++ ) {
+			q[ c < largest ? c : c + 1 ] = v[ c ];
+		}
+
+		// the frames are stored with a positive w
+		if ( q.w < 0.0f ) {
+			q = -q;
+		}
+
+		float *jointframe = buffer + rotation.firstComponent;
+		if ( rotation.animBits & ANIM_QX ) {
+			*jointframe++ = q.x;
+		}
+		if ( rotation.animBits & ANIM_QY ) {
+			*jointframe++ = q.y;
+		}
+		if ( rotation.animBits & ANIM_QZ ) {
+			*jointframe++ = q.z;
+		}
+	}
+
+	if ( numRootComponents ) {
+		SIMDProcessor->Memcpy( buffer + jointInfo[ 0 ].firstComponent, RootComponents( framenum ), numRootComponents * sizeof( float ) );
+	}
+
+	return buffer;
+}
+
+/*
+====================
+idMD5Anim::RootComponents
+
+  the animated components of the root joint in a frame
+====================
+*/
+const float *idMD5Anim::RootComponents( int framenum ) const {
+	if ( quantized ) {
+		return &rootFrames[ framenum * numRootComponents ];
+	}
+	return &componentFrames[ numAnimatedComponents * framenum + jointInfo[ 0 ].firstComponent ];
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -445,8 +836,8 @@ void idMD5Anim::GetOrigin( idVec3 &offset, int time, int cyclecount ) const {
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	const float *componentPtr1 = RootComponents( frame.frame1 );
+	const float *componentPtr2 = RootComponents( frame.frame2 );
 
 	if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 		offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -487,8 +878,8 @@ void idMD5Anim::GetOriginRotation( idQuat &rotation, int time, int cyclecount )
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float	*jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float	*jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	const float	*jointframe1 = RootComponents( frame.frame1 );
+	const float	*jointframe2 = RootComponents( frame.frame2 );
 
 	if ( animBits & ANIM_TX ) {
 		jointframe1++;
@@ -601,8 +992,8 @@ void idMD5Anim::GetBounds( idBounds &bnds, int time, int cyclecount ) const {
 	// origin position
 	offset = baseFrame[ 0 ].t;
 	if ( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) ) {
-		const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		const float *componentPtr1 = RootComponents( frame.frame1 );
+		const float *componentPtr2 = RootComponents( frame.frame2 );
 
 		if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 			offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -642,6 +1033,8 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 	idJointQuat				*jointPtr;
 	idJointQuat				*blendPtr;
 	int						*lerpIndex;
+	float					*decoded1;
+	float					*decoded2;
 
 	// copy the baseframe
 	SIMDProcessor->Memcpy( joints, baseFrame.Ptr(), baseFrame.Num() * sizeof( baseFrame[ 0 ] ) );
@@ -653,10 +1046,12 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 
 	blendJoints = (idJointQuat *)_alloca16( baseFrame.Num() * sizeof( blendPtr[ 0 ] ) );
 	lerpIndex = (int *)_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
+	decoded1 = (float *)_alloca16( numAnimatedComponents * sizeof( decoded1[ 0 ] ) );
+	decoded2 = (float *)_alloca16( numAnimatedComponents * sizeof( decoded2[ 0 ] ) );
 	numLerpJoints = 0;
 
-	frame1 = &componentFrames[ frame.frame1 * numAnimatedComponents ];
-	frame2 = &componentFrames[ frame.frame2 * numAnimatedComponents ];
+	frame1 = DecodeFrame( frame.frame1, decoded1 );
+	frame2 = DecodeFrame( frame.frame2, decoded2 );
 
 	for ( i = 0; i < numIndexes; i++ ) {
 		int j = index[i];
@@ -824,6 +1219,7 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 	int						i;
 	const float				*frame;
 	const float				*jointframe;
+	float					*decoded;
 	int						animBits;
 	idJointQuat				*jointPtr;
 	const jointAnimInfo_t	*infoPtr;
@@ -836,7 +1232,8 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 		return;
 	}
 
-	frame = &componentFrames[ framenum * numAnimatedComponents ];
+	decoded = (float *)_alloca16( numAnimatedComponents * sizeof( decoded[ 0 ] ) );
+	frame = DecodeFrame( framenum, decoded );
 
 	for ( i = 0; i < numIndexes; i++ ) {
 		int j = index[i];
@@ -1040,18 +1437,26 @@ void idAnimManager::ListAnims( void ) const {
 	size_t		size;
 	size_t		s;
 	size_t		namesize;
+	size_t		saved;
 	int			num;
+	int			numQuantized;
 
 	num = 0;
 	size = 0;
+	saved = 0;
+	numQuantized = 0;
 	for( i = 0; i < animations.Num(); i++ ) {
 		animptr = animations.GetIndex( i );
 		if ( animptr && *animptr ) {
 			anim = *animptr;
 			s = anim->Size();
-			gameLocal.Printf( "%8zd bytes : %2d refs : %s\n", s, anim->NumRefs(), anim->Name() );
+			gameLocal.Printf( "%8zd bytes : %2d refs : %s%s\n", s, anim->NumRefs(), anim->Name(), anim->IsQuantized() ? " (quantized)" : "" );
 			size += s;
 			num++;
+			if ( anim->IsQuantized() ) {
+				saved += anim->QuantizedSavings();
+				numQuantized++;
+			}
 		}
 	}
 
@@ -1061,6 +1466,9 @@ void idAnimManager::ListAnims( void ) const {
 	}
 
 	gameLocal.Printf( "\n%zd memory used in %d anims\n", size, num );
+	if ( numQuantized ) {
+		gameLocal.Printf( "%zd memory saved by %d quantized anims, %zd without them\n", saved, numQuantized, size + saved );
+	}
 	gameLocal.Printf( "%zd memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
@@ -26,6 +26,8 @@ If you have questions concerning this license or the applicable additional terms
 ===========================================================================
 */
 
+#include <mutex>
+
 #include "sys/platform.h"
 #include "idlib/containers/BinSearch.h"
 #include "idlib/geometry/JointTransform.h"
@@ -1858,6 +1860,41 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 	return true;
 }
 
+/*
+=====================
+idAnimBlend::GetPoseKey
+
+  the results of the time and weight calculations BlendAnim does
+=====================
+*/
+void idAnimBlend::GetPoseKey( int currentTime, animPoseBlend_t &key ) const {
+	int				i;
+	frameBlend_t	frametime;
+
+	const idAnim *anim = Anim();
+	if ( !anim ) {
+		key.animNum = -1;
+		return;
+	}
+
+	key.animNum = animNum;
+	key.weight = GetWeight( currentTime );
+	key.ended = ( endtime >= 0 ) && ( currentTime >= endtime );
+	key.allowMove = allowMove;
+	key.frame = frame;
+	if ( !frame ) {
+		anim->MD5Anim( 0 )->ConvertTimeToFrame( AnimTime( currentTime ), cycle, frametime );
+		key.frame1 = frametime.frame1;
+		key.frame2 = frametime.frame2;
+		key.backlerp = frametime.backlerp;
+	}
+	if ( anim->NumAnims() > 1 ) {
+		for( i = 0; i < anim->NumAnims(); i++ ) {
+			key.animWeights[ i ] = animWeights[ i ];
+		}
+	}
+}
+
 /*
 =====================
 idAnimBlend::BlendOrigin
@@ -4174,69 +4211,20 @@ bool idAnimator::FrameHasChanged( int currentTime ) const {
 
 /*
 =====================
-idAnimator::CreateFrame
+idAnimator::BlendChannels
+
+  blends the anims of all channels and the articulated figure pose into jointFrame
 =====================
 */
-bool idAnimator::CreateFrame( int currentTime, bool force ) {
+bool idAnimator::BlendChannels( int currentTime, idJointQuat *jointFrame, bool debugInfo ) const {
 	int					i, j;
 	int					numJoints;
-	int					parentNum;
 	bool				hasAnim;
-	bool				debugInfo;
 	float				baseBlend;
 	float				blendWeight;
 	const idAnimBlend *	blend;
-	const int *			jointParent;
-	const jointMod_t *	jointMod;
-	const idJointQuat *	defaultPose;
-
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
-
-	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
-		return false;
-	}
-
-	if ( !modelDef || !modelDef->ModelHandle() ) {
-		return false;
-	}
-
-	if ( !force && !r_showSkel.GetInteger() ) {
-		if ( lastTransformTime == currentTime ) {
-			return false;
-		}
-		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
-			return false;
-		}
-	}
-
-	lastTransformTime = currentTime;
-	stoppedAnimatingUpdate = false;
-
-	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
-		debugInfo = true;
-		gameLocal.Printf( "---------------\n%d: entity '%s':\n", gameLocal.time, entity->GetName() );
-		gameLocal.Printf( "model '%s':\n", modelDef->GetModelName() );
-	} else {
-		debugInfo = false;
-	}
-
-	// init the joint buffer
-	if ( AFPoseJoints.Num() ) {
-		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
-		defaultPose = AFPoseJointFrame.Ptr();
-	} else {
-		defaultPose = modelDef->GetDefaultPose();
-	}
-
-	if ( !defaultPose ) {
-		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
-		return false;
-	}
 
 	numJoints = modelDef->Joints().Num();
-	idJointQuat *jointFrame = ( idJointQuat * )_alloca16( numJoints * sizeof( jointFrame[0] ) );
-	SIMDProcessor->Memcpy( jointFrame, defaultPose, numJoints * sizeof( jointFrame[0] ) );
-
 	hasAnim = false;
 
 	// blend the all channel
@@ -4299,13 +4287,112 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 		hasAnim = true;
 	}
 
-	if ( !hasAnim && !jointMods.Num() ) {
-		// no animations were updated
+	return hasAnim;
+}
+
+/*
+=====================
+idAnimator::CreateFrame
+=====================
+*/
+bool idAnimator::CreateFrame( int currentTime, bool force ) {
+	int					i, j;
+	int					numJoints;
+	int					parentNum;
+	bool				hasAnim;
+	bool				debugInfo;
+	const int *			jointParent;
+	const jointMod_t *	jointMod;
+	const idJointQuat *	defaultPose;
+
+	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+
+	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
 		return false;
 	}
 
-	// convert the joint quaternions to rotation matrices
-	SIMDProcessor->ConvertJointQuatsToJointMats( joints, jointFrame, numJoints );
+	if ( !modelDef || !modelDef->ModelHandle() ) {
+		return false;
+	}
+
+	if ( !force && !r_showSkel.GetInteger() ) {
+		if ( lastTransformTime == currentTime ) {
+			return false;
+		}
+		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+			return false;
+		}
+	}
+
+	lastTransformTime = currentTime;
+	stoppedAnimatingUpdate = false;
+
+	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
+		debugInfo = true;
+		gameLocal.Printf( "---------------\n%d: entity '%s':\n", gameLocal.time, entity->GetName() );
+		gameLocal.Printf( "model '%s':\n", modelDef->GetModelName() );
+	} else {
+		debugInfo = false;
+	}
+
+	// init the joint buffer
+	if ( AFPoseJoints.Num() ) {
+		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
+		defaultPose = AFPoseJointFrame.Ptr();
+	} else {
+		defaultPose = modelDef->GetDefaultPose();
+	}
+
+	if ( !defaultPose ) {
+		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
+		return false;
+	}
+
+	numJoints = modelDef->Joints().Num();
+
+	// animators in the same state share the blended joints, the IK and the
+	// other joint modifiers are added for each entity
+	const bool usePoseCache = g_poseCache.GetBool() && !AFPoseJoints.Num() && !debugInfo;
+	const animPose_t *pose = NULL;
+	animPoseKey_t poseKey;
+	if ( usePoseCache ) {
+		memset( &poseKey, 0, sizeof( poseKey ) );
+		poseKey.modelDef = modelDef;
+		poseKey.removeOriginOffset = removeOriginOffset;
+		for( i = 0; i < ANIM_NumAnimChannels; i++ ) {
+			for( j = 0; j < ANIM_MaxAnimsPerChannel; j++ ) {
+				channels[ i ][ j ].GetPoseKey( currentTime, poseKey.blends[ i ][ j ] );
+			}
+		}
+		pose = animPoseCache.FindPose( poseKey );
+	}
+
+	if ( !pose ) {
+		idJointQuat *jointFrame = ( idJointQuat * )_alloca16( numJoints * sizeof( jointFrame[0] ) );
+		SIMDProcessor->Memcpy( jointFrame, defaultPose, numJoints * sizeof( jointFrame[0] ) );
+
+		hasAnim = BlendChannels( currentTime, jointFrame, debugInfo );
+
+		if ( !hasAnim && !jointMods.Num() ) {
+			// no animations were updated
+			return false;
+		}
+
+		// convert the joint quaternions to rotation matrices
+		SIMDProcessor->ConvertJointQuatsToJointMats( joints, jointFrame, numJoints );
+
+		if ( usePoseCache && hasAnim ) {
+			pose = animPoseCache.AddPose( poseKey, joints, numJoints );
+		}
+	} else if ( jointMods.Num() ) {
+		SIMDProcessor->Memcpy( joints, pose->localJoints, numJoints * sizeof( joints[0] ) );
+	}
+
+	if ( pose && !jointMods.Num() ) {
+		// the model space joints are shared as well
+		SIMDProcessor->Memcpy( joints, pose->modelJoints, numJoints * sizeof( joints[0] ) );
+		return true;
+	}
 
 	// check if we need to modify the origin
 	if ( jointMods.Num() && ( jointMods[0]->jointnum == 0 ) ) {
@@ -4679,6 +4766,177 @@ const idVec3 &idAnimator::TotalMovementDelta( int animNum ) const {
 	}
 }
 
+/***********************************************************************
+
+	idAnimPoseCache
+
+***********************************************************************/
+
+// CreateFrame runs on the job threads with g_parallelAnim
+static std::mutex poseCacheLock;
+
+/*
+=====================
+PoseKeyHash
+=====================
+*/
+static int PoseKeyHash( const animPoseKey_t &key ) {
+	const unsigned int *data = reinterpret_cast<const unsigned int *>( &key );
+	unsigned int hash = 0;
+
+	for( int i = 0; i < (int)( sizeof( key ) / sizeof( data[0] ) ); i++ ) {
+		hash = hash * 31 + data[ i ];
+	}
+	return (int)( hash & 0x7fffffff );
+}
+
+/*
+=====================
+idAnimPoseCache::idAnimPoseCache
+=====================
+*/
+idAnimPoseCache::idAnimPoseCache() {
+	numPoses = 0;
+	numHits = 0;
+	numMisses = 0;
+}
+
+/*
+=====================
+idAnimPoseCache::~idAnimPoseCache
+=====================
+*/
+idAnimPoseCache::~idAnimPoseCache() {
+	Shutdown();
+}
+
+/*
+=====================
+idAnimPoseCache::Shutdown
+=====================
+*/
+void idAnimPoseCache::Shutdown( void ) {
+	int i;
+
+	for( i = 0; i < poses.Num(); i++ ) {
+		Mem_Free16( poses[ i ]->localJoints );
+		Mem_Free16( poses[ i ]->modelJoints );
+		delete poses[ i ];
+	}
+	poses.Clear();
+	poseHash.Free();
+	numPoses = 0;
+	numHits = 0;
+	numMisses = 0;
+}
+
+/*
+=====================
+idAnimPoseCache::BeginFrame
+
+  The poses are only shared within a frame, the anim pointers in the keys
+  may not be valid anymore after it.  The memory is kept for the next frame.
+=====================
+*/
+void idAnimPoseCache::BeginFrame( void ) {
+	if ( g_showPoseCache.GetBool() && ( numHits || numMisses ) ) {
+		gameLocal.Printf( "poseCache: %d hits %d misses (%d%%) %d poses\n", numHits, numMisses, numHits * 100 / ( numHits + numMisses ), numPoses );
+	}
+
+	numPoses = 0;
+	numHits = 0;
+	numMisses = 0;
+	poseHash.Clear();
+}
+
+/*
+=====================
+idAnimPoseCache::FindPose
+=====================
+*/
+const animPose_t *idAnimPoseCache::FindPose( const animPoseKey_t &key ) {
+	const int hash = PoseKeyHash( key );
+	const animPose_t *pose = NULL;
+	int i;
+
+	poseCacheLock.lock();
+	for( i = poseHash.First( hash ); i != -1; i = poseHash.Next( i ) ) {
+		if ( !memcmp( &poses[ i ]->key, &key, sizeof( key ) ) ) {
+			pose = poses[ i ];
+			break;
+		}
+	}
+	if ( pose ) {
+		numHits++;
+	} else {
+		numMisses++;
+	}
+	poseCacheLock.unlock();
+
+	return pose;
+}
+
+/*
+=====================
+idAnimPoseCache::AddPose
+
+  Stores the joints CreateFrame converted from the blended quaternions and
+  transforms them to model space the way CreateFrame does without joint
+  modifiers.  The poses don't change until the next frame once they can be
+  found, so they are read without the lock.
+=====================
+*/
+const animPose_t *idAnimPoseCache::AddPose( const animPoseKey_t &key, const idJointMat *localJoints, int numJoints ) {
+	const int hash = PoseKeyHash( key );
+	animPose_t *pose;
+	int index;
+	int i;
+
+	poseCacheLock.lock();
+	if ( numPoses >= poses.Num() ) {
+		pose = new animPose_t;
+		pose->numJoints = 0;
+		pose->maxJoints = 0;
+		pose->localJoints = NULL;
+		pose->modelJoints = NULL;
+		poses.Append( pose );
+	}
+	index = numPoses++;
+	pose = poses[ index ];
+	poseCacheLock.unlock();
+
+	if ( pose->maxJoints < numJoints ) {
+		Mem_Free16( pose->localJoints );
+		Mem_Free16( pose->modelJoints );
+		pose->localJoints = ( idJointMat * )Mem_Alloc16( numJoints * sizeof( pose->localJoints[0] ) );
+		pose->modelJoints = ( idJointMat * )Mem_Alloc16( numJoints * sizeof( pose->modelJoints[0] ) );
+		pose->maxJoints = numJoints;
+	}
+
+	pose->key = key;
+	pose->numJoints = numJoints;
+	SIMDProcessor->Memcpy( pose->localJoints, localJoints, numJoints * sizeof( localJoints[0] ) );
+	SIMDProcessor->Memcpy( pose->modelJoints, localJoints, numJoints * sizeof( localJoints[0] ) );
+	pose->modelJoints[0].SetTranslation( pose->modelJoints[0].ToVec3() + key.modelDef->GetVisualOffset() );
+	SIMDProcessor->TransformJoints( pose->modelJoints, key.modelDef->JointParents(), 1, numJoints - 1 );
+
+	// another thread may have added the same pose in the meantime, this one is then unused until the next frame
+	poseCacheLock.lock();
+	for( i = poseHash.First( hash ); i != -1; i = poseHash.Next( i ) ) {
+		if ( !memcmp( &poses[ i ]->key, &key, sizeof( key ) ) ) {
+			break;
+		}
+	}
+	if ( i == -1 ) {
+		poseHash.Add( hash, index );
+	} else {
+		pose = poses[ i ];
+	}
+	poseCacheLock.unlock();
+
+	return pose;
+}
+
 /***********************************************************************
 
 	Util functions
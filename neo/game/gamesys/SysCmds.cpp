@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/LangDict.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/FileSystem.h"
+#include "idlib/Timer.h"
 
 #include "gamesys/TypeInfo.h"
 #include "gamesys/SysCvar.h"
@@ -196,6 +197,82 @@ void Cmd_Script_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_ScriptBenchmark_f
+
+Runs a script function without parameters a number of times, with and
+without the superinstructions, and prints how many statements ran and how
+long they took. The function must not wait, every run has to finish in
+one frame.
+==================
+*/
+void Cmd_ScriptBenchmark_f( const idCmdArgs &args ) {
+	const function_t *func;
+	idThread *		thread;
+	idTimer			timer;
+	bool			oldSuper;
+	int				runs;
+	int				mode;
+	int				i;
+	int				statements;
+	unsigned int	ms;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() < 2 ) {
+		gameLocal.Printf( "usage: scriptBenchmark <function> [runs]\n" );
+		return;
+	}
+
+	func = gameLocal.program.FindFunction( args.Argv( 1 ) );
+	if ( !func ) {
+		gameLocal.Printf( "Function '%s' not found\n", args.Argv( 1 ) );
+		return;
+	}
+
+	if ( func->parmTotal ) {
+		gameLocal.Printf( "Function '%s' takes parameters\n", args.Argv( 1 ) );
+		return;
+	}
+
+	runs = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 100;
+	if ( runs < 1 ) {
+		runs = 1;
+	}
+
+	oldSuper = g_scriptSuperInstructions.GetBool();
+
+	for( mode = 0; mode < 2; mode++ ) {
+		g_scriptSuperInstructions.SetBool( mode != 0 );
+
+		idInterpreter::ClearExecutedStatements();
+		timer.Clear();
+		timer.Start();
+		for( i = 0; i < runs; i++ ) {
+			thread = new idThread( func );
+			thread->ManualDelete();
+			thread->ManualControl();
+			if ( !thread->Start() ) {
+				gameLocal.Warning( "'%s' didn't finish in one frame", func->Name() );
+				delete thread;
+				break;
+			}
+			delete thread;
+		}
+		timer.Stop();
+
+		statements = idInterpreter::GetExecutedStatements();
+		ms = timer.Milliseconds();
+		gameLocal.Printf( "%-18s %d runs, %d statements, %u ms, %.2f ns per statement\n", mode ? "superinstructions:" : "plain:", i, statements, ms,
+			statements ? ms * 1000000.0f / statements : 0.0f );
+	}
+
+	g_scriptSuperInstructions.SetBool( oldSuper );
+}
+
 /*
 ==================
 KillEntities
@@ -1854,6 +1931,89 @@ static void Cmd_UnbindRagdoll_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_BenchRagdolls_f
+
+Spawns a grid of ragdolls in front of the player and prints the think time
+while they fall, to compare af_parallelIslands and the job thread counts
+==================
+*/
+static void Cmd_BenchRagdolls_f( const idCmdArgs &args ) {
+	int			i, count, frames, side;
+	float		yaw;
+	idVec3		org, forward, right;
+	idPlayer	*player;
+	idEntity	*ent;
+	idDict		dict;
+	idRandom	random;
+	idEntityPtr<idEntity> ragdoll;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk( false ) ) {
+		return;
+	}
+
+	if ( args.Argc() < 2 ) {
+		gameLocal.Printf( "usage: benchRagdolls <classname> [count] [frames]\n" );
+		return;
+	}
+
+	count = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, 256, atoi( args.Argv( 2 ) ) ) : 32;
+	frames = ( args.Argc() > 3 ) ? Max( 1, atoi( args.Argv( 3 ) ) ) : 300;
+
+	// remove the ragdolls of the previous run
+	for ( i = 0; i < gameLocal.benchRagdolls.Num(); i++ ) {
+		delete gameLocal.benchRagdolls[i].GetEntity();
+	}
+	gameLocal.benchRagdolls.Clear();
+	gameLocal.benchRagdollFrames = 0;
+
+	yaw = player->viewAngles.yaw;
+	idAngles( 0, yaw, 0 ).ToVectors( &forward, &right );
+	side = (int) idMath::Ceil( idMath::Sqrt( (float) count ) );
+
+	// always the same seed so the checksums of two runs can be compared
+	random.SetSeed( 0 );
+
+	for ( i = 0; i < count; i++ ) {
+		org = player->GetPhysics()->GetOrigin() + idVec3( 0, 0, 64 );
+		org += forward * ( 128.0f + ( i / side ) * 64.0f );
+		org += right * ( ( i % side ) - ( side - 1 ) * 0.5f ) * 64.0f;
+
+		dict.Clear();
+		dict.Set( "classname", args.Argv( 1 ) );
+		dict.Set( "angle", va( "%f", yaw + random.CRandomFloat() * 180.0f ) );
+		dict.Set( "origin", org.ToString() );
+
+		if ( !gameLocal.SpawnEntityDef( dict, &ent ) || !ent ) {
+			break;
+		}
+		if ( !ent->GetPhysics()->IsType( idPhysics_AF::Type ) ) {
+			gameLocal.Printf( "'%s' is not an articulated figure\n", args.Argv( 1 ) );
+			delete ent;
+			break;
+		}
+
+		// push them a little so they don't all fall the same way
+		ent->GetPhysics()->ApplyImpulse( 0, ent->GetPhysics()->GetOrigin( 0 ), idVec3( random.CRandomFloat(), random.CRandomFloat(), 0.5f ) * 1000.0f );
+
+		ragdoll = ent;
+		gameLocal.benchRagdolls.Append( ragdoll );
+	}
+
+	if ( !gameLocal.benchRagdolls.Num() ) {
+		return;
+	}
+
+	gameLocal.benchRagdollFrames = frames;
+	gameLocal.benchRagdollFrame = 0;
+	gameLocal.benchRagdollTime = 0.0;
+	gameLocal.benchRagdollMaxTime = 0.0;
+
+	gameLocal.Printf( "spawned %d ragdolls, measuring %d frames with af_parallelIslands %d\n", gameLocal.benchRagdolls.Num(), frames, af_parallelIslands.GetInteger() );
+}
+
 /*
 ==================
 Cmd_GameError_f
@@ -2361,6 +2521,7 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "testBlend",				idTestModel::TestBlend_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests animation blending" );
 	cmdSystem->AddCommand( "reloadScript",			Cmd_ReloadScript_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads scripts" );
 	cmdSystem->AddCommand( "script",				Cmd_Script_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"executes a line of script" );
+	cmdSystem->AddCommand( "scriptBenchmark",		Cmd_ScriptBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"times a script function with and without superinstructions" );
 	cmdSystem->AddCommand( "listCollisionModels",	Cmd_ListCollisionModels_f,	CMD_FL_GAME,				"lists collision models" );
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
 	cmdSystem->AddCommand( "reexportmodels",		Cmd_ReexportModels_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"reexports models", ArgCompletion_DefFile );
@@ -2375,6 +2536,7 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "saveRagdolls",			Cmd_SaveRagdolls_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"save all ragdoll poses to the .map file" );
 	cmdSystem->AddCommand( "bindRagdoll",			Cmd_BindRagdoll_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"binds ragdoll at the current drag position" );
 	cmdSystem->AddCommand( "unbindRagdoll",			Cmd_UnbindRagdoll_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"unbinds the selected ragdoll" );
+	cmdSystem->AddCommand( "benchRagdolls",			Cmd_BenchRagdolls_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"spawns ragdolls and measures the think time while they fall", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "saveLights",			Cmd_SaveLights_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"saves all lights to the .map file" );
 	cmdSystem->AddCommand( "saveParticles",			Cmd_SaveParticles_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"saves all lights to the .map file" );
 	cmdSystem->AddCommand( "clearLights",			Cmd_ClearLights_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"clears all lights" );
@@ -113,6 +113,8 @@ idCVar g_skipFX(					"g_skipFX",					"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_skipParticles(				"g_skipParticles",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 
 idCVar g_disasm(					"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
+idCVar g_binaryScripts(				"g_binaryScripts",			"1",			CVAR_GAME | CVAR_BOOL, "load the compiled scripts from a .bcs file under fs_savepath, written when missing or out of date" );
+idCVar g_scriptSuperInstructions(	"g_scriptSuperInstructions",	"1",			CVAR_GAME | CVAR_BOOL, "run common statement sequences as one instruction in the script interpreter" );
 idCVar g_debugBounds(				"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
 idCVar g_debugAnim(					"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
 idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -149,6 +151,11 @@ idCVar g_showEnemies(				"g_showEnemies",			"0",			CVAR_GAME | CVAR_BOOL, "draws
 
 idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "displays timing information for each game frame" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
+idCVar g_parallelAnim(				"g_parallelAnim",			"0",			CVAR_GAME | CVAR_BOOL, "build the frames of visible animating entities on the job threads after the think pass" );
+idCVar g_parallelTraces(			"g_parallelTraces",			"1",			CVAR_GAME | CVAR_BOOL, "run the collision queries of batched traces on the job threads" );
+idCVar g_quantizeAnims(			"g_quantizeAnims",			"0",			CVAR_GAME | CVAR_BOOL, "keep the frames of loaded anims as 16 bit values, applies to anims loaded afterwards or after reloadanims" );
+idCVar g_poseCache(				"g_poseCache",				"1",			CVAR_GAME | CVAR_BOOL, "share the blended joints between animators of the same model that are in the same state" );
+idCVar g_showPoseCache(			"g_showPoseCache",			"0",			CVAR_GAME | CVAR_BOOL, "print the pose cache hits and misses of every frame" );
 
 idCVar ai_debugScript(				"ai_debugScript",			"-1",			CVAR_GAME | CVAR_INTEGER, "displays script calls for the specified monster entity number" );
 idCVar ai_debugMove(				"ai_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "draws movement information for monsters" );
@@ -197,6 +204,7 @@ idCVar af_useLinearTime(			"af_useLinearTime",			"1",			CVAR_GAME | CVAR_BOOL, "
 idCVar af_useImpulseFriction(		"af_useImpulseFriction",	"0",			CVAR_GAME | CVAR_BOOL, "use impulse based contact friction" );
 idCVar af_useJointImpulseFriction(	"af_useJointImpulseFriction","0",			CVAR_GAME | CVAR_BOOL, "use impulse based joint friction" );
 idCVar af_useSymmetry(				"af_useSymmetry",			"1",			CVAR_GAME | CVAR_BOOL, "use constraint matrix symmetry" );
+idCVar af_parallelIslands(			"af_parallelIslands",		"0",			CVAR_GAME | CVAR_BOOL, "solve the moving articulated figures on the job threads before the think pass" );
 idCVar af_skipSelfCollision(		"af_skipSelfCollision",		"0",			CVAR_GAME | CVAR_BOOL, "skip self collision detection" );
 idCVar af_skipLimits(				"af_skipLimits",			"0",			CVAR_GAME | CVAR_BOOL, "skip joint limits" );
 idCVar af_skipFriction(				"af_skipFriction",			"0",			CVAR_GAME | CVAR_BOOL, "skip friction" );
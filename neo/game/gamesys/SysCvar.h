@@ -52,6 +52,8 @@ extern idCVar	g_hitEffect;
 extern idCVar	g_muzzleFlash;
 
 extern idCVar	g_disasm;
+extern idCVar	g_binaryScripts;
+extern idCVar	g_scriptSuperInstructions;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
 extern idCVar	g_debugMove;
@@ -86,6 +88,11 @@ extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
 extern idCVar	g_timeentities;
+extern idCVar	g_parallelAnim;
+extern idCVar	g_parallelTraces;
+extern idCVar	g_quantizeAnims;
+extern idCVar	g_poseCache;
+extern idCVar	g_showPoseCache;
 
 extern idCVar	ai_debugScript;
 extern idCVar	ai_debugMove;
@@ -127,6 +134,7 @@ extern idCVar	af_useLinearTime;
 extern idCVar	af_useImpulseFriction;
 extern idCVar	af_useJointImpulseFriction;
 extern idCVar	af_useSymmetry;
+extern idCVar	af_parallelIslands;
 extern idCVar	af_skipSelfCollision;
 extern idCVar	af_skipLimits;
 extern idCVar	af_skipFriction;
@@ -250,6 +250,29 @@ ID_INLINE const idTraceModel *idClipModel::GetTraceModel( void ) const {
 //
 //===============================================================
 
+// a point or box translation for idClip::TraceBatch
+typedef struct clipTrace_s {
+	idVec3					start;
+	idVec3					end;
+	idBounds				bounds;				// cleared bounds for a point trace
+	int						contentMask;
+	const idEntity *		passEntity;
+} clipTrace_t;
+
+// per trace state while a batch is running
+typedef struct clipBatchTrace_s {
+	const clipTrace_t *		trace;
+	trace_t *				results;
+	const idTraceModel *	trm;				// NULL for a point trace
+	float					radius;
+	int						sortKey;
+	int						firstClipModel;		// into idClip::batchClipModels
+	int						numClipModels;
+	int						hitClipModel;		// clip model the results come from, -1 for the world or no hit
+	int						numTranslations;
+	bool					done;				// blocked right away, nothing left to test
+} clipBatchTrace_t;
+
 class idClip {
 
 	friend class idClipModel;
@@ -277,6 +300,9 @@ public:
 								int contentMask, const idEntity *passEntity );
 	bool					TraceBounds( trace_t &results, const idVec3 &start, const idVec3 &end, const idBounds &bounds,
 								int contentMask, const idEntity *passEntity );
+	// runs many point and box translations together, the traces are sorted spatially
+	// and the collision model queries run on the job threads when there are any
+	void					TraceBatch( trace_t *results, const clipTrace_t *traces, const int numTraces );
 
 	// clip versus a specific model
 	void					TranslationModel( trace_t &results, const idVec3 &start, const idVec3 &end,
@@ -325,6 +351,10 @@ private:
 	int						numRenderModelTraces;
 	int						numContents;
 	int						numContacts;
+							// TraceBatch work space
+	idList<clipBatchTrace_t>	batchTraces;
+	idList<idTraceModel>	batchTraceModels;
+	idList<idClipModel *>	batchClipModels;
 
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
@@ -332,6 +362,8 @@ private:
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
+	static void				TraceBatchWorldJob( void *data, int index );
+	static void				TraceBatchEntitiesJob( void *data, int index );
 };
 
 
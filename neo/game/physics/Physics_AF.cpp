@@ -65,7 +65,8 @@ const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON
 #ifdef AF_TIMINGS
 static int lastTimerReset = 0;
 static int numArticulatedFigures = 0;
-static idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
+// the figures solved on the job threads count into the timers of those threads
+static thread_local idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
 #endif
 
 
@@ -6217,47 +6218,27 @@ const idBounds &idPhysics_AF::GetAbsBounds( int id ) const {
 
 /*
 ================
-idPhysics_AF::Evaluate
+idPhysics_AF::GetTimeStep
 ================
 */
-bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
-	float timeStep;
-
+float idPhysics_AF::GetTimeStep( int timeStepMSec, int endTimeMSec ) const {
 	if ( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) ) {
-		timeStep = MS2SEC( timeStepMSec ) * ( MS2SEC( endTimeMSec ) - timeScaleRampStart ) / ( timeScaleRampEnd - timeScaleRampStart );
+		return MS2SEC( timeStepMSec ) * ( MS2SEC( endTimeMSec ) - timeScaleRampStart ) / ( timeScaleRampEnd - timeScaleRampStart );
 	} else if ( af_timeScale.GetFloat() != 1.0f ) {
-		timeStep = MS2SEC( timeStepMSec ) * af_timeScale.GetFloat();
+		return MS2SEC( timeStepMSec ) * af_timeScale.GetFloat();
 	} else {
-		timeStep = MS2SEC( timeStepMSec ) * timeScale;
-	}
-	current.lastTimeStep = timeStep;
-
-
-	// if the articulated figure changed
-	if ( changedAF || ( linearTime != af_useLinearTime.GetBool() ) ) {
-		BuildTrees();
-		changedAF = false;
-		linearTime = af_useLinearTime.GetBool();
-	}
-
-	// get the new master position
-	if ( masterBody ) {
-		idVec3 masterOrigin;
-		idMat3 masterAxis;
-		self->GetMasterPosition( masterOrigin, masterAxis );
-		if ( current.atRest >= 0 && ( masterBody->current->worldOrigin != masterOrigin || masterBody->current->worldAxis != masterAxis ) ) {
-			Activate();
-		}
-		masterBody->current->worldOrigin = masterOrigin;
-		masterBody->current->worldAxis = masterAxis;
+		return MS2SEC( timeStepMSec ) * timeScale;
 	}
+}
 
-	// if the simulation is suspended because the figure is at rest
-	if ( current.atRest >= 0 || timeStep <= 0.0f ) {
-		DebugDraw();
-		return false;
-	}
+/*
+================
+idPhysics_AF::BeginStep
 
+  finds the contacts, the figure is expected not to be at rest
+================
+*/
+void idPhysics_AF::BeginStep( void ) {
 	// move the af velocity into the frame of a pusher
 	AddPushVelocity( -current.pushVelocity );
 
@@ -6278,7 +6259,17 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 #ifdef AF_TIMINGS
 	timer_collision.Stop();
 #endif
+}
+
+/*
+================
+idPhysics_AF::SolveStep
 
+  solves the constraints and evolves the bodies to the next state, only
+  touches the figure itself so it can run on a job thread
+================
+*/
+void idPhysics_AF::SolveStep( float timeStep, int endTimeMSec ) {
 	// evaluate constraint equations
 	EvaluateConstraints( timeStep );
 
@@ -6289,13 +6280,6 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	AddFrameConstraints();
 
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
-	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
-	}
-	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
-	}
 	timer_pc.Start();
 #endif
 
@@ -6319,6 +6303,24 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 
 	// evolve current state to next state
 	Evolve( timeStep );
+}
+
+/*
+================
+idPhysics_AF::FinishStep
+================
+*/
+void idPhysics_AF::FinishStep( float timeStep, int endTimeMSec ) {
+
+#ifdef AF_TIMINGS
+	int i, numPrimary = 0, numAuxiliary = 0;
+	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
+		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+	}
+	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+	}
+#endif
 
 	// debug graphics
 	DebugDraw();
@@ -6410,6 +6412,166 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		timer_lcp.Clear();
 	}
 #endif
+}
+
+/*
+================
+idPhysics_AF::IslandChanged
+
+  true if anything moved, pushed, woke up or changed the figure since the step was prepared
+================
+*/
+bool idPhysics_AF::IslandChanged( void ) const {
+	int i;
+
+	if ( changedAF || masterBody || islandBodyStates.Num() != bodies.Num() ) {
+		return true;
+	}
+	if ( memcmp( &current, &islandState, sizeof( current ) ) != 0 ) {
+		return true;
+	}
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		if ( memcmp( bodies[i]->current, &islandBodyStates[i], sizeof( AFBodyPState_t ) ) != 0 ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+================
+idPhysics_AF::DiscardIsland
+================
+*/
+void idPhysics_AF::DiscardIsland( void ) {
+	if ( islandTime == -1 ) {
+		return;
+	}
+	// the solve appended the frame constraints to the auxiliary constraints
+	RemoveFrameConstraints();
+	islandTime = -1;
+}
+
+/*
+================
+idPhysics_AF::PrepareIsland
+
+  Does the part of Evaluate before the solve for a figure that only interacts
+  with the other entities through the contacts and the collisions. The contacts
+  are found in the start of frame positions of the other entities, which is
+  why the island solver gives slightly different results than the serial one,
+  but the solve itself only reads the figure so the results don't depend on
+  the job threads. Evaluate falls back to the serial step if anything touched
+  the figure in between.
+================
+*/
+bool idPhysics_AF::PrepareIsland( int timeStepMSec, int endTimeMSec ) {
+	int i;
+	float timeStep;
+
+	DiscardIsland();
+
+	timeStep = GetTimeStep( timeStepMSec, endTimeMSec );
+
+	if ( current.atRest >= 0 || timeStep <= 0.0f ) {
+		return false;
+	}
+
+	// the master position and the push velocity come from the entities that think before this one
+	if ( masterBody || current.pushVelocity != vec6_origin ) {
+		return false;
+	}
+
+	// the suspension constraints trace against the world
+	for ( i = 0; i < constraints.Num(); i++ ) {
+		if ( constraints[i]->GetType() == CONSTRAINT_SUSPENSION ) {
+			return false;
+		}
+	}
+
+	current.lastTimeStep = timeStep;
+
+	// if the articulated figure changed
+	if ( changedAF || ( linearTime != af_useLinearTime.GetBool() ) ) {
+		BuildTrees();
+		changedAF = false;
+		linearTime = af_useLinearTime.GetBool();
+	}
+
+	BeginStep();
+
+	islandTime = endTimeMSec;
+	islandTimeStep = timeStep;
+	islandState = current;
+	islandBodyStates.SetNum( bodies.Num(), false );
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		islandBodyStates[i] = *bodies[i]->current;
+	}
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SolveIsland
+================
+*/
+void idPhysics_AF::SolveIsland( void ) {
+	assert( islandTime != -1 );
+
+	SolveStep( islandTimeStep, islandTime );
+}
+
+/*
+================
+idPhysics_AF::Evaluate
+================
+*/
+bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+	float timeStep;
+
+	timeStep = GetTimeStep( timeStepMSec, endTimeMSec );
+
+	// if the step was solved on a job thread and the figure didn't change since
+	if ( islandTime == endTimeMSec && islandTimeStep == timeStep && !IslandChanged() ) {
+		islandTime = -1;
+		FinishStep( timeStep, endTimeMSec );
+		return true;
+	}
+	DiscardIsland();
+
+	current.lastTimeStep = timeStep;
+
+	// if the articulated figure changed
+	if ( changedAF || ( linearTime != af_useLinearTime.GetBool() ) ) {
+		BuildTrees();
+		changedAF = false;
+		linearTime = af_useLinearTime.GetBool();
+	}
+
+	// get the new master position
+	if ( masterBody ) {
+		idVec3 masterOrigin;
+		idMat3 masterAxis;
+		self->GetMasterPosition( masterOrigin, masterAxis );
+		if ( current.atRest >= 0 && ( masterBody->current->worldOrigin != masterOrigin || masterBody->current->worldAxis != masterAxis ) ) {
+			Activate();
+		}
+		masterBody->current->worldOrigin = masterOrigin;
+		masterBody->current->worldAxis = masterAxis;
+	}
+
+	// if the simulation is suspended because the figure is at rest
+	if ( current.atRest >= 0 || timeStep <= 0.0f ) {
+		DebugDraw();
+		return false;
+	}
+
+	BeginStep();
+
+	SolveStep( timeStep, endTimeMSec );
+
+	FinishStep( timeStep, endTimeMSec );
 
 	return true;
 }
@@ -6605,6 +6767,9 @@ idPhysics_AF::idPhysics_AF( void ) {
 
 	lcp = idLCP::AllocSymmetric();
 
+	islandTime = -1;
+	islandTimeStep = 0.0f;
+
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
 	current.lastTimeStep = USERCMD_MSEC;
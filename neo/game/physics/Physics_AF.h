@@ -892,6 +892,10 @@ public:
 	void					SetForcePushable( const bool enable ) { forcePushable = enable; }
 							// update the clip model positions
 	void					UpdateClipModels( void );
+							// find the contacts and solve the step ahead of the think, returns false if the figure can't be solved on a job thread
+	bool					PrepareIsland( int timeStepMSec, int endTimeMSec );
+							// solve the prepared step, safe to call on a job thread, Evaluate finishes it
+	void					SolveIsland( void );
 
 public:	// common physics interface
 	void					SetClipModel( idClipModel *model, float density, int id = 0, bool freeOld = true );
@@ -1020,7 +1024,19 @@ private:
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
 
+							// step solved ahead of the think
+	int						islandTime;						// end time of the prepared step, -1 if none
+	float					islandTimeStep;					// time step of the prepared step
+	AFPState_t				islandState;					// state when the step was prepared
+	idList<AFBodyPState_t>	islandBodyStates;				// body states when the step was prepared
+
 private:
+	float					GetTimeStep( int timeStepMSec, int endTimeMSec ) const;
+	void					BeginStep( void );
+	void					SolveStep( float timeStep, int endTimeMSec );
+	void					FinishStep( float timeStep, int endTimeMSec );
+	bool					IslandChanged( void ) const;
+	void					DiscardIsland( void );
 	void					BuildTrees( void );
 	bool					IsClosedLoop( const idAFBody *body1, const idAFBody *body2 ) const;
 	void					PrimaryFactor( void );
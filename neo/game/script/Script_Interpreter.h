@@ -73,6 +73,7 @@ private:
 	void				SetString( idVarDef *def, const char *from );
 	const char			*GetString( idVarDef *def );
 	varEval_t			GetVariable( idVarDef *def );
+	varEval_t			GetOperand( intptr_t operand, int stack );
 	idEntity			*GetEntity( int entnum ) const;
 	idScriptObject		*GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
@@ -80,6 +81,9 @@ private:
 	void				LeaveFunction( idVarDef *returnDef );
 	void				CallEvent( const function_t *func, int argsize );
 	void				CallSysEvent( const function_t *func, int argsize );
+	void				DebugStatement( void );
+
+	static int			executedStatements;
 
 public:
 	bool				doneProcessing;
@@ -115,6 +119,10 @@ public:
 	bool				Execute( void );
 	void				Reset( void );
 
+	// number of statements run by all interpreters, for benchmarking
+	static int			GetExecutedStatements( void ) { return executedStatements; }
+	static void			ClearExecutedStatements( void ) { executedStatements = 0; }
+
 	bool				GetRegisterValue( const char *name, idStr &out, int scopeDepth );
 	int					GetCallstackDepth( void ) const;
 	const prstack_t		*GetCallstack( void ) const;
@@ -246,6 +254,20 @@ ID_INLINE varEval_t idInterpreter::GetVariable( idVarDef *def ) {
 	}
 }
 
+/*
+====================
+idInterpreter::GetOperand
+
+Operands of decoded instructions are addresses, or offsets in the locals
+of the current function for stack variables
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetOperand( intptr_t operand, int stack ) {
+	varEval_t val;
+	val.bytePtr = ( byte * )( operand + ( -( intptr_t )stack & ( intptr_t )&localstack[ localstackBase ] ) );
+	return val;
+}
+
 /*
 ================
 idInterpreter::GetEntity
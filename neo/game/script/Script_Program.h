@@ -94,6 +94,8 @@ Contains type information for variables and functions.
 ***********************************************************************/
 
 class idTypeDef {
+	friend class idProgram;
+
 private:
 	etype_t						type;
 	idStr						name;
@@ -433,6 +435,18 @@ typedef struct statement_s {
 	idVarDef		*c;
 } statement_t;
 
+// a statement decoded for the interpreter, see idProgram::DecodeStatements
+typedef struct scriptInstruction_s {
+	unsigned short	op[ 2 ];		// superinstruction or opcode, and the plain opcode for debugging
+	byte			numStatements;	// number of statements op[ 0 ] runs
+	byte			stackA;			// set for stack variables, the operand is an offset in the locals
+	byte			stackB;
+	byte			stackC;
+	intptr_t		a;				// address of the variable, or the jump offset, arg size,
+	intptr_t		b;				// virtual function number, field offset or function
+	intptr_t		c;
+} scriptInstruction_t;
+
 /***********************************************************************
 
 idProgram
@@ -455,6 +469,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idList<scriptInstruction_t>					instructions;
 	idList<idTypeDef *>							types;
 	idList<idVarDefName *>						varDefNames;
 	idHashIndex									varDefNameHash;
@@ -472,6 +487,10 @@ private:
 	byte										*ReserveMem(int size);
 	idVarDef									*AllocVarDef(idTypeDef *type, const char *name, idVarDef *scope);
 
+	bool										LoadBinaryProgram( const char *defaultScript );
+	bool										ReadBinaryProgram( idFile *fp );
+	void										WriteBinaryProgram( const char *defaultScript ) const;
+
 public:
 	idVarDef									*returnDef;
 	idVarDef									*returnStringDef;
@@ -523,6 +542,8 @@ public:
 
 	statement_t									*AllocStatement( void );
 	statement_t									&GetStatement( int index );
+	void										DecodeStatements( void );
+	const scriptInstruction_t					&GetInstruction( int index ) const { return instructions[ index ]; }
 	int											NumStatements( void ) { return statements.Num(); }
 
 	int											GetReturnedInteger( void );
@@ -35,6 +35,17 @@ If you have questions concerning this license or the applicable additional terms
 	#define USE_LIBC_MALLOC		0
 #endif
 
+// thread safe heap with a small block cache per thread
+#ifndef USE_MT_HEAP
+	#define USE_MT_HEAP			1
+#endif
+
+#if USE_MT_HEAP
+#include <atomic>
+#include <mutex>
+#include <new>
+#endif
+
 #ifndef CRASH_ON_STATIC_ALLOCATION
 //	#define CRASH_ON_STATIC_ALLOCATION
 #endif
@@ -45,16 +56,24 @@ If you have questions concerning this license or the applicable additional terms
 //
 //===============================================================
 
+#if USE_MT_HEAP
+// small blocks also store the index of the thread cache they came from
+#define SMALL_HEADER_SIZE		( (intptr_t) ( sizeof( byte ) + sizeof( byte ) + sizeof( byte ) ) )
+#else
 #define SMALL_HEADER_SIZE		( (intptr_t) ( sizeof( byte ) + sizeof( byte ) ) )
+#endif
 #define MEDIUM_HEADER_SIZE		( (intptr_t) ( sizeof( mediumHeapEntry_s ) + sizeof( byte ) ) )
 #define LARGE_HEADER_SIZE		( (intptr_t) ( sizeof( dword * ) + sizeof( byte ) ) )
 
 #define ALIGN_SIZE( bytes )		( ( (bytes) + ALIGN - 1 ) & ~(ALIGN - 1) )
 #define SMALL_ALIGN( bytes )	( ALIGN_SIZE( (bytes) + SMALL_HEADER_SIZE ) - SMALL_HEADER_SIZE )
 #define MEDIUM_SMALLEST_SIZE	( ALIGN_SIZE( 256 ) + ALIGN_SIZE( MEDIUM_HEADER_SIZE ) )
+#define SMALL_SIZE_INDEX( p )	( ((byte *)(p))[-2] )		// size / ALIGN of a small block
 
+struct heapThreadCache_s;
 
 class idHeap {
+	friend struct heapThreadCache_s;
 
 public:
 					idHeap( void );
@@ -102,10 +121,12 @@ private:
 	};
 
 	// variables
+#if !USE_MT_HEAP
 	void *			smallFirstFree[256/ALIGN+1];	// small heap allocator lists (for allocs of 1-255 bytes)
 	page_s *		smallCurPage;					// current page for small allocations
 	dword			smallCurPageOffset;				// byte offset in current page
 	page_s *		smallFirstUsedPage;				// first used page of the small heap manager
+#endif
 
 	page_s *		mediumFirstFreePage;			// first partially free page
 	page_s *		mediumLastFreePage;				// last partially free page
@@ -121,8 +142,6 @@ private:
 	dword			pageRequests;					// page requests
 	dword			OSAllocs;						// number of allocs made to the OS
 
-	int				c_heapAllocRunningCount;
-
 	void			*defragBlock;					// a single huge block that can be allocated
 													// at startup, then freed when needed
 
@@ -144,6 +163,151 @@ private:
 	void			FreePageReal( idHeap::page_s *p );
 };
 
+#if USE_MT_HEAP
+
+/*
+===============================================================================
+
+	Small allocations come from a cache owned by the allocating thread. The
+	cache carves its own pages and keeps its own free lists, so allocating
+	and freeing on the same thread takes no lock.
+
+	A block freed by another thread is pushed on a lock-free list of the
+	cache that owns it. Only the owner ever takes from that list, and it
+	takes the whole list at once, so there is no ABA problem.
+
+	Medium and large allocations and the page lists are behind heapLock.
+
+	The caches are never freed, a thread that exits releases its cache and
+	the next new thread adopts it with everything still on its free lists.
+
+===============================================================================
+*/
+
+#define MAX_HEAP_THREAD_CACHES	255					// the cache index is stored in a byte
+
+typedef struct {
+	std::atomic<int>		num;
+	std::atomic<int>		minSize;
+	std::atomic<int>		maxSize;
+	std::atomic<int>		totalSize;
+} memThreadStats_t;
+
+struct heapThreadCache_s {
+	enum {
+		NUM_SMALL_LISTS		= 256/idHeap::ALIGN+1
+	};
+
+	void *					firstFree[NUM_SMALL_LISTS];		// only used by the owning thread
+	std::atomic<void *>		remoteFree[NUM_SMALL_LISTS];	// blocks freed by other threads
+	idHeap::page_s *		curPage;						// current page for small allocations
+	dword					curPageOffset;					// byte offset in current page
+	idHeap::page_s *		firstUsedPage;					// pages filled by this cache, under heapLock
+	std::atomic<bool>		inUse;							// owned by a running thread
+	int						index;
+
+	// the Mem_* statistics of this thread, written by the owner only
+	std::atomic<int>		statsFrame;						// mem_statsFrame the frame stats are for
+	memThreadStats_t		frameAllocs;
+	memThreadStats_t		frameFrees;
+	memThreadStats_t		totalAllocs;
+};
+
+typedef struct heapThreadCache_s heapThreadCache_t;
+
+static std::mutex			heapLock;
+static heapThreadCache_t *	heapThreadCaches[MAX_HEAP_THREAD_CACHES];
+static std::atomic<int>		numHeapThreadCaches( 0 );
+
+// releases the cache of a thread when it exits
+class idHeapThreadCacheRef {
+public:
+	heapThreadCache_t *		cache;
+
+							~idHeapThreadCacheRef( void ) {
+								if ( cache ) {
+									cache->inUse.store( false, std::memory_order_release );
+								}
+							}
+};
+
+static thread_local idHeapThreadCacheRef heapThreadCacheRef;
+
+/*
+==================
+Mem_ClearThreadStats
+==================
+*/
+static void Mem_ClearThreadStats( memThreadStats_t &stats ) {
+	stats.num.store( 0, std::memory_order_relaxed );
+	stats.minSize.store( 0x0fffffff, std::memory_order_relaxed );
+	stats.maxSize.store( -1, std::memory_order_relaxed );
+	stats.totalSize.store( 0, std::memory_order_relaxed );
+}
+
+/*
+==================
+Mem_AcquireThreadCache
+==================
+*/
+static heapThreadCache_t *Mem_AcquireThreadCache( void ) {
+	int num = numHeapThreadCaches.load( std::memory_order_acquire );
+
+	// adopt the cache of a thread that has exited
+	for ( int i = 0; i < num; i++ ) {
+		bool expected = false;
+		if ( heapThreadCaches[i]->inUse.compare_exchange_strong( expected, true, std::memory_order_acquire ) ) {
+			return heapThreadCaches[i];
+		}
+	}
+
+	std::lock_guard<std::mutex> lock( heapLock );
+
+	num = numHeapThreadCaches.load( std::memory_order_relaxed );
+	if ( num >= MAX_HEAP_THREAD_CACHES ) {
+		idLib::common->FatalError( "Mem_AcquireThreadCache: more than %d threads", MAX_HEAP_THREAD_CACHES );
+	}
+
+	void *mem = ::malloc( sizeof( heapThreadCache_t ) );
+	if ( !mem ) {
+		idLib::common->FatalError( "malloc failure for %i", (int)sizeof( heapThreadCache_t ) );
+	}
+	heapThreadCache_t *cache = new ( mem ) heapThreadCache_t;
+	for ( int i = 0; i < heapThreadCache_t::NUM_SMALL_LISTS; i++ ) {
+		cache->firstFree[i] = NULL;
+		cache->remoteFree[i].store( NULL, std::memory_order_relaxed );
+	}
+	cache->curPage = NULL;
+	cache->curPageOffset = 0;
+	cache->firstUsedPage = NULL;
+	cache->inUse.store( true, std::memory_order_relaxed );
+	cache->index = num;
+	cache->statsFrame.store( 0, std::memory_order_relaxed );
+	Mem_ClearThreadStats( cache->frameAllocs );
+	Mem_ClearThreadStats( cache->frameFrees );
+	Mem_ClearThreadStats( cache->totalAllocs );
+
+	heapThreadCaches[num] = cache;
+	numHeapThreadCaches.store( num + 1, std::memory_order_release );
+
+	return cache;
+}
+
+/*
+==================
+Mem_ThreadCache
+==================
+*/
+static ID_INLINE heapThreadCache_t *Mem_ThreadCache( void ) {
+	heapThreadCache_t *cache = heapThreadCacheRef.cache;
+	if ( !cache ) {
+		cache = heapThreadCacheRef.cache = Mem_AcquireThreadCache();
+	}
+	return cache;
+}
+
+#endif
+
 
 /*
 ================
@@ -159,19 +323,19 @@ void idHeap::Init () {
 	largeFirstUsedPage	= NULL;								// init large heap manager
 	swapPage			= NULL;
 
+#if !USE_MT_HEAP
 	memset( smallFirstFree, 0, sizeof(smallFirstFree) );	// init small heap manager
 	smallFirstUsedPage	= NULL;
 	smallCurPage		= AllocatePage( pageSize );
 	assert( smallCurPage );
 	smallCurPageOffset	= SMALL_ALIGN( 0 );
+#endif
 
 	defragBlock = NULL;
 
 	mediumFirstFreePage	= NULL;								// init medium heap manager
 	mediumLastFreePage	= NULL;
 	mediumFirstUsedPage	= NULL;
-
-	c_heapAllocRunningCount = 0;
 }
 
 /*
@@ -194,6 +358,30 @@ idHeap::~idHeap( void ) {
 
 	idHeap::page_s	*p;
 
+#if USE_MT_HEAP
+	// empty the thread caches, threads still running start over with new pages
+	int numCaches = numHeapThreadCaches.load( std::memory_order_acquire );
+	for ( int i = 0; i < numCaches; i++ ) {
+		heapThreadCache_t *cache = heapThreadCaches[i];
+
+		if ( cache->curPage ) {
+			FreePage( cache->curPage );
+		}
+		p = cache->firstUsedPage;
+		while( p ) {
+			idHeap::page_s *next = p->next;
+			FreePage( p );
+			p = next;
+		}
+		for ( int j = 0; j < heapThreadCache_t::NUM_SMALL_LISTS; j++ ) {
+			cache->firstFree[j] = NULL;
+			cache->remoteFree[j].store( NULL, std::memory_order_relaxed );
+		}
+		cache->curPage = NULL;
+		cache->curPageOffset = 0;
+		cache->firstUsedPage = NULL;
+	}
+#else
 	if ( smallCurPage ) {
 		FreePage( smallCurPage );			// free small-heap current allocation page
 	}
@@ -203,6 +391,7 @@ idHeap::~idHeap( void ) {
 		FreePage( p );
 		p= next;
 	}
+#endif
 
 	p = largeFirstUsedPage;					// free large-heap allocated pages
 	while( p ) {
@@ -264,7 +453,6 @@ void *idHeap::Allocate( const dword bytes ) {
 	if ( !bytes ) {
 		return NULL;
 	}
-	c_heapAllocRunningCount++;
 
 #if USE_LIBC_MALLOC
 	return malloc( bytes );
@@ -272,6 +460,9 @@ void *idHeap::Allocate( const dword bytes ) {
 	if ( !(bytes & ~255) ) {
 		return SmallAllocate( bytes );
 	}
+#if USE_MT_HEAP
+	std::lock_guard<std::mutex> lock( heapLock );
+#endif
 	if ( !(bytes & ~32767) ) {
 		return MediumAllocate( bytes );
 	}
@@ -288,7 +479,6 @@ void idHeap::Free( void *p ) {
 	if ( !p ) {
 		return;
 	}
-	c_heapAllocRunningCount--;
 
 #if USE_LIBC_MALLOC
 	free( p );
@@ -299,10 +489,16 @@ void idHeap::Free( void *p ) {
 			break;
 		}
 		case MEDIUM_ALLOC: {
+#if USE_MT_HEAP
+			std::lock_guard<std::mutex> lock( heapLock );
+#endif
 			MediumFree( p );
 			break;
 		}
 		case LARGE_ALLOC: {
+#if USE_MT_HEAP
+			std::lock_guard<std::mutex> lock( heapLock );
+#endif
 			LargeFree( p );
 			break;
 		}
@@ -324,6 +520,9 @@ void *idHeap::Allocate16( const dword bytes ) {
 
 	ptr = (byte *) malloc( bytes + 16 + sizeof(intptr_t) );
 	if ( !ptr ) {
+#if USE_MT_HEAP
+		std::lock_guard<std::mutex> lock( heapLock );
+#endif
 		if ( defragBlock ) {
 			idLib::common->Printf( "Freeing defragBlock on alloc of %i.\n", bytes );
 			free( defragBlock );
@@ -377,7 +576,7 @@ dword idHeap::Msize( void *p ) {
 #else
 	switch( ((byte *)(p))[-1] ) {
 		case SMALL_ALLOC: {
-			return SMALL_ALIGN( ((byte *)(p))[-SMALL_HEADER_SIZE] * ALIGN );
+			return SMALL_ALIGN( SMALL_SIZE_INDEX( p ) * ALIGN );
 		}
 		case MEDIUM_ALLOC: {
 			return ((mediumHeapEntry_s *)(((byte *)(p)) - ALIGN_SIZE( MEDIUM_HEADER_SIZE )))->size - ALIGN_SIZE( MEDIUM_HEADER_SIZE );
@@ -403,6 +602,24 @@ idHeap::Dump
 void idHeap::Dump( void ) {
 	idHeap::page_s	*pg;
 
+#if USE_MT_HEAP
+	std::lock_guard<std::mutex> lock( heapLock );
+
+	int numCaches = numHeapThreadCaches.load( std::memory_order_acquire );
+	for ( int i = 0; i < numCaches; i++ ) {
+		const heapThreadCache_t *cache = heapThreadCaches[i];
+
+		for ( pg = cache->firstUsedPage; pg; pg = pg->next ) {
+			idLib::common->Printf( "%p  bytes %-8d  (in use by small heap of thread cache %d)\n", pg->data, pg->dataSize, i );
+		}
+
+		// pages are only switched under the lock
+		if ( cache->curPage ) {
+			pg = cache->curPage;
+			idLib::common->Printf( "%p  bytes %-8d  (small heap active page of thread cache %d)\n", pg->data, pg->dataSize, i );
+		}
+	}
+#else
 	for ( pg = smallFirstUsedPage; pg; pg = pg->next ) {
 		idLib::common->Printf( "%p  bytes %-8d  (in use by small heap)\n", pg->data, pg->dataSize);
 	}
@@ -411,6 +628,7 @@ void idHeap::Dump( void ) {
 		pg = smallCurPage;
 		idLib::common->Printf( "%p  bytes %-8d  (small heap active page)\n", pg->data, pg->dataSize );
 	}
+#endif
 
 	for ( pg = mediumFirstUsedPage; pg; pg = pg->next ) {
 		idLib::common->Printf( "%p  bytes %-8d  (completely used by medium heap)\n", pg->data, pg->dataSize );
@@ -551,6 +769,46 @@ void *idHeap::SmallAllocate( dword bytes ) {
 	// increase the number of bytes if necessary to make sure the next small allocation is aligned
 	bytes = SMALL_ALIGN( bytes );
 
+#if USE_MT_HEAP
+	heapThreadCache_t *cache = Mem_ThreadCache();
+	dword ix = bytes / ALIGN;
+
+	byte *smallBlock = (byte *)(cache->firstFree[ix]);
+	if ( !smallBlock && cache->remoteFree[ix].load( std::memory_order_relaxed ) ) {
+		// take back everything other threads have freed to us
+		smallBlock = (byte *)cache->remoteFree[ix].exchange( NULL, std::memory_order_acquire );
+	}
+	if ( smallBlock ) {
+		intptr_t *link = (intptr_t *)(smallBlock + SMALL_HEADER_SIZE);
+		smallBlock[2] = SMALL_ALLOC;					// allocation identifier
+		cache->firstFree[ix] = (void *)(*link);
+		return (void *)(link);
+	}
+
+	// if we need to allocate a new page
+	if ( !cache->curPage || bytes >= (size_t)(pageSize) - cache->curPageOffset ) {
+		std::lock_guard<std::mutex> lock( heapLock );
+
+		if ( cache->curPage ) {
+			cache->curPage->next	= cache->firstUsedPage;
+			cache->firstUsedPage	= cache->curPage;
+		}
+		cache->curPage			= AllocatePage( pageSize );
+		if ( !cache->curPage ) {
+			return NULL;
+		}
+		// make sure the first allocation is aligned
+		cache->curPageOffset	= SMALL_ALIGN( 0 );
+	}
+
+	smallBlock				= ((byte *)cache->curPage->data) + cache->curPageOffset;
+	smallBlock[0]			= (byte)cache->index;			// owning thread cache
+	smallBlock[1]			= (byte)ix;						// write # of bytes/ALIGN
+	smallBlock[2]			= SMALL_ALLOC;					// allocation identifier
+	cache->curPageOffset	+= bytes + SMALL_HEADER_SIZE;	// increase the offset on the current page
+	return ( smallBlock + SMALL_HEADER_SIZE );				// skip the header
+#else
+
 	byte *smallBlock = (byte *)(smallFirstFree[bytes / ALIGN]);
 	if ( smallBlock ) {
 		intptr_t *link = (intptr_t *)(smallBlock + SMALL_HEADER_SIZE);
@@ -578,6 +836,7 @@ void *idHeap::SmallAllocate( dword bytes ) {
 	smallBlock[1]		= SMALL_ALLOC;					// allocation identifier
 	smallCurPageOffset  += bytes + SMALL_HEADER_SIZE;	// increase the offset on the current page
 	return ( smallBlock + SMALL_HEADER_SIZE );			// skip the first two bytes
+#endif
 }
 
 /*
@@ -594,15 +853,35 @@ void idHeap::SmallFree( void *ptr ) {
 	byte *d = ( (byte *)ptr ) - SMALL_HEADER_SIZE;
 	intptr_t *link = (intptr_t *)ptr;
 	// index into the table with free small memory blocks
-	dword ix = *d;
+	dword ix = SMALL_SIZE_INDEX( ptr );
 
 	// check if the index is correct
 	if ( ix > (256 / ALIGN) ) {
 		idLib::common->FatalError( "SmallFree: invalid memory block" );
 	}
 
+#if USE_MT_HEAP
+	int owner = d[0];
+	if ( owner >= numHeapThreadCaches.load( std::memory_order_relaxed ) ) {
+		idLib::common->FatalError( "SmallFree: invalid memory block" );
+	}
+	heapThreadCache_t *cache = heapThreadCaches[owner];
+
+	if ( cache == heapThreadCacheRef.cache ) {
+		*link = (intptr_t)cache->firstFree[ix];	// write next index
+		cache->firstFree[ix] = (void *)d;		// link
+		return;
+	}
+
+	// push it on the list of the owning thread
+	void *head = cache->remoteFree[ix].load( std::memory_order_relaxed );
+	do {
+		*link = (intptr_t)head;
+	} while ( !cache->remoteFree[ix].compare_exchange_weak( head, (void *)d, std::memory_order_release, std::memory_order_relaxed ) );
+#else
 	*link = (intptr_t)smallFirstFree[ix];	// write next index
 	smallFirstFree[ix] = (void *)d;		// link
+#endif
 }
 
 //===============================================================
@@ -986,20 +1265,92 @@ void idHeap::LargeFree( void *ptr) {
 #undef new
 
 static idHeap *			mem_heap = NULL;
+
+#if USE_MT_HEAP
+
+// every thread keeps its own statistics in its heap cache, they are summed
+// up when asked for. Clearing the frame stats starts a new stats frame, the
+// threads reset their frame stats when they see it.
+static std::atomic<int>	mem_statsFrame( 0 );
+
+/*
+==================
+Mem_SumThreadStats
+==================
+*/
+static void Mem_SumThreadStats( memoryStats_t &sum, const memThreadStats_t &stats ) {
+	int num = stats.num.load( std::memory_order_relaxed );
+	int minSize = stats.minSize.load( std::memory_order_relaxed );
+	int maxSize = stats.maxSize.load( std::memory_order_relaxed );
+
+	sum.num += num;
+	sum.totalSize += stats.totalSize.load( std::memory_order_relaxed );
+	if ( minSize < sum.minSize ) {
+		sum.minSize = minSize;
+	}
+	if ( maxSize > sum.maxSize ) {
+		sum.maxSize = maxSize;
+	}
+}
+
+/*
+==================
+Mem_UpdateThreadStats
+==================
+*/
+static void Mem_UpdateThreadStats( memThreadStats_t &stats, int size ) {
+	// only the owning thread writes, the atomics are for the readers
+	stats.num.store( stats.num.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	if ( size < stats.minSize.load( std::memory_order_relaxed ) ) {
+		stats.minSize.store( size, std::memory_order_relaxed );
+	}
+	if ( size > stats.maxSize.load( std::memory_order_relaxed ) ) {
+		stats.maxSize.store( size, std::memory_order_relaxed );
+	}
+	stats.totalSize.store( stats.totalSize.load( std::memory_order_relaxed ) + size, std::memory_order_relaxed );
+}
+
+/*
+==================
+Mem_ThreadStatsCache
+
+  the heap cache of this thread with its frame stats brought up to date
+==================
+*/
+static heapThreadCache_t *Mem_ThreadStatsCache( void ) {
+	heapThreadCache_t *cache = Mem_ThreadCache();
+	int frame = mem_statsFrame.load( std::memory_order_relaxed );
+
+	if ( cache->statsFrame.load( std::memory_order_relaxed ) != frame ) {
+		Mem_ClearThreadStats( cache->frameAllocs );
+		Mem_ClearThreadStats( cache->frameFrees );
+		cache->statsFrame.store( frame, std::memory_order_relaxed );
+	}
+	return cache;
+}
+
+#else
+
 static memoryStats_t	mem_total_allocs = { 0, 0x0fffffff, -1, 0 };
 static memoryStats_t	mem_frame_allocs;
 static memoryStats_t	mem_frame_frees;
 
+#endif
+
 /*
 ==================
 Mem_ClearFrameStats
 ==================
 */
 void Mem_ClearFrameStats( void ) {
+#if USE_MT_HEAP
+	mem_statsFrame.fetch_add( 1, std::memory_order_relaxed );
+#else
 	mem_frame_allocs.num = mem_frame_frees.num = 0;
 	mem_frame_allocs.minSize = mem_frame_frees.minSize = 0x0fffffff;
 	mem_frame_allocs.maxSize = mem_frame_frees.maxSize = -1;
 	mem_frame_allocs.totalSize = mem_frame_frees.totalSize = 0;
+#endif
 }
 
 /*
@@ -1008,8 +1359,26 @@ Mem_GetFrameStats
 ==================
 */
 void Mem_GetFrameStats( memoryStats_t &allocs, memoryStats_t &frees ) {
+#if USE_MT_HEAP
+	int frame = mem_statsFrame.load( std::memory_order_relaxed );
+	int numCaches = numHeapThreadCaches.load( std::memory_order_acquire );
+
+	allocs.num = frees.num = 0;
+	allocs.minSize = frees.minSize = 0x0fffffff;
+	allocs.maxSize = frees.maxSize = -1;
+	allocs.totalSize = frees.totalSize = 0;
+
+	for ( int i = 0; i < numCaches; i++ ) {
+		const heapThreadCache_t *cache = heapThreadCaches[i];
+		if ( cache->statsFrame.load( std::memory_order_relaxed ) == frame ) {
+			Mem_SumThreadStats( allocs, cache->frameAllocs );
+			Mem_SumThreadStats( frees, cache->frameFrees );
+		}
+	}
+#else
 	allocs = mem_frame_allocs;
 	frees = mem_frame_frees;
+#endif
 }
 
 /*
@@ -1018,7 +1387,21 @@ Mem_GetStats
 ==================
 */
 void Mem_GetStats( memoryStats_t &stats ) {
+#if USE_MT_HEAP
+	int numCaches = numHeapThreadCaches.load( std::memory_order_acquire );
+
+	stats.num = 0;
+	stats.minSize = 0x0fffffff;
+	stats.maxSize = -1;
+	stats.totalSize = 0;
+
+	// frees on another thread make a thread's own count go negative, only the sum means something
+	for ( int i = 0; i < numCaches; i++ ) {
+		Mem_SumThreadStats( stats, heapThreadCaches[i]->totalAllocs );
+	}
+#else
 	stats = mem_total_allocs;
+#endif
 }
 
 /*
@@ -1043,8 +1426,14 @@ Mem_UpdateAllocStats
 ==================
 */
 void Mem_UpdateAllocStats( int size ) {
+#if USE_MT_HEAP
+	heapThreadCache_t *cache = Mem_ThreadStatsCache();
+	Mem_UpdateThreadStats( cache->frameAllocs, size );
+	Mem_UpdateThreadStats( cache->totalAllocs, size );
+#else
 	Mem_UpdateStats( mem_frame_allocs, size );
 	Mem_UpdateStats( mem_total_allocs, size );
+#endif
 }
 
 /*
@@ -1053,9 +1442,16 @@ Mem_UpdateFreeStats
 ==================
 */
 void Mem_UpdateFreeStats( int size ) {
+#if USE_MT_HEAP
+	heapThreadCache_t *cache = Mem_ThreadStatsCache();
+	Mem_UpdateThreadStats( cache->frameFrees, size );
+	cache->totalAllocs.num.store( cache->totalAllocs.num.load( std::memory_order_relaxed ) - 1, std::memory_order_relaxed );
+	cache->totalAllocs.totalSize.store( cache->totalAllocs.totalSize.load( std::memory_order_relaxed ) - size, std::memory_order_relaxed );
+#else
 	Mem_UpdateStats( mem_frame_frees, size );
 	mem_total_allocs.num--;
 	mem_total_allocs.totalSize -= size;
+#endif
 }
 
 
@@ -1160,6 +1556,9 @@ Mem_ClearedAlloc
 ==================
 */
 void Mem_AllocDefragBlock( void ) {
+#if USE_MT_HEAP
+	std::lock_guard<std::mutex> lock( heapLock );
+#endif
 	mem_heap->AllocDefragBlock();
 }
 
@@ -1243,6 +1642,10 @@ typedef struct debugMemory_s {
 } debugMemory_t;
 
 static debugMemory_t *	mem_debugMemory = NULL;
+#if USE_MT_HEAP
+// recursive, the dumps allocate while walking the list
+static std::recursive_mutex	mem_debugMemoryLock;
+#endif
 static char				mem_leakName[256] = "";
 
 /*
@@ -1296,6 +1699,10 @@ void Mem_Dump( const char *fileName ) {
 		return;
 	}
 
+#if USE_MT_HEAP
+	std::lock_guard<std::recursive_mutex> lock( mem_debugMemoryLock );
+#endif
+
 	totalSize = 0;
 	for ( numBlocks = 0, b = mem_debugMemory; b; b = b->next, numBlocks++ ) {
 		ptr = ((char *) b) + sizeof(debugMemory_t);
@@ -1365,6 +1772,10 @@ void Mem_DumpCompressed( const char *fileName, memorySortType_t memSort, int num
 	idStr module, funcName;
 	FILE *f;
 
+#if USE_MT_HEAP
+	std::unique_lock<std::recursive_mutex> lock( mem_debugMemoryLock );
+#endif
+
 	// build list with memory allocations
 	totalSize = 0;
 	numBlocks = 0;
@@ -1551,6 +1962,10 @@ void *Mem_AllocDebugMemory( const int size, const char *fileName, const int line
 
 	Mem_UpdateAllocStats( size );
 
+#if USE_MT_HEAP
+	std::lock_guard<std::recursive_mutex> lock( mem_debugMemoryLock );
+#endif
+
 	m = (debugMemory_t *) p;
 	m->fileName = fileName;
 	m->lineNumber = lineNumber;
@@ -1595,6 +2010,10 @@ void Mem_FreeDebugMemory( void *p, const char *fileName, const int lineNumber, c
 
 	Mem_UpdateFreeStats( m->size );
 
+#if USE_MT_HEAP
+	std::unique_lock<std::recursive_mutex> lock( mem_debugMemoryLock );
+#endif
+
 	if ( m->next ) {
 		m->next->prev = m->prev;
 	}
@@ -1610,6 +2029,10 @@ void Mem_FreeDebugMemory( void *p, const char *fileName, const int lineNumber, c
 	m->frameNumber = idLib::frameNumber;
 	m->size = -m->size;
 
+#if USE_MT_HEAP
+	lock.unlock();
+#endif
+
 	if ( align16 ) {
 		mem_heap->Free16( m );
 	}
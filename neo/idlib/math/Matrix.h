@@ -2008,9 +2008,10 @@ private:
 	int				alloced;				// floats allocated, if -1 then mat points to data set with SetData
 	float *			mat;					// memory the matrix is stored
 
-	static float	temp[MATX_MAX_TEMP+4];	// used to store intermediate results
-	static float *	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	// per thread like the idVecX pool
+	static thread_local float	temp[MATX_MAX_TEMP+4];	// used to store intermediate results
+	static thread_local float *	tempPtr;				// pointer to 16 byte aligned temporary memory
+	static thread_local int		tempIndex;				// index into memory pool, wraps around
 
 private:
 	void			SetTempSize( int rows, int columns );
@@ -43,6 +43,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/math/Simd_SSE.h"
 #include "idlib/math/Simd_SSE2.h"
 #include "idlib/math/Simd_SSE3.h"
+#include "idlib/math/Simd_AVX2.h"
+#include "idlib/math/Simd_NEON.h"
 #include "idlib/math/Simd_AltiVec.h"
 #include "idlib/math/Plane.h"
 #include "idlib/bv/Bounds.h"
@@ -71,9 +73,11 @@ void idSIMD::Init( void ) {
 /*
 ============
 idSIMD::InitProcessor
+
+  The NEON processor is only used when useNEON is set, com_useNEON
 ============
 */
-void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
+void idSIMD::InitProcessor( const char *module, bool forceGeneric, bool useNEON ) {
 	int cpuid;
 	idSIMDProcessor *newProcessor;
 
@@ -88,6 +92,14 @@ void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
 		if ( !processor ) {
 			if ( ( cpuid & CPUID_ALTIVEC ) ) {
 				processor = new idSIMD_AltiVec;
+#ifdef ID_SIMD_NEON
+			} else if ( ( cpuid & CPUID_NEON ) ) {
+				processor = new idSIMD_NEON;
+#endif
+#ifdef ID_SIMD_AVX2
+			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) && ( cpuid & CPUID_AVX2 ) && ( cpuid & CPUID_FMA3 ) ) {
+				processor = new idSIMD_AVX2;
+#endif
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) ) {
 				processor = new idSIMD_SSE3;
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
@@ -105,6 +117,13 @@ void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
 		}
 
 		newProcessor = processor;
+
+#ifdef ID_SIMD_NEON
+		// the NEON processor hasn't been through testSIMD on ARM yet, it has to be asked for
+		if ( ( cpuid & CPUID_NEON ) && !useNEON ) {
+			newProcessor = generic;
+		}
+#endif
 	}
 
 	if ( newProcessor != SIMDProcessor ) {
@@ -187,6 +206,22 @@ double ticksPerNanosecond;
 #define StopRecordTime( end )				\
 	end = mach_absolute_time();
 
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+
+#define TIME_TYPE int
+
+static inline int ReadTimeStampCounter( void ) {
+	unsigned int lo, hi;
+	__asm__ __volatile__( "lfence\n\trdtsc\n\tlfence" : "=a" (lo), "=d" (hi) : : "memory" );
+	return (int)lo;
+}
+
+#define StartRecordTime( start )			\
+	start = ReadTimeStampCounter();
+
+#define StopRecordTime( end )				\
+	end = ReadTimeStampCounter();
+
 #else
 
 #define TIME_TYPE int
@@ -2180,6 +2215,55 @@ void TestMatXLDLTFactor( void ) {
 	}
 }
 
+/*
+============
+TestDequantize
+============
+*/
+void TestDequantize( void ) {
+	int i;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( unsigned short src[COUNT] );
+	ALIGN16( float bias[COUNT] );
+	ALIGN16( float scale[COUNT] );
+	ALIGN16( float dst1[COUNT] );
+	ALIGN16( float dst2[COUNT] );
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < COUNT; i++ ) {
+		src[i] = srnd.RandomInt( 65536 );
+		bias[i] = srnd.CRandomFloat() * 10.0f;
+		scale[i] = srnd.RandomFloat() * 10.0f / 65535.0f;
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->Dequantize( dst1, src, bias, scale, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->Dequantize()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->Dequantize( dst2, src, bias, scale, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		if ( dst1[i] != dst2[i] ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->Dequantize() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestBlendJoints
@@ -2875,6 +2959,91 @@ void TestDeriveTangents( void ) {
 	PrintClocks( va( "   simd->DeriveTangents() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestDeriveTangentsShortIndexes
+============
+*/
+void TestDeriveTangentsShortIndexes( void ) {
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( idDrawVert drawVerts1[COUNT] );
+	ALIGN16( idDrawVert drawVerts2[COUNT] );
+	ALIGN16( idPlane planes1[COUNT] );
+	ALIGN16( idPlane planes2[COUNT] );
+	ALIGN16( short indexes[COUNT*3] );
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < COUNT; i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			drawVerts1[i].xyz[j] = srnd.CRandomFloat() * 10.0f;
+		}
+		for ( j = 0; j < 2; j++ ) {
+			drawVerts1[i].st[j] = srnd.CRandomFloat();
+		}
+		drawVerts2[i] = drawVerts1[i];
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		indexes[i*3+0] = ( i + 0 ) % COUNT;
+		indexes[i*3+1] = ( i + 1 ) % COUNT;
+		indexes[i*3+2] = ( i + 2 ) % COUNT;
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->DeriveTangents( planes1, drawVerts1, COUNT, indexes, COUNT*3 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->DeriveTangents( short )", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->DeriveTangents( planes2, drawVerts2, COUNT, indexes, COUNT*3 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		idVec3 v1, v2;
+
+		v1 = drawVerts1[i].normal;
+		v1.Normalize();
+		v2 = drawVerts2[i].normal;
+		v2.Normalize();
+		if ( !v1.Compare( v2, 1e-1f ) ) {
+			idLib::common->Printf("DeriveTangents: broken at normal %i\n -- expecting %s got %s", i, v1.ToString(), v2.ToString());
+			break;
+		}
+		v1 = drawVerts1[i].tangents[0];
+		v1.Normalize();
+		v2 = drawVerts2[i].tangents[0];
+		v2.Normalize();
+		if ( !v1.Compare( v2, 1e-1f ) ) {
+			idLib::common->Printf("DeriveTangents: broken at tangent0 %i -- expecting %s got %s\n", i, v1.ToString(), v2.ToString() );
+			break;
+		}
+		v1 = drawVerts1[i].tangents[1];
+		v1.Normalize();
+		v2 = drawVerts2[i].tangents[1];
+		v2.Normalize();
+		if ( !v1.Compare( v2, 1e-1f ) ) {
+			idLib::common->Printf("DeriveTangents: broken at tangent1 %i -- expecting %s got %s\n", i, v1.ToString(), v2.ToString() );
+			break;
+		}
+		if ( !planes1[i].Compare( planes2[i], 1e-1f, 1e-1f ) ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->DeriveTangents( short ) %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestDeriveUnsmoothedTangents
@@ -4038,14 +4207,30 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 				return;
 			}
 			p_simd = new idSIMD_SSE3();
+#ifdef ID_SIMD_AVX2
+		} else if ( idStr::Icmp( argString, "AVX2" ) == 0 ) {
+			if ( !( cpuid & CPUID_MMX ) || !( cpuid & CPUID_SSE ) || !( cpuid & CPUID_SSE2 ) || !( cpuid & CPUID_SSE3 ) || !( cpuid & CPUID_AVX2 ) || !( cpuid & CPUID_FMA3 ) ) {
+				common->Printf( "CPU does not support MMX & SSE & SSE2 & SSE3 & AVX2 & FMA\n" );
+				return;
+			}
+			p_simd = new idSIMD_AVX2();
+#endif
 		} else if ( idStr::Icmp( argString, "AltiVec" ) == 0 ) {
 			if ( !( cpuid & CPUID_ALTIVEC ) ) {
 				common->Printf( "CPU does not support AltiVec\n" );
 				return;
 			}
 			p_simd = new idSIMD_AltiVec();
+#ifdef ID_SIMD_NEON
+		} else if ( idStr::Icmp( argString, "NEON" ) == 0 ) {
+			if ( !( cpuid & CPUID_NEON ) ) {
+				common->Printf( "CPU does not support NEON\n" );
+				return;
+			}
+			p_simd = new idSIMD_NEON();
+#endif
 		} else {
-			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AltiVec\n" );
+			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AVX2, AltiVec, NEON\n" );
 			return;
 		}
 	}
@@ -4083,6 +4268,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 
 	idLib::common->Printf("====================================\n" );
 
+	TestDequantize();
 	TestBlendJoints();
 	TestConvertJointQuatsToJointMats();
 	TestConvertJointMatsToJointQuats();
@@ -4094,6 +4280,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 	TestOverlayPointCull();
 	TestDeriveTriPlanes();
 	TestDeriveTangents();
+	TestDeriveTangentsShortIndexes();
 	TestDeriveUnsmoothedTangents();
 	TestNormalizeTangents();
 	TestGetTextureSpaceLightVectors();
@@ -45,7 +45,7 @@ If you have questions concerning this license or the applicable additional terms
 class idSIMD {
 public:
 	static void			Init( void );
-	static void			InitProcessor( const char *module, bool forceGeneric );
+	static void			InitProcessor( const char *module, bool forceGeneric, bool useNEON = false );
 	static void			Shutdown( void );
 	static void			Test_f( const class idCmdArgs &args );
 };
@@ -174,6 +174,7 @@ public:
 	virtual bool VPCALL MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const int n ) = 0;
 
 	// rendering
+	virtual void VPCALL Dequantize( float *dst, const unsigned short *src, const float *bias, const float *scale, const int count ) = 0;
 	virtual void VPCALL BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) = 0;
 	virtual void VPCALL ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) = 0;
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat *jointQuats, const idJointMat *jointMats, const int numJoints ) = 0;
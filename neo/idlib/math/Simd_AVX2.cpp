@@ -0,0 +1,971 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "idlib/geometry/DrawVert.h"
+#include "idlib/geometry/JointTransform.h"
+#include "idlib/math/Plane.h"
+#include "idlib/math/Matrix.h"
+
+#include "idlib/math/Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 & FMA implementation of idSIMDProcessor
+//
+//===============================================================
+
+#ifdef ID_SIMD_AVX2
+
+#include <immintrin.h>
+
+// only the functions marked with this may use AVX2 and FMA instructions
+#define AVX2_FUNC					__attribute__ (( target( "avx2,fma" ) ))
+
+#define DRAWVERT_FLOATS				( sizeof( idDrawVert ) / sizeof( float ) )
+#define DRAWVERT_XYZ_OFFSET			0
+#define DRAWVERT_ST_OFFSET			3
+#define DRAWVERT_NORMAL_OFFSET		5
+#define DRAWVERT_TANGENT0_OFFSET	8
+#define DRAWVERT_TANGENT1_OFFSET	11
+
+#define JOINTQUAT_FLOATS			( sizeof( idJointQuat ) / sizeof( float ) )
+
+/*
+============
+RSqrt8
+
+  reciprocal square root with one Newton-Raphson step, about as precise as idMath::RSqrt
+============
+*/
+AVX2_FUNC static inline __m256 RSqrt8( __m256 x ) {
+	__m256 r = _mm256_rsqrt_ps( x );
+	__m256 hx = _mm256_mul_ps( x, _mm256_set1_ps( 0.5f ) );
+	return _mm256_mul_ps( r, _mm256_fnmadd_ps( hx, _mm256_mul_ps( r, r ), _mm256_set1_ps( 1.5f ) ) );
+}
+
+/*
+============
+Sin8
+
+  idMath::Sin16 for angles in the range [0, PI/2]
+============
+*/
+AVX2_FUNC static inline __m256 Sin8( __m256 a ) {
+	__m256 s = _mm256_mul_ps( a, a );
+	__m256 p = _mm256_set1_ps( -2.39e-08f );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 2.7526e-06f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -1.98409e-04f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 8.3333315e-03f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -1.666666664e-01f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 1.0f ) );
+	return _mm256_mul_ps( p, a );
+}
+
+/*
+============
+ATan8
+
+  idMath::ATan16( y, x ) for y >= 0 and x >= 0
+============
+*/
+AVX2_FUNC static inline __m256 ATan8( __m256 y, __m256 x ) {
+	__m256 swap = _mm256_cmp_ps( y, x, _CMP_GT_OQ );
+	__m256 a = _mm256_div_ps( _mm256_min_ps( x, y ), _mm256_max_ps( x, y ) );
+	__m256 s = _mm256_mul_ps( a, a );
+	__m256 p = _mm256_set1_ps( 0.0028662257f );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.0161657367f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 0.0429096138f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.0752896400f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 0.1065626393f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.1420889944f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 0.1999355085f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( -0.3333314528f ) );
+	p = _mm256_fmadd_ps( p, s, _mm256_set1_ps( 1.0f ) );
+	p = _mm256_mul_ps( p, a );
+	return _mm256_blendv_ps( p, _mm256_sub_ps( _mm256_set1_ps( idMath::HALF_PI ), p ), swap );
+}
+
+/*
+============
+Transpose8
+
+  8x8 transpose, the rows become the columns
+============
+*/
+AVX2_FUNC static inline void Transpose8( __m256 r[8] ) {
+	__m256 t0 = _mm256_unpacklo_ps( r[0], r[1] );
+	__m256 t1 = _mm256_unpackhi_ps( r[0], r[1] );
+	__m256 t2 = _mm256_unpacklo_ps( r[2], r[3] );
+	__m256 t3 = _mm256_unpackhi_ps( r[2], r[3] );
+	__m256 t4 = _mm256_unpacklo_ps( r[4], r[5] );
+	__m256 t5 = _mm256_unpackhi_ps( r[4], r[5] );
+	__m256 t6 = _mm256_unpacklo_ps( r[6], r[7] );
+	__m256 t7 = _mm256_unpackhi_ps( r[6], r[7] );
+
+	__m256 s0 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s1 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	__m256 s2 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s3 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	__m256 s4 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s5 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	__m256 s6 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s7 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+
+	r[0] = _mm256_permute2f128_ps( s0, s4, 0x20 );
+	r[1] = _mm256_permute2f128_ps( s1, s5, 0x20 );
+	r[2] = _mm256_permute2f128_ps( s2, s6, 0x20 );
+	r[3] = _mm256_permute2f128_ps( s3, s7, 0x20 );
+	r[4] = _mm256_permute2f128_ps( s0, s4, 0x31 );
+	r[5] = _mm256_permute2f128_ps( s1, s5, 0x31 );
+	r[6] = _mm256_permute2f128_ps( s2, s6, 0x31 );
+	r[7] = _mm256_permute2f128_ps( s3, s7, 0x31 );
+}
+
+/*
+============
+LoadXYZST8
+
+  loads the position and texture coordinates of eight vertexes into separate registers
+============
+*/
+AVX2_FUNC static inline void LoadXYZST8( const float *vertsPtr, const int offsets[8], __m256 xyzst[5] ) {
+	__m256 v0 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( vertsPtr + offsets[0] ) ), _mm_loadu_ps( vertsPtr + offsets[4] ), 1 );
+	__m256 v1 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( vertsPtr + offsets[1] ) ), _mm_loadu_ps( vertsPtr + offsets[5] ), 1 );
+	__m256 v2 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( vertsPtr + offsets[2] ) ), _mm_loadu_ps( vertsPtr + offsets[6] ), 1 );
+	__m256 v3 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( vertsPtr + offsets[3] ) ), _mm_loadu_ps( vertsPtr + offsets[7] ), 1 );
+
+	__m256 t0 = _mm256_unpacklo_ps( v0, v1 );
+	__m256 t1 = _mm256_unpacklo_ps( v2, v3 );
+	__m256 t2 = _mm256_unpackhi_ps( v0, v1 );
+	__m256 t3 = _mm256_unpackhi_ps( v2, v3 );
+
+	xyzst[0] = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	xyzst[1] = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	xyzst[2] = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	xyzst[3] = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	xyzst[4] = _mm256_setr_ps( vertsPtr[offsets[0] + 4], vertsPtr[offsets[1] + 4], vertsPtr[offsets[2] + 4], vertsPtr[offsets[3] + 4],
+								vertsPtr[offsets[4] + 4], vertsPtr[offsets[5] + 4], vertsPtr[offsets[6] + 4], vertsPtr[offsets[7] + 4] );
+}
+
+/*
+============
+HorizontalSum8
+
+  adds the eight elements, always in the same order
+============
+*/
+AVX2_FUNC static inline float HorizontalSum8( __m256 v ) {
+	__m128 s = _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+	s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+	s = _mm_add_ss( s, _mm_shuffle_ps( s, s, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( s );
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName( void ) const {
+	return "MMX & SSE & SSE2 & SSE3 & AVX2 & FMA";
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i] + constant[3];
+  eight points at a time, without FMA so the result is the same as the generic code
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idVec3 *src, const int count ) {
+	int i;
+
+	const __m256 nx = _mm256_set1_ps( constant[0] );
+	const __m256 ny = _mm256_set1_ps( constant[1] );
+	const __m256 nz = _mm256_set1_ps( constant[2] );
+	const __m256 d = _mm256_set1_ps( constant[3] );
+	const __m256i offsets = _mm256_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21 );
+	const float *srcPtr = src[0].ToFloatPtr();
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		__m256 x = _mm256_i32gather_ps( srcPtr + i*3 + 0, offsets, 4 );
+		__m256 y = _mm256_i32gather_ps( srcPtr + i*3 + 1, offsets, 4 );
+		__m256 z = _mm256_i32gather_ps( srcPtr + i*3 + 2, offsets, 4 );
+		__m256 dot = _mm256_add_ps( _mm256_mul_ps( nx, x ), _mm256_mul_ps( ny, y ) );
+		dot = _mm256_add_ps( dot, _mm256_mul_ps( nz, z ) );
+		_mm256_storeu_ps( dst + i, _mm256_add_ps( dot, d ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i] + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MatX_LDLTFactor
+
+  in-place factorization LDL' of the n * n sub-matrix of mat
+  the reciprocal of the diagonal elements are stored in invDiag
+  left looking like the generic code, the column below the diagonal is updated
+  in blocks of four rows which share the loads of the scaled row, every row is
+  summed in the same order in and outside the blocks so the result only depends
+  on the matrix
+============
+*/
+AVX2_FUNC bool VPCALL idSIMD_AVX2::MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const int n ) {
+	int i, j, k;
+	float *v, *diag, *mptr, *r0, *r1, *r2, *r3;
+	float sum, s0, s1, s2, s3, d;
+
+	if ( n <= 0 ) {
+		return true;
+	}
+
+	v = (float *) _alloca16( n * sizeof( float ) );
+	diag = (float *) _alloca16( n * sizeof( float ) );
+
+	for ( i = 0; i < n; i++ ) {
+
+		mptr = mat[i];
+
+		// scale the row with the diagonal and subtract the scaled squares from the diagonal element
+		__m256 acc = _mm256_setzero_ps();
+		for ( k = 0; k + 8 <= i; k += 8 ) {
+			__m256 r = _mm256_loadu_ps( mptr + k );
+			__m256 t = _mm256_mul_ps( _mm256_loadu_ps( diag + k ), r );
+			_mm256_storeu_ps( v + k, t );
+			acc = _mm256_fmadd_ps( t, r, acc );
+		}
+		sum = HorizontalSum8( acc );
+		for ( ; k < i; k++ ) {
+			v[k] = diag[k] * mptr[k];
+			sum += v[k] * mptr[k];
+		}
+		sum = mptr[i] - sum;
+
+		if ( sum == 0.0f ) {
+			return false;
+		}
+
+		mptr[i] = sum;
+		diag[i] = sum;
+		invDiag[i] = d = 1.0f / sum;
+
+		// update the column below the diagonal
+		for ( j = i + 1; j + 4 <= n; j += 4 ) {
+			r0 = mat[j+0];
+			r1 = mat[j+1];
+			r2 = mat[j+2];
+			r3 = mat[j+3];
+			__m256 a0 = _mm256_setzero_ps();
+			__m256 a1 = _mm256_setzero_ps();
+			__m256 a2 = _mm256_setzero_ps();
+			__m256 a3 = _mm256_setzero_ps();
+			for ( k = 0; k + 8 <= i; k += 8 ) {
+				__m256 t = _mm256_loadu_ps( v + k );
+				a0 = _mm256_fmadd_ps( _mm256_loadu_ps( r0 + k ), t, a0 );
+				a1 = _mm256_fmadd_ps( _mm256_loadu_ps( r1 + k ), t, a1 );
+				a2 = _mm256_fmadd_ps( _mm256_loadu_ps( r2 + k ), t, a2 );
+				a3 = _mm256_fmadd_ps( _mm256_loadu_ps( r3 + k ), t, a3 );
+			}
+			s0 = HorizontalSum8( a0 );
+			s1 = HorizontalSum8( a1 );
+			s2 = HorizontalSum8( a2 );
+			s3 = HorizontalSum8( a3 );
+			for ( ; k < i; k++ ) {
+				s0 += r0[k] * v[k];
+				s1 += r1[k] * v[k];
+				s2 += r2[k] * v[k];
+				s3 += r3[k] * v[k];
+			}
+			r0[i] = ( r0[i] - s0 ) * d;
+			r1[i] = ( r1[i] - s1 ) * d;
+			r2[i] = ( r2[i] - s2 ) * d;
+			r3[i] = ( r3[i] - s3 ) * d;
+		}
+		for ( ; j < n; j++ ) {
+			r0 = mat[j];
+			__m256 a0 = _mm256_setzero_ps();
+			for ( k = 0; k + 8 <= i; k += 8 ) {
+				a0 = _mm256_fmadd_ps( _mm256_loadu_ps( r0 + k ), _mm256_loadu_ps( v + k ), a0 );
+			}
+			s0 = HorizontalSum8( a0 );
+			for ( ; k < i; k++ ) {
+				s0 += r0[k] * v[k];
+			}
+			r0[i] = ( r0[i] - s0 ) * d;
+		}
+	}
+
+	return true;
+}
+
+/*
+============
+idSIMD_AVX2::Dequantize
+
+  dst[i] = bias[i] + scale[i] * src[i];
+  eight values at a time, without FMA so the result is the same as the generic code
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::Dequantize( float *dst, const unsigned short *src, const float *bias, const float *scale, const int count ) {
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		__m256 v = _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)( src + i ) ) ) );
+		v = _mm256_add_ps( _mm256_loadu_ps( bias + i ), _mm256_mul_ps( _mm256_loadu_ps( scale + i ), v ) );
+		_mm256_storeu_ps( dst + i, v );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = bias[i] + scale[i] * (float) src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::BlendJoints
+
+  eight joints at a time, the same math as idQuat::Slerp and idVec3::Lerp
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+	int i, k;
+	ALIGN16( float out[7][8] );
+
+	if ( lerp <= 0.0f ) {
+		return;
+	}
+	if ( lerp >= 1.0f ) {
+		for ( i = 0; i < numJoints; i++ ) {
+			int j = index[i];
+			joints[j] = blendJoints[j];
+		}
+		return;
+	}
+
+	const float *fromPtr = joints[0].q.ToFloatPtr();
+	const float *toPtr = blendJoints[0].q.ToFloatPtr();
+
+	const __m256 vlerp = _mm256_set1_ps( lerp );
+	const __m256 vinvLerp = _mm256_set1_ps( 1.0f - lerp );
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	const __m256 signBit = _mm256_set1_ps( -0.0f );
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		__m256i offsets = _mm256_mullo_epi32( _mm256_loadu_si256( (const __m256i *)( index + i ) ), _mm256_set1_epi32( JOINTQUAT_FLOATS ) );
+		__m256 from[7], to[7];
+
+		for ( k = 0; k < 7; k++ ) {
+			from[k] = _mm256_i32gather_ps( fromPtr + k, offsets, 4 );
+			to[k] = _mm256_i32gather_ps( toPtr + k, offsets, 4 );
+		}
+
+		__m256 cosom = _mm256_mul_ps( from[0], to[0] );
+		cosom = _mm256_fmadd_ps( from[1], to[1], cosom );
+		cosom = _mm256_fmadd_ps( from[2], to[2], cosom );
+		cosom = _mm256_fmadd_ps( from[3], to[3], cosom );
+
+		// take the short way around
+		__m256 sign = _mm256_and_ps( cosom, signBit );
+		cosom = _mm256_xor_ps( cosom, sign );
+
+		__m256 scale0 = _mm256_fnmadd_ps( cosom, cosom, one );
+		__m256 sinom = RSqrt8( scale0 );
+		__m256 omega = ATan8( _mm256_mul_ps( scale0, sinom ), cosom );
+		__m256 s0 = _mm256_mul_ps( Sin8( _mm256_mul_ps( vinvLerp, omega ) ), sinom );
+		__m256 s1 = _mm256_mul_ps( Sin8( _mm256_mul_ps( vlerp, omega ) ), sinom );
+
+		// nearly the same rotation, just lerp
+		__m256 useSlerp = _mm256_cmp_ps( _mm256_sub_ps( one, cosom ), _mm256_set1_ps( 1e-6f ), _CMP_GT_OQ );
+		s0 = _mm256_blendv_ps( vinvLerp, s0, useSlerp );
+		s1 = _mm256_xor_ps( _mm256_blendv_ps( vlerp, s1, useSlerp ), sign );
+
+		for ( k = 0; k < 4; k++ ) {
+			_mm256_store_ps( out[k], _mm256_fmadd_ps( from[k], s0, _mm256_mul_ps( to[k], s1 ) ) );
+		}
+		for ( k = 4; k < 7; k++ ) {
+			_mm256_store_ps( out[k], _mm256_fmadd_ps( _mm256_sub_ps( to[k], from[k] ), vlerp, from[k] ) );
+		}
+
+		for ( k = 0; k < 8; k++ ) {
+			float *dst = joints[index[i + k]].q.ToFloatPtr();
+			dst[0] = out[0][k];
+			dst[1] = out[1][k];
+			dst[2] = out[2][k];
+			dst[3] = out[3][k];
+			dst[4] = out[4][k];
+			dst[5] = out[5][k];
+			dst[6] = out[6][k];
+		}
+	}
+
+	if ( i < numJoints ) {
+		idSIMD_SSE3::BlendJoints( joints, blendJoints, lerp, index + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	int i;
+
+	// the eighth float of the last joint is past the end of the array
+	const __m256i lastMask = _mm256_setr_epi32( -1, -1, -1, -1, -1, -1, -1, 0 );
+	const __m256 one = _mm256_set1_ps( 1.0f );
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		const float *src = jointQuats[i].q.ToFloatPtr();
+		__m256 q[8];
+
+		for ( int k = 0; k < 7; k++ ) {
+			q[k] = _mm256_loadu_ps( src + k * JOINTQUAT_FLOATS );
+		}
+		q[7] = _mm256_maskload_ps( src + 7 * JOINTQUAT_FLOATS, lastMask );
+		Transpose8( q );
+
+		__m256 x2 = _mm256_add_ps( q[0], q[0] );
+		__m256 y2 = _mm256_add_ps( q[1], q[1] );
+		__m256 z2 = _mm256_add_ps( q[2], q[2] );
+
+		__m256 xx = _mm256_mul_ps( q[0], x2 );
+		__m256 xy = _mm256_mul_ps( q[0], y2 );
+		__m256 xz = _mm256_mul_ps( q[0], z2 );
+		__m256 yy = _mm256_mul_ps( q[1], y2 );
+		__m256 yz = _mm256_mul_ps( q[1], z2 );
+		__m256 zz = _mm256_mul_ps( q[2], z2 );
+		__m256 wx = _mm256_mul_ps( q[3], x2 );
+		__m256 wy = _mm256_mul_ps( q[3], y2 );
+		__m256 wz = _mm256_mul_ps( q[3], z2 );
+
+		// the joint matrix is the transpose of idQuat::ToMat3
+		__m256 m0[8], m1[8];
+		m0[0] = _mm256_sub_ps( one, _mm256_add_ps( yy, zz ) );
+		m0[1] = _mm256_add_ps( xy, wz );
+		m0[2] = _mm256_sub_ps( xz, wy );
+		m0[3] = q[4];
+		m0[4] = _mm256_sub_ps( xy, wz );
+		m0[5] = _mm256_sub_ps( one, _mm256_add_ps( xx, zz ) );
+		m0[6] = _mm256_add_ps( yz, wx );
+		m0[7] = q[5];
+		m1[0] = _mm256_add_ps( xz, wy );
+		m1[1] = _mm256_sub_ps( yz, wx );
+		m1[2] = _mm256_sub_ps( one, _mm256_add_ps( xx, yy ) );
+		m1[3] = q[6];
+		m1[4] = m1[5] = m1[6] = m1[7] = _mm256_setzero_ps();
+
+		Transpose8( m0 );
+		Transpose8( m1 );
+
+		for ( int k = 0; k < 8; k++ ) {
+			float *dst = jointMats[i + k].ToFloatPtr();
+			_mm256_storeu_ps( dst, m0[k] );
+			_mm_storeu_ps( dst + 8, _mm256_castps256_ps128( m1[k] ) );
+		}
+	}
+
+	if ( i < numJoints ) {
+		idSIMD_SSE3::ConvertJointQuatsToJointMats( jointMats + i, jointQuats + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformJoints
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	for ( int i = firstJoint; i <= lastJoint; i++ ) {
+		assert( parents[i] < i );
+
+		float *m = jointMats[i].ToFloatPtr();
+		const float *p = jointMats[parents[i]].ToFloatPtr();
+
+		__m128 r0 = _mm_loadu_ps( m + 0 );
+		__m128 r1 = _mm_loadu_ps( m + 4 );
+		__m128 r2 = _mm_loadu_ps( m + 8 );
+
+		for ( int r = 0; r < 3; r++ ) {
+			const float *a = p + r * 4;
+			__m128 d = _mm_set_ps( a[3], 0.0f, 0.0f, 0.0f );
+			d = _mm_fmadd_ps( _mm_set1_ps( a[0] ), r0, d );
+			d = _mm_fmadd_ps( _mm_set1_ps( a[1] ), r1, d );
+			d = _mm_fmadd_ps( _mm_set1_ps( a[2] ), r2, d );
+			_mm_storeu_ps( m + r * 4, d );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::UntransformJoints
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::UntransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	for ( int i = lastJoint; i >= firstJoint; i-- ) {
+		assert( parents[i] < i );
+
+		float *m = jointMats[i].ToFloatPtr();
+		const float *p = jointMats[parents[i]].ToFloatPtr();
+
+		__m128 r0 = _mm_sub_ps( _mm_loadu_ps( m + 0 ), _mm_set_ps( p[3], 0.0f, 0.0f, 0.0f ) );
+		__m128 r1 = _mm_sub_ps( _mm_loadu_ps( m + 4 ), _mm_set_ps( p[7], 0.0f, 0.0f, 0.0f ) );
+		__m128 r2 = _mm_sub_ps( _mm_loadu_ps( m + 8 ), _mm_set_ps( p[11], 0.0f, 0.0f, 0.0f ) );
+
+		for ( int r = 0; r < 3; r++ ) {
+			__m128 d = _mm_mul_ps( _mm_set1_ps( p[0 * 4 + r] ), r0 );
+			d = _mm_fmadd_ps( _mm_set1_ps( p[1 * 4 + r] ), r1, d );
+			d = _mm_fmadd_ps( _mm_set1_ps( p[2 * 4 + r] ), r2, d );
+			_mm_storeu_ps( m + r * 4, d );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformVerts
+
+  The first two rows of the joint matrix are done in one register and
+  the horizontal adds are left until all the weights of a vertex are in.
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+
+	for ( int j = 0, i = 0; i < numVerts; i++ ) {
+		__m256 row01 = _mm256_setzero_ps();
+		__m128 row2 = _mm_setzero_ps();
+
+		for ( ; ; ) {
+			const float *mat = (const float *)( jointsPtr + index[j*2+0] );
+			__m128 w = _mm_loadu_ps( weights[j].ToFloatPtr() );
+
+			row01 = _mm256_fmadd_ps( _mm256_loadu_ps( mat ), _mm256_broadcast_ps( &w ), row01 );
+			row2 = _mm_fmadd_ps( _mm_loadu_ps( mat + 8 ), w, row2 );
+
+			if ( index[j*2+1] != 0 ) {
+				j++;
+				break;
+			}
+			j++;
+		}
+
+		__m128 s01 = _mm_hadd_ps( _mm256_castps256_ps128( row01 ), _mm256_extractf128_ps( row01, 1 ) );
+		__m128 s2 = _mm_hadd_ps( row2, row2 );
+		__m128 xyz = _mm_hadd_ps( s01, s2 );
+
+		float *dst = verts[i].xyz.ToFloatPtr();
+		_mm_storel_pi( (__m64 *)dst, xyz );
+		_mm_store_ss( dst + 2, _mm_movehl_ps( xyz, xyz ) );
+	}
+}
+
+/*
+============
+DeriveTangents_AVX2
+
+  Eight triangles at a time.  The vertexes are shared between the triangles,
+  so the sums are still added to the vertexes one triangle after the other.
+============
+*/
+template< class indexType >
+AVX2_FUNC static void DeriveTangents_AVX2( idPlane *planes, idDrawVert *verts, const int numVerts, const indexType *indexes, const int numIndexes ) {
+	int tri[3][8], offsets[3][8];
+	ALIGN16( float dist[8] );
+	ALIGN16( float lastTangent[8] );
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	const float *vertsPtr = verts[0].xyz.ToFloatPtr();
+	const int numTris = numIndexes / 3;
+	const __m256 signBit = _mm256_set1_ps( -0.0f );
+
+	for ( int i = 0; i < numTris; i += 8 ) {
+		int count = Min( 8, numTris - i );
+
+		// pad the last batch with copies of the last triangle
+		for ( int k = 0; k < 8; k++ ) {
+			int t = ( i + Min( k, count - 1 ) ) * 3;
+			for ( int v = 0; v < 3; v++ ) {
+				tri[v][k] = indexes[t + v];
+				offsets[v][k] = tri[v][k] * DRAWVERT_FLOATS;
+			}
+		}
+
+		__m256 a[5], d0[5], d1[5];
+
+		LoadXYZST8( vertsPtr, offsets[0], a );
+		LoadXYZST8( vertsPtr, offsets[1], d0 );
+		LoadXYZST8( vertsPtr, offsets[2], d1 );
+
+		for ( int k = 0; k < 5; k++ ) {
+			d0[k] = _mm256_sub_ps( d0[k], a[k] );
+			d1[k] = _mm256_sub_ps( d1[k], a[k] );
+		}
+
+		// normal
+		__m256 nx = _mm256_fmsub_ps( d1[1], d0[2], _mm256_mul_ps( d1[2], d0[1] ) );
+		__m256 ny = _mm256_fmsub_ps( d1[2], d0[0], _mm256_mul_ps( d1[0], d0[2] ) );
+		__m256 nz = _mm256_fmsub_ps( d1[0], d0[1], _mm256_mul_ps( d1[1], d0[0] ) );
+
+		__m256 f = RSqrt8( _mm256_fmadd_ps( nx, nx, _mm256_fmadd_ps( ny, ny, _mm256_mul_ps( nz, nz ) ) ) );
+		nx = _mm256_mul_ps( nx, f );
+		ny = _mm256_mul_ps( ny, f );
+		nz = _mm256_mul_ps( nz, f );
+
+		// plane distance, see idPlane::FitThroughPoint
+		_mm256_store_ps( dist, _mm256_xor_ps( _mm256_fmadd_ps( nx, a[0], _mm256_fmadd_ps( ny, a[1], _mm256_mul_ps( nz, a[2] ) ) ), signBit ) );
+
+		// area sign bit
+		__m256 area = _mm256_fmsub_ps( d0[3], d1[4], _mm256_mul_ps( d0[4], d1[3] ) );
+		__m256 sign = _mm256_and_ps( area, signBit );
+
+		// first tangent
+		__m256 t0x = _mm256_fmsub_ps( d0[0], d1[4], _mm256_mul_ps( d0[4], d1[0] ) );
+		__m256 t0y = _mm256_fmsub_ps( d0[1], d1[4], _mm256_mul_ps( d0[4], d1[1] ) );
+		__m256 t0z = _mm256_fmsub_ps( d0[2], d1[4], _mm256_mul_ps( d0[4], d1[2] ) );
+
+		f = _mm256_xor_ps( RSqrt8( _mm256_fmadd_ps( t0x, t0x, _mm256_fmadd_ps( t0y, t0y, _mm256_mul_ps( t0z, t0z ) ) ) ), sign );
+
+		// second tangent
+		__m256 t1x = _mm256_fmsub_ps( d0[3], d1[0], _mm256_mul_ps( d0[0], d1[3] ) );
+		__m256 t1y = _mm256_fmsub_ps( d0[3], d1[1], _mm256_mul_ps( d0[1], d1[3] ) );
+		__m256 t1z = _mm256_fmsub_ps( d0[3], d1[2], _mm256_mul_ps( d0[2], d1[3] ) );
+
+		__m256 g = _mm256_xor_ps( RSqrt8( _mm256_fmadd_ps( t1x, t1x, _mm256_fmadd_ps( t1y, t1y, _mm256_mul_ps( t1z, t1z ) ) ) ), sign );
+		_mm256_store_ps( lastTangent, _mm256_mul_ps( t1z, g ) );
+
+		// the normal and the tangents are next to each other in the vertex,
+		// so the first eight floats of each triangle can be added at once
+		__m256 r[8];
+		r[0] = nx;
+		r[1] = ny;
+		r[2] = nz;
+		r[3] = _mm256_mul_ps( t0x, f );
+		r[4] = _mm256_mul_ps( t0y, f );
+		r[5] = _mm256_mul_ps( t0z, f );
+		r[6] = _mm256_mul_ps( t1x, g );
+		r[7] = _mm256_mul_ps( t1y, g );
+		Transpose8( r );
+
+		for ( int k = 0; k < count; k++ ) {
+			__m128 n = _mm256_castps256_ps128( r[k] );
+			_mm_storeu_ps( planes[i + k].ToFloatPtr(), _mm_insert_ps( n, _mm_set_ss( dist[k] ), 0x30 ) );
+
+			for ( int v = 0; v < 3; v++ ) {
+				int vertNum = tri[v][k];
+				float *dst = verts[vertNum].normal.ToFloatPtr();
+
+				if ( used[vertNum] ) {
+					_mm256_storeu_ps( dst, _mm256_add_ps( _mm256_loadu_ps( dst ), r[k] ) );
+					dst[8] += lastTangent[k];
+				} else {
+					_mm256_storeu_ps( dst, r[k] );
+					dst[8] = lastTangent[k];
+					used[vertNum] = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::DeriveTangents
+============
+*/
+void VPCALL idSIMD_AVX2::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	DeriveTangents_AVX2( planes, verts, numVerts, indexes, numIndexes );
+}
+
+/*
+============
+idSIMD_AVX2::DeriveTangents
+============
+*/
+void VPCALL idSIMD_AVX2::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const short *indexes, const int numIndexes ) {
+	DeriveTangents_AVX2( planes, verts, numVerts, indexes, numIndexes );
+}
+
+/*
+============
+idSIMD_AVX2::NormalizeTangents
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::NormalizeTangents( idDrawVert *verts, const int numVerts ) {
+	int i;
+	ALIGN16( float out[9][8] );
+
+	const __m256i offsets = _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ), _mm256_set1_epi32( DRAWVERT_FLOATS ) );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		float *src = verts[i].normal.ToFloatPtr();
+
+		__m256 nx = _mm256_i32gather_ps( src + 0, offsets, 4 );
+		__m256 ny = _mm256_i32gather_ps( src + 1, offsets, 4 );
+		__m256 nz = _mm256_i32gather_ps( src + 2, offsets, 4 );
+
+		__m256 f = RSqrt8( _mm256_fmadd_ps( nx, nx, _mm256_fmadd_ps( ny, ny, _mm256_mul_ps( nz, nz ) ) ) );
+		nx = _mm256_mul_ps( nx, f );
+		ny = _mm256_mul_ps( ny, f );
+		nz = _mm256_mul_ps( nz, f );
+
+		_mm256_store_ps( out[0], nx );
+		_mm256_store_ps( out[1], ny );
+		_mm256_store_ps( out[2], nz );
+
+		for ( int j = 0; j < 2; j++ ) {
+			__m256 tx = _mm256_i32gather_ps( src + 3 + j * 3, offsets, 4 );
+			__m256 ty = _mm256_i32gather_ps( src + 4 + j * 3, offsets, 4 );
+			__m256 tz = _mm256_i32gather_ps( src + 5 + j * 3, offsets, 4 );
+
+			// project onto the plane orthogonal to the normal
+			__m256 d = _mm256_fmadd_ps( tx, nx, _mm256_fmadd_ps( ty, ny, _mm256_mul_ps( tz, nz ) ) );
+			tx = _mm256_fnmadd_ps( d, nx, tx );
+			ty = _mm256_fnmadd_ps( d, ny, ty );
+			tz = _mm256_fnmadd_ps( d, nz, tz );
+
+			f = RSqrt8( _mm256_fmadd_ps( tx, tx, _mm256_fmadd_ps( ty, ty, _mm256_mul_ps( tz, tz ) ) ) );
+			_mm256_store_ps( out[3 + j * 3], _mm256_mul_ps( tx, f ) );
+			_mm256_store_ps( out[4 + j * 3], _mm256_mul_ps( ty, f ) );
+			_mm256_store_ps( out[5 + j * 3], _mm256_mul_ps( tz, f ) );
+		}
+
+		for ( int k = 0; k < 8; k++ ) {
+			float *dst = src + k * DRAWVERT_FLOATS;
+			for ( int e = 0; e < 9; e++ ) {
+				dst[e] = out[e][k];
+			}
+		}
+	}
+
+	if ( i < numVerts ) {
+		idSIMD_SSE3::NormalizeTangents( verts + i, numVerts - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CreateShadowCache
+============
+*/
+AVX2_FUNC int VPCALL idSIMD_AVX2::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	int outVerts = 0;
+
+	// w = 1 for the vertex on the surface, w = 0 for the one projected to infinity
+	const __m256 light = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 0.0f, lightOrigin[0], lightOrigin[1], lightOrigin[2], 0.0f );
+	const __m256 w = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		__m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		__m256 vv = _mm256_blend_ps( _mm256_broadcast_ps( &v ), w, 0x88 );
+		_mm256_storeu_ps( vertexCache[outVerts].ToFloatPtr(), _mm256_sub_ps( vv, light ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_AVX2::CreateVertexProgramShadowCache
+============
+*/
+AVX2_FUNC int VPCALL idSIMD_AVX2::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m256 w = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		__m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		_mm256_storeu_ps( vertexCache[i*2].ToFloatPtr(), _mm256_blend_ps( _mm256_broadcast_ps( &v ), w, 0x88 ) );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundTwoSpeakerMono
+
+  four samples at a time, the volume ramps are stepped by four samples
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m256 vol = _mm256_setr_ps( lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR,
+									lastV[0] + 2.0f * incL, lastV[1] + 2.0f * incR, lastV[0] + 3.0f * incL, lastV[1] + 3.0f * incR );
+	const __m256 inc = _mm256_setr_ps( 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR );
+	const __m256i dup = _mm256_setr_epi32( 0, 0, 1, 1, 2, 2, 3, 3 );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		__m256 s = _mm256_permutevar8x32_ps( _mm256_castps128_ps256( _mm_loadu_ps( samples + j ) ), dup );
+		_mm256_storeu_ps( mixBuffer + j*2, _mm256_fmadd_ps( s, vol, _mm256_loadu_ps( mixBuffer + j*2 ) ) );
+		vol = _mm256_add_ps( vol, inc );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundTwoSpeakerStereo
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m256 vol = _mm256_setr_ps( lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR,
+									lastV[0] + 2.0f * incL, lastV[1] + 2.0f * incR, lastV[0] + 3.0f * incL, lastV[1] + 3.0f * incR );
+	const __m256 inc = _mm256_setr_ps( 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		_mm256_storeu_ps( mixBuffer + j*2, _mm256_fmadd_ps( _mm256_loadu_ps( samples + j*2 ), vol, _mm256_loadu_ps( mixBuffer + j*2 ) ) );
+		vol = _mm256_add_ps( vol, inc );
+	}
+}
+
+/*
+============
+SixSpeakerVolumes
+
+  the volumes of four samples of six speakers, and how much they change over four samples
+============
+*/
+AVX2_FUNC static inline void SixSpeakerVolumes( __m256 vol[3], __m256 inc[3], const float lastV[6], const float currentV[6] ) {
+	ALIGN16( float v[24] );
+	ALIGN16( float i4[24] );
+
+	for ( int c = 0; c < 6; c++ ) {
+		float incV = ( currentV[c] - lastV[c] ) / MIXBUFFER_SAMPLES;
+		for ( int k = 0; k < 4; k++ ) {
+			v[k*6+c] = lastV[c] + k * incV;
+			i4[k*6+c] = 4.0f * incV;
+		}
+	}
+	for ( int r = 0; r < 3; r++ ) {
+		vol[r] = _mm256_load_ps( v + r * 8 );
+		inc[r] = _mm256_load_ps( i4 + r * 8 );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerMono
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m256 vol[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SixSpeakerVolumes( vol, inc, lastV, currentV );
+
+	const __m256i spread0 = _mm256_setr_epi32( 0, 0, 0, 0, 0, 0, 1, 1 );
+	const __m256i spread1 = _mm256_setr_epi32( 1, 1, 1, 1, 2, 2, 2, 2 );
+	const __m256i spread2 = _mm256_setr_epi32( 2, 2, 3, 3, 3, 3, 3, 3 );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		__m256 s = _mm256_castps128_ps256( _mm_loadu_ps( samples + i ) );
+		float *dst = mixBuffer + i*6;
+
+		_mm256_storeu_ps( dst + 0, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread0 ), vol[0], _mm256_loadu_ps( dst + 0 ) ) );
+		_mm256_storeu_ps( dst + 8, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread1 ), vol[1], _mm256_loadu_ps( dst + 8 ) ) );
+		_mm256_storeu_ps( dst + 16, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread2 ), vol[2], _mm256_loadu_ps( dst + 16 ) ) );
+
+		vol[0] = _mm256_add_ps( vol[0], inc[0] );
+		vol[1] = _mm256_add_ps( vol[1], inc[1] );
+		vol[2] = _mm256_add_ps( vol[2], inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerStereo
+
+  speakers 0, 2, 3 and 4 get the left channel, 1 and 5 the right one
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m256 vol[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SixSpeakerVolumes( vol, inc, lastV, currentV );
+
+	const __m256i spread0 = _mm256_setr_epi32( 0, 1, 0, 0, 0, 1, 2, 3 );
+	const __m256i spread1 = _mm256_setr_epi32( 2, 2, 2, 3, 4, 5, 4, 4 );
+	const __m256i spread2 = _mm256_setr_epi32( 4, 5, 6, 7, 6, 6, 6, 7 );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		__m256 s = _mm256_loadu_ps( samples + i*2 );
+		float *dst = mixBuffer + i*6;
+
+		_mm256_storeu_ps( dst + 0, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread0 ), vol[0], _mm256_loadu_ps( dst + 0 ) ) );
+		_mm256_storeu_ps( dst + 8, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread1 ), vol[1], _mm256_loadu_ps( dst + 8 ) ) );
+		_mm256_storeu_ps( dst + 16, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread2 ), vol[2], _mm256_loadu_ps( dst + 16 ) ) );
+
+		vol[0] = _mm256_add_ps( vol[0], inc[0] );
+		vol[1] = _mm256_add_ps( vol[1], inc[1] );
+		vol[2] = _mm256_add_ps( vol[2], inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixedSoundToSamples
+============
+*/
+AVX2_FUNC void VPCALL idSIMD_AVX2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	int i;
+
+	const __m256 minSample = _mm256_set1_ps( -32768.0f );
+	const __m256 maxSample = _mm256_set1_ps( 32767.0f );
+
+	for ( i = 0; i + 8 <= numSamples; i += 8 ) {
+		__m256 m = _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( mixBuffer + i ), minSample ), maxSample );
+		__m256i s = _mm256_cvttps_epi32( m );
+		_mm_storeu_si128( (__m128i *)( samples + i ), _mm_packs_epi32( _mm256_castsi256_si128( s ), _mm256_extracti128_si256( s, 1 ) ) );
+	}
+
+	if ( i < numSamples ) {
+		idSIMD_SSE3::MixedSoundToSamples( samples + i, mixBuffer + i, numSamples - i );
+	}
+}
+
+#endif /* ID_SIMD_AVX2 */
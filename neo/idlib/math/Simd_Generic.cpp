@@ -2255,6 +2255,21 @@ bool VPCALL idSIMD_Generic::MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const
 #endif
 }
 
+/*
+============
+idSIMD_Generic::Dequantize
+
+  dst[i] = bias[i] + scale[i] * src[i];
+============
+*/
+void VPCALL idSIMD_Generic::Dequantize( float *dst, const unsigned short *src, const float *bias, const float *scale, const int count ) {
+	int i;
+
+	for ( i = 0; i < count; i++ ) {
+		dst[i] = bias[i] + scale[i] * (float) src[i];
+	}
+}
+
 /*
 ============
 idSIMD_Generic::BlendJoints
@@ -0,0 +1,903 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "idlib/geometry/DrawVert.h"
+#include "idlib/geometry/JointTransform.h"
+#include "idlib/math/Plane.h"
+#include "idlib/math/Matrix.h"
+
+#include "idlib/math/Simd_NEON.h"
+
+//===============================================================
+//
+//	NEON implementation of idSIMDProcessor
+//
+//===============================================================
+
+#ifdef ID_SIMD_NEON
+
+#if defined(__arm__) && !defined(__ARM_NEON__) && !defined(__ARM_NEON)
+#error "Simd_NEON.cpp has to be compiled with -mfpu=neon"
+#endif
+
+#include <arm_neon.h>
+
+#define DRAWVERT_FLOATS				( sizeof( idDrawVert ) / sizeof( float ) )
+
+/*
+============
+Transpose4
+============
+*/
+static inline void Transpose4( float32x4_t r[4] ) {
+	float32x4x2_t t01 = vtrnq_f32( r[0], r[1] );
+	float32x4x2_t t23 = vtrnq_f32( r[2], r[3] );
+
+	r[0] = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+	r[1] = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+	r[2] = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+	r[3] = vcombine_f32( vget_high_f32( t01.val[1] ), vget_high_f32( t23.val[1] ) );
+}
+
+/*
+============
+RSqrt4
+
+  the estimate only has 8 bits, two Newton-Raphson steps get it close to idMath::RSqrt
+============
+*/
+static inline float32x4_t RSqrt4( float32x4_t x ) {
+	float32x4_t r = vrsqrteq_f32( x );
+	r = vmulq_f32( r, vrsqrtsq_f32( vmulq_f32( x, r ), r ) );
+	r = vmulq_f32( r, vrsqrtsq_f32( vmulq_f32( x, r ), r ) );
+	return r;
+}
+
+/*
+============
+Reciprocal4
+============
+*/
+static inline float32x4_t Reciprocal4( float32x4_t x ) {
+	float32x4_t r = vrecpeq_f32( x );
+	r = vmulq_f32( r, vrecpsq_f32( x, r ) );
+	r = vmulq_f32( r, vrecpsq_f32( x, r ) );
+	return r;
+}
+
+/*
+============
+Sin4
+
+  idMath::Sin16 for angles in the range [0, PI/2]
+============
+*/
+static inline float32x4_t Sin4( float32x4_t a ) {
+	float32x4_t s = vmulq_f32( a, a );
+	float32x4_t p = vdupq_n_f32( -2.39e-08f );
+	p = vmlaq_f32( vdupq_n_f32( 2.7526e-06f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( -1.98409e-04f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( 8.3333315e-03f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( -1.666666664e-01f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( 1.0f ), p, s );
+	return vmulq_f32( p, a );
+}
+
+/*
+============
+ATan4
+
+  idMath::ATan16( y, x ) for y >= 0 and x >= 0
+============
+*/
+static inline float32x4_t ATan4( float32x4_t y, float32x4_t x ) {
+	uint32x4_t swap = vcgtq_f32( y, x );
+	float32x4_t a = vmulq_f32( vminq_f32( x, y ), Reciprocal4( vmaxq_f32( x, y ) ) );
+	float32x4_t s = vmulq_f32( a, a );
+	float32x4_t p = vdupq_n_f32( 0.0028662257f );
+	p = vmlaq_f32( vdupq_n_f32( -0.0161657367f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( 0.0429096138f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( -0.0752896400f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( 0.1065626393f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( -0.1420889944f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( 0.1999355085f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( -0.3333314528f ), p, s );
+	p = vmlaq_f32( vdupq_n_f32( 1.0f ), p, s );
+	p = vmulq_f32( p, a );
+	return vbslq_f32( swap, vsubq_f32( vdupq_n_f32( idMath::HALF_PI ), p ), p );
+}
+
+/*
+============
+XorSign
+============
+*/
+static inline float32x4_t XorSign( float32x4_t x, uint32x4_t sign ) {
+	return vreinterpretq_f32_u32( veorq_u32( vreinterpretq_u32_f32( x ), sign ) );
+}
+
+/*
+============
+HorizontalSum4
+
+  adds the four elements, always in the same order
+============
+*/
+static inline float HorizontalSum4( float32x4_t v ) {
+	float32x2_t s = vadd_f32( vget_low_f32( v ), vget_high_f32( v ) );
+	return vget_lane_f32( vpadd_f32( s, s ), 0 );
+}
+
+/*
+============
+idSIMD_NEON::GetName
+============
+*/
+const char * idSIMD_NEON::GetName( void ) const {
+	return "NEON";
+}
+
+/*
+============
+idSIMD_NEON::Dot
+
+  dst[i] = constant.Normal() * src[i] + constant[3];
+  four points at a time, without fused multiply-add so the result is the same as the generic code
+============
+*/
+void VPCALL idSIMD_NEON::Dot( float *dst, const idPlane &constant, const idVec3 *src, const int count ) {
+	int i;
+
+	const float32x4_t nx = vdupq_n_f32( constant[0] );
+	const float32x4_t ny = vdupq_n_f32( constant[1] );
+	const float32x4_t nz = vdupq_n_f32( constant[2] );
+	const float32x4_t d = vdupq_n_f32( constant[3] );
+	const float *srcPtr = src[0].ToFloatPtr();
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		float32x4x3_t xyz = vld3q_f32( srcPtr + i*3 );
+		float32x4_t dot = vaddq_f32( vmulq_f32( nx, xyz.val[0] ), vmulq_f32( ny, xyz.val[1] ) );
+		dot = vaddq_f32( dot, vmulq_f32( nz, xyz.val[2] ) );
+		vst1q_f32( dst + i, vaddq_f32( dot, d ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i] + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_NEON::MatX_LDLTFactor
+
+  in-place factorization LDL' of the n * n sub-matrix of mat
+  the reciprocal of the diagonal elements are stored in invDiag
+  the same blocking as the AVX2 version with four lanes, every row is summed
+  in the same order in and outside the blocks
+============
+*/
+bool VPCALL idSIMD_NEON::MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const int n ) {
+	int i, j, k;
+	float *v, *diag, *mptr, *r0, *r1, *r2, *r3;
+	float sum, s0, s1, s2, s3, d;
+
+	if ( n <= 0 ) {
+		return true;
+	}
+
+	v = (float *) _alloca16( n * sizeof( float ) );
+	diag = (float *) _alloca16( n * sizeof( float ) );
+
+	for ( i = 0; i < n; i++ ) {
+
+		mptr = mat[i];
+
+		// scale the row with the diagonal and subtract the scaled squares from the diagonal element
+		float32x4_t acc = vdupq_n_f32( 0.0f );
+		for ( k = 0; k + 4 <= i; k += 4 ) {
+			float32x4_t r = vld1q_f32( mptr + k );
+			float32x4_t t = vmulq_f32( vld1q_f32( diag + k ), r );
+			vst1q_f32( v + k, t );
+			acc = vmlaq_f32( acc, t, r );
+		}
+		sum = HorizontalSum4( acc );
+		for ( ; k < i; k++ ) {
+			v[k] = diag[k] * mptr[k];
+			sum += v[k] * mptr[k];
+		}
+		sum = mptr[i] - sum;
+
+		if ( sum == 0.0f ) {
+			return false;
+		}
+
+		mptr[i] = sum;
+		diag[i] = sum;
+		invDiag[i] = d = 1.0f / sum;
+
+		// update the column below the diagonal
+		for ( j = i + 1; j + 4 <= n; j += 4 ) {
+			r0 = mat[j+0];
+			r1 = mat[j+1];
+			r2 = mat[j+2];
+			r3 = mat[j+3];
+			float32x4_t a0 = vdupq_n_f32( 0.0f );
+			float32x4_t a1 = vdupq_n_f32( 0.0f );
+			float32x4_t a2 = vdupq_n_f32( 0.0f );
+			float32x4_t a3 = vdupq_n_f32( 0.0f );
+			for ( k = 0; k + 4 <= i; k += 4 ) {
+				float32x4_t t = vld1q_f32( v + k );
+				a0 = vmlaq_f32( a0, vld1q_f32( r0 + k ), t );
+				a1 = vmlaq_f32( a1, vld1q_f32( r1 + k ), t );
+				a2 = vmlaq_f32( a2, vld1q_f32( r2 + k ), t );
+				a3 = vmlaq_f32( a3, vld1q_f32( r3 + k ), t );
+			}
+			s0 = HorizontalSum4( a0 );
+			s1 = HorizontalSum4( a1 );
+			s2 = HorizontalSum4( a2 );
+			s3 = HorizontalSum4( a3 );
+			for ( ; k < i; k++ ) {
+				s0 += r0[k] * v[k];
+				s1 += r1[k] * v[k];
+				s2 += r2[k] * v[k];
+				s3 += r3[k] * v[k];
+			}
+			r0[i] = ( r0[i] - s0 ) * d;
+			r1[i] = ( r1[i] - s1 ) * d;
+			r2[i] = ( r2[i] - s2 ) * d;
+			r3[i] = ( r3[i] - s3 ) * d;
+		}
+		for ( ; j < n; j++ ) {
+			r0 = mat[j];
+			float32x4_t a0 = vdupq_n_f32( 0.0f );
+			for ( k = 0; k + 4 <= i; k += 4 ) {
+				a0 = vmlaq_f32( a0, vld1q_f32( r0 + k ), vld1q_f32( v + k ) );
+			}
+			s0 = HorizontalSum4( a0 );
+			for ( ; k < i; k++ ) {
+				s0 += r0[k] * v[k];
+			}
+			r0[i] = ( r0[i] - s0 ) * d;
+		}
+	}
+
+	return true;
+}
+
+/*
+============
+idSIMD_NEON::Dequantize
+
+  dst[i] = bias[i] + scale[i] * src[i];
+  eight values at a time, without fused multiply-add so the result is the same as the generic code
+============
+*/
+void VPCALL idSIMD_NEON::Dequantize( float *dst, const unsigned short *src, const float *bias, const float *scale, const int count ) {
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		uint16x8_t s = vld1q_u16( src + i );
+		float32x4_t lo = vcvtq_f32_u32( vmovl_u16( vget_low_u16( s ) ) );
+		float32x4_t hi = vcvtq_f32_u32( vmovl_u16( vget_high_u16( s ) ) );
+		vst1q_f32( dst + i + 0, vaddq_f32( vld1q_f32( bias + i + 0 ), vmulq_f32( vld1q_f32( scale + i + 0 ), lo ) ) );
+		vst1q_f32( dst + i + 4, vaddq_f32( vld1q_f32( bias + i + 4 ), vmulq_f32( vld1q_f32( scale + i + 4 ), hi ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = bias[i] + scale[i] * (float) src[i];
+	}
+}
+
+/*
+============
+idSIMD_NEON::BlendJoints
+
+  four joints at a time, the same math as idQuat::Slerp and idVec3::Lerp
+============
+*/
+void VPCALL idSIMD_NEON::BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+	int i;
+
+	if ( lerp <= 0.0f ) {
+		return;
+	}
+	if ( lerp >= 1.0f ) {
+		for ( i = 0; i < numJoints; i++ ) {
+			int j = index[i];
+			joints[j] = blendJoints[j];
+		}
+		return;
+	}
+
+	const float32x4_t vlerp = vdupq_n_f32( lerp );
+	const float32x4_t vinvLerp = vdupq_n_f32( 1.0f - lerp );
+	const float32x4_t one = vdupq_n_f32( 1.0f );
+	const uint32x4_t signBit = vdupq_n_u32( 0x80000000 );
+
+	for ( i = 0; i + 4 <= numJoints; i += 4 ) {
+		float32x4_t from[4], to[4], q[4];
+		int k;
+
+		for ( k = 0; k < 4; k++ ) {
+			from[k] = vld1q_f32( joints[index[i + k]].q.ToFloatPtr() );
+			to[k] = vld1q_f32( blendJoints[index[i + k]].q.ToFloatPtr() );
+		}
+		Transpose4( from );
+		Transpose4( to );
+
+		float32x4_t cosom = vmulq_f32( from[0], to[0] );
+		cosom = vmlaq_f32( cosom, from[1], to[1] );
+		cosom = vmlaq_f32( cosom, from[2], to[2] );
+		cosom = vmlaq_f32( cosom, from[3], to[3] );
+
+		// take the short way around
+		uint32x4_t sign = vandq_u32( vreinterpretq_u32_f32( cosom ), signBit );
+		cosom = XorSign( cosom, sign );
+
+		float32x4_t scale0 = vmlsq_f32( one, cosom, cosom );
+		float32x4_t sinom = RSqrt4( scale0 );
+		float32x4_t omega = ATan4( vmulq_f32( scale0, sinom ), cosom );
+		float32x4_t s0 = vmulq_f32( Sin4( vmulq_f32( vinvLerp, omega ) ), sinom );
+		float32x4_t s1 = vmulq_f32( Sin4( vmulq_f32( vlerp, omega ) ), sinom );
+
+		// nearly the same rotation, just lerp
+		uint32x4_t useSlerp = vcgtq_f32( vsubq_f32( one, cosom ), vdupq_n_f32( 1e-6f ) );
+		s0 = vbslq_f32( useSlerp, s0, vinvLerp );
+		s1 = XorSign( vbslq_f32( useSlerp, s1, vlerp ), sign );
+
+		for ( k = 0; k < 4; k++ ) {
+			q[k] = vmlaq_f32( vmulq_f32( from[k], s0 ), to[k], s1 );
+		}
+		Transpose4( q );
+
+		for ( k = 0; k < 4; k++ ) {
+			float *dst = joints[index[i + k]].q.ToFloatPtr();
+			const float *src = blendJoints[index[i + k]].q.ToFloatPtr();
+
+			// the translation is loaded with q.w in front of it so nothing past
+			// the joint is touched, q.w is written again right after
+			float32x4_t t0 = vld1q_f32( dst + 3 );
+			float32x4_t t1 = vld1q_f32( src + 3 );
+			vst1q_f32( dst + 3, vmlaq_f32( t0, vsubq_f32( t1, t0 ), vlerp ) );
+			vst1q_f32( dst, q[k] );
+		}
+	}
+
+	if ( i < numJoints ) {
+		idSIMD_Generic::BlendJoints( joints, blendJoints, lerp, index + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_NEON::TransformVerts
+============
+*/
+void VPCALL idSIMD_NEON::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+
+	for ( int j = 0, i = 0; i < numVerts; i++ ) {
+		float32x4_t r0 = vdupq_n_f32( 0.0f );
+		float32x4_t r1 = vdupq_n_f32( 0.0f );
+		float32x4_t r2 = vdupq_n_f32( 0.0f );
+
+		for ( ; ; ) {
+			const float *mat = (const float *)( jointsPtr + index[j*2+0] );
+			float32x4_t w = vld1q_f32( weights[j].ToFloatPtr() );
+
+			r0 = vmlaq_f32( r0, vld1q_f32( mat + 0 ), w );
+			r1 = vmlaq_f32( r1, vld1q_f32( mat + 4 ), w );
+			r2 = vmlaq_f32( r2, vld1q_f32( mat + 8 ), w );
+
+			if ( index[j*2+1] != 0 ) {
+				j++;
+				break;
+			}
+			j++;
+		}
+
+		float32x2_t s0 = vpadd_f32( vget_low_f32( r0 ), vget_high_f32( r0 ) );
+		float32x2_t s1 = vpadd_f32( vget_low_f32( r1 ), vget_high_f32( r1 ) );
+		float32x2_t s2 = vpadd_f32( vget_low_f32( r2 ), vget_high_f32( r2 ) );
+
+		float *dst = verts[i].xyz.ToFloatPtr();
+		vst1_f32( dst, vpadd_f32( s0, s1 ) );
+		vst1_lane_f32( dst + 2, vpadd_f32( s2, s2 ), 0 );
+	}
+}
+
+/*
+============
+LoadXYZST4
+
+  loads the position and texture coordinates of four vertexes into separate registers
+============
+*/
+static inline void LoadXYZST4( const float *vertsPtr, const int offsets[4], float32x4_t xyzst[5] ) {
+	xyzst[0] = vld1q_f32( vertsPtr + offsets[0] );
+	xyzst[1] = vld1q_f32( vertsPtr + offsets[1] );
+	xyzst[2] = vld1q_f32( vertsPtr + offsets[2] );
+	xyzst[3] = vld1q_f32( vertsPtr + offsets[3] );
+	Transpose4( xyzst );
+
+	float32x4_t t = vdupq_n_f32( vertsPtr[offsets[0] + 4] );
+	t = vsetq_lane_f32( vertsPtr[offsets[1] + 4], t, 1 );
+	t = vsetq_lane_f32( vertsPtr[offsets[2] + 4], t, 2 );
+	t = vsetq_lane_f32( vertsPtr[offsets[3] + 4], t, 3 );
+	xyzst[4] = t;
+}
+
+/*
+============
+DeriveTangents_NEON
+
+  Four triangles at a time. The vertexes are shared between the triangles,
+  so the sums are still added to the vertexes one triangle after the other.
+============
+*/
+template< class indexType >
+static void DeriveTangents_NEON( idPlane *planes, idDrawVert *verts, const int numVerts, const indexType *indexes, const int numIndexes ) {
+	int tri[3][4], offsets[3][4];
+	float dist[4], lastTangent[4];
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	const float *vertsPtr = verts[0].xyz.ToFloatPtr();
+	const int numTris = numIndexes / 3;
+	const uint32x4_t signBit = vdupq_n_u32( 0x80000000 );
+
+	for ( int i = 0; i < numTris; i += 4 ) {
+		int count = Min( 4, numTris - i );
+
+		// pad the last batch with copies of the last triangle
+		for ( int k = 0; k < 4; k++ ) {
+			int t = ( i + Min( k, count - 1 ) ) * 3;
+			for ( int v = 0; v < 3; v++ ) {
+				tri[v][k] = indexes[t + v];
+				offsets[v][k] = tri[v][k] * DRAWVERT_FLOATS;
+			}
+		}
+
+		float32x4_t a[5], d0[5], d1[5];
+
+		LoadXYZST4( vertsPtr, offsets[0], a );
+		LoadXYZST4( vertsPtr, offsets[1], d0 );
+		LoadXYZST4( vertsPtr, offsets[2], d1 );
+
+		for ( int k = 0; k < 5; k++ ) {
+			d0[k] = vsubq_f32( d0[k], a[k] );
+			d1[k] = vsubq_f32( d1[k], a[k] );
+		}
+
+		// normal
+		float32x4_t nx = vmlsq_f32( vmulq_f32( d1[1], d0[2] ), d1[2], d0[1] );
+		float32x4_t ny = vmlsq_f32( vmulq_f32( d1[2], d0[0] ), d1[0], d0[2] );
+		float32x4_t nz = vmlsq_f32( vmulq_f32( d1[0], d0[1] ), d1[1], d0[0] );
+
+		float32x4_t f = RSqrt4( vmlaq_f32( vmlaq_f32( vmulq_f32( nx, nx ), ny, ny ), nz, nz ) );
+		nx = vmulq_f32( nx, f );
+		ny = vmulq_f32( ny, f );
+		nz = vmulq_f32( nz, f );
+
+		// plane distance, see idPlane::FitThroughPoint
+		vst1q_f32( dist, vnegq_f32( vmlaq_f32( vmlaq_f32( vmulq_f32( nx, a[0] ), ny, a[1] ), nz, a[2] ) ) );
+
+		// area sign bit
+		float32x4_t area = vmlsq_f32( vmulq_f32( d0[3], d1[4] ), d0[4], d1[3] );
+		uint32x4_t sign = vandq_u32( vreinterpretq_u32_f32( area ), signBit );
+
+		// first tangent
+		float32x4_t t0x = vmlsq_f32( vmulq_f32( d0[0], d1[4] ), d0[4], d1[0] );
+		float32x4_t t0y = vmlsq_f32( vmulq_f32( d0[1], d1[4] ), d0[4], d1[1] );
+		float32x4_t t0z = vmlsq_f32( vmulq_f32( d0[2], d1[4] ), d0[4], d1[2] );
+
+		f = XorSign( RSqrt4( vmlaq_f32( vmlaq_f32( vmulq_f32( t0x, t0x ), t0y, t0y ), t0z, t0z ) ), sign );
+
+		// second tangent
+		float32x4_t t1x = vmlsq_f32( vmulq_f32( d0[3], d1[0] ), d0[0], d1[3] );
+		float32x4_t t1y = vmlsq_f32( vmulq_f32( d0[3], d1[1] ), d0[1], d1[3] );
+		float32x4_t t1z = vmlsq_f32( vmulq_f32( d0[3], d1[2] ), d0[2], d1[3] );
+
+		float32x4_t g = XorSign( RSqrt4( vmlaq_f32( vmlaq_f32( vmulq_f32( t1x, t1x ), t1y, t1y ), t1z, t1z ) ), sign );
+		vst1q_f32( lastTangent, vmulq_f32( t1z, g ) );
+
+		// the normal and the tangents are next to each other in the vertex,
+		// so the first eight floats of each triangle can be added as two vectors
+		float32x4_t r0[4], r1[4];
+		r0[0] = nx;
+		r0[1] = ny;
+		r0[2] = nz;
+		r0[3] = vmulq_f32( t0x, f );
+		r1[0] = vmulq_f32( t0y, f );
+		r1[1] = vmulq_f32( t0z, f );
+		r1[2] = vmulq_f32( t1x, g );
+		r1[3] = vmulq_f32( t1y, g );
+		Transpose4( r0 );
+		Transpose4( r1 );
+
+		for ( int k = 0; k < count; k++ ) {
+			vst1q_f32( planes[i + k].ToFloatPtr(), vsetq_lane_f32( dist[k], r0[k], 3 ) );
+
+			for ( int v = 0; v < 3; v++ ) {
+				int vertNum = tri[v][k];
+				float *dst = verts[vertNum].normal.ToFloatPtr();
+
+				if ( used[vertNum] ) {
+					vst1q_f32( dst + 0, vaddq_f32( vld1q_f32( dst + 0 ), r0[k] ) );
+					vst1q_f32( dst + 4, vaddq_f32( vld1q_f32( dst + 4 ), r1[k] ) );
+					dst[8] += lastTangent[k];
+				} else {
+					vst1q_f32( dst + 0, r0[k] );
+					vst1q_f32( dst + 4, r1[k] );
+					dst[8] = lastTangent[k];
+					used[vertNum] = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_NEON::DeriveTangents
+============
+*/
+void VPCALL idSIMD_NEON::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	DeriveTangents_NEON( planes, verts, numVerts, indexes, numIndexes );
+}
+
+/*
+============
+idSIMD_NEON::DeriveTangents
+============
+*/
+void VPCALL idSIMD_NEON::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const short *indexes, const int numIndexes ) {
+	DeriveTangents_NEON( planes, verts, numVerts, indexes, numIndexes );
+}
+
+/*
+============
+idSIMD_NEON::CreateShadowCache
+============
+*/
+int VPCALL idSIMD_NEON::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	int outVerts = 0;
+
+	// w = 1 for the vertex on the surface, w = 0 for the one projected to infinity
+	float32x4_t light = vdupq_n_f32( 0.0f );
+	light = vsetq_lane_f32( lightOrigin[0], light, 0 );
+	light = vsetq_lane_f32( lightOrigin[1], light, 1 );
+	light = vsetq_lane_f32( lightOrigin[2], light, 2 );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		float32x4_t v = vld1q_f32( verts[i].xyz.ToFloatPtr() );
+		vst1q_f32( vertexCache[outVerts+0].ToFloatPtr(), vsetq_lane_f32( 1.0f, v, 3 ) );
+		vst1q_f32( vertexCache[outVerts+1].ToFloatPtr(), vsubq_f32( vsetq_lane_f32( 0.0f, v, 3 ), light ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_NEON::CreateVertexProgramShadowCache
+============
+*/
+int VPCALL idSIMD_NEON::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	for ( int i = 0; i < numVerts; i++ ) {
+		float32x4_t v = vld1q_f32( verts[i].xyz.ToFloatPtr() );
+		vst1q_f32( vertexCache[i*2+0].ToFloatPtr(), vsetq_lane_f32( 1.0f, v, 3 ) );
+		vst1q_f32( vertexCache[i*2+1].ToFloatPtr(), vsetq_lane_f32( 0.0f, v, 3 ) );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+UpSample4
+
+  writes four samples of one or two channels at the 44kHz rate, the samples
+  of a stereo pair are next to each other in the vector
+============
+*/
+static inline float *UpSample4( float *dest, float32x4_t s, const int kHz, const int numChannels ) {
+	if ( kHz == 11025 ) {
+		if ( numChannels == 1 ) {
+			vst1q_f32( dest + 0, vdupq_lane_f32( vget_low_f32( s ), 0 ) );
+			vst1q_f32( dest + 4, vdupq_lane_f32( vget_low_f32( s ), 1 ) );
+			vst1q_f32( dest + 8, vdupq_lane_f32( vget_high_f32( s ), 0 ) );
+			vst1q_f32( dest + 12, vdupq_lane_f32( vget_high_f32( s ), 1 ) );
+		} else {
+			float32x4_t lo = vcombine_f32( vget_low_f32( s ), vget_low_f32( s ) );
+			float32x4_t hi = vcombine_f32( vget_high_f32( s ), vget_high_f32( s ) );
+			vst1q_f32( dest + 0, lo );
+			vst1q_f32( dest + 4, lo );
+			vst1q_f32( dest + 8, hi );
+			vst1q_f32( dest + 12, hi );
+		}
+		return dest + 16;
+	} else if ( kHz == 22050 ) {
+		if ( numChannels == 1 ) {
+			float32x4x2_t z = vzipq_f32( s, s );
+			vst1q_f32( dest + 0, z.val[0] );
+			vst1q_f32( dest + 4, z.val[1] );
+		} else {
+			vst1q_f32( dest + 0, vcombine_f32( vget_low_f32( s ), vget_low_f32( s ) ) );
+			vst1q_f32( dest + 4, vcombine_f32( vget_high_f32( s ), vget_high_f32( s ) ) );
+		}
+		return dest + 8;
+	} else {
+		vst1q_f32( dest, s );
+		return dest + 4;
+	}
+}
+
+/*
+============
+idSIMD_NEON::UpSamplePCMTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void VPCALL idSIMD_NEON::UpSamplePCMTo44kHz( float *dest, const short *src, const int numSamples, const int kHz, const int numChannels ) {
+	int i;
+
+	if ( kHz != 11025 && kHz != 22050 && kHz != 44100 ) {
+		assert( 0 );
+		return;
+	}
+
+	for ( i = 0; i + 4 <= numSamples; i += 4 ) {
+		dest = UpSample4( dest, vcvtq_f32_s32( vmovl_s16( vld1_s16( src + i ) ) ), kHz, numChannels );
+	}
+
+	if ( i < numSamples ) {
+		idSIMD_Generic::UpSamplePCMTo44kHz( dest, src + i, numSamples - i, kHz, numChannels );
+	}
+}
+
+/*
+============
+idSIMD_NEON::UpSampleOGGTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void VPCALL idSIMD_NEON::UpSampleOGGTo44kHz( float *dest, const float * const *ogg, const int numSamples, const int kHz, const int numChannels ) {
+	int i;
+
+	if ( kHz != 11025 && kHz != 22050 && kHz != 44100 ) {
+		assert( 0 );
+		return;
+	}
+
+	const float32x4_t scale = vdupq_n_f32( 32768.0f );
+
+	if ( numChannels == 1 ) {
+		for ( i = 0; i + 4 <= numSamples; i += 4 ) {
+			dest = UpSample4( dest, vmulq_f32( vld1q_f32( ogg[0] + i ), scale ), kHz, 1 );
+		}
+		if ( i < numSamples ) {
+			const float *tail[1] = { ogg[0] + i };
+			idSIMD_Generic::UpSampleOGGTo44kHz( dest, tail, numSamples - i, kHz, 1 );
+		}
+	} else {
+		// the channels are decoded into separate buffers, interleave them first
+		for ( i = 0; i + 4 <= ( numSamples >> 1 ); i += 4 ) {
+			float32x4x2_t z = vzipq_f32( vmulq_f32( vld1q_f32( ogg[0] + i ), scale ), vmulq_f32( vld1q_f32( ogg[1] + i ), scale ) );
+			dest = UpSample4( dest, z.val[0], kHz, 2 );
+			dest = UpSample4( dest, z.val[1], kHz, 2 );
+		}
+		if ( i < ( numSamples >> 1 ) ) {
+			const float *tail[2] = { ogg[0] + i, ogg[1] + i };
+			idSIMD_Generic::UpSampleOGGTo44kHz( dest, tail, numSamples - i * 2, kHz, 2 );
+		}
+	}
+}
+
+/*
+============
+idSIMD_NEON::MixSoundTwoSpeakerMono
+
+  four samples at a time, the volume ramps are stepped by four samples
+============
+*/
+void VPCALL idSIMD_NEON::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+	float v[8], inc[4];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	for ( int k = 0; k < 4; k++ ) {
+		v[k*2+0] = lastV[0] + k * incL;
+		v[k*2+1] = lastV[1] + k * incR;
+	}
+	inc[0] = inc[2] = 4.0f * incL;
+	inc[1] = inc[3] = 4.0f * incR;
+
+	float32x4_t vol0 = vld1q_f32( v + 0 );
+	float32x4_t vol1 = vld1q_f32( v + 4 );
+	const float32x4_t vinc = vld1q_f32( inc );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		float32x4_t s = vld1q_f32( samples + j );
+		float32x4x2_t z = vzipq_f32( s, s );
+		float *dst = mixBuffer + j*2;
+
+		vst1q_f32( dst + 0, vmlaq_f32( vld1q_f32( dst + 0 ), z.val[0], vol0 ) );
+		vst1q_f32( dst + 4, vmlaq_f32( vld1q_f32( dst + 4 ), z.val[1], vol1 ) );
+
+		vol0 = vaddq_f32( vol0, vinc );
+		vol1 = vaddq_f32( vol1, vinc );
+	}
+}
+
+/*
+============
+idSIMD_NEON::MixSoundTwoSpeakerStereo
+============
+*/
+void VPCALL idSIMD_NEON::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+	float v[8], inc[4];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	for ( int k = 0; k < 4; k++ ) {
+		v[k*2+0] = lastV[0] + k * incL;
+		v[k*2+1] = lastV[1] + k * incR;
+	}
+	inc[0] = inc[2] = 4.0f * incL;
+	inc[1] = inc[3] = 4.0f * incR;
+
+	float32x4_t vol0 = vld1q_f32( v + 0 );
+	float32x4_t vol1 = vld1q_f32( v + 4 );
+	const float32x4_t vinc = vld1q_f32( inc );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		float *dst = mixBuffer + j*2;
+
+		vst1q_f32( dst + 0, vmlaq_f32( vld1q_f32( dst + 0 ), vld1q_f32( samples + j*2 + 0 ), vol0 ) );
+		vst1q_f32( dst + 4, vmlaq_f32( vld1q_f32( dst + 4 ), vld1q_f32( samples + j*2 + 4 ), vol1 ) );
+
+		vol0 = vaddq_f32( vol0, vinc );
+		vol1 = vaddq_f32( vol1, vinc );
+	}
+}
+
+/*
+============
+SixSpeakerVolumes
+
+  the volumes of two samples of six speakers, and how much they change over two samples
+============
+*/
+static inline void SixSpeakerVolumes( float32x4_t vol[3], float32x4_t inc[3], const float lastV[6], const float currentV[6] ) {
+	float v[12], i2[12];
+
+	for ( int c = 0; c < 6; c++ ) {
+		float incV = ( currentV[c] - lastV[c] ) / MIXBUFFER_SAMPLES;
+		v[c] = lastV[c];
+		v[6+c] = lastV[c] + incV;
+		i2[c] = i2[6+c] = 2.0f * incV;
+	}
+	for ( int r = 0; r < 3; r++ ) {
+		vol[r] = vld1q_f32( v + r * 4 );
+		inc[r] = vld1q_f32( i2 + r * 4 );
+	}
+}
+
+/*
+============
+idSIMD_NEON::MixSoundSixSpeakerMono
+============
+*/
+void VPCALL idSIMD_NEON::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	float32x4_t vol[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SixSpeakerVolumes( vol, inc, lastV, currentV );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 2 ) {
+		float32x2_t s = vld1_f32( samples + i );
+		float *dst = mixBuffer + i*6;
+
+		// s0 s0 s0 s0, s0 s0 s1 s1, s1 s1 s1 s1
+		float32x2_t s0 = vdup_lane_f32( s, 0 );
+		float32x2_t s1 = vdup_lane_f32( s, 1 );
+
+		vst1q_f32( dst + 0, vmlaq_f32( vld1q_f32( dst + 0 ), vcombine_f32( s0, s0 ), vol[0] ) );
+		vst1q_f32( dst + 4, vmlaq_f32( vld1q_f32( dst + 4 ), vcombine_f32( s0, s1 ), vol[1] ) );
+		vst1q_f32( dst + 8, vmlaq_f32( vld1q_f32( dst + 8 ), vcombine_f32( s1, s1 ), vol[2] ) );
+
+		vol[0] = vaddq_f32( vol[0], inc[0] );
+		vol[1] = vaddq_f32( vol[1], inc[1] );
+		vol[2] = vaddq_f32( vol[2], inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_NEON::MixSoundSixSpeakerStereo
+
+  speakers 0, 2, 3 and 4 get the left channel, 1 and 5 the right one
+============
+*/
+void VPCALL idSIMD_NEON::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	float32x4_t vol[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SixSpeakerVolumes( vol, inc, lastV, currentV );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 2 ) {
+		float32x2_t p = vld1_f32( samples + i*2 + 0 );
+		float32x2_t q = vld1_f32( samples + i*2 + 2 );
+		float *dst = mixBuffer + i*6;
+
+		// L0 R0 L0 L0, L0 R0 L1 R1, L1 L1 L1 R1
+		vst1q_f32( dst + 0, vmlaq_f32( vld1q_f32( dst + 0 ), vcombine_f32( p, vdup_lane_f32( p, 0 ) ), vol[0] ) );
+		vst1q_f32( dst + 4, vmlaq_f32( vld1q_f32( dst + 4 ), vcombine_f32( p, q ), vol[1] ) );
+		vst1q_f32( dst + 8, vmlaq_f32( vld1q_f32( dst + 8 ), vcombine_f32( vdup_lane_f32( q, 0 ), q ), vol[2] ) );
+
+		vol[0] = vaddq_f32( vol[0], inc[0] );
+		vol[1] = vaddq_f32( vol[1], inc[1] );
+		vol[2] = vaddq_f32( vol[2], inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_NEON::MixedSoundToSamples
+============
+*/
+void VPCALL idSIMD_NEON::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	int i;
+
+	const float32x4_t minSample = vdupq_n_f32( -32768.0f );
+	const float32x4_t maxSample = vdupq_n_f32( 32767.0f );
+
+	for ( i = 0; i + 8 <= numSamples; i += 8 ) {
+		float32x4_t m0 = vminq_f32( vmaxq_f32( vld1q_f32( mixBuffer + i + 0 ), minSample ), maxSample );
+		float32x4_t m1 = vminq_f32( vmaxq_f32( vld1q_f32( mixBuffer + i + 4 ), minSample ), maxSample );
+		vst1q_s16( samples + i, vcombine_s16( vqmovn_s32( vcvtq_s32_f32( m0 ) ), vqmovn_s32( vcvtq_s32_f32( m1 ) ) ) );
+	}
+
+	if ( i < numSamples ) {
+		idSIMD_Generic::MixedSoundToSamples( samples + i, mixBuffer + i, numSamples - i );
+	}
+}
+
+#endif /* ID_SIMD_NEON */
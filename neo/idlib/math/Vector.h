@@ -1499,9 +1499,10 @@ private:
 	int				alloced;				// if -1 p points to data set with SetData
 	float *			p;						// memory the vector is stored
 
-	static float	temp[VECX_MAX_TEMP+4];	// used to store intermediate results
-	static float *	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	// every thread has its own pool so the physics can be solved on the job threads
+	static thread_local float	temp[VECX_MAX_TEMP+4];	// used to store intermediate results
+	static thread_local float *	tempPtr;				// pointer to 16 byte aligned temporary memory
+	static thread_local int		tempIndex;				// index into memory pool, wraps around
 
 private:
 	void			SetTempSize( int size );
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "idlib/containers/List.h"
 #include "framework/FileSystem.h"
+#include "sys/sys_public.h"
 #include "renderer/Material.h"
 #include "renderer/qgl.h"
 
@@ -150,6 +151,55 @@ typedef enum {
 
 #define	MAX_IMAGE_NAME	256
 
+class idImage;
+
+// one mip level prepared by a background load
+typedef enum {
+	SL_RGBA,		// plain RGBA8
+	SL_ETC1,		// r_useETC1 compressed
+	SL_RGBA4444		// r_useETC1 with alpha
+} stagingLevelFormat_t;
+
+typedef struct {
+	stagingLevelFormat_t	format;
+	int					width, height;
+	int					size;
+	byte *				data;
+} stagingLevel_t;
+
+// identifies an image and the settings it was built with in the ETC1 cache
+typedef struct {
+	unsigned int		hash;			// names the cache file
+	unsigned int		check;			// kept in the file to catch hash collisions
+} etcCacheKey_t;
+
+static const int MAX_STAGING_LEVELS = 16;
+
+// An image being read, decoded and built into a mip chain by a job, then
+// waiting for the GL thread to upload it. The settings are copied from the
+// image when the load starts, the job doesn't touch the idImage
+typedef struct imageStaging_s {
+	idImage *			image;			// NULL if the image was purged before the upload
+	char				imgName[MAX_IMAGE_NAME];
+	bool				allowDownSize;
+	ID_TIME_T			timestamp;		// R_LoadImageProgram sets these two again,
+	textureDepth_t		depth;			// they go to the image at upload
+	byte *				pic;			// from R_LoadImageProgram, freed at upload
+	int					width, height;
+	int					scaledWidth, scaledHeight;	// after GetDownsize
+	textureRepeat_t		repeat;
+	bool				colorMipLevels;
+	bool				compress;		// r_useETC1
+	bool				writeCache;		// r_useETC1Cache, written when uploaded
+	etcCacheKey_t		cacheKey;
+	int					numLevels;		// 0 if the file couldn't be loaded
+	stagingLevel_t		levels[MAX_STAGING_LEVELS];
+	int					totalSize;
+	idStr *				log;			// loader messages, printed at upload
+	char				error[MAX_STRING_CHARS];	// raised at upload if set
+	struct imageStaging_s *next;		// linked from globalImages->finishedImageLoads
+} imageStaging_t;
+
 class idImage {
 public:
 				idImage();
@@ -164,6 +214,7 @@ public:
 	void		BindFragment();
 
 	// deletes the texture object, but leaves the structure so it can be reloaded
+	// also drops a background load that hasn't been uploaded yet
 	void		PurgeImage();
 
 	// used by callback functions to specify the actual data
@@ -201,10 +252,17 @@ public:
 
 //==========================================================
 
+	int			DownsizeLimit() const;
 	void		GetDownsize( int &scaled_width, int &scaled_height ) const;
 	void		MakeDefault();	// fill with a grid pattern
 	void		SetImageFilterAndRepeat() const;
 	void		ActuallyLoadImage( bool fromBind );
+	bool		ShouldLoadInBackground() const;
+	imageStaging_t *AllocStaging() const;
+	imageStaging_t *AllocStaging( byte *pic, int width, int height ) const;
+	void		StartBackgroundLoad( imageStaging_t *staging );
+	void		UploadStaging( const imageStaging_t *staging );
+	void		UploadLevels( const stagingLevel_t *levels, int numLevels );
 	int			BitsForInternalFormat( int internalFormat ) const;
 	void		UploadCompressedNormalMap( int width, int height, const byte *rgba, int mipLevel );
 	void		ImageProgramStringToCompressedFileName( const char *imageProg, char *fileName ) const;
@@ -218,9 +276,7 @@ public:
 	int					bindCount;				// incremented each bind
 
 	// background loading information
-	bool				backgroundLoadInProgress;	// true if another thread is reading the complete d3t file
-	backgroundDownload_t	bgl;
-	idImage *			bglNext;				// linked from tr.backgroundImageLoads
+	imageStaging_t *	backgroundLoad;			// non-NULL while a job is loading the image
 
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
@@ -265,10 +321,7 @@ ID_INLINE idImage::idImage() {
 	type = TT_DISABLED;
 	frameUsed = 0;
 	classification = 0;
-	backgroundLoadInProgress = false;
-	bgl.opcode = DLTYPE_FILE;
-	bgl.f = NULL;
-	bglNext = NULL;
+	backgroundLoad = NULL;
 	imgName[0] = '\0';
 	generatorFunction = NULL;
 	allowDownSize = false;
@@ -352,8 +405,19 @@ public:
 	void				AddAllocList(idImage * image);
 	void				AddPurgeList(idImage * iamge);
 
-	idImage *			GetNextAllocImage();
-	idImage *			GetNextPurgeImage();
+	// Swaps everything queued so far into the lists of a frame about to be
+	// handed to the backend. The lists passed in must be empty.
+	void				TakeQueuedImages( idList<idImage*> &alloc, idList<idImage*> &purge );
+
+	// Background loads are read, decoded, mipmapped and compressed by jobs,
+	// then uploaded by the backend a few per frame, up to image_uploadBudget.
+	// Only call these from the thread that owns the GL context
+	void				UploadBackgroundLoads();
+	void				CancelBackgroundLoads();	// waits for the jobs and drops their results
+	void				FinishBackgroundLoad( imageStaging_t *staging );	// called by the jobs
+
+	// true if a job has finished a load, any thread
+	bool				BackgroundLoadsReady();
 
 	// used to clear and then write the dds conversion batch file
 	void				StartBuild();
@@ -373,6 +437,8 @@ public:
 	static idCVar		image_writeTGA;				// debug tool to write out .tgas of the non normal maps
 	static idCVar		image_preload;				// if 0, dynamically load all images
 	static idCVar		image_showBackgroundLoads;	// 1 = print number of outstanding background loads
+	static idCVar		image_backgroundLoad;		// load images on the job system threads
+	static idCVar		image_uploadBudget;			// KB of background loaded textures uploaded per frame
 	static idCVar		image_forceDownSize;		// allows the ability to force a downsize
 	static idCVar		image_downSizeSpecular;		// downsize specular
 	static idCVar		image_downSizeSpecularLimit;// downsize specular limit
@@ -428,17 +494,24 @@ public:
 
 	idImage *			imageHashTable[FILE_HASH_SIZE];
 
-	idImage *			backgroundImageLoads;		// chain of images that have background file loads active
+	xjobGroup_t			backgroundImageJobs;
+	imageStaging_t *	finishedImageLoads;			// built by the jobs, waiting for upload, under CRITICAL_SECTION_TWO
+	imageStaging_t *	finishedImageLoadsTail;
+	int					numActiveBackgroundImageLoads;	// started and not yet uploaded, GL thread only
+	const static int MAX_BACKGROUND_IMAGE_LOADS = 16;	// bounds the staging memory
+	idList<idImage*>	deferredImageLoads;			// started as uploads free up slots, GL thread only
+
 	idImage				cacheLRU;					// head/tail of doubly linked list
 	int					totalCachedImageSize;		// for determining when something should be purged
-
-	int	numActiveBackgroundImageLoads;
-	const static int MAX_BACKGROUND_IMAGE_LOADS = 8;
 };
 
 extern idImageManager	*globalImages;		// pointer to global list for the rest of the system
 
 int MakePowerOfTwo( int num );
+int R_DownsizeLimit( textureDepth_t depth, bool allowDownSize );
+void R_SetStagingPic( imageStaging_t *staging, byte *pic, int width, int height );
+void R_BuildStagingLevels( void *staging );	// imageStaging_t, can run as a job
+void R_FreeStaging( imageStaging_t *staging );
 
 /*
 ====================================================================
@@ -455,6 +528,7 @@ byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
 							int outwidth, int outheight );
 byte *R_MipMapWithAlphaSpecularity( const byte *in, int width, int height );
 byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder );
+void R_MipMapInto( const byte *in, int width, int height, bool preserveBorder, byte *out );
 byte *R_MipMap3D( const byte *in, int width, int height, int depth, bool preserveBorder );
 
 // these operate in-place on the provided pixels
@@ -477,6 +551,15 @@ void R_LoadImage( const char *name, byte **pic, int *width, int *height, ID_TIME
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char *cname, cubeFiles_t extensions, byte *pic[6], int *size, ID_TIME_T *timestamp );
 
+// The loaders report through these. While a load job has set a log the
+// messages are appended to it and errors are thrown as an idException,
+// the GL thread prints and raises them when it uploads the image
+idStr *R_SetImageLoadLog( idStr *log );		// returns the previous log
+idStr *R_GetImageLoadLog();
+void R_ImageLoadPrintf( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void R_ImageLoadWarning( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void R_ImageLoadError( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+
 /*
 ====================================================================
 
@@ -488,4 +571,22 @@ IMAGEPROGRAM
 void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp, textureDepth_t *depth = NULL );
 const char *R_ParsePastImageProgram( idLexer &src );
 
+/*
+====================================================================
+
+ETC1 CACHE
+
+====================================================================
+*/
+
+unsigned int etc1_data_size( unsigned int width, unsigned int height );
+
+// the image timestamp and depth must be current, see ActuallyLoadImage
+etcCacheKey_t R_EtcCacheKey( const idImage *image );
+etcCacheKey_t R_EtcCacheKey( const char *imgName, ID_TIME_T timestamp, textureDepth_t depth, textureRepeat_t repeat, int downsizeLimit );
+bool R_EtcCacheExists( const etcCacheKey_t &key );
+bool R_UploadFromEtcCache( idImage *image, const etcCacheKey_t &key );
+void R_WriteEtcCache( const imageStaging_t *staging );
+void R_BuildEtcCache_f( const idCmdArgs &args );
+
 #endif
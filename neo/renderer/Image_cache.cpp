@@ -0,0 +1,326 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "idlib/hashing/CRC32.h"
+#include "idlib/hashing/MD5.h"
+#include "framework/CmdSystem.h"
+#include "renderer/tr_local.h"
+
+#include "renderer/Image.h"
+
+/*
+
+With r_useETC1Cache, the compressed mip chain of every file image is kept in
+etccache/ under fs_savepath, one file per image. The file name is a hash of
+the image program string, the source timestamp and the settings that change
+the result, so editing a texture or changing the downsize options just makes
+a new entry instead of loading a stale one.
+
+The files are mapped and uploaded straight from the mapping. They are
+written in native byte order, they are only meant for the machine that
+built them.
+
+*/
+
+static const int ETC_CACHE_IDENT = ( '1' << 24 ) + ( 'C' << 16 ) + ( 'T' << 8 ) + 'E';
+static const int ETC_CACHE_VERSION = 1;
+
+typedef struct {
+	int					format;			// stagingLevelFormat_t
+	int					width, height;
+	int					size;
+	int					offset;			// from the start of the file, 4 byte aligned
+} etcCacheLevel_t;
+
+typedef struct {
+	int					ident;
+	int					version;
+	unsigned int		check;			// etcCacheKey_t::check
+	int					numLevels;
+	etcCacheLevel_t		levels[MAX_STAGING_LEVELS];
+} etcCacheHeader_t;
+
+/*
+================
+R_EtcCachePath
+================
+*/
+static void R_EtcCachePath( const etcCacheKey_t &key, char path[MAX_OSPATH] ) {
+	idStr::snPrintf( path, MAX_OSPATH, "etccache/%08x.etc1", key.hash );
+}
+
+/*
+================
+R_EtcCacheKey
+================
+*/
+etcCacheKey_t R_EtcCacheKey( const idImage *image ) {
+	return R_EtcCacheKey( image->imgName, image->timestamp, image->depth, image->repeat, image->DownsizeLimit() );
+}
+
+/*
+================
+R_EtcCacheKey
+
+the same for a load job, which only has the settings in the staging
+================
+*/
+etcCacheKey_t R_EtcCacheKey( const char *imgName, ID_TIME_T timestamp, textureDepth_t depth, textureRepeat_t repeat, int downsizeLimit ) {
+	etcCacheKey_t	key;
+	idStr			keyString;
+
+	// the mip levels only get the color tint on diffuse maps
+	bool colorMipLevels = ( depth == TD_DIFFUSE && globalImages->image_colorMipLevels.GetBool() );
+
+	sprintf( keyString, "%s %u %i %i %i %i %i %i", imgName, (unsigned int)timestamp,
+				depth, repeat, downsizeLimit, glConfig.maxTextureSize, colorMipLevels, ETC_CACHE_VERSION );
+
+	key.hash = MD5_BlockChecksum( keyString.c_str(), keyString.Length() );
+	key.check = CRC32_BlockChecksum( keyString.c_str(), keyString.Length() );
+	return key;
+}
+
+/*
+================
+R_MapEtcCache
+
+Returns the mapped file if it is a valid entry for the key
+================
+*/
+static const etcCacheHeader_t *R_MapEtcCache( const etcCacheKey_t &key, int *size ) {
+	char	path[MAX_OSPATH];
+
+	R_EtcCachePath( key, path );
+
+	const etcCacheHeader_t *header = (const etcCacheHeader_t *)Sys_MapFile( fileSystem->RelativePathToOSPath( path, "fs_savepath" ), size );
+	if ( !header ) {
+		return NULL;
+	}
+
+	bool valid = ( *size >= (int)sizeof( *header ) && header->ident == ETC_CACHE_IDENT && header->version == ETC_CACHE_VERSION
+					&& header->check == key.check && header->numLevels >= 1 && header->numLevels <= MAX_STAGING_LEVELS );
+
+	for ( int i = 0 ; valid && i < header->numLevels ; i++ ) {
+		const etcCacheLevel_t &level = header->levels[i];
+
+		if ( level.offset < (int)sizeof( *header ) || level.size <= 0 || level.offset > *size - level.size ) {
+			valid = false;
+		} else if ( level.format == SL_ETC1 ) {
+			valid = ( level.size == (int)etc1_data_size( level.width, level.height ) );
+		} else if ( level.format == SL_RGBA4444 ) {
+			valid = ( level.size == level.width * level.height * 2 );
+		} else {
+			valid = false;
+		}
+	}
+
+	if ( !valid ) {
+		common->DPrintf( "R_MapEtcCache: ignoring bad cache file %s\n", path );
+		Sys_UnmapFile( header, *size );
+		return NULL;
+	}
+
+	return header;
+}
+
+/*
+================
+R_EtcCacheExists
+================
+*/
+bool R_EtcCacheExists( const etcCacheKey_t &key ) {
+	int size;
+	const etcCacheHeader_t *header = R_MapEtcCache( key, &size );
+
+	if ( !header ) {
+		return false;
+	}
+	Sys_UnmapFile( header, size );
+	return true;
+}
+
+/*
+================
+R_UploadFromEtcCache
+================
+*/
+bool R_UploadFromEtcCache( idImage *image, const etcCacheKey_t &key ) {
+	stagingLevel_t	levels[MAX_STAGING_LEVELS];
+	int				size;
+
+	const etcCacheHeader_t *header = R_MapEtcCache( key, &size );
+	if ( !header ) {
+		return false;
+	}
+
+	for ( int i = 0 ; i < header->numLevels ; i++ ) {
+		levels[i].format = (stagingLevelFormat_t)header->levels[i].format;
+		levels[i].width = header->levels[i].width;
+		levels[i].height = header->levels[i].height;
+		levels[i].size = header->levels[i].size;
+		levels[i].data = (byte *)header + header->levels[i].offset;
+	}
+
+	image->UploadLevels( levels, header->numLevels );
+
+	Sys_UnmapFile( header, size );
+	return true;
+}
+
+/*
+================
+R_WriteEtcCache
+================
+*/
+void R_WriteEtcCache( const imageStaging_t *staging ) {
+	etcCacheHeader_t	header;
+	char				path[MAX_OSPATH];
+	int					total;
+
+	assert( staging->compress );
+
+	memset( &header, 0, sizeof( header ) );
+	header.ident = ETC_CACHE_IDENT;
+	header.version = ETC_CACHE_VERSION;
+	header.check = staging->cacheKey.check;
+	header.numLevels = staging->numLevels;
+
+	total = sizeof( header );
+	for ( int i = 0 ; i < staging->numLevels ; i++ ) {
+		header.levels[i].format = staging->levels[i].format;
+		header.levels[i].width = staging->levels[i].width;
+		header.levels[i].height = staging->levels[i].height;
+		header.levels[i].size = staging->levels[i].size;
+		header.levels[i].offset = total;
+		total += ( staging->levels[i].size + 3 ) & ~3;
+	}
+
+	byte *buffer = (byte *)R_StaticAlloc( total );
+	memset( buffer, 0, total );
+	memcpy( buffer, &header, sizeof( header ) );
+	for ( int i = 0 ; i < staging->numLevels ; i++ ) {
+		memcpy( buffer + header.levels[i].offset, staging->levels[i].data, staging->levels[i].size );
+	}
+
+	R_EtcCachePath( staging->cacheKey, path );
+	fileSystem->WriteFile( path, buffer, total );
+
+	R_StaticFree( buffer );
+}
+
+/*
+================
+R_FlushEtcCacheBatch
+================
+*/
+static void R_FlushEtcCacheBatch( xjobGroup_t &jobs, imageStaging_t **batch, int &numBatch ) {
+	Sys_WaitJobGroup( jobs );
+
+	for ( int i = 0 ; i < numBatch ; i++ ) {
+		R_WriteEtcCache( batch[i] );
+		R_FreeStaging( batch[i] );
+	}
+	numBatch = 0;
+}
+
+/*
+================
+R_BuildEtcCache_f
+
+Compresses every file image the current level uses into the ETC1 cache, so
+loading the map doesn't have to. With a map name, the map is loaded first.
+================
+*/
+void R_BuildEtcCache_f( const idCmdArgs &args ) {
+	xjobGroup_t		jobs;
+	imageStaging_t	*batch[idImageManager::MAX_BACKGROUND_IMAGE_LOADS];
+	int				numBatch = 0;
+	int				numBuilt = 0;
+	int				numCached = 0;
+
+	if ( args.Argc() > 1 ) {
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, va( "map %s\nbuildEtcCache\n", args.Args() ) );
+		return;
+	}
+
+	if ( !glConfig.isInitialized ) {
+		common->Printf( "buildEtcCache needs the renderer running, the size limits are part of the cache key\n" );
+		return;
+	}
+
+	int start = Sys_Milliseconds();
+
+	Sys_InitJobGroup( jobs, "buildEtcCache" );
+
+	for ( int i = 0 ; i < globalImages->images.Num() ; i++ ) {
+		idImage	*image = globalImages->images[i];
+		byte	*pic;
+		int		width, height;
+
+		if ( image->generatorFunction || image->cinematic || image->cubeFiles != CF_2D ) {
+			continue;
+		}
+		if ( !image->levelLoadReferenced && !image->referencedOutsideLevelLoad ) {
+			continue;
+		}
+
+		// the timestamp and depth the load would get are part of the key
+		R_LoadImageProgram( image->imgName, NULL, NULL, NULL, &image->timestamp, &image->depth );
+		if ( R_EtcCacheExists( R_EtcCacheKey( image ) ) ) {
+			numCached++;
+			continue;
+		}
+
+		R_LoadImageProgram( image->imgName, &pic, &width, &height, &image->timestamp, &image->depth );
+		if ( pic == NULL ) {
+			continue;
+		}
+
+		// compress even if r_useETC1 is off now, and don't tie it to the
+		// image, the result only goes to the file
+		imageStaging_t *staging = image->AllocStaging( pic, width, height );
+		staging->image = NULL;
+		staging->compress = true;
+		staging->writeCache = true;
+
+		batch[numBatch++] = staging;
+		Sys_SubmitJob( jobs, R_BuildStagingLevels, staging, "buildEtcCache" );
+		numBuilt++;
+
+		// the staging buffers add up, don't have too many at once
+		if ( numBatch == idImageManager::MAX_BACKGROUND_IMAGE_LOADS ) {
+			R_FlushEtcCacheBatch( jobs, batch, numBatch );
+		}
+	}
+	R_FlushEtcCacheBatch( jobs, batch, numBatch );
+
+	common->Printf( "%5i images compressed\n", numBuilt );
+	common->Printf( "%5i already in the cache\n", numCached );
+	common->Printf( "ETC1 cache built in %5.1f seconds\n", ( Sys_Milliseconds() - start ) * 0.001f );
+}
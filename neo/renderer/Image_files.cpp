@@ -49,6 +49,89 @@ void R_LoadImage( const char *name, byte **pic, int *width, int *height, bool ma
 
 */
 
+static thread_local idStr *	imageLoadLog;		// set while a background load job runs
+
+/*
+================
+R_SetImageLoadLog
+================
+*/
+idStr *R_SetImageLoadLog( idStr *log ) {
+	idStr *oldLog = imageLoadLog;
+	imageLoadLog = log;
+	return oldLog;
+}
+
+/*
+================
+R_GetImageLoadLog
+================
+*/
+idStr *R_GetImageLoadLog() {
+	return imageLoadLog;
+}
+
+/*
+================
+R_ImageLoadPrintf
+================
+*/
+void R_ImageLoadPrintf( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( imageLoadLog ) {
+		imageLoadLog->Append( text );
+	} else {
+		common->Printf( "%s", text );
+	}
+}
+
+/*
+================
+R_ImageLoadWarning
+================
+*/
+void R_ImageLoadWarning( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( imageLoadLog ) {
+		imageLoadLog->Append( S_COLOR_YELLOW "WARNING: " S_COLOR_RED );
+		imageLoadLog->Append( text );
+		imageLoadLog->Append( "\n" );
+	} else {
+		common->Warning( "%s", text );
+	}
+}
+
+/*
+================
+R_ImageLoadError
+================
+*/
+void R_ImageLoadError( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( imageLoadLog ) {
+		throw idException( text );
+	}
+	common->Error( "%s", text );
+}
+
 /*
 ================
 R_WriteTGA
@@ -278,19 +361,19 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 
 	if ( bmpHeader.id[0] != 'B' && bmpHeader.id[1] != 'M' )
 	{
-		common->Error( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
 	}
 	if ( bmpHeader.fileSize != length )
 	{
-		common->Error( "LoadBMP: header size does not match file size (%u vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
+		R_ImageLoadError( "LoadBMP: header size does not match file size (%u vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
 	}
 	if ( bmpHeader.compression != 0 )
 	{
-		common->Error( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
 	}
 	if ( bmpHeader.bitsPerPixel < 8 )
 	{
-		common->Error( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
 	}
 
 	columns = bmpHeader.width;
@@ -356,7 +439,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 				*pixbuf++ = alpha;
 				break;
 			default:
-				common->Error( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
+				R_ImageLoadError( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
 				break;
 			}
 		}
@@ -423,7 +506,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 		|| xmax >= 1024
 		|| ymax >= 1024)
 	{
-		common->Printf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax+1, ymax+1, pcx->xmax, pcx->ymax);
+		R_ImageLoadPrintf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax+1, ymax+1, pcx->xmax, pcx->ymax);
 		return;
 	}
 
@@ -467,7 +550,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 
 	if ( raw - (byte *)pcx > len)
 	{
-		common->Printf( "PCX file %s was malformed", filename );
+		R_ImageLoadPrintf( "PCX file %s was malformed", filename );
 		R_StaticFree (*pic);
 		*pic = NULL;
 	}
@@ -572,21 +655,21 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	targa_header.attributes = *buf_p++;
 
 	if ( targa_header.image_type != 2 && targa_header.image_type != 10 && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
 	}
 
 	if ( targa_header.colormap_type != 0 ) {
-		common->Error( "LoadTGA( %s ): colormaps not supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): colormaps not supported\n", name );
 	}
 
 	if ( ( targa_header.pixel_size != 32 && targa_header.pixel_size != 24 ) && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
 	}
 
 	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
 		numBytes = targa_header.width * targa_header.height * ( targa_header.pixel_size >> 3 );
 		if ( numBytes > fileSize - 18 - targa_header.id_length ) {
-			common->Error( "LoadTGA( %s ): incomplete file\n", name );
+			R_ImageLoadError( "LoadTGA( %s ): incomplete file\n", name );
 		}
 	}
 
@@ -650,7 +733,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 					*pixbuf++ = alphabyte;
 					break;
 				default:
-					common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+					R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 					break;
 				}
 			}
@@ -684,7 +767,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 								alphabyte = *buf_p++;
 								break;
 						default:
-							common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+							R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 							break;
 					}
 
@@ -729,7 +812,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 									*pixbuf++ = alphabyte;
 									break;
 							default:
-								common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+								R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 								break;
 						}
 						column++;
@@ -790,7 +873,7 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
 	Mem_Free( fbuffer );
 
 	if ( decodedImageData == NULL ) {
-		common->Warning( "stb_image was unable to load JPG %s : %s\n",
+		R_ImageLoadWarning( "stb_image was unable to load JPG %s : %s\n",
 					filename, stbi_failure_reason());
 		return;
 	}
@@ -50,6 +50,8 @@ idCVar idImageManager::image_anisotropy( "image_anisotropy", "1", CVAR_RENDERER
 idCVar idImageManager::image_colorMipLevels( "image_colorMipLevels", "0", CVAR_RENDERER | CVAR_BOOL, "development aid to see texture mip usage" );
 idCVar idImageManager::image_preload( "image_preload", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "if 0, dynamically load all images" );
 idCVar idImageManager::image_showBackgroundLoads( "image_showBackgroundLoads", "0", CVAR_RENDERER | CVAR_BOOL, "1 = print number of outstanding background loads" );
+idCVar idImageManager::image_backgroundLoad( "image_backgroundLoad", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "read, decode, mip map and ETC1 compress images on the job system threads, only the upload is left to the backend" );
+idCVar idImageManager::image_uploadBudget( "image_uploadBudget", "4096", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "KB of background loaded images uploaded per frame, at least one is always uploaded", 0, 65536 );
 idCVar idImageManager::image_downSize( "image_downSize", "0", CVAR_RENDERER | CVAR_ROM, "controls texture downsampling" );
 idCVar idImageManager::image_forceDownSize( "image_forceDownSize", "0", CVAR_RENDERER | CVAR_ROM | CVAR_BOOL, "" );
 idCVar idImageManager::image_roundDown( "image_roundDown", "0", CVAR_RENDERER | CVAR_ROM | CVAR_BOOL, "round bad sizes down to nearest power of two" );
@@ -1721,6 +1723,11 @@ void idImageManager::Init() {
 	imagesAlloc.Resize( 1024, 1024 );
 	imagesPurge.Resize( 1024, 1024 );
 
+	Sys_InitJobGroup( backgroundImageJobs, "backgroundImageLoads" );
+	finishedImageLoads = NULL;
+	finishedImageLoadsTail = NULL;
+	numActiveBackgroundImageLoads = 0;
+
 	// clear the cached LRU
 	cacheLRU.cacheUsageNext = &cacheLRU;
 	cacheLRU.cacheUsagePrev = &cacheLRU;
@@ -1758,6 +1765,7 @@ void idImageManager::Init() {
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "buildEtcCache", R_BuildEtcCache_f, CMD_FL_RENDERER, "compresses the images of the current map, or of the given map, into the ETC1 cache" );
 
 	// should forceLoadImages be here?
 }
@@ -1768,6 +1776,8 @@ Shutdown
 ===============
 */
 void idImageManager::Shutdown() {
+	CancelBackgroundLoads();
+
 	images.DeleteContents( true );
 
 	while(imagesAlloc.Num() > 0)
@@ -1897,39 +1907,182 @@ void idImageManager::AddAllocList( idImage * image )
 
 void idImageManager::AddPurgeList( idImage * image )
 {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+
 	if(image)
 	{
 		imagesPurge.Append( image );
 		image->purgePending = true;
 	}
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
 }
 
-idImage * idImageManager::GetNextAllocImage()
+void idImageManager::TakeQueuedImages( idList<idImage*> &alloc, idList<idImage*> &purge )
 {
-	idImage * img = NULL;
+	assert( alloc.Num() == 0 && purge.Num() == 0 );
+
+	// Swap rather than copy, the backend empties the frame lists without
+	// freeing them so the buffers just go back and forth
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+
+	imagesAlloc.Swap( alloc );
+	imagesPurge.Swap( purge );
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+}
+
+/*
+===============
+idImageManager::FinishBackgroundLoad
+
+Called by the jobs when a mip chain is ready
+===============
+*/
+void idImageManager::FinishBackgroundLoad( imageStaging_t *staging )
+{
+	staging->next = NULL;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
 
-	if(imagesAlloc.Num() > 0)
+	if( finishedImageLoadsTail )
 	{
-		img = imagesAlloc[0];
-		imagesAlloc.Remove( img );
+		finishedImageLoadsTail->next = staging;
 	}
+	else
+	{
+		finishedImageLoads = staging;
+	}
+	finishedImageLoadsTail = staging;
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+}
+
+/*
+===============
+idImageManager::BackgroundLoadsReady
+
+The front end only has to wait for an image phase when there is something to upload
+===============
+*/
+bool idImageManager::BackgroundLoadsReady()
+{
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	bool ready = ( finishedImageLoads != NULL );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
 
-	return img;
+	return ready;
 }
 
-idImage * idImageManager::GetNextPurgeImage()
+/*
+===============
+idImageManager::UploadBackgroundLoads
+
+Uploads the finished background loads in the order they finished until
+image_uploadBudget is used up, the rest waits for the next frame
+===============
+*/
+void idImageManager::UploadBackgroundLoads()
 {
-	idImage * img = NULL;
+	int budget = image_uploadBudget.GetInteger() * 1024;
+	int uploaded = 0;
+	int uploadedSize = 0;
 
-	if(imagesPurge.Num() > 0)
+	while( 1 )
 	{
-		img = imagesPurge[0];
-		imagesPurge.Remove( img );
-		img->purgePending = false;
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+
+		imageStaging_t *staging = finishedImageLoads;
+		if( staging && ( uploaded == 0 || uploadedSize + staging->totalSize <= budget ) )
+		{
+			finishedImageLoads = staging->next;
+			if( !finishedImageLoads )
+			{
+				finishedImageLoadsTail = NULL;
+			}
+		}
+		else
+		{
+			staging = NULL;
+		}
+
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+
+		if( !staging )
+		{
+			break;
+		}
+
+		// the jobs can't print, so the loader output shows up here
+		if( staging->log->Length() )
+		{
+			common->Printf( "%s", staging->log->c_str() );
+		}
+		if( staging->error[0] )
+		{
+			idStr error = staging->error;
+			if( staging->image )
+			{
+				staging->image->backgroundLoad = NULL;
+			}
+			R_FreeStaging( staging );
+			numActiveBackgroundImageLoads--;
+			common->Error( "%s", error.c_str() );
+		}
+
+		// the image may have been purged while the job ran
+		if( staging->image )
+		{
+			staging->image->UploadStaging( staging );
+			uploaded++;
+			uploadedSize += staging->totalSize;
+		}
+
+		R_FreeStaging( staging );
+		numActiveBackgroundImageLoads--;
 	}
 
-	return img;
+	// start the images that were waiting for a free slot
+	while( deferredImageLoads.Num() && numActiveBackgroundImageLoads < MAX_BACKGROUND_IMAGE_LOADS )
+	{
+		idImage *image = deferredImageLoads[0];
+		deferredImageLoads.RemoveIndex( 0 );
+		image->ActuallyLoadImage( false );
+	}
+
+	if( image_showBackgroundLoads.GetBool() && ( uploaded || numActiveBackgroundImageLoads ) )
+	{
+		common->Printf( "background image loads: %i uploaded (%i kB), %i outstanding\n", uploaded, uploadedSize >> 10, numActiveBackgroundImageLoads );
+	}
+}
+
+/*
+===============
+idImageManager::CancelBackgroundLoads
+===============
+*/
+void idImageManager::CancelBackgroundLoads()
+{
+	Sys_WaitJobGroup( backgroundImageJobs );
+
+	while( finishedImageLoads )
+	{
+		imageStaging_t *staging = finishedImageLoads;
+		finishedImageLoads = staging->next;
+
+		if( staging->image )
+		{
+			staging->image->backgroundLoad = NULL;
+		}
+		R_FreeStaging( staging );
+		numActiveBackgroundImageLoads--;
+	}
+	finishedImageLoadsTail = NULL;
+	deferredImageLoads.Clear();
+
+	assert( numActiveBackgroundImageLoads == 0 );
 }
+
 /*
 ===============
 idImageManager::StartBuild
@@ -204,11 +204,22 @@ void idImage::SetImageFilterAndRepeat() const {
 
 /*
 ================
-idImage::Downsize
-helper function that takes the current width/height and might make them smaller
+idImage::DownsizeLimit
+the largest size the image options allow for this image, 0 if not limited
 ================
 */
-void idImage::GetDownsize( int &scaled_width, int &scaled_height ) const {
+int idImage::DownsizeLimit() const {
+	return R_DownsizeLimit( depth, allowDownSize );
+}
+
+/*
+================
+R_DownsizeLimit
+
+the load jobs use this with the settings of the image in the staging
+================
+*/
+int R_DownsizeLimit( textureDepth_t depth, bool allowDownSize ) {
 	int size = 0;
 
 	// perform optional picmip operation to save texture memory
@@ -229,6 +240,17 @@ void idImage::GetDownsize( int &scaled_width, int &scaled_height ) const {
 		}
 	}
 
+	return size;
+}
+
+/*
+================
+R_Downsize
+
+shrinks width/height to the downsize limit and the hardware limit
+================
+*/
+static void R_Downsize( int size, int &scaled_width, int &scaled_height ) {
 	if ( size > 0 ) {
 		while ( scaled_width > size || scaled_height > size ) {
 			if ( scaled_width > 1 ) {
@@ -260,6 +282,16 @@ void idImage::GetDownsize( int &scaled_width, int &scaled_height ) const {
 	}
 }
 
+/*
+================
+idImage::Downsize
+helper function that takes the current width/height and might make them smaller
+================
+*/
+void idImage::GetDownsize( int &scaled_width, int &scaled_height ) const {
+	R_Downsize( DownsizeLimit(), scaled_width, scaled_height );
+}
+
 
 //Code from raspberrypi q3 for ETC image compression
 
@@ -273,8 +305,19 @@ static int isopaque(GLint width, GLint height, const GLvoid *pixels) {
 	return 1;
 }
 
+static void rgba4444_convert(const unsigned char *cpixels, int count, unsigned short *out) {
+	int i;
+	for (i = 0; i < count; i++) {
+		unsigned char r,g,b,a;
+		r = cpixels[4*i]>>4;
+		g = cpixels[4*i+1]>>4;
+		b = cpixels[4*i+2]>>4;
+		a = cpixels[4*i+3]>>4;
+		out[i] = r << 12 | g << 8 | b << 4 | a;
+	}
+}
+
 void rgba4444_convert_tex_image(
-    char* cachefname,
     GLenum target,
     GLint level,
     GLenum internalformat,
@@ -285,23 +328,9 @@ void rgba4444_convert_tex_image(
     GLenum type,
     const GLvoid *pixels) {
 	unsigned char const *cpixels = (unsigned char const *)pixels;
-	unsigned short *rgba4444data = (unsigned short *)malloc(2*width*height+1);
-	((unsigned char*)rgba4444data)[0]=1;
-	rgba4444data=(unsigned short *)((unsigned char*)rgba4444data+1);
-	int i;
-	for (i = 0; i < width * height; i++) {
-		unsigned char r,g,b,a;
-		r = cpixels[4*i]>>4;
-		g = cpixels[4*i+1]>>4;
-		b = cpixels[4*i+2]>>4;
-		a = cpixels[4*i+3]>>4;
-		rgba4444data[i] = r << 12 | g << 8 | b << 4 | a;
-	}
+	unsigned short *rgba4444data = (unsigned short *)malloc(2*width*height);
+	rgba4444_convert(cpixels, width * height, rgba4444data);
 	qglTexImage2D(target, level, format, width, height,border,format,GL_UNSIGNED_SHORT_4_4_4_4,rgba4444data);
-	rgba4444data=(unsigned short *)((unsigned char*)rgba4444data-1);
-	if (cachefname!=0) {
-		fileSystem->WriteFile(cachefname, rgba4444data, width*height*2+1);
-	}
 	free(rgba4444data);
 }
 //#define USE_RG_ETC1
@@ -315,8 +344,17 @@ unsigned int etc1_data_size(unsigned int width, unsigned int height) {
 	return (((width + 3) & ~3) * ((height + 3) & ~3)) >> 1;
 }
 
+static void etc1_encode(const unsigned char *cpixels, int width, int height, unsigned char *etc1data) {
+#ifdef USE_RG_ETC1
+	rg_etc1::etc1_encode_image(cpixels, width, height,
+	                           4, width*4, etc1data);
+#else
+	etc1_encode_image(cpixels, width, height,
+	                  4, width*4, etc1data);
+#endif
+}
+
 void etc1_compress_tex_image(
-    char* cachefname,
     GLenum target,
     GLint level,
     GLenum internalformat,
@@ -329,16 +367,8 @@ void etc1_compress_tex_image(
 	unsigned char const *cpixels = (unsigned char const *)pixels;
 	unsigned char *etc1data;
 	unsigned int size=etc1_data_size(width,height);
-	etc1data = (unsigned char *)malloc(size+1);
-	etc1data[0]=0;
-	etc1data++;
-#ifdef USE_RG_ETC1
-	rg_etc1::etc1_encode_image(cpixels, width, height,
-	                           4, width*4, etc1data);
-#else
-	etc1_encode_image(cpixels, width, height,
-	                  4, width*4, etc1data);
-#endif
+	etc1data = (unsigned char *)malloc(size);
+	etc1_encode(cpixels, width, height, etc1data);
 	qglCompressedTexImage2D(
 	    target,
 	    level,
@@ -348,79 +378,376 @@ void etc1_compress_tex_image(
 	    0,
 	    size,
 	    etc1data);
-	etc1data--;
-	if (cachefname!=0) {
-		fileSystem->WriteFile(cachefname, etc1data, size+1);
-	}
 	free(etc1data);
 }
 
-int etcavail(char* cachefname) {
-	return (r_useETC1Cache.GetBool())&&(r_useETC1.GetBool())&&(cachefname!=0)&&(fileSystem->ReadFile(cachefname,0,0)!=-1);
+// file images with r_useETC1 go through the staging path and the ETC1 cache,
+// this is left for generated images
+void myglTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {
+	static int opaque = 0;
+
+	if (r_useETC1.GetBool() && format == GL_RGBA && type == GL_UNSIGNED_BYTE) {
+
+		if (level == 0)
+			opaque = isopaque(width, height, pixels);
+
+		if (opaque)
+			etc1_compress_tex_image(target, level, format, width, height, border, format, type, pixels);
+		else
+			rgba4444_convert_tex_image(target, level, format, width, height, border, format, type, pixels);
+	} else {
+		qglTexImage2D(target,level,internalformat,width,height,border,format,type,pixels);
+	}
 }
 
-int uploadetc(char* cachefname,GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type) {
-	char* tmp;
-	int failed=0;
+//end
 
-	if( !etcavail( cachefname ) )
-		return 1;
+/*
+================
+R_BuildStagingLevels
 
-	int sz = fileSystem->ReadFile(cachefname,(void**)&tmp,0);
+Does the CPU side of GenerateImage for a staged load: shrinks the picture
+to the size GetDownsize picked, builds the mip chain and compresses it for
+r_useETC1. This runs as a job, the levels are malloc'd.
+================
+*/
+void R_BuildStagingLevels( void *data ) {
+	imageStaging_t	*staging = (imageStaging_t *)data;
+	bool			preserveBorder;
+	const byte		*src;
+	byte			*scaledBuffer;
+	byte			*shrunk;
+	int				width, height;
 
-	if( sz == -1 )
-		return 1;
+	// don't let mip mapping smear the texture into the clamped border
+	preserveBorder = ( staging->repeat == TR_CLAMP_TO_ZERO );
 
-	if (tmp[0]==0) {
-		if (sz==etc1_data_size(width,height)+1) {
-			qglCompressedTexImage2D(target,level,GL_ETC1_RGB8_OES,width,height,0,etc1_data_size(width,height),tmp + 1);
-		} else {
-			failed=1;
+	width = staging->width;
+	height = staging->height;
+
+	// resample down as needed
+	src = staging->pic;
+	scaledBuffer = NULL;
+	while ( width > staging->scaledWidth || height > staging->scaledHeight ) {
+		shrunk = (byte *)malloc( Max( width >> 1, 1 ) * Max( height >> 1, 1 ) * 4 );
+		R_MipMapInto( src, width, height, preserveBorder, shrunk );
+		free( scaledBuffer );
+		scaledBuffer = shrunk;
+		src = shrunk;
+
+		width = Max( width >> 1, 1 );
+		height = Max( height >> 1, 1 );
+	}
+
+	// we must copy even if unchanged, because the border zeroing
+	// would otherwise modify const data
+	if ( !scaledBuffer ) {
+		scaledBuffer = (byte *)malloc( width * height * 4 );
+		memcpy( scaledBuffer, src, width * height * 4 );
+	}
+
+	// zero the border if desired, allowing clamped projection textures
+	// even after picmip resampling or careless artists.
+	if ( staging->repeat == TR_CLAMP_TO_ZERO ) {
+		byte	rgba[4];
+
+		rgba[0] = rgba[1] = rgba[2] = 0;
+		rgba[3] = 255;
+		R_SetBorderTexels( scaledBuffer, width, height, rgba );
+	}
+	if ( staging->repeat == TR_CLAMP_TO_ZERO_ALPHA ) {
+		byte	rgba[4];
+
+		rgba[0] = rgba[1] = rgba[2] = 255;
+		rgba[3] = 0;
+		R_SetBorderTexels( scaledBuffer, width, height, rgba );
+	}
+
+	// swap the red and alpha for rxgb support
+	if ( staging->depth == TD_BUMP ) {
+		for ( int i = 0; i < width * height * 4; i += 4 ) {
+			scaledBuffer[ i + 3 ] = scaledBuffer[ i ];
+			scaledBuffer[ i ] = 0;
 		}
-	} else {
-		if (sz==width*height*2+1) {
-			qglTexImage2D(target,level,format,width,height,border,format,GL_UNSIGNED_SHORT_4_4_4_4,tmp + 1);
+	}
+
+	// like myglTexImage2D, the first level decides between ETC1 and RGBA4444
+	bool opaque = staging->compress && isopaque( width, height, scaledBuffer );
+
+	for ( int miplevel = 0 ; ; miplevel++ ) {
+		stagingLevel_t &level = staging->levels[miplevel];
+
+		assert( miplevel < MAX_STAGING_LEVELS );
+
+		// the next level is made from this one before it gets compressed
+		shrunk = NULL;
+		if ( width > 1 || height > 1 ) {
+			shrunk = (byte *)malloc( Max( width >> 1, 1 ) * Max( height >> 1, 1 ) * 4 );
+			R_MipMapInto( scaledBuffer, width, height, preserveBorder, shrunk );
+		}
+
+		level.width = width;
+		level.height = height;
+		if ( !staging->compress ) {
+			level.format = SL_RGBA;
+			level.size = width * height * 4;
+			level.data = scaledBuffer;
+		} else if ( opaque ) {
+			level.format = SL_ETC1;
+			level.size = etc1_data_size( width, height );
+			level.data = (byte *)malloc( level.size );
+			etc1_encode( scaledBuffer, width, height, level.data );
+			free( scaledBuffer );
 		} else {
-			failed=1;
+			level.format = SL_RGBA4444;
+			level.size = width * height * 2;
+			level.data = (byte *)malloc( level.size );
+			rgba4444_convert( scaledBuffer, width * height, (unsigned short *)level.data );
+			free( scaledBuffer );
+		}
+		staging->totalSize += level.size;
+		staging->numLevels = miplevel + 1;
+
+		if ( !shrunk ) {
+			break;
+		}
+		scaledBuffer = shrunk;
+		width = Max( width >> 1, 1 );
+		height = Max( height >> 1, 1 );
+
+		// this is a visualization tool that shades each mip map
+		// level with a different color so you can see the
+		// rasterizer's texture level selection algorithm
+		if ( staging->depth == TD_DIFFUSE && staging->colorMipLevels ) {
+			R_BlendOverTexture( scaledBuffer, width * height, mipBlendColors[miplevel + 1] );
+		}
+	}
+}
+
+/*
+================
+R_BackgroundLoadJob
+
+Reads and decodes the image, then builds the mip chain. The loader
+messages and errors are kept in the staging for the upload.
+================
+*/
+static void R_BackgroundLoadJob( void *data ) {
+	imageStaging_t	*staging = (imageStaging_t *)data;
+	byte			*pic;
+	int				width, height;
+
+	// other jobs may run on this thread while it waits for a job group
+	idStr *oldLog = R_SetImageLoadLog( staging->log );
+	try {
+		R_LoadImageProgram( staging->imgName, &pic, &width, &height, &staging->timestamp, &staging->depth );
+		if ( pic ) {
+			R_SetStagingPic( staging, pic, width, height );
+			R_BuildStagingLevels( staging );
 		}
+	} catch ( idException &ex ) {
+		idStr::Copynz( staging->error, ex.error, sizeof( staging->error ) );
 	}
+	R_SetImageLoadLog( oldLog );
 
-	tmp--;
-	fileSystem->FreeFile(tmp);
-	return failed;
+	globalImages->FinishBackgroundLoad( staging );
 }
 
-void myglTexImage2D(char* cachefname,GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {
-	static int opaque = 0;
+/*
+================
+R_FreeStaging
+================
+*/
+void R_FreeStaging( imageStaging_t *staging ) {
+	for ( int i = 0 ; i < staging->numLevels ; i++ ) {
+		free( staging->levels[i].data );
+	}
+	R_StaticFree( staging->pic );
+	delete staging->log;
+	free( staging );
+}
 
-	// LOGI("myglTexImage2D, name = %s", cachefname );
+/*
+================
+ShouldLoadInBackground
 
-	if (r_useETC1.GetBool() && format == GL_RGBA && type == GL_UNSIGNED_BYTE) {
+Reading, decoding, making the mip chain and compressing file images can
+be left to the job system while we go on with the next image. The debug
+tools that write the result out keep the synchronous path.
+================
+*/
+bool idImage::ShouldLoadInBackground() const {
+	if ( !globalImages->image_backgroundLoad.GetBool() || Sys_NumWorkerThreads() == 0 ) {
+		return false;
+	}
+	if ( !glConfig.isInitialized || cinematic || generatorFunction || cubeFiles != CF_2D ) {
+		return false;
+	}
+	if ( ( depth == TD_BUMP && globalImages->image_writeNormalTGA.GetBool() ) || ( depth != TD_BUMP && globalImages->image_writeTGA.GetBool() ) ) {
+		return false;
+	}
+	return true;
+}
 
-		if (level == 0)
-			opaque = isopaque(width, height, pixels);
+/*
+================
+AllocStaging
+
+Copies the settings the load depends on, timestamp and depth must be
+the current ones. The picture is added with R_SetStagingPic.
+================
+*/
+imageStaging_t *idImage::AllocStaging() const {
+	imageStaging_t	*staging;
+
+	staging = (imageStaging_t *)calloc( 1, sizeof( *staging ) );
+	staging->image = const_cast<idImage *>( this );
+	idStr::Copynz( staging->imgName, imgName, sizeof( staging->imgName ) );
+	staging->allowDownSize = allowDownSize;
+	staging->timestamp = timestamp;
+	staging->depth = depth;
+	staging->repeat = repeat;
+	staging->colorMipLevels = globalImages->image_colorMipLevels.GetBool();
+	staging->compress = r_useETC1.GetBool();
+	staging->writeCache = staging->compress && r_useETC1Cache.GetBool();
+	staging->log = new idStr;
+
+	return staging;
+}
 
-		if (!r_useETC1Cache.GetBool())
-			cachefname=0;
+/*
+================
+AllocStaging
 
-		if( uploadetc(cachefname, target, level, internalformat, width, height, border, format, type ) != 0 )
-		{
-			if (opaque)
-				etc1_compress_tex_image(cachefname,target, level, format, width, height, border, format, type, pixels);
-			else
-				rgba4444_convert_tex_image(cachefname,target, level, format, width, height, border, format, type, pixels);
+Takes ownership of pic, which must have come from R_StaticAlloc.
+timestamp and depth must be those R_LoadImageProgram returned with it.
+================
+*/
+imageStaging_t *idImage::AllocStaging( byte *pic, int width, int height ) const {
+	imageStaging_t *staging = AllocStaging();
 
-		}
-		else
-		{
+	R_SetStagingPic( staging, pic, width, height );
+
+	return staging;
+}
+
+/*
+================
+R_SetStagingPic
+
+Takes ownership of pic and picks the size it is uploaded at from
+the staging settings, the same way GetDownsize does for the image
+================
+*/
+void R_SetStagingPic( imageStaging_t *staging, byte *pic, int width, int height ) {
+	int				scaled_width, scaled_height;
+	int				size;
 
+	staging->pic = pic;
+	staging->width = width;
+	staging->height = height;
+
+	// make sure it is a power of 2
+	scaled_width = MakePowerOfTwo( width );
+	scaled_height = MakePowerOfTwo( height );
+
+	if ( scaled_width != width || scaled_height != height ) {
+		R_ImageLoadError( "R_CreateImage: not a power of 2 image" );
+	}
+
+	// Optionally modify our width/height based on options/hardware
+	size = R_DownsizeLimit( staging->depth, staging->allowDownSize );
+	R_Downsize( size, scaled_width, scaled_height );
+
+	staging->scaledWidth = scaled_width;
+	staging->scaledHeight = scaled_height;
+	staging->cacheKey = R_EtcCacheKey( staging->imgName, staging->timestamp, staging->depth, staging->repeat, size );
+}
+
+/*
+================
+StartBackgroundLoad
+================
+*/
+void idImage::StartBackgroundLoad( imageStaging_t *staging ) {
+	PurgeImage();
+
+	backgroundLoad = staging;
+	globalImages->numActiveBackgroundImageLoads++;
+
+	Sys_SubmitJob( globalImages->backgroundImageJobs, R_BackgroundLoadJob, staging, "imageLoad" );
+}
+
+/*
+================
+UploadLevels
+
+The GL side of GenerateImage for a mip chain that has been built already,
+by R_BuildStagingLevels or read from the ETC1 cache
+================
+*/
+void idImage::UploadLevels( const stagingLevel_t *levels, int numLevels ) {
+	PurgeImage();
+
+	// generate the texture number
+	qglGenTextures( 1, &texnum );
+
+	internalFormat = GL_RGBA;
+	uploadWidth = levels[0].width;
+	uploadHeight = levels[0].height;
+	type = TT_2D;
+
+	Bind();
+
+	for ( int i = 0 ; i < numLevels ; i++ ) {
+		const stagingLevel_t &level = levels[i];
+
+		switch ( level.format ) {
+			case SL_RGBA:
+				qglTexImage2D( GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.data );
+				break;
+			case SL_ETC1:
+				qglCompressedTexImage2D( GL_TEXTURE_2D, i, GL_ETC1_RGB8_OES, level.width, level.height, 0, level.size, level.data );
+				break;
+			case SL_RGBA4444:
+				qglTexImage2D( GL_TEXTURE_2D, i, GL_RGBA, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, level.data );
+				break;
 		}
-	} else {
-		qglTexImage2D(target,level,internalformat,width,height,border,format,type,pixels);
 	}
+
+	SetImageFilterAndRepeat();
+
+	// see if we messed anything up
+	GL_CheckErrors();
 }
 
-//end
+/*
+================
+UploadStaging
+================
+*/
+void idImage::UploadStaging( const imageStaging_t *staging ) {
+	// clear it first, PurgeImage would drop the load we are finishing
+	if ( backgroundLoad == staging ) {
+		backgroundLoad = NULL;
+	}
+
+	// a load job got these from the file
+	timestamp = staging->timestamp;
+	depth = staging->depth;
+
+	if ( !staging->numLevels ) {
+		common->Warning( "Couldn't load image: %s", imgName.c_str() );
+		MakeDefault();
+		return;
+	}
+
+	UploadLevels( staging->levels, staging->numLevels );
+
+	if ( staging->writeCache ) {
+		R_WriteEtcCache( staging );
+	}
+}
 
 /*
 ================
@@ -601,16 +928,7 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 	}
 	// upload the main image level
 	Bind();
-	char filename[MAX_IMAGE_NAME];
-	char*fptr=&filename[0];
-	ImageProgramStringToCompressedFileName(imgName, filename);
-	char *ext = strrchr(filename, '.');
-	if (ext) {
-		strcpy(ext, ".etc");
-	} else
-		fptr=0;
-
-	myglTexImage2D(fptr,GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer);
+	myglTexImage2D(GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer);
 
 	// create and upload the mip map levels, which we do in all cases, even if we don't think they are needed
 	int		miplevel;
@@ -641,18 +959,7 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		}
 
 		// upload the mip map
-		char filename[MAX_IMAGE_NAME];
-		char*fptr=&filename[0];
-		ImageProgramStringToCompressedFileName(imgName, filename);
-		char *ext = strrchr(filename, '.');
-		if (ext) {
-			strcpy(ext, ".e");
-			ext[2]='0'+miplevel/10;
-			ext[3]='0'+miplevel%10;
-		} else
-			fptr=0;
-
-		myglTexImage2D(fptr,GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer);
+		myglTexImage2D(GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer);
 	}
 
 	if ( scaledBuffer != 0 ) {
@@ -847,6 +1154,12 @@ void	idImage::ActuallyLoadImage( bool fromBind ) {
 	int		width, height;
 	byte	*pic;
 
+	// already being loaded by a job, or waiting for a free slot,
+	// the upload will follow
+	if ( backgroundLoad || globalImages->deferredImageLoads.FindIndex( this ) != -1 ) {
+		return;
+	}
+
 	if(fromBind)
 	{
 		//LOGI("ERROR!! CAN NOT LOAD IMAGE FROM BIND");
@@ -902,6 +1215,28 @@ void	idImage::ActuallyLoadImage( bool fromBind ) {
 			}
 		}
 	} else {
+		// see if the ETC1 cache has it compressed for the current settings,
+		// that only needs the timestamps, not the image itself
+		if ( r_useETC1.GetBool() && r_useETC1Cache.GetBool() && glConfig.isInitialized ) {
+			R_LoadImageProgram( imgName, NULL, NULL, NULL, &timestamp, &depth );
+			if ( R_UploadFromEtcCache( this, R_EtcCacheKey( this ) ) ) {
+				return;
+			}
+		}
+
+		if ( ShouldLoadInBackground() ) {
+			// the staging buffers of a load add up, the upload
+			// that frees a slot starts the next waiting image
+			if ( globalImages->numActiveBackgroundImageLoads >= idImageManager::MAX_BACKGROUND_IMAGE_LOADS ) {
+				globalImages->deferredImageLoads.Append( this );
+				return;
+			}
+
+			// the job reads the file as well
+			StartBackgroundLoad( AllocStaging() );
+			return;
+		}
+
 		// see if we have a pre-generated image file that is
 		// already image processed and compressed
 
@@ -913,6 +1248,16 @@ void	idImage::ActuallyLoadImage( bool fromBind ) {
 			return;
 		}
 
+		// compressed images are staged even when done here, so the
+		// whole mip chain can go to the ETC1 cache at once
+		if ( r_useETC1.GetBool() && glConfig.isInitialized ) {
+			imageStaging_t *staging = AllocStaging( pic, width, height );
+			R_BuildStagingLevels( staging );
+			UploadStaging( staging );
+			R_FreeStaging( staging );
+			return;
+		}
+
 		GenerateImage( pic, width, height, filter, allowDownSize, repeat, depth );
 
 		R_StaticFree( pic );
@@ -927,6 +1272,13 @@ PurgeImage
 ===============
 */
 void idImage::PurgeImage() {
+	// the job may still be running, globalImages frees the staging
+	// buffers when it comes to upload them
+	if ( backgroundLoad ) {
+		backgroundLoad->image = NULL;
+		backgroundLoad = NULL;
+	}
+	globalImages->deferredImageLoads.Remove( this );
 	if ( texnum != TEXTURE_NOT_LOADED ) {
 		qglDeleteTextures( 1, &texnum );	// this should be the ONLY place it is ever called!
 		texnum = TEXTURE_NOT_LOADED;
@@ -380,9 +380,11 @@ byte *R_MipMapWithAlphaSpecularity( const byte *in, int width, int height ) {
 
 /*
 ================
-R_MipMap
+R_MipMapInto
 
-Returns a new copy of the texture, quartered in size and filtered.
+Writes the texture quartered in size and filtered to out, which must have
+room for the new size. Doesn't allocate anything, so it can be used by the
+background image load jobs.
 
 If a texture is intended to be used in GL_CLAMP or GL_CLAMP_TO_EDGE mode with
 a completely transparent border, we must prevent any blurring into the outer
@@ -391,17 +393,14 @@ will result in a slight shrinking of the texture as it mips, but better than
 smeared clamps...
 ================
 */
-byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
+void R_MipMapInto( const byte *in, int width, int height, bool preserveBorder, byte *out ) {
 	int		i, j;
 	const byte	*in_p;
-	byte	*out, *out_p;
+	byte	*out_p;
 	int		row;
 	byte	border[4];
-	int		newWidth, newHeight;
 
-	if ( width < 1 || height < 1 || ( width + height == 2 ) ) {
-		common->FatalError( "R_MipMap called with size %i,%i", width, height );
-	}
+	assert( width >= 1 && height >= 1 && width + height > 2 );
 
 	border[0] = in[0];
 	border[1] = in[1];
@@ -410,15 +409,6 @@ byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
 
 	row = width * 4;
 
-	newWidth = width >> 1;
-	newHeight = height >> 1;
-	if ( !newWidth ) {
-		newWidth = 1;
-	}
-	if ( !newHeight ) {
-		newHeight = 1;
-	}
-	out = (byte *)R_StaticAlloc( newWidth * newHeight * 4 );
 	out_p = out;
 
 	in_p = in;
@@ -443,7 +433,7 @@ byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
 				out_p[3] = ( in_p[3] + in_p[7] )>>1;
 			}
 		}
-		return out;
+		return;
 	}
 
 	for (i=0 ; i<height ; i++, in_p+=row) {
@@ -459,6 +449,34 @@ byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
 	if ( preserveBorder ) {
 		R_SetBorderTexels( out, width, height, border );
 	}
+}
+
+/*
+================
+R_MipMap
+
+Returns a new copy of the texture, quartered in size and filtered.
+================
+*/
+byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
+	byte	*out;
+	int		newWidth, newHeight;
+
+	if ( width < 1 || height < 1 || ( width + height == 2 ) ) {
+		common->FatalError( "R_MipMap called with size %i,%i", width, height );
+	}
+
+	newWidth = width >> 1;
+	newHeight = height >> 1;
+	if ( !newWidth ) {
+		newWidth = 1;
+	}
+	if ( !newHeight ) {
+		newHeight = 1;
+	}
+	out = (byte *)R_StaticAlloc( newWidth * newHeight * 4 );
+
+	R_MipMapInto( in, width, height, preserveBorder, out );
 
 	return out;
 }
@@ -330,8 +330,9 @@ static void R_ImageAdd( byte *data1, int width1, int height1, byte *data2, int w
 }
 
 
-// we build a canonical token form of the image program here
-static char parseBuffer[MAX_IMAGE_NAME];
+// we build a canonical token form of the image program here,
+// per thread as background loads run the programs on jobs
+static thread_local char parseBuffer[MAX_IMAGE_NAME];
 
 /*
 ===================
@@ -615,6 +616,11 @@ void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height,
 	src.LoadMemory( name, strlen(name), name );
 	src.SetFlags( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
 
+	// a load job can't print, the program was already parsed with the material
+	if ( R_GetImageLoadLog() ) {
+		src.SetFlags( src.GetFlags() | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+	}
+
 	parseBuffer[0] = 0;
 	if ( timestamps ) {
 		*timestamps = 0;
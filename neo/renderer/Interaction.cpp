@@ -448,9 +448,13 @@ idInteraction::idInteraction( void ) {
 	lightPrev				= NULL;
 	entityNext				= NULL;
 	entityPrev				= NULL;
+	shadowsPending			= false;
 	dynamicModelFrameCount	= 0;
 	frustumState			= FRUSTUM_UNINITIALIZED;
 	frustumAreas			= NULL;
+	preparedViewCount		= -1;
+	preparedCulled			= false;
+	preparedBoundsValid		= false;
 }
 
 /*
@@ -475,10 +479,13 @@ idInteraction *idInteraction::AllocAndLink( idRenderEntityLocal *edef, idRenderL
 
 	interaction->numSurfaces = -1;		// not checked yet
 	interaction->surfaces = NULL;
+	interaction->shadowsPending = false;
 
 	interaction->frustumState = idInteraction::FRUSTUM_UNINITIALIZED;
 	interaction->frustumAreas = NULL;
 
+	interaction->preparedViewCount = -1;
+
 	// link at the start of the entity's list
 	interaction->lightNext = ldef->firstInteraction;
 	interaction->lightPrev = NULL;
@@ -520,6 +527,11 @@ will be regenerated automatically
 ===============
 */
 void idInteraction::FreeSurfaces( void ) {
+	// don't free the surfaces out from under a shadow job
+	if ( this->shadowsPending ) {
+		R_FlushShadowBatch();
+	}
+
 	if ( this->surfaces ) {
 		for ( int i = 0 ; i < this->numSurfaces ; i++ ) {
 			surfaceInteraction_t *sint = &this->surfaces[i];
@@ -737,10 +749,10 @@ idScreenRect idInteraction::CalcInteractionScissorRectangle( const idFrustum &vi
 	}
 
 	// calculate bounds of the interaction frustum projected into the view frustum
-	if ( lightDef->parms.pointLight ) {
-		viewFrustum.ClippedProjectionBounds( frustum, idBox( lightDef->parms.origin, lightDef->parms.lightRadius, lightDef->parms.axis ), projectionBounds );
+	if ( preparedViewCount == tr.viewCount && preparedBoundsValid ) {
+		projectionBounds = preparedProjectionBounds;
 	} else {
-		viewFrustum.ClippedProjectionBounds( frustum, idBox( lightDef->frustumTris->bounds ), projectionBounds );
+		CalcInteractionProjectionBounds( viewFrustum, projectionBounds );
 	}
 
 	if ( projectionBounds.IsCleared() ) {
@@ -760,12 +772,27 @@ idScreenRect idInteraction::CalcInteractionScissorRectangle( const idFrustum &vi
 	return scissorRect;
 }
 
+/*
+==================
+idInteraction::CalcInteractionProjectionBounds
+==================
+*/
+void idInteraction::CalcInteractionProjectionBounds( const idFrustum &viewFrustum, idBounds &projectionBounds ) const {
+	if ( lightDef->parms.pointLight ) {
+		viewFrustum.ClippedProjectionBounds( frustum, idBox( lightDef->parms.origin, lightDef->parms.lightRadius, lightDef->parms.axis ), projectionBounds );
+	} else {
+		viewFrustum.ClippedProjectionBounds( frustum, idBox( lightDef->frustumTris->bounds ), projectionBounds );
+	}
+}
+
 /*
 ===================
-idInteraction::CullInteractionByViewFrustum
+idInteraction::TestInteractionViewFrustum
+
+The culling part of CullInteractionByViewFrustum, without any debug drawing
 ===================
 */
-bool idInteraction::CullInteractionByViewFrustum( const idFrustum &viewFrustum ) {
+bool idInteraction::TestInteractionViewFrustum( const idFrustum &viewFrustum ) {
 
 	if ( !r_useInteractionCulling.GetBool() ) {
 		return false;
@@ -797,6 +824,27 @@ bool idInteraction::CullInteractionByViewFrustum( const idFrustum &viewFrustum )
 		return true;
 	}
 
+	return false;
+}
+
+/*
+===================
+idInteraction::CullInteractionByViewFrustum
+===================
+*/
+bool idInteraction::CullInteractionByViewFrustum( const idFrustum &viewFrustum ) {
+	bool culled;
+
+	if ( preparedViewCount == tr.viewCount ) {
+		culled = preparedCulled;
+	} else {
+		culled = TestInteractionViewFrustum( viewFrustum );
+	}
+
+	if ( culled || !r_useInteractionCulling.GetBool() || frustumState == idInteraction::FRUSTUM_INVALID ) {
+		return culled;
+	}
+
 	if ( r_showInteractionFrustums.GetInteger() ) {
 		static idVec4 colors[] = { colorRed, colorGreen, colorBlue, colorYellow, colorMagenta, colorCyan, colorWhite, colorPurple };
 		tr.viewDef->renderWorld->DebugFrustum( colors[lightDef->index & 7], frustum, ( r_showInteractionFrustums.GetInteger() > 1 ) );
@@ -808,6 +856,223 @@ bool idInteraction::CullInteractionByViewFrustum( const idFrustum &viewFrustum )
 	return false;
 }
 
+/*
+===================
+idInteraction::PrepareForView
+
+Runs the expensive interaction frustum setup, culling and projection
+ahead of AddActiveInteraction, under the same conditions it would use them.
+===================
+*/
+void idInteraction::PrepareForView( const idFrustum &viewFrustum ) {
+	preparedViewCount = tr.viewCount;
+	preparedCulled = false;
+	preparedBoundsValid = false;
+
+	if ( !HasShadows() || entityDef->parms.hModel->IsStaticWorldModel() ) {
+		return;
+	}
+
+	preparedCulled = TestInteractionViewFrustum( viewFrustum );
+
+	if ( preparedCulled || r_useInteractionScissors.GetInteger() <= 0 ) {
+		return;
+	}
+	if ( frustumState == idInteraction::FRUSTUM_UNINITIALIZED || frustumState == idInteraction::FRUSTUM_INVALID ) {
+		return;
+	}
+
+	CalcInteractionProjectionBounds( viewFrustum, preparedProjectionBounds );
+	preparedBoundsValid = true;
+}
+
+/*
+===============================================================================
+
+	Shadow batch
+
+	R_AddModelSurfaces opens a shadow batch around the interactions of a view
+	with r_parallelShadows.  The shadow volumes that aren't in the shadow cache
+	are queued by CreateInteraction, and the interactions that are waiting on
+	them don't link their shadow surfaces until R_FlushShadowBatch has built
+	all the volumes on the job threads.  Allocating the surfaces, caching the
+	volumes and linking are done on the calling thread in queue order.
+
+===============================================================================
+*/
+
+typedef struct {
+	idInteraction *				inter;
+	surfaceInteraction_t *		sint;
+	const srfTriangles_t *		tri;
+	shadowGen_t					shadowGen;
+	bool						noCaps;
+	bool						cacheable;
+	shadowCacheKey_t			key;
+	shadowVolume_t *			volume;			// set by R_ShadowVolumeJob, NULL if there is no shadow
+} shadowBatchBuild_t;
+
+typedef struct {
+	idInteraction *				inter;
+	idScreenRect				shadowScissor;
+} shadowBatchLink_t;
+
+static bool							shadowBatch;
+static idList<shadowBatchBuild_t>	shadowBatchBuilds;
+static idList<shadowBatchLink_t>	shadowBatchLinks;
+
+/*
+====================
+R_BeginShadowBatch
+====================
+*/
+void R_BeginShadowBatch( void ) {
+	shadowBatch = true;
+}
+
+/*
+====================
+R_ShadowBatchOpen
+====================
+*/
+bool R_ShadowBatchOpen( void ) {
+	return shadowBatch;
+}
+
+/*
+====================
+R_ShadowVolumeJob
+====================
+*/
+static void R_ShadowVolumeJob( void *data, int index ) {
+	shadowBatchBuild_t *build = &( (shadowBatchBuild_t *)data )[index];
+	shadowVolume_t vol;
+
+	build->volume = NULL;
+	if ( R_BuildShadowVolume( build->inter->entityDef, build->tri, build->inter->lightDef, build->shadowGen, build->sint->cullInfo, vol ) ) {
+		// the volume is in the memory of this thread until the next build
+		build->volume = R_CopyShadowVolume( vol );
+	}
+}
+
+/*
+====================
+R_FlushShadowBatch
+
+Also called when something is about to free the surfaces of an interaction
+that is waiting in the batch.
+====================
+*/
+void R_FlushShadowBatch( void ) {
+	int i;
+
+	if ( shadowBatchBuilds.Num() == 0 && shadowBatchLinks.Num() == 0 ) {
+		return;
+	}
+
+	R_ParallelFor( R_ShadowVolumeJob, shadowBatchBuilds.Ptr(), shadowBatchBuilds.Num(), "shadowVolumes" );
+
+	for ( i = 0; i < shadowBatchBuilds.Num(); i++ ) {
+		shadowBatchBuild_t *build = &shadowBatchBuilds[i];
+		surfaceInteraction_t *sint = build->sint;
+
+		sint->shadowTris = build->volume ? R_AllocShadowVolumeTris( *build->volume ) : NULL;
+		if ( sint->shadowTris && build->noCaps ) {
+			sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
+			sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
+		}
+
+		if ( build->cacheable ) {
+			R_CacheShadowVolume( build->key, build->volume );
+		} else {
+			R_FreeShadowVolume( build->volume );
+		}
+
+		if ( sint->lightTris != LIGHT_TRIS_DEFERRED ) {
+			R_FreeInteractionCullInfo( sint->cullInfo );
+		}
+		build->inter->shadowsPending = false;
+	}
+	shadowBatchBuilds.SetNum( 0, false );
+
+	for ( i = 0; i < shadowBatchLinks.Num(); i++ ) {
+		shadowBatchLink_t *link = &shadowBatchLinks[i];
+		link->inter->shadowsPending = false;
+		link->inter->LinkShadowSurfaces( link->shadowScissor );
+	}
+	shadowBatchLinks.SetNum( 0, false );
+}
+
+/*
+====================
+R_EndShadowBatch
+====================
+*/
+void R_EndShadowBatch( void ) {
+	R_FlushShadowBatch();
+	shadowBatch = false;
+}
+
+/*
+====================
+R_CreateInteractionShadow
+
+Copies the shadow volume of the surface from the shadow cache, or builds it.
+
+While a shadow batch is open, a volume that has to be built is queued instead
+and true is returned, the cull info is needed until the batch is flushed.
+====================
+*/
+static bool R_CreateInteractionShadow( idInteraction *inter, int surfaceNum, srfTriangles_t *tri, shadowGen_t shadowGen, bool noCaps ) {
+	surfaceInteraction_t *sint = &inter->surfaces[surfaceNum];
+	shadowCacheKey_t key;
+
+	bool cacheable = R_ShadowCacheKey( inter->entityDef, surfaceNum, tri, inter->lightDef, shadowGen, key );
+
+	if ( cacheable && R_FindCachedShadowVolume( key, &sint->shadowTris ) ) {
+		// nothing that shapes the volume has changed
+	} else if ( shadowBatch ) {
+		// the jobs can't allocate the face planes
+		if ( !tri->facePlanes || !tri->facePlanesCalculated ) {
+			R_DeriveFacePlanes( tri );
+		}
+
+		tr.pc.c_createShadowVolumes++;
+
+		shadowBatchBuild_t &build = shadowBatchBuilds.Alloc();
+		build.inter = inter;
+		build.sint = sint;
+		build.tri = tri;
+		build.shadowGen = shadowGen;
+		build.noCaps = noCaps;
+		build.cacheable = cacheable;
+		build.key = key;
+		build.volume = NULL;
+
+		inter->shadowsPending = true;
+		return true;
+	} else if ( cacheable ) {
+		shadowVolume_t vol;
+		shadowVolume_t *copy = NULL;
+
+		tr.pc.c_createShadowVolumes++;
+
+		if ( R_BuildShadowVolume( inter->entityDef, tri, inter->lightDef, shadowGen, sint->cullInfo, vol ) ) {
+			copy = R_CopyShadowVolume( vol );
+		}
+		sint->shadowTris = copy ? R_AllocShadowVolumeTris( *copy ) : NULL;
+		R_CacheShadowVolume( key, copy );
+	} else {
+		sint->shadowTris = R_CreateShadowVolume( inter->entityDef, tri, inter->lightDef, shadowGen, sint->cullInfo );
+	}
+
+	if ( sint->shadowTris && noCaps ) {
+		sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
+		sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
+	}
+	return false;
+}
+
 /*
 ====================
 idInteraction::CreateInteraction
@@ -882,6 +1147,7 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 		}
 
 		surfaceInteraction_t *sint = &surfaces[c];
+		bool shadowQueued = false;
 
 		sint->shader = shader;
 
@@ -912,23 +1178,20 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 			// if the light has an optimized shadow volume, don't create shadows for any models that are part of the base areas
 			if ( lightDef->parms.prelightModel == NULL || !model->IsStaticWorldModel() || !r_useOptimizedShadows.GetBool() ) {
 
-				// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
-				sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
-				if ( sint->shadowTris ) {
-					if ( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) {
-						// if any surface is a shadow-casting perforated or translucent surface, or the
-						// base surface is suppressed in the view (world weapon shadows) we can't use
-						// the external shadow optimizations because we can see through some of the faces
-						sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
-						sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
-					}
-				}
+				// if any surface is a shadow-casting perforated or translucent surface, or the
+				// base surface is suppressed in the view (world weapon shadows) we can't use
+				// the external shadow optimizations because we can see through some of the faces
+				bool noCaps = ( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) );
+
+				// this is the only place during gameplay (outside the utilities) that shadow volumes are created
+				shadowQueued = R_CreateInteractionShadow( this, c, tri, shadowGen, noCaps );
 				interactionGenerated = true;
 			}
 		}
 
-		// free the cull information when it's no longer needed
-		if ( sint->lightTris != LIGHT_TRIS_DEFERRED ) {
+		// free the cull information when it's no longer needed,
+		// a queued shadow volume still needs it
+		if ( sint->lightTris != LIGHT_TRIS_DEFERRED && !shadowQueued ) {
 			R_FreeInteractionCullInfo( sint->cullInfo );
 		}
 	}
@@ -1028,8 +1291,6 @@ void idInteraction::AddActiveInteraction( void ) {
 	viewEntity_t *	vEntity;
 	idScreenRect	shadowScissor;
 	idScreenRect	lightScissor;
-	idVec3			localLightOrigin;
-	idVec3			localViewOrigin;
 
 	vLight = lightDef->viewLight;
 	vEntity = entityDef->viewEntity;
@@ -1083,9 +1344,6 @@ void idInteraction::AddActiveInteraction( void ) {
 		CreateInteraction( model );
 	}
 
-	R_GlobalPointToLocal( vEntity->modelMatrix, lightDef->globalLightOrigin, localLightOrigin );
-	R_GlobalPointToLocal( vEntity->modelMatrix, tr.viewDef->renderView.vieworg, localViewOrigin );
-
 	// calculate the scissor as the intersection of the light and model rects
 	// this is used for light triangles, but not for shadow triangles
 	lightScissor = vLight->scissorRect;
@@ -1155,6 +1413,38 @@ void idInteraction::AddActiveInteraction( void ) {
 				}
 			}
 		}
+	}
+
+	// the shadow volumes queued by CreateInteraction aren't there yet
+	if ( shadowsPending ) {
+		shadowBatchLink_t &link = shadowBatchLinks.Alloc();
+		link.inter = this;
+		link.shadowScissor = shadowScissor;
+	} else {
+		LinkShadowSurfaces( shadowScissor );
+	}
+}
+
+/*
+==================
+idInteraction::LinkShadowSurfaces
+==================
+*/
+void idInteraction::LinkShadowSurfaces( const idScreenRect &shadowScissor ) {
+	viewLight_t *	vLight;
+	viewEntity_t *	vEntity;
+	idVec3			localLightOrigin;
+	idVec3			localViewOrigin;
+
+	vLight = lightDef->viewLight;
+	vEntity = entityDef->viewEntity;
+
+	R_GlobalPointToLocal( vEntity->modelMatrix, lightDef->globalLightOrigin, localLightOrigin );
+	R_GlobalPointToLocal( vEntity->modelMatrix, tr.viewDef->renderView.vieworg, localViewOrigin );
+
+	// for each surface of this entity / light interaction
+	for ( int i = 0; i < numSurfaces; i++ ) {
+		surfaceInteraction_t *sint = &surfaces[i];
 
 		srfTriangles_t *shadowTris = sint->shadowTris;
 
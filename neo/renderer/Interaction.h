@@ -114,6 +114,10 @@ public:
 	idInteraction *			entityNext;				// for entityDef chains
 	idInteraction *			entityPrev;
 
+	// set while shadow volumes or shadow surfaces of the interaction are
+	// waiting in the shadow batch
+	bool					shadowsPending;
+
 public:
 							idInteraction( void );
 
@@ -146,10 +150,18 @@ public:
 	// will be used to determine when we need to start purging old interactions
 	int						MemoryUsed( void );
 
+	// does the view frustum culling for AddActiveInteraction ahead of time
+	// only touches this interaction, so it can be run from a worker thread
+	void					PrepareForView( const idFrustum &viewFrustum );
+
 	// makes sure all necessary light surfaces and shadow surfaces are created, and
 	// calls R_LinkLightSurf() for each one
 	void					AddActiveInteraction( void );
 
+	// links the shadow surfaces, AddActiveInteraction leaves that to R_FlushShadowBatch
+	// when it queued shadow volumes for the batch
+	void					LinkShadowSurfaces( const idScreenRect &shadowScissor );
+
 private:
 	enum {
 		FRUSTUM_UNINITIALIZED,
@@ -162,6 +174,11 @@ private:
 
 	int						dynamicModelFrameCount;	// so we can tell if a callback model animated
 
+	int						preparedViewCount;		// tr.viewCount of the last PrepareForView
+	bool					preparedCulled;
+	bool					preparedBoundsValid;
+	idBounds				preparedProjectionBounds;
+
 private:
 	// actually create the interaction
 	void					CreateInteraction( const idRenderModel *model );
@@ -172,6 +189,10 @@ private:
 	// try to determine if the entire interaction, including shadows, is guaranteed
 	// to be outside the view frustum
 	bool					CullInteractionByViewFrustum( const idFrustum &viewFrustum );
+	bool					TestInteractionViewFrustum( const idFrustum &viewFrustum );
+
+	// bounds of the interaction frustum projected into the view frustum
+	void					CalcInteractionProjectionBounds( const idFrustum &viewFrustum, idBounds &projectionBounds ) const;
 
 	// determine the minimum scissor rect that will include the interaction shadows
 	// projected to the bounds of the light
@@ -183,6 +204,14 @@ void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles
 void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo );
 void R_FreeInteractionCullInfo( srfCullInfo_t &cullInfo );
 
+// while a shadow batch is open, the shadow volumes that have to be built by
+// idInteraction::CreateInteraction are queued, R_FlushShadowBatch builds all
+// of them on the job threads and links the shadow surfaces of the interactions
+void R_BeginShadowBatch( void );
+bool R_ShadowBatchOpen( void );
+void R_FlushShadowBatch( void );
+void R_EndShadowBatch( void );
+
 void R_ShowInteractionMemory_f( const idCmdArgs &args );
 
 #endif /* !__INTERACTION_H__ */
@@ -2139,7 +2139,10 @@ void idRenderModelStatic::FreeVertexCache( void ) {
 
 		// Free the vertex caches
 		// NB: these are always private, so we can free them without worrying
-		if ( tri->ambientCache ) {
+		if ( tri->ambientCacheFrame ) {
+			tri->ambientCache = NULL;
+			tri->ambientCacheFrame = 0;
+		} else if ( tri->ambientCache ) {
 			vertexCache.Free( tri->ambientCache );
 			tri->ambientCache = NULL;
 		}
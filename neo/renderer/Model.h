@@ -92,6 +92,8 @@ typedef struct srfTriangles_s {
 	bool						perfectHull;			// true if there aren't any dangling edges
 	bool						deformedSurface;		// if true, indexes, silIndexes, mirrorVerts, and silEdges are
 														// pointers into the original surface, and should not be freed
+	bool						mappedSurface;			// if true, all the vertex, index and derived arrays point into a mapped
+														// .bproc file, and should not be freed
 
 	int							numVerts;				// number of vertices
 	idDrawVert *				verts;					// vertices, allocated with special allocator
@@ -134,6 +136,9 @@ typedef struct srfTriangles_s {
 	struct vertCache_s *		indexCache;				// int
 	struct vertCache_s *		ambientCache;			// idDrawVert
 	struct vertCache_s *		shadowCache;			// shadowCache_t
+
+	int							ambientCacheFrame;		// vertexCache.GetTempFrameNum() if ambientCache is a frame temp
+														// allocation, it is not freed and is stale after that frame
 } srfTriangles_t;
 
 typedef idList<srfTriangles_t *> idTriList;
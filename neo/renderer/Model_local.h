@@ -147,6 +147,8 @@ public:
 
 	void						ParseMesh( idLexer &parser, int numJoints, const idJointMat *joints );
 	void						UpdateSurface( const struct renderEntity_s *ent, const idJointMat *joints, modelSurface_t *surf );
+	srfTriangles_t *			SetupSurface( modelSurface_t *surf );
+	void						SkinSurface( srfTriangles_t *tri, const idJointMat *joints, float skinScale );
 	idBounds					CalcBounds( const idJointMat *joints );
 	int							NearestJoint( int a, int b, int c ) const;
 	int							NumVerts( void ) const;
@@ -194,6 +196,7 @@ private:
 	void						CalculateBounds( const idJointMat *joints );
 	void						GetFrameBounds( const renderEntity_t *ent, idBounds &bounds ) const;
 	void						DrawJoints( const renderEntity_t *ent, const struct viewDef_s *view ) const;
+	void						QueueSkinning( const struct renderEntity_s *ent, idMD5Mesh *mesh, const idMaterial *shader, modelSurface_t *surf, idRenderModelStatic *staticModel );
 	void						ParseJoint( idLexer &parser, idMD5Joint *joint, idJointQuat *defaultPose );
 };
 
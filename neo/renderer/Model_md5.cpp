@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "framework/Session.h"
+#include "renderer/VertexCache.h"
 #include "renderer/tr_local.h"
 
 #include "renderer/Model_local.h"
@@ -272,7 +273,30 @@ idMD5Mesh::UpdateSurface
 ====================
 */
 void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf ) {
-	int i, base;
+	srfTriangles_t *tri = SetupSurface( surf );
+
+	SkinSurface( tri, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
+
+	// If a surface is going to be have a lighting interaction generated, it will also have to call
+	// R_DeriveTangents() to get normals, tangents, and face planes.  If it only
+	// needs shadows generated, it will only have to generate face planes.  If it only
+	// has ambient drawing, or is culled, no additional work will be necessary
+	if ( !r_useDeferredTangents.GetBool() ) {
+		// set face planes, vertex normals, tangents
+		R_DeriveTangents( tri );
+	}
+}
+
+/*
+====================
+idMD5Mesh::SetupSurface
+
+Gets the triangle surface ready to have the vertexes skinned into it,
+reusing the old geometry if possible
+====================
+*/
+srfTriangles_t *idMD5Mesh::SetupSurface( modelSurface_t *surf ) {
+	int i;
 	srfTriangles_t *tri;
 
 	tr.pc.c_deformedSurfaces++;
@@ -321,8 +345,22 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 		}
 	}
 
-	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
-		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
+	return tri;
+}
+
+/*
+====================
+idMD5Mesh::SkinSurface
+
+Transforms the vertexes by the joints and bounds the result.  Only touches
+the surface itself, so different surfaces can be skinned at the same time.
+====================
+*/
+void idMD5Mesh::SkinSurface( srfTriangles_t *tri, const idJointMat *entJoints, float skinScale ) {
+	int i, base;
+
+	if ( skinScale != 0.0f ) {
+		TransformScaledVerts( tri->verts, entJoints, skinScale );
 	} else {
 		TransformVerts( tri->verts, entJoints );
 	}
@@ -334,15 +372,6 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 	}
 
 	R_BoundTriSurf( tri );
-
-	// If a surface is going to be have a lighting interaction generated, it will also have to call
-	// R_DeriveTangents() to get normals, tangents, and face planes.  If it only
-	// needs shadows generated, it will only have to generate face planes.  If it only
-	// has ambient drawing, or is culled, no additional work will be necessary
-	if ( !r_useDeferredTangents.GetBool() ) {
-		// set face planes, vertex normals, tangents
-		R_DeriveTangents( tri );
-	}
 }
 
 /*
@@ -713,6 +742,101 @@ void idRenderModelMD5::DrawJoints( const renderEntity_t *ent, const struct viewD
 	}
 }
 
+typedef struct {
+	idMD5Mesh *					mesh;
+	srfTriangles_t *			tri;
+	const idJointMat *			joints;
+	float						skinScale;
+	bool						deriveTangents;
+	idDrawVert *				frameTemp;			// ambient cache memory to fill, or NULL
+	idRenderModelStatic *		model;				// gets the bounds of the surface
+} md5SkinJob_t;
+
+static idList<md5SkinJob_t>	md5SkinJobs;
+
+/*
+====================
+R_SkinMD5MeshJob
+====================
+*/
+static void R_SkinMD5MeshJob( void *data, int index ) {
+	md5SkinJob_t *job = &( (md5SkinJob_t *)data )[index];
+	srfTriangles_t *tri = job->tri;
+
+	job->mesh->SkinSurface( tri, job->joints, job->skinScale );
+
+	if ( job->deriveTangents ) {
+		R_DeriveTangentsNoAlloc( tri );
+	}
+
+	if ( job->frameTemp ) {
+		SIMDProcessor->Memcpy( job->frameTemp, tri->verts, tri->numVerts * sizeof( tri->verts[0] ) );
+	}
+}
+
+/*
+====================
+R_RunMD5SkinJobs
+
+The skinned vertexes still go to tri->verts, shadows and the interaction
+culling need them on the CPU, the frame temp copy is just what gets drawn.
+====================
+*/
+void R_RunMD5SkinJobs( void ) {
+	if ( !md5SkinJobs.Num() ) {
+		return;
+	}
+
+	Sys_ParallelFor( R_SkinMD5MeshJob, md5SkinJobs.Ptr(), md5SkinJobs.Num(), "skinMD5" );
+
+	for ( int i = 0; i < md5SkinJobs.Num(); i++ ) {
+		const md5SkinJob_t &job = md5SkinJobs[i];
+		job.model->bounds.AddPoint( job.tri->bounds[0] );
+		job.model->bounds.AddPoint( job.tri->bounds[1] );
+	}
+
+	md5SkinJobs.SetNum( 0, false );
+}
+
+/*
+====================
+idRenderModelMD5::QueueSkinning
+
+Sets up the surface and leaves the skinning to R_RunMD5SkinJobs.  Everything
+that allocates is done here, so the jobs only write to their own surface.
+====================
+*/
+void idRenderModelMD5::QueueSkinning( const struct renderEntity_s *ent, idMD5Mesh *mesh, const idMaterial *shader, modelSurface_t *surf, idRenderModelStatic *staticModel ) {
+	md5SkinJob_t &job = md5SkinJobs.Alloc();
+
+	job.mesh = mesh;
+	job.tri = mesh->SetupSurface( surf );
+	job.joints = ent->joints;
+	job.skinScale = ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ];
+	job.model = staticModel;
+	job.frameTemp = NULL;
+
+	// do the tangents now if they are going to be needed for drawing anyway
+	job.deriveTangents = !r_useDeferredTangents.GetBool() || shader->ReceivesLighting();
+	if ( job.deriveTangents && !job.tri->dominantTris ) {
+		tr.pc.c_tangentIndexes += job.tri->numIndexes;
+		if ( !job.tri->facePlanes ) {
+			R_AllocStaticTriSurfPlanes( job.tri, job.tri->numIndexes );
+		}
+	}
+
+	// reserve the ambient cache, the job fills it in
+	if ( shader->IsDrawn() && tr.frameCount != 0 ) {
+		void *memory;
+		vertCache_t *block = vertexCache.AllocFrameTempMemory( job.tri->numVerts * sizeof( idDrawVert ), false, &memory );
+		if ( block ) {
+			job.tri->ambientCache = block;
+			job.tri->ambientCacheFrame = vertexCache.GetTempFrameNum();
+			job.frameTemp = (idDrawVert *)memory;
+		}
+	}
+}
+
 /*
 ====================
 idRenderModelMD5::InstantiateDynamicModel
@@ -800,6 +924,11 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 			surf->id = i;
 		}
 
+		if ( R_SkinningBatchOpen() ) {
+			QueueSkinning( ent, mesh, shader, surf, staticModel );
+			continue;
+		}
+
 		mesh->UpdateSurface( ent, ent->joints, surf );
 
 		staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
@@ -62,6 +62,156 @@ void idRenderModelPrt::TouchData( void ) {
 	particleSystem = static_cast<const idDeclParticle *>( declManager->FindType( DECL_PARTICLE, name ) );
 }
 
+/*
+===============================================================================
+
+	Batched particle creation
+
+	The live particles of a stage are gathered in stage order, then created a
+	range at a time by idParticleStage::CreateParticles.  Every particle gets a
+	fixed slot in the surface verts, the slots of the faded out particles are
+	squeezed out afterwards, which leaves exactly what CreateParticle would have
+	made one particle at a time.
+
+===============================================================================
+*/
+
+static const int PARTICLE_JOB_SIZE = 256;		// particles created by each job
+
+static idList<int>		batchIndex;
+static idList<float>	batchFrac;
+static idList<float>	batchAge;
+static idList<int>		batchRandomSeed;
+static idList<float>	batchFade;
+static idList<float>	batchColors;
+static idList<int>		batchNumVerts;
+static idList<idDrawVert> checkVerts;
+
+typedef struct {
+	const idParticleStage *	stage;
+	const particleGen_t *	g;
+	particleBatch_t *		batch;
+	idDrawVert *			verts;
+} particleJob_t;
+
+/*
+====================
+R_BeginParticleBatch
+====================
+*/
+static void R_BeginParticleBatch( particleBatch_t &batch, int maxParticles ) {
+	batchIndex.AssureSize( maxParticles );
+	batchFrac.AssureSize( maxParticles );
+	batchAge.AssureSize( maxParticles );
+	batchRandomSeed.AssureSize( maxParticles );
+	batchFade.AssureSize( maxParticles );
+	batchColors.AssureSize( 6 * maxParticles );
+	batchNumVerts.AssureSize( maxParticles );
+
+	batch.numParticles = 0;
+	batch.index = batchIndex.Ptr();
+	batch.frac = batchFrac.Ptr();
+	batch.age = batchAge.Ptr();
+	batch.randomSeed = batchRandomSeed.Ptr();
+	batch.fade = batchFade.Ptr();
+	batch.colors = batchColors.Ptr();
+	batch.numVerts = batchNumVerts.Ptr();
+}
+
+/*
+====================
+R_CreateParticlesJob
+====================
+*/
+static void R_CreateParticlesJob( void *data, int index ) {
+	particleJob_t *job = (particleJob_t *)data;
+	int first = index * PARTICLE_JOB_SIZE;
+	int last = Min( first + PARTICLE_JOB_SIZE, job->batch->numParticles );
+
+	job->stage->CreateParticles( job->g, job->batch, first, last, job->verts );
+}
+
+/*
+====================
+R_CheckParticleBatch
+
+Creates the batch again one particle at a time and compares the vertexes
+====================
+*/
+static void R_CheckParticleBatch( const idDeclParticle *particleSystem, int stageNum, const particleGen_t &base, const particleBatch_t &batch, const idDrawVert *verts, int numVerts ) {
+	const idParticleStage *stage = particleSystem->stages[stageNum];
+
+	checkVerts.AssureSize( batch.numParticles * 4 * stage->NumQuadsPerParticle() );
+
+	particleGen_t g = base;
+	int checkNumVerts = 0;
+
+	for ( int i = 0; i < batch.numParticles; i++ ) {
+		g.index = batch.index[i];
+		g.frac = batch.frac[i];
+		g.random.SetSeed( batch.randomSeed[i] );
+		g.originalRandom = g.random;
+		g.age = g.frac * stage->particleLife;
+
+		checkNumVerts += stage->CreateParticle( &g, checkVerts.Ptr() + checkNumVerts );
+	}
+
+	if ( checkNumVerts != numVerts ) {
+		common->Printf( "%s stage %d: %d verts, CreateParticle made %d\n", particleSystem->GetName(), stageNum, numVerts, checkNumVerts );
+		return;
+	}
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( memcmp( &verts[i], &checkVerts[i], sizeof( verts[i] ) ) != 0 ) {
+			common->Printf( "%s stage %d: vertex %d differs from CreateParticle\n", particleSystem->GetName(), stageNum, i );
+			return;
+		}
+	}
+}
+
+/*
+====================
+R_CreateParticleBatch
+
+Returns the number of verts created
+====================
+*/
+static int R_CreateParticleBatch( const idParticleStage *stage, const particleGen_t &g, particleBatch_t &batch, idDrawVert *verts ) {
+	if ( !batch.numParticles ) {
+		return 0;
+	}
+
+	SIMDProcessor->Mul( batch.age, stage->particleLife, batch.frac, batch.numParticles );
+
+	particleJob_t job;
+	job.stage = stage;
+	job.g = &g;
+	job.batch = &batch;
+	job.verts = verts;
+
+	int numJobs = ( batch.numParticles + PARTICLE_JOB_SIZE - 1 ) / PARTICLE_JOB_SIZE;
+	if ( numJobs > 1 ) {
+		Sys_ParallelFor( R_CreateParticlesJob, &job, numJobs, "particles" );
+	} else {
+		stage->CreateParticles( &g, &batch, 0, batch.numParticles, verts );
+	}
+
+	// squeeze out the faded particles, slots only move down by whole slots so a copy never overlaps itself
+	const int vertsPerParticle = 4 * stage->NumQuadsPerParticle();
+	int numVerts = 0;
+	for ( int i = 0; i < batch.numParticles; i++ ) {
+		if ( !batch.numVerts[i] ) {
+			continue;
+		}
+		if ( numVerts != i * vertsPerParticle ) {
+			SIMDProcessor->Memcpy( verts + numVerts, verts + i * vertsPerParticle, batch.numVerts[i] * sizeof( verts[0] ) );
+		}
+		numVerts += batch.numVerts[i];
+	}
+
+	return numVerts;
+}
+
 /*
 ====================
 idRenderModelPrt::InstantiateDynamicModel
@@ -158,6 +308,12 @@ idRenderModel *idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 		int numVerts = 0;
 		idDrawVert *verts = surf->geometry->verts;
 
+		particleBatch_t batch;
+		bool batched = r_parallelParticles.GetBool();
+		if ( batched ) {
+			R_BeginParticleBatch( batch, stage->totalParticles );
+		}
+
 		for ( int index = 0; index < stage->totalParticles; index++ ) {
 			g.index = index;
 
@@ -204,6 +360,14 @@ idRenderModel *idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 				continue;
 			}
 
+			if ( batched ) {
+				batch.index[batch.numParticles] = index;
+				batch.frac[batch.numParticles] = g.frac;
+				batch.randomSeed[batch.numParticles] = g.random.GetSeed();
+				batch.numParticles++;
+				continue;
+			}
+
 			// this is needed so aimed particles can calculate origins at different times
 			g.originalRandom = g.random;
 
@@ -213,6 +377,13 @@ idRenderModel *idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			numVerts += stage->CreateParticle( &g, verts + numVerts );
 		}
 
+		if ( batched ) {
+			numVerts = R_CreateParticleBatch( stage, g, batch, verts );
+			if ( r_checkParticles.GetBool() ) {
+				R_CheckParticleBatch( particleSystem, stageNum, g, batch, verts, numVerts );
+			}
+		}
+
 		// numVerts must be a multiple of 4
 		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
 
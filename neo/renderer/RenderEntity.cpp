@@ -41,6 +41,7 @@ idRenderEntityLocal::idRenderEntityLocal() {
 	dynamicModel			= NULL;
 	dynamicModelFrameCount	= 0;
 	cachedDynamicModel		= NULL;
+	dynamicModelPending		= false;
 	referenceBounds			= bounds_zero;
 	viewCount				= 0;
 	viewEntity				= NULL;
@@ -101,6 +102,9 @@ idRenderLightLocal::idRenderLightLocal() {
 	foggedPortals			= NULL;
 	firstInteraction		= NULL;
 	lastInteraction			= NULL;
+	flowCacheValid			= false;
+	flowCacheOrigin			= vec3_zero;
+	memset( flowCacheFrustum, 0, sizeof( flowCacheFrustum ) );
 }
 
 void idRenderLightLocal::FreeRenderLight() {
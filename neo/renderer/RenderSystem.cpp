@@ -38,6 +38,11 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "renderer/tr_local.h"
 
+#if __cplusplus >= 201103
+  // every frame in the ring needs its own vertex cache temp list
+  static_assert( NUM_VERTEX_FRAMES == NUM_FRAME_DATA, "NUM_VERTEX_FRAMES must match NUM_FRAME_DATA" );
+#endif
+
 idRenderSystemLocal	tr;
 idRenderSystem	*renderSystem = &tr;
 
@@ -101,8 +106,11 @@ static void R_PerformanceCounters( void ) {
 	}
 
 	if ( r_showInteractions.GetBool() ) {
-		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i\n",
-			tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes );
+		int shadowCacheVolumes, shadowCacheBytes;
+		R_ShadowCacheMemory( shadowCacheVolumes, shadowCacheBytes );
+		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i shadowCache:%i hits %i misses %i volumes %ik\n",
+			tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes,
+			tr.pc.c_shadowCacheHits, tr.pc.c_shadowCacheMisses, shadowCacheVolumes, shadowCacheBytes / 1024 );
 	}
 	if ( r_showDefs.GetBool() ) {
 		common->Printf( "viewEntities:%i  shadowEntities:%i  viewLights:%i\n", tr.pc.c_visibleViewEntities,
@@ -113,6 +121,21 @@ static void R_PerformanceCounters( void ) {
 			tr.pc.c_entityUpdates, tr.pc.c_entityReferences,
 			tr.pc.c_lightUpdates, tr.pc.c_lightReferences );
 	}
+	if ( r_showPortalFlow.GetBool() ) {
+		common->Printf( "viewFlows:%i (%i cached) lightFlows:%i (%i cached) areas:%i portalClips:%i\n",
+			tr.pc.c_portalViewFlows, tr.pc.c_portalViewCacheHits,
+			tr.pc.c_portalLightFlows, tr.pc.c_portalLightCacheHits,
+			tr.pc.c_portalAreas, tr.pc.c_portalClips );
+	}
+	if ( r_showBackendStall.GetBool() ) {
+		int idleMsec = tr.backendIdleMsec;
+		tr.backendIdleMsec = 0;
+		common->Printf( "queued:%i queueStalls:%i (%i msec) imageStalls:%i (%i msec) readback:%i msec backendIdle:%i msec\n",
+			tr.framesQueued - tr.BackendFramesDone(),
+			tr.pc.c_queueStalls, tr.pc.queueStallMsec,
+			tr.pc.c_imageStalls, tr.pc.imageStallMsec,
+			tr.pc.readbackStallMsec, idleMsec );
+	}
 	if ( r_showMemory.GetBool() ) {
 		int	m1 = frameData ? frameData->memoryHighwater : 0;
 		common->Printf( "frameData: %i (%i)\n", R_CountFrameData(), m1 );
@@ -580,14 +603,44 @@ int idRenderSystemLocal::BackendThreadRunner(void *localRenderSystem)
 	return 0;
 }
 
+int idRenderSystemLocal::BackendFramesDone()
+{
+	Sys_EnterCriticalSection( CRITICAL_SECTION_BACKEND );
+	int done = framesDone;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_BACKEND );
+
+	return done;
+}
+
+void idRenderSystemLocal::BackendWaitForFrames( int numFrames )
+{
+	while( BackendFramesDone() < numFrames )
+	{
+		// The event can still be set from an earlier frame, so check again
+		Sys_WaitForEvent(TRIGGER_EVENT_BACKEND_FINISHED);
+	}
+}
+
+void idRenderSystemLocal::BackendWaitForImages( int numFrames )
+{
+	while( 1 )
+	{
+		Sys_EnterCriticalSection( CRITICAL_SECTION_BACKEND );
+		bool done = imagesDone >= numFrames;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_BACKEND );
+
+		if( done )
+		{
+			break;
+		}
+
+		Sys_WaitForEvent(TRIGGER_EVENT_IMAGES_PROCESSES);
+	}
+}
+
 void idRenderSystemLocal::BackendThreadWait()
 {
-	while(!backendFinished)
-    {
-        //usleep(1000 * 3);
-        Sys_WaitForEvent(TRIGGER_EVENT_BACKEND_FINISHED);
-        //usleep(500);
-    }
+	BackendWaitForFrames( framesQueued );
 }
 
 void idRenderSystemLocal::BackendThread()
@@ -596,21 +649,28 @@ void idRenderSystemLocal::BackendThread()
 
 	while( 1 )
 	{
-		if( useSpinLock )
-    	{
-			while(!backendThreadRun)
+		// Sleep until the front end queues a frame or wants us to shut down
+		int start = Sys_Milliseconds();
+		int frameNum;
+
+		while( 1 )
+		{
+			Sys_EnterCriticalSection( CRITICAL_SECTION_BACKEND );
+			bool haveFrame = framesDone < framesQueued;
+			frameNum = framesDone;
+			Sys_LeaveCriticalSection( CRITICAL_SECTION_BACKEND );
+
+			if( haveFrame || backendThreadShutdown )
 			{
-				if(spinLockDelay)
-					usleep(spinLockDelay);
+				break;
 			}
-			backendThreadRun = false;
-    	}
-    	else
-    	{
+
 			Sys_WaitForEvent(TRIGGER_EVENT_RUN_BACKEND);
 		}
 
-		// Thread will be woken up to either shutdown or render
+		backendIdleMsec += Sys_Milliseconds() - start;
+
+		// The front end only asks for a shutdown once every frame is done
 		if( backendThreadShutdown )
 		{
 			common->Printf( "Backend thread ending..\n" );
@@ -622,58 +682,71 @@ void idRenderSystemLocal::BackendThread()
 		}
 		else
 		{
-			BackendThreadTask();
+			BackendThreadTask( frameNum );
 		}
 	}
 }
 
 
-void idRenderSystemLocal::BackendThreadTask()
+void idRenderSystemLocal::BackendThreadTask( int frameNum )
 {
-	idImage * img;
-	// Purge all images
-	while( (img = globalImages->GetNextPurgeImage()) != NULL )
-	{
-		img->PurgeImage();
-	}
+	backendFrame_t &frame = frameQueue[frameNum % NUM_FRAME_DATA];
+	bool hadImages = frame.imagePhase;
 
-	// Load all images
-	while( (img = globalImages->GetNextAllocImage()) != NULL )
+	// Purge and load the images queued while this frame was built.
+	// The lists are emptied without freeing, the heap isn't ours to touch
+	for( int i = 0; i < frame.imagesPurge.Num(); i++ )
 	{
-		img->ActuallyLoadImage( false );
+		frame.imagesPurge[i]->purgePending = false;
+		frame.imagesPurge[i]->PurgeImage();
 	}
+	frame.imagesPurge.SetNum( 0, false );
 
-
-	if( useSpinLock )
+	for( int i = 0; i < frame.imagesAlloc.Num(); i++ )
 	{
-		imagesFinished = true;
+		frame.imagesAlloc[i]->ActuallyLoadImage( false );
 	}
-	else
+	frame.imagesAlloc.SetNum( 0, false );
+
+	if( hadImages )
 	{
+		// upload what the jobs have built since the last image phase
+		globalImages->UploadBackgroundLoads();
+
+		Sys_EnterCriticalSection( CRITICAL_SECTION_BACKEND );
+		imagesDone = frameNum + 1;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_BACKEND );
+
 		Sys_TriggerEvent(TRIGGER_EVENT_IMAGES_PROCESSES);
 	}
 
-	vertexCache.BeginBackEnd(vertListToRender);
+	vertexCache.BeginBackEnd(frame.vertList);
 
-	R_IssueRenderCommands(fdToRender);
+	R_IssueRenderCommands(frame.frameData);
 
 	// Take screen shot
-	if(pixels)
+	if(frame.pixels)
 	{
-		qglReadPixels( pixelsCrop->x, pixelsCrop->y, pixelsCrop->width, pixelsCrop->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)pixels );
-		pixels = NULL;
-		pixelsCrop = NULL;
+		qglReadPixels( frame.pixelsCrop->x, frame.pixelsCrop->y, frame.pixelsCrop->width, frame.pixelsCrop->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)frame.pixels );
+		frame.pixels = NULL;
+		frame.pixelsCrop = NULL;
 	}
 
-	backendFinished = true;
+	Sys_EnterCriticalSection( CRITICAL_SECTION_BACKEND );
+	framesDone = frameNum + 1;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_BACKEND );
+
 	Sys_TriggerEvent(TRIGGER_EVENT_BACKEND_FINISHED);
 }
 
 void idRenderSystemLocal::BackendThreadExecute()
 {
 	//LOGI("BackendThreadRun called..");
-	imagesFinished = false;
-	backendFinished = false;
+	int frameNum = framesQueued;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_BACKEND );
+	framesQueued++;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_BACKEND );
 
 	if(multithreadActive)
 	{
@@ -686,18 +759,11 @@ void idRenderSystemLocal::BackendThreadExecute()
 		}
 
 		// Start Thread
-		if( useSpinLock )
-		{
-			backendThreadRun = true;
-		}
-		else
-		{
-			Sys_TriggerEvent(TRIGGER_EVENT_RUN_BACKEND);
-		}
+		Sys_TriggerEvent(TRIGGER_EVENT_RUN_BACKEND);
 	}
 	else // No multithread, just execute in sequence
 	{
-		BackendThreadTask();
+		BackendThreadTask( frameNum );
 	}
 }
 
@@ -713,14 +779,7 @@ void idRenderSystemLocal::BackendThreadShutdown()
 		backendThreadShutdown = true;
 
 		// Start Thread
-		if( useSpinLock )
-		{
-			backendThreadRun = true;
-		}
-		else
-		{
-			Sys_TriggerEvent(TRIGGER_EVENT_RUN_BACKEND);
-		}
+		Sys_TriggerEvent(TRIGGER_EVENT_RUN_BACKEND);
 
 		// Join thread and wait until finished
 		Sys_DestroyThread(renderThread);
@@ -735,9 +794,19 @@ void idRenderSystemLocal::BackendThreadShutdown()
 
 void idRenderSystemLocal::RenderCommands(renderCrop_t *pc, byte *pix)
 {
+	int start;
 
-	//Wait for last backend rendering to finish
-	BackendThreadWait();
+	// Wait until there is room in the pipeline. With a depth of 2 this waits for
+	// the previous frame to finish, with 3 the backend can still have one queued
+	int maxQueued = multithreadActive ? r_frameQueueDepth.GetInteger() - 2 : 0;
+
+	if( framesQueued - BackendFramesDone() > maxQueued )
+	{
+		start = Sys_Milliseconds();
+		BackendWaitForFrames( framesQueued - maxQueued );
+		tr.pc.c_queueStalls++;
+		tr.pc.queueStallMsec += Sys_Milliseconds() - start;
+	}
 
 	// Limit maximum FPS
 	int maxFPS = r_maxFps.GetInteger();
@@ -766,39 +835,46 @@ void idRenderSystemLocal::RenderCommands(renderCrop_t *pc, byte *pix)
 		multithreadActive = true;
 	}
 
-	//Save the current vertexs and framedata to use for next render
-	vertListToRender = vertexCache.GetListNum();
-	fdToRender = frameData;
+	// Hand the current frame data, vertex list and the image work queued
+	// while building them to the backend
+	int frameNum = framesQueued;
+	backendFrame_t &frame = frameQueue[frameNum % NUM_FRAME_DATA];
+
+	frame.frameData = frameData;
+	frame.vertList = vertexCache.GetListNum();
+	globalImages->TakeQueuedImages( frame.imagesAlloc, frame.imagesPurge );
+
+	// Loads still running on the jobs don't need an image phase, only
+	// the ones that are ready to be uploaded
+	frame.imagePhase = frame.imagesAlloc.Num() || frame.imagesPurge.Num() || globalImages->BackgroundLoadsReady();
+	bool waitForImages = frame.imagePhase;
 
 	//Save the potential pixel
-	pixelsCrop = pc;
-	pixels = pix;
+	frame.pixelsCrop = pc;
+	frame.pixels = pix;
 
 	BackendThreadExecute();
 
-	// Wait for the backend to load any images, this only really happens at level load time
-	// Problem is image loading is not thread safe, hence the wait
-	if(useSpinLock)
+	// Image loading is not thread safe, so if this frame brought any we have
+	// to wait for them. Mostly this only happens at level load time
+	if( waitForImages )
 	{
-		while(!imagesFinished)
-		{
-			if(spinLockDelay)
-				usleep(spinLockDelay);
-		}
-	}
-	else
-	{
-		Sys_WaitForEvent(TRIGGER_EVENT_IMAGES_PROCESSES);
+		start = Sys_Milliseconds();
+		BackendWaitForImages( frameNum + 1 );
+		tr.pc.c_imageStalls++;
+		tr.pc.imageStallMsec += Sys_Milliseconds() - start;
 	}
 
 	// If we are waiting for pixel data, make sure we wait for the backend to finish
 	if(pix)
 	{
-		BackendThreadWait();
+		start = Sys_Milliseconds();
+		BackendWaitForFrames( frameNum + 1 );
+		tr.pc.readbackStallMsec += Sys_Milliseconds() - start;
 	}
 
-	// use the other buffers next frame, because another CPU
-	// may still be rendering into the current buffers
+	// use the next buffers in the ring, the backend may still be
+	// rendering the ones before
 	R_ToggleSmpFrame();
 
 	// we can now release the vertexes used this frame
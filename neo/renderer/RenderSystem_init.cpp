@@ -146,6 +146,9 @@ idCVar r_useScissor( "r_useScissor", "1", CVAR_RENDERER | CVAR_BOOL, "scissor cl
 idCVar r_screenFraction( "r_screenFraction", "100", CVAR_RENDERER | CVAR_INTEGER, "for testing fill rate, the resolution of the entire screen can be changed" );
 idCVar r_demonstrateBug( "r_demonstrateBug", "0", CVAR_RENDERER | CVAR_BOOL, "used during development to show IHV's their problems" );
 idCVar r_usePortals( "r_usePortals", "1", CVAR_RENDERER | CVAR_BOOL, " 1 = use portals to perform area culling, otherwise draw everything" );
+idCVar r_usePortalCache( "r_usePortalCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse the portal flow of earlier views and lights that didn't move" );
+idCVar r_useShadowCache( "r_useShadowCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse the shadow volumes of surfaces and lights that didn't move" );
+idCVar r_shadowCacheSize( "r_shadowCacheSize", "8", CVAR_RENDERER | CVAR_INTEGER, "MB of shadow volumes kept for reuse", 0, 256 );
 idCVar r_singleLight( "r_singleLight", "-1", CVAR_RENDERER | CVAR_INTEGER, "suppress all but one light" );
 idCVar r_singleEntity( "r_singleEntity", "-1", CVAR_RENDERER | CVAR_INTEGER, "suppress all but one entity" );
 idCVar r_singleSurface( "r_singleSurface", "-1", CVAR_RENDERER | CVAR_INTEGER, "suppress all but one surface on each entity" );
@@ -160,6 +163,7 @@ idCVar r_showUnsmoothedTangents( "r_showUnsmoothedTangents", "0", CVAR_RENDERER
 idCVar r_showSilhouette( "r_showSilhouette", "0", CVAR_RENDERER | CVAR_BOOL, "highlight edges that are casting shadow planes" );
 idCVar r_showVertexColor( "r_showVertexColor", "0", CVAR_RENDERER | CVAR_BOOL, "draws all triangles with the solid vertex color" );
 idCVar r_showUpdates( "r_showUpdates", "0", CVAR_RENDERER | CVAR_BOOL, "report entity and light updates and ref counts" );
+idCVar r_showPortalFlow( "r_showPortalFlow", "0", CVAR_RENDERER | CVAR_BOOL, "report portal flows, clipped portals and portal cache hits" );
 idCVar r_showDemo( "r_showDemo", "0", CVAR_RENDERER | CVAR_BOOL, "report reads and writes to the demo file" );
 idCVar r_showDynamic( "r_showDynamic", "0", CVAR_RENDERER | CVAR_BOOL, "report stats on dynamic surface generation" );
 idCVar r_showDefs( "r_showDefs", "0", CVAR_RENDERER | CVAR_BOOL, "report the number of modeDefs and lightDefs in view" );
@@ -212,10 +216,18 @@ idCVar r_useStencilOpSeparate( "r_useStencilOpSeparate", "1", CVAR_RENDERER | CV
 
 
 idCVar r_multithread("r_multithread", "0", CVAR_RENDERER | CVAR_BOOL, "Multithread backend");
+idCVar r_frameQueueDepth( "r_frameQueueDepth", "2", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "Frames in the multithreaded render pipeline. 2 = the front end overlaps the backend by one frame, 3 = the front end can get another frame ahead", 2, NUM_FRAME_DATA );
+idCVar r_showBackendStall( "r_showBackendStall", "0", CVAR_RENDERER | CVAR_BOOL, "Print how often and how long the front end waited on the backend thread" );
+idCVar r_parallelFrontEnd( "r_parallelFrontEnd", "0", CVAR_RENDERER | CVAR_BOOL, "Spread front end culling over the job system worker threads" );
+idCVar r_parallelSkinning( "r_parallelSkinning", "0", CVAR_RENDERER | CVAR_BOOL, "Skin the visible MD5 models together on the job system worker threads, straight into frame temp vertex memory" );
+idCVar r_parallelShadows( "r_parallelShadows", "0", CVAR_RENDERER | CVAR_BOOL, "Build the shadow volumes needed by a view together on the job system worker threads" );
+idCVar r_parallelParticles( "r_parallelParticles", "0", CVAR_RENDERER | CVAR_BOOL, "Create the particles of a stage a range at a time, big stages are split over the job system worker threads" );
+idCVar r_checkParticles( "r_checkParticles", "0", CVAR_RENDERER | CVAR_BOOL, "Also create every particle stage with CreateParticle and print the stages where r_parallelParticles gave different vertexes" );
 
 idCVar r_noLight("r_noLight", "0", CVAR_RENDERER | CVAR_BOOL, "lighting disable hack");
 idCVar r_useETC1("r_useETC1", "0", CVAR_RENDERER | CVAR_BOOL, "use ETC1 compression");
-idCVar r_useETC1Cache("r_useETC1cache", "0", CVAR_RENDERER | CVAR_BOOL, "cache ETC1 data");
+idCVar r_useETC1Cache("r_useETC1cache", "0", CVAR_RENDERER | CVAR_BOOL, "keep ETC1 compressed images in etccache/ under fs_savepath");
+idCVar r_useBinaryProc( "r_useBinaryProc", "1", CVAR_RENDERER | CVAR_BOOL, "keep a binary copy of each map .proc in maps/*.bproc under fs_savepath and map it instead of parsing the text" );
 
 idCVar r_maxFps( "r_maxFps", "0", CVAR_RENDERER | CVAR_INTEGER, "Limit maximum FPS. 0 = unlimited" );
 
@@ -1348,9 +1360,12 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 	// free any current world interaction surfaces and vertex caches
 	R_FreeDerivedData();
 
-	// make sure the defered frees are actually freed
-	R_ToggleSmpFrame();
-	R_ToggleSmpFrame();
+	// make sure the defered frees are actually freed, the backend
+	// mustn't be using any of the frames for that
+	tr.BackendThreadWait();
+	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		R_ToggleSmpFrame();
+	}
 
 	// free the vertex caches so they will be regenerated again
 	vertexCache.PurgeAll();
@@ -1562,8 +1577,6 @@ void idRenderSystemLocal::Init( void ) {
 	// there may be other state we need to reset
 
 	multithreadActive = r_multithread.GetBool();
-	useSpinLock = false;
-	spinLockDelay = 500;
 
 	ambientLightVector[0] = 0.5f;
 	ambientLightVector[1] = 0.5f - 0.385f;
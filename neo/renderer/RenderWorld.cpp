@@ -145,6 +145,15 @@ idRenderWorldLocal::idRenderWorldLocal() {
 	interactionTable = 0;
 	interactionTableWidth = 0;
 	interactionTableHeight = 0;
+
+	mappedProc = NULL;
+	mappedProcSize = 0;
+
+	for ( int i = 0; i < MAX_PORTAL_VIS_CACHE; i++ ) {
+		portalVisCache[i].valid = false;
+	}
+	portalVisRecord = NULL;
+	portalVisGeneration = 0;
 }
 
 /*
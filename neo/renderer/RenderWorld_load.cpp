@@ -27,11 +27,13 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/hashing/CRC32.h"
 #include "framework/Session.h"
 #include "renderer/ModelManager.h"
 #include "renderer/RenderWorld_local.h"
 
 #include "renderer/tr_local.h"
+#include "renderer/Model_local.h"
 
 /*
 ================
@@ -44,6 +46,9 @@ void idRenderWorldLocal::FreeWorld() {
 	// this will free all the lightDefs and entityDefs
 	FreeDefs();
 
+	// the cached portal flows point into the old areas
+	InvalidatePortalVisCache();
+
 	// free all the portals and check light/model references
 	for ( i = 0 ; i < numPortalAreas ; i++ ) {
 		portalArea_t	*area;
@@ -91,6 +96,15 @@ void idRenderWorldLocal::FreeWorld() {
 	}
 	localModels.Clear();
 
+	// the surfaces of the models pointed into the .bproc, the backend
+	// may still be drawing them in a queued frame
+	if ( mappedProc ) {
+		tr.BackendThreadWait();
+		Sys_UnmapFile( mappedProc, mappedProcSize );
+		mappedProc = NULL;
+		mappedProcSize = 0;
+	}
+
 	areaReferenceAllocator.Shutdown();
 	interactionAllocator.Shutdown();
 	areaNumRefAllocator.Shutdown();
@@ -298,7 +312,6 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
 		int		numPoints, a1, a2;
 		idWinding	*w;
-		portal_t	*p;
 
 		numPoints = src->ParseInt();
 		a1 = src->ParseInt();
@@ -313,32 +326,46 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 			(*w)[j][4] = 0;
 		}
 
-		// add the portal to a1
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a2;
-		p->doublePortal = &doublePortals[i];
-		p->w = w;
-		p->w->GetPlane( p->plane );
+		AddInterAreaPortal( i, a1, a2, w );
+	}
+
+	src->ExpectTokenString( "}" );
+}
+
+/*
+================
+idRenderWorldLocal::AddInterAreaPortal
+
+Links both sides of doublePortals[portalNum] into their areas, the a1
+side keeps w and the a2 side gets a reversed copy
+================
+*/
+void idRenderWorldLocal::AddInterAreaPortal( int portalNum, int a1, int a2, idWinding *w ) {
+	portal_t	*p;
 
-		p->next = portalAreas[a1].portals;
-		portalAreas[a1].portals = p;
+	// add the portal to a1
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a2;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w;
+	p->w->GetPlane( p->plane );
 
-		doublePortals[i].portals[0] = p;
+	p->next = portalAreas[a1].portals;
+	portalAreas[a1].portals = p;
 
-		// reverse it for a2
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a1;
-		p->doublePortal = &doublePortals[i];
-		p->w = w->Reverse();
-		p->w->GetPlane( p->plane );
+	doublePortals[portalNum].portals[0] = p;
 
-		p->next = portalAreas[a2].portals;
-		portalAreas[a2].portals = p;
+	// reverse it for a2
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a1;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w->Reverse();
+	p->w->GetPlane( p->plane );
 
-		doublePortals[i].portals[1] = p;
-	}
+	p->next = portalAreas[a2].portals;
+	portalAreas[a2].portals = p;
 
-	src->ExpectTokenString( "}" );
+	doublePortals[portalNum].portals[1] = p;
 }
 
 /*
@@ -370,6 +397,604 @@ void idRenderWorldLocal::ParseNodes( idLexer *src ) {
 	src->ExpectTokenString( "}" );
 }
 
+/*
+
+With r_useBinaryProc, the first load of a map writes everything InitFromMap
+built from the text .proc to maps/<name>.bproc under fs_savepath: the world
+model surfaces as they are after FinishSurfaces, with their silhouette edges,
+face planes and tangents, the inter area portals and the area nodes. Later
+loads map that file and point the srfTriangles_t arrays straight into the
+mapping, so the lexer, the surface cleanup and most of the allocations are
+skipped.
+
+The file is only used if it was built from a .proc with the same CRC, and if
+the materials of the surfaces still want the same back sides, tangents and
+deform bounds, otherwise it is rebuilt from the text. Like the ETC1 cache it
+is written in native byte order for the machine that built it.
+
+*/
+
+#define BPROC_FILE_EXT				"bproc"
+
+static const int BPROC_IDENT = ( 'C' << 24 ) + ( 'R' << 16 ) + ( 'P' << 8 ) + 'B';
+static const int BPROC_VERSION = 1;
+static const int BPROC_ALIGN = 16;			// every record and array starts 16 byte aligned
+
+// the material settings FinishSurfaces depends on
+static const int BPROC_MATERIAL_BACK_SIDES	= BIT( 0 );
+static const int BPROC_MATERIAL_UNSMOOTHED	= BIT( 1 );
+static const int BPROC_MATERIAL_DEFORM		= BIT( 2 );
+
+// srfTriangles_t flags and the arrays that follow a bprocSurface_t
+static const int BPROC_TRI_GENERATE_NORMALS	= BIT( 0 );
+static const int BPROC_TRI_TANGENTS			= BIT( 1 );
+static const int BPROC_TRI_FACE_PLANES		= BIT( 2 );
+static const int BPROC_TRI_PERFECT_HULL		= BIT( 3 );
+static const int BPROC_TRI_VERTS			= BIT( 4 );
+static const int BPROC_TRI_SHADOW_VERTS		= BIT( 5 );
+static const int BPROC_TRI_INDEXES			= BIT( 6 );
+static const int BPROC_TRI_SIL_INDEXES		= BIT( 7 );
+static const int BPROC_TRI_SIL_EDGES		= BIT( 8 );
+static const int BPROC_TRI_MIRRORED_VERTS	= BIT( 9 );
+static const int BPROC_TRI_DUP_VERTS		= BIT( 10 );
+static const int BPROC_TRI_PLANES			= BIT( 11 );
+static const int BPROC_TRI_DOMINANT_TRIS	= BIT( 12 );
+
+typedef struct {
+	int					ident;
+	int					version;
+	unsigned int		check;			// CRC32 of the source .proc
+	int					indexSize;		// sizeof( glIndex_t )
+	int					numModels;
+	int					numPortalAreas;
+	int					numInterAreaPortals;
+	int					numAreaNodes;
+} bprocHeader_t;
+
+// followed by the name
+typedef struct {
+	idBounds			bounds;
+	int					numSurfaces;
+} bprocModel_t;
+
+// followed by the material name and the arrays in BPROC_TRI_* order
+typedef struct {
+	idBounds			bounds;
+	int					materialBits;
+	int					triBits;
+	int					numVerts;
+	int					numIndexes;
+	int					numMirroredVerts;
+	int					numDupVerts;
+	int					numSilEdges;
+	int					numShadowIndexesNoFrontCaps;
+	int					numShadowIndexesNoCaps;
+	int					shadowCapPlaneBits;
+} bprocSurface_t;
+
+// followed by the points
+typedef struct {
+	int					numPoints;
+	int					areas[2];
+} bprocPortal_t;
+
+typedef struct {
+	idPlane				plane;
+	int					children[2];
+} bprocNode_t;
+
+typedef struct {
+	const byte *		data;
+	int					size;
+	int					offset;
+} bprocReader_t;
+
+/*
+================
+R_BProcMaterialBits
+================
+*/
+static int R_BProcMaterialBits( const idMaterial *shader ) {
+	int bits = 0;
+
+	if ( shader->ShouldCreateBackSides() ) {
+		bits |= BPROC_MATERIAL_BACK_SIDES;
+	}
+	if ( shader->UseUnsmoothedTangents() ) {
+		bits |= BPROC_MATERIAL_UNSMOOTHED;
+	}
+	if ( shader->Deform() != DFRM_NONE ) {
+		bits |= BPROC_MATERIAL_DEFORM;
+	}
+	return bits;
+}
+
+/*
+================
+R_BProcRead
+
+Returns the next count elements of the file and skips the alignment
+padding after them, or NULL if the file is too short
+================
+*/
+static const void *R_BProcRead( bprocReader_t &r, int count, int elementSize ) {
+	if ( count < 0 || r.offset > r.size || count > ( r.size - r.offset ) / elementSize ) {
+		return NULL;
+	}
+	const void *data = r.data + r.offset;
+	r.offset += ( count * elementSize + BPROC_ALIGN - 1 ) & ~( BPROC_ALIGN - 1 );
+	return data;
+}
+
+/*
+================
+R_BProcReadString
+================
+*/
+static const char *R_BProcReadString( bprocReader_t &r ) {
+	if ( r.offset > r.size - (int)sizeof( int ) ) {
+		return NULL;
+	}
+	int length = *(const int *)( r.data + r.offset );
+	if ( length <= 0 || length > r.size ) {
+		return NULL;
+	}
+	const char *string = (const char *)R_BProcRead( r, sizeof( int ) + length, 1 );
+	if ( !string || string[sizeof( int ) + length - 1] != '\0' ) {
+		return NULL;
+	}
+	return string + sizeof( int );
+}
+
+/*
+================
+R_BProcReadArray
+
+The arrays are used straight from the read only mapping
+================
+*/
+template< class type >
+static bool R_BProcReadArray( bprocReader_t &r, int triBits, int bit, int count, type *&array ) {
+	array = NULL;
+	if ( !( triBits & bit ) ) {
+		return true;
+	}
+	array = (type *)R_BProcRead( r, count, sizeof( type ) );
+	return ( array != NULL );
+}
+
+/*
+================
+R_BProcCheckIndexes
+================
+*/
+template< class type >
+static bool R_BProcCheckIndexes( const type *indexes, int count, int limit ) {
+	for ( int i = 0 ; i < count ; i++ ) {
+		int index = indexes[i];
+		if ( index < 0 || index >= limit ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+R_BProcCheckTri
+
+The counts are only checked against the file size by the reads, this makes
+sure everything in the arrays points inside the surface, so a damaged file
+can't send the renderer outside of the mapping
+================
+*/
+static bool R_BProcCheckTri( const srfTriangles_t *tri ) {
+	int		i;
+
+	if ( tri->numMirroredVerts < 0 || tri->numSilEdges < 0 || tri->numIndexes % 3 != 0
+			|| tri->numShadowIndexesNoCaps < 0 || tri->numShadowIndexesNoCaps > tri->numShadowIndexesNoFrontCaps
+			|| tri->numShadowIndexesNoFrontCaps > tri->numIndexes ) {
+		return false;
+	}
+	if ( ( tri->numVerts && !tri->verts && !tri->shadowVertexes ) || ( tri->numIndexes && !tri->indexes ) ) {
+		return false;
+	}
+	if ( !R_BProcCheckIndexes( tri->indexes, tri->indexes ? tri->numIndexes : 0, tri->numVerts ) ) {
+		return false;
+	}
+	if ( tri->silIndexes && !R_BProcCheckIndexes( tri->silIndexes, tri->numIndexes, tri->numVerts ) ) {
+		return false;
+	}
+	if ( tri->mirroredVerts && !R_BProcCheckIndexes( tri->mirroredVerts, tri->numMirroredVerts, tri->numVerts ) ) {
+		return false;
+	}
+	if ( tri->dupVerts && !R_BProcCheckIndexes( tri->dupVerts, tri->numDupVerts * 2, tri->numVerts ) ) {
+		return false;
+	}
+	if ( tri->silEdges ) {
+		// p2 is the number of faces for the dangling edges
+		for ( i = 0 ; i < tri->numSilEdges ; i++ ) {
+			const silEdge_t &edge = tri->silEdges[i];
+			if ( !R_BProcCheckIndexes( &edge.p1, 1, tri->numIndexes / 3 ) || !R_BProcCheckIndexes( &edge.p2, 1, tri->numIndexes / 3 + 1 )
+					|| !R_BProcCheckIndexes( &edge.v1, 1, tri->numVerts ) || !R_BProcCheckIndexes( &edge.v2, 1, tri->numVerts ) ) {
+				return false;
+			}
+		}
+	}
+	if ( tri->dominantTris ) {
+		for ( i = 0 ; i < tri->numVerts ; i++ ) {
+			const dominantTri_t &dt = tri->dominantTris[i];
+			if ( !R_BProcCheckIndexes( &dt.v2, 1, tri->numVerts ) || !R_BProcCheckIndexes( &dt.v3, 1, tri->numVerts ) ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+================
+R_BProcPad
+================
+*/
+static void R_BProcPad( idFile *f ) {
+	static const byte zeros[BPROC_ALIGN] = { 0 };
+
+	f->Write( zeros, -f->Tell() & ( BPROC_ALIGN - 1 ) );
+}
+
+/*
+================
+R_BProcWrite
+================
+*/
+static void R_BProcWrite( idFile *f, const void *data, int size ) {
+	f->Write( data, size );
+	R_BProcPad( f );
+}
+
+/*
+================
+R_BProcWriteString
+================
+*/
+static void R_BProcWriteString( idFile *f, const char *string ) {
+	int length = strlen( string ) + 1;
+
+	f->Write( &length, sizeof( length ) );
+	R_BProcWrite( f, string, length );
+}
+
+/*
+================
+R_BProcWriteArray
+================
+*/
+template< class type >
+static void R_BProcWriteArray( idFile *f, const type *array, int count ) {
+	if ( array ) {
+		R_BProcWrite( f, array, count * sizeof( type ) );
+	}
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryProc
+
+Builds the world from a mapped .bproc, returns false as soon as anything
+doesn't match, the caller frees whatever was built by then
+================
+*/
+bool idRenderWorldLocal::ReadBinaryProc( const byte *data, int size, unsigned int check ) {
+	bprocReader_t	r;
+	int				i, j;
+
+	r.data = data;
+	r.size = size;
+	r.offset = 0;
+
+	const bprocHeader_t *header = (const bprocHeader_t *)R_BProcRead( r, 1, sizeof( *header ) );
+	if ( !header || header->ident != BPROC_IDENT || header->version != BPROC_VERSION || header->check != check
+			|| header->indexSize != sizeof( glIndex_t ) || header->numModels < 0 || header->numPortalAreas < 0
+			|| header->numInterAreaPortals < 0 || header->numAreaNodes < 0 ) {
+		return false;
+	}
+
+	for ( i = 0 ; i < header->numModels ; i++ ) {
+		const bprocModel_t *bmodel = (const bprocModel_t *)R_BProcRead( r, 1, sizeof( *bmodel ) );
+		const char *name = R_BProcReadString( r );
+		if ( !bmodel || !name || bmodel->numSurfaces < 0 ) {
+			return false;
+		}
+
+		idRenderModel *model = renderModelManager->AllocModel();
+		model->InitEmpty( name );
+
+		renderModelManager->AddModel( model );
+		localModels.Append( model );
+
+		for ( j = 0 ; j < bmodel->numSurfaces ; j++ ) {
+			const bprocSurface_t *bsurf = (const bprocSurface_t *)R_BProcRead( r, 1, sizeof( *bsurf ) );
+			const char *shaderName = R_BProcReadString( r );
+			if ( !bsurf || !shaderName || bsurf->numVerts < 0 || bsurf->numIndexes < 0 || bsurf->numDupVerts < 0 ) {
+				return false;
+			}
+
+			// shadow models use the default material, and don't reference it
+			modelSurface_t	surf;
+			surf.id = 0;
+			if ( bsurf->triBits & BPROC_TRI_SHADOW_VERTS ) {
+				surf.shader = tr.defaultMaterial;
+			} else {
+				surf.shader = declManager->FindMaterial( shaderName );
+				((idMaterial*)surf.shader)->AddReference();
+			}
+
+			// the surface was finished for a different material
+			if ( R_BProcMaterialBits( surf.shader ) != bsurf->materialBits ) {
+				common->DPrintf( "idRenderWorldLocal::ReadBinaryProc: material %s has changed\n", shaderName );
+				return false;
+			}
+
+			srfTriangles_t *tri = R_AllocStaticTriSurf();
+			tri->mappedSurface = true;
+			tri->bounds = bsurf->bounds;
+			tri->generateNormals = ( bsurf->triBits & BPROC_TRI_GENERATE_NORMALS ) != 0;
+			tri->tangentsCalculated = ( bsurf->triBits & BPROC_TRI_TANGENTS ) != 0;
+			tri->facePlanesCalculated = ( bsurf->triBits & BPROC_TRI_FACE_PLANES ) != 0;
+			tri->perfectHull = ( bsurf->triBits & BPROC_TRI_PERFECT_HULL ) != 0;
+			tri->numVerts = bsurf->numVerts;
+			tri->numIndexes = bsurf->numIndexes;
+			tri->numMirroredVerts = bsurf->numMirroredVerts;
+			tri->numDupVerts = bsurf->numDupVerts;
+			tri->numSilEdges = bsurf->numSilEdges;
+			tri->numShadowIndexesNoFrontCaps = bsurf->numShadowIndexesNoFrontCaps;
+			tri->numShadowIndexesNoCaps = bsurf->numShadowIndexesNoCaps;
+			tri->shadowCapPlaneBits = bsurf->shadowCapPlaneBits;
+
+			surf.geometry = tri;
+			model->AddSurface( surf );
+
+			if ( !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_VERTS, tri->numVerts, tri->verts )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_SHADOW_VERTS, tri->numVerts, tri->shadowVertexes )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_INDEXES, tri->numIndexes, tri->indexes )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_SIL_INDEXES, tri->numIndexes, tri->silIndexes )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_SIL_EDGES, tri->numSilEdges, tri->silEdges )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_MIRRORED_VERTS, tri->numMirroredVerts, tri->mirroredVerts )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_DUP_VERTS, tri->numDupVerts * 2, tri->dupVerts )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_PLANES, tri->numIndexes / 3, tri->facePlanes )
+					|| !R_BProcReadArray( r, bsurf->triBits, BPROC_TRI_DOMINANT_TRIS, tri->numVerts, tri->dominantTris ) ) {
+				return false;
+			}
+			if ( !R_BProcCheckTri( tri ) ) {
+				return false;
+			}
+
+			// add up the total surface area for development information, like FinishSurfaces
+			if ( tri->verts ) {
+				for ( int k = 0 ; k < tri->numIndexes ; k += 3 ) {
+					float	area = idWinding::TriangleArea( tri->verts[tri->indexes[k]].xyz,
+						tri->verts[tri->indexes[k+1]].xyz, tri->verts[tri->indexes[k+2]].xyz );
+					const_cast<idMaterial *>(surf.shader)->AddToSurfaceArea( area );
+				}
+			}
+		}
+
+		// the surfaces were finished when the file was written
+		static_cast<idRenderModelStatic *>( model )->bounds = bmodel->bounds;
+	}
+
+	numPortalAreas = header->numPortalAreas;
+	numInterAreaPortals = header->numInterAreaPortals;
+	if ( numPortalAreas ) {
+		portalAreas = (portalArea_t *)R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
+		areaScreenRect = (idScreenRect *) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
+		doublePortals = (doublePortal_t *)R_ClearedStaticAlloc( numInterAreaPortals * sizeof( doublePortals [0] ) );
+
+		// set the doubly linked lists
+		SetupAreaRefs();
+	}
+
+	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
+		const bprocPortal_t *bportal = (const bprocPortal_t *)R_BProcRead( r, 1, sizeof( *bportal ) );
+		if ( !bportal || bportal->areas[0] < 0 || bportal->areas[0] >= numPortalAreas
+				|| bportal->areas[1] < 0 || bportal->areas[1] >= numPortalAreas ) {
+			return false;
+		}
+		const idVec3 *points = (const idVec3 *)R_BProcRead( r, bportal->numPoints, sizeof( idVec3 ) );
+		if ( !points ) {
+			return false;
+		}
+
+		idWinding *w = new idWinding( bportal->numPoints );
+		w->SetNumPoints( bportal->numPoints );
+		for ( j = 0 ; j < bportal->numPoints ; j++ ) {
+			(*w)[j].ToVec3() = points[j];
+			// no texture coordinates
+			(*w)[j][3] = 0;
+			(*w)[j][4] = 0;
+		}
+
+		AddInterAreaPortal( i, bportal->areas[0], bportal->areas[1], w );
+	}
+
+	const bprocNode_t *nodes = (const bprocNode_t *)R_BProcRead( r, header->numAreaNodes, sizeof( bprocNode_t ) );
+	if ( !nodes ) {
+		return false;
+	}
+	// a positive child is a node, a negative one an area, 0 is solid
+	for ( i = 0 ; i < header->numAreaNodes ; i++ ) {
+		for ( j = 0 ; j < 2 ; j++ ) {
+			int child = nodes[i].children[j];
+			if ( child >= header->numAreaNodes || ( child < 0 && -1 - child >= numPortalAreas ) ) {
+				return false;
+			}
+		}
+	}
+	numAreaNodes = header->numAreaNodes;
+	areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
+	for ( i = 0 ; i < numAreaNodes ; i++ ) {
+		areaNodes[i].plane = nodes[i].plane;
+		areaNodes[i].children[0] = nodes[i].children[0];
+		areaNodes[i].children[1] = nodes[i].children[1];
+	}
+
+	return ( r.offset == r.size );
+}
+
+/*
+================
+idRenderWorldLocal::LoadBinaryProc
+
+Tries to build the world from the .bproc of fileName, check is the CRC
+of the .proc text. The mapping is kept until FreeWorld.
+================
+*/
+bool idRenderWorldLocal::LoadBinaryProc( const char *fileName, unsigned int check ) {
+	idStr	bprocName;
+	int		size;
+
+	bprocName = fileName;
+	bprocName.SetFileExtension( BPROC_FILE_EXT );
+
+	const byte *data = (const byte *)Sys_MapFile( fileSystem->RelativePathToOSPath( bprocName, "fs_savepath" ), &size );
+	if ( !data ) {
+		return false;
+	}
+
+	// FreeWorld unmaps it, also after a partial load
+	mappedProc = data;
+	mappedProcSize = size;
+
+	if ( !ReadBinaryProc( data, size, check ) ) {
+		common->DPrintf( "idRenderWorldLocal::LoadBinaryProc: ignoring stale or bad %s\n", bprocName.c_str() );
+		FreeWorld();
+		return false;
+	}
+
+	common->Printf( "idRenderWorldLocal::InitFromMap: loaded %s\n", bprocName.c_str() );
+	return true;
+}
+
+/*
+================
+idRenderWorldLocal::WriteBinaryProc
+
+Writes the world that was just parsed from fileName to its .bproc
+================
+*/
+void idRenderWorldLocal::WriteBinaryProc( const char *fileName, unsigned int check ) {
+	bprocHeader_t	header;
+	idStr			bprocName;
+	int				i, j;
+
+	bprocName = fileName;
+	bprocName.SetFileExtension( BPROC_FILE_EXT );
+
+	idFile *f = fileSystem->OpenFileWrite( bprocName, "fs_savepath" );
+	if ( !f ) {
+		common->Warning( "idRenderWorldLocal::WriteBinaryProc: couldn't write %s", bprocName.c_str() );
+		return;
+	}
+
+	memset( &header, 0, sizeof( header ) );
+	header.ident = BPROC_IDENT;
+	header.version = BPROC_VERSION;
+	header.check = check;
+	header.indexSize = sizeof( glIndex_t );
+	header.numModels = localModels.Num();
+	header.numPortalAreas = numPortalAreas;
+	header.numInterAreaPortals = numInterAreaPortals;
+	header.numAreaNodes = numAreaNodes;
+	R_BProcWrite( f, &header, sizeof( header ) );
+
+	for ( i = 0 ; i < localModels.Num() ; i++ ) {
+		const idRenderModel *model = localModels[i];
+		bprocModel_t bmodel;
+
+		memset( &bmodel, 0, sizeof( bmodel ) );
+		bmodel.bounds = model->Bounds();
+		bmodel.numSurfaces = model->NumSurfaces();
+		R_BProcWrite( f, &bmodel, sizeof( bmodel ) );
+		R_BProcWriteString( f, model->Name() );
+
+		for ( j = 0 ; j < model->NumSurfaces() ; j++ ) {
+			const modelSurface_t *surf = model->Surface( j );
+			srfTriangles_t *tri = surf->geometry;
+			bprocSurface_t bsurf;
+
+			// the face planes are otherwise derived later on, in the read only mapping
+			if ( !tri->shadowVertexes && !tri->facePlanesCalculated ) {
+				R_DeriveFacePlanes( tri );
+			}
+
+			memset( &bsurf, 0, sizeof( bsurf ) );
+			bsurf.bounds = tri->bounds;
+			bsurf.materialBits = R_BProcMaterialBits( surf->shader );
+			bsurf.triBits = ( tri->generateNormals ? BPROC_TRI_GENERATE_NORMALS : 0 )
+							| ( tri->tangentsCalculated ? BPROC_TRI_TANGENTS : 0 )
+							| ( tri->facePlanesCalculated ? BPROC_TRI_FACE_PLANES : 0 )
+							| ( tri->perfectHull ? BPROC_TRI_PERFECT_HULL : 0 )
+							| ( tri->verts ? BPROC_TRI_VERTS : 0 )
+							| ( tri->shadowVertexes ? BPROC_TRI_SHADOW_VERTS : 0 )
+							| ( tri->indexes ? BPROC_TRI_INDEXES : 0 )
+							| ( tri->silIndexes ? BPROC_TRI_SIL_INDEXES : 0 )
+							| ( tri->silEdges ? BPROC_TRI_SIL_EDGES : 0 )
+							| ( tri->mirroredVerts ? BPROC_TRI_MIRRORED_VERTS : 0 )
+							| ( tri->dupVerts ? BPROC_TRI_DUP_VERTS : 0 )
+							| ( tri->facePlanes ? BPROC_TRI_PLANES : 0 )
+							| ( tri->dominantTris ? BPROC_TRI_DOMINANT_TRIS : 0 );
+			bsurf.numVerts = tri->numVerts;
+			bsurf.numIndexes = tri->numIndexes;
+			bsurf.numMirroredVerts = tri->numMirroredVerts;
+			bsurf.numDupVerts = tri->numDupVerts;
+			bsurf.numSilEdges = tri->numSilEdges;
+			bsurf.numShadowIndexesNoFrontCaps = tri->numShadowIndexesNoFrontCaps;
+			bsurf.numShadowIndexesNoCaps = tri->numShadowIndexesNoCaps;
+			bsurf.shadowCapPlaneBits = tri->shadowCapPlaneBits;
+			R_BProcWrite( f, &bsurf, sizeof( bsurf ) );
+			R_BProcWriteString( f, surf->shader->GetName() );
+
+			R_BProcWriteArray( f, tri->verts, tri->numVerts );
+			R_BProcWriteArray( f, tri->shadowVertexes, tri->numVerts );
+			R_BProcWriteArray( f, tri->indexes, tri->numIndexes );
+			R_BProcWriteArray( f, tri->silIndexes, tri->numIndexes );
+			R_BProcWriteArray( f, tri->silEdges, tri->numSilEdges );
+			R_BProcWriteArray( f, tri->mirroredVerts, tri->numMirroredVerts );
+			R_BProcWriteArray( f, tri->dupVerts, tri->numDupVerts * 2 );
+			R_BProcWriteArray( f, tri->facePlanes, tri->numIndexes / 3 );
+			R_BProcWriteArray( f, tri->dominantTris, tri->numVerts );
+		}
+	}
+
+	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
+		const portal_t *p = doublePortals[i].portals[0];
+		bprocPortal_t bportal;
+
+		bportal.numPoints = p->w->GetNumPoints();
+		bportal.areas[0] = doublePortals[i].portals[1]->intoArea;
+		bportal.areas[1] = p->intoArea;
+		R_BProcWrite( f, &bportal, sizeof( bportal ) );
+
+		for ( j = 0 ; j < bportal.numPoints ; j++ ) {
+			f->Write( (*p->w)[j].ToFloatPtr(), sizeof( idVec3 ) );
+		}
+		R_BProcPad( f );
+	}
+
+	for ( i = 0 ; i < numAreaNodes ; i++ ) {
+		bprocNode_t bnode;
+
+		bnode.plane = areaNodes[i].plane;
+		bnode.children[0] = areaNodes[i].children[0];
+		bnode.children[1] = areaNodes[i].children[1];
+		f->Write( &bnode, sizeof( bnode ) );
+	}
+	R_BProcPad( f );
+
+	fileSystem->CloseFile( f );
+}
+
 /*
 ================
 idRenderWorldLocal::CommonChildrenArea_r
@@ -467,6 +1092,62 @@ void idRenderWorldLocal::FreeDefs() {
 			entityDefs[i] = NULL;
 		}
 	}
+
+	// the models of the map may go away after this
+	R_PurgeShadowCache();
+}
+
+/*
+=================
+idRenderWorldLocal::ParseProc
+
+Parses everything after the .proc id
+=================
+*/
+void idRenderWorldLocal::ParseProc( idLexer *src ) {
+	idToken			token;
+	idRenderModel *	lastModel;
+
+	// parse the file
+	while ( 1 ) {
+		if ( !src->ReadToken( &token ) ) {
+			break;
+		}
+
+		if ( token == "model" ) {
+			lastModel = ParseModel( src );
+
+			// add it to the model manager list
+			renderModelManager->AddModel( lastModel );
+
+			// save it in the list to free when clearing this map
+			localModels.Append( lastModel );
+			continue;
+		}
+
+		if ( token == "shadowModel" ) {
+			lastModel = ParseShadowModel( src );
+
+			// add it to the model manager list
+			renderModelManager->AddModel( lastModel );
+
+			// save it in the list to free when clearing this map
+			localModels.Append( lastModel );
+			continue;
+		}
+
+		if ( token == "interAreaPortals" ) {
+			ParseInterAreaPortals( src );
+			continue;
+		}
+
+		if ( token == "nodes" ) {
+			ParseNodes( src );
+			continue;
+		}
+
+		src->Error( "idRenderWorldLocal::InitFromMap: bad token \"%s\"", token.c_str() );
+	}
 }
 
 /*
@@ -481,7 +1162,6 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	idLexer *		src;
 	idToken			token;
 	idStr			filename;
-	idRenderModel *	lastModel;
 
 	// if this is an empty world, initialize manually
 	if ( !name || !name[0] ) {
@@ -515,13 +1195,17 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 	FreeWorld();
 
-	src = new idLexer( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
-	if ( !src->IsLoaded() ) {
+	// the text is always read, the .bproc is only used if it was built from the same text
+	void *buffer;
+	int length = fileSystem->ReadFile( filename, &buffer, NULL );
+	if ( length < 0 ) {
 		common->Printf( "idRenderWorldLocal::InitFromMap: %s not found\n", filename.c_str() );
 		ClearWorld();
 		return false;
 	}
+	unsigned int check = CRC32_BlockChecksum( buffer, length );
 
+	bool loaded = ( r_useBinaryProc.GetBool() && LoadBinaryProc( filename, check ) );
 
 	mapName = name;
 	mapTimeStamp = currentTimeStamp;
@@ -531,54 +1215,27 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		WriteLoadMap();
 	}
 
-	if ( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) ) {
-		common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
-		delete src;
-		return false;
-	}
+	if ( !loaded ) {
+		src = new idLexer( LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
+		src->LoadMemory( (const char *)buffer, length, filename );
 
-	// parse the file
-	while ( 1 ) {
-		if ( !src->ReadToken( &token ) ) {
-			break;
+		if ( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) ) {
+			common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
+			delete src;
+			fileSystem->FreeFile( buffer );
+			return false;
 		}
 
-		if ( token == "model" ) {
-			lastModel = ParseModel( src );
-
-			// add it to the model manager list
-			renderModelManager->AddModel( lastModel );
-
-			// save it in the list to free when clearing this map
-			localModels.Append( lastModel );
-			continue;
-		}
+		ParseProc( src );
 
-		if ( token == "shadowModel" ) {
-			lastModel = ParseShadowModel( src );
-
-			// add it to the model manager list
-			renderModelManager->AddModel( lastModel );
-
-			// save it in the list to free when clearing this map
-			localModels.Append( lastModel );
-			continue;
-		}
-
-		if ( token == "interAreaPortals" ) {
-			ParseInterAreaPortals( src );
-			continue;
-		}
+		delete src;
 
-		if ( token == "nodes" ) {
-			ParseNodes( src );
-			continue;
+		if ( r_useBinaryProc.GetBool() ) {
+			WriteBinaryProc( filename, check );
 		}
-
-		src->Error( "idRenderWorldLocal::InitFromMap: bad token \"%s\"", token.c_str() );
 	}
 
-	delete src;
+	fileSystem->FreeFile( buffer );
 
 	// if it was a trivial map without any areas, create a single area
 	if ( !numPortalAreas ) {
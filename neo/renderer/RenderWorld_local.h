@@ -70,6 +70,39 @@ typedef struct portalArea_s {
 } portalArea_t;
 
 
+// an area a view flooded into and the portal planes it was seen through
+typedef struct {
+	int				areaNum;
+	idScreenRect	rect;
+	int				firstPlane;		// in portalVisCache_t::planes
+	int				numPlanes;
+} portalVisArea_t;
+
+// Views from the same place see the same areas through the same portals,
+// so the flood of the last few views is kept and replayed by the next
+// view that matches it. Only the portal clipping is reused, the entities
+// and lights in the areas are culled again.
+const int MAX_PORTAL_VIS_CACHE = 4;
+
+typedef struct {
+	bool			valid;
+	int				lastUsedFrame;
+	int				generation;		// idRenderWorldLocal::portalVisGeneration of the flood
+
+	// everything the flood depends on besides the world
+	int				areaNum;
+	idVec3			origin;
+	int				numPlanes;
+	idPlane			planes[6];
+	idScreenRect	scissor;
+	idScreenRect	viewport;
+	float			modelViewMatrix[16];
+	float			projectionMatrix[16];
+
+	idList<portalVisArea_t>	areas;
+	idList<idPlane>			areaPlanes;
+} portalVisCache_t;
+
 static const int	CHILDREN_HAVE_MULTIPLE_AREAS = -2;
 static const int	AREANUM_SOLID = -1;
 typedef struct {
@@ -156,6 +189,9 @@ public:
 
 	idList<idRenderModel *>	localModels;
 
+	const void *			mappedProc;				// .bproc the surfaces of localModels point into
+	int						mappedProcSize;
+
 	idList<idRenderEntityLocal*>	entityDefs;
 	idList<idRenderLightLocal*>		lightDefs;
 
@@ -175,6 +211,10 @@ public:
 
 	bool					generateAllInteractionsCalled;
 
+	portalVisCache_t		portalVisCache[MAX_PORTAL_VIS_CACHE];
+	portalVisCache_t *		portalVisRecord;		// entry the current view flood is recorded into
+	int						portalVisGeneration;	// incremented when portals open, close or get fogged
+
 	//-----------------------
 	// RenderWorld_load.cpp
 
@@ -183,6 +223,11 @@ public:
 	void					SetupAreaRefs();
 	void					ParseInterAreaPortals( idLexer *src );
 	void					ParseNodes( idLexer *src );
+	void					AddInterAreaPortal( int portalNum, int a1, int a2, idWinding *w );
+	void					ParseProc( idLexer *src );
+	bool					ReadBinaryProc( const byte *data, int size, unsigned int check );
+	bool					LoadBinaryProc( const char *fileName, unsigned int check );
+	void					WriteBinaryProc( const char *fileName, unsigned int check );
 	int						CommonChildrenArea_r( areaNode_t *node );
 	void					FreeWorld();
 	void					ClearWorld();
@@ -195,10 +240,12 @@ public:
 	//--------------------------
 	// RenderWorld_portals.cpp
 
-	idScreenRect			ScreenRectFromWinding( const idWinding *w, viewEntity_t *space );
+	idScreenRect			ScreenRectFromPoints( const idVec3 *points, int numPoints, viewEntity_t *space );
 	bool					PortalIsFoggedOut( const portal_t *p );
 	void					FloodViewThroughArea_r( const idVec3 origin, int areaNum, const struct portalStack_s *ps );
 	void					FlowViewThroughPortals( const idVec3 origin, int numPlanes, const idPlane *planes );
+	portalVisCache_t *		FindPortalVisCache( const idVec3 &origin, int numPlanes, const idPlane *planes, bool &hit );
+	void					InvalidatePortalVisCache( void ) { portalVisGeneration++; }
 	void					FloodLightThroughArea_r( idRenderLightLocal *light, int areaNum, const struct portalStack_s *ps );
 	void					FlowLightThroughPortals( idRenderLightLocal *light );
 	areaNumRef_t *			FloodFrustumAreas_r( const idFrustum &frustum, const int areaNum, const idBounds &bounds, areaNumRef_t *areas );
@@ -58,16 +58,144 @@ typedef struct portalStack_s {
 	// positive side is outside the visible frustum
 } portalStack_t;
 
+// portal windings are clipped as plain points, so the distances to a
+// plane can be done for all of them at once by the SIMD processor
+typedef struct {
+	int			numPoints;
+	idVec3		points[MAX_POINTS_ON_WINDING];
+} portalWinding_t;
+
 
 //====================================================================
 
 
 /*
 ===================
-idRenderWorldLocal::ScreenRectForWinding
+R_PortalWindingFromWinding
+===================
+*/
+static void R_PortalWindingFromWinding( portalWinding_t &pw, const idWinding &w ) {
+	pw.numPoints = w.GetNumPoints();
+	for ( int i = 0; i < pw.numPoints; i++ ) {
+		pw.points[i] = w[i].ToVec3();
+	}
+}
+
+/*
+===================
+R_ClipPortalWinding
+
+Same as idWinding::ClipInPlace without texture coordinates.
+Returns false if the winding was clipped away.
+===================
+*/
+static bool R_ClipPortalWinding( portalWinding_t &w, const idPlane &plane, const float epsilon ) {
+	float		dists[MAX_POINTS_ON_WINDING+1];
+	byte		sides[MAX_POINTS_ON_WINDING+1];
+	idVec3		newPoints[MAX_POINTS_ON_WINDING];
+	int			newNumPoints;
+	int			counts[3];
+	float		dot;
+	int			i, j;
+
+	SIMDProcessor->Dot( dists, plane, w.points, w.numPoints );
+
+	counts[SIDE_FRONT] = counts[SIDE_BACK] = counts[SIDE_ON] = 0;
+	for ( i = 0; i < w.numPoints; i++ ) {
+		if ( dists[i] > epsilon ) {
+			sides[i] = SIDE_FRONT;
+		} else if ( dists[i] < -epsilon ) {
+			sides[i] = SIDE_BACK;
+		} else {
+			sides[i] = SIDE_ON;
+		}
+		counts[sides[i]]++;
+	}
+	sides[i] = sides[0];
+	dists[i] = dists[0];
+
+	// if nothing at the front of the clipping plane
+	if ( !counts[SIDE_FRONT] ) {
+		w.numPoints = 0;
+		return false;
+	}
+	// if nothing at the back of the clipping plane
+	if ( !counts[SIDE_BACK] ) {
+		return true;
+	}
+
+	newNumPoints = 0;
+	for ( i = 0; i < w.numPoints; i++ ) {
+		const idVec3 &p1 = w.points[i];
+
+		if ( newNumPoints+1 > MAX_POINTS_ON_WINDING ) {
+			return true;		// can't split -- fall back to original
+		}
+
+		if ( sides[i] == SIDE_ON ) {
+			newPoints[newNumPoints++] = p1;
+			continue;
+		}
+
+		if ( sides[i] == SIDE_FRONT ) {
+			newPoints[newNumPoints++] = p1;
+		}
+
+		if ( sides[i+1] == SIDE_ON || sides[i+1] == sides[i] ) {
+			continue;
+		}
+
+		if ( newNumPoints+1 > MAX_POINTS_ON_WINDING ) {
+			return true;		// can't split -- fall back to original
+		}
+
+		// generate a split point
+		const idVec3 &p2 = w.points[(i+1)%w.numPoints];
+		idVec3 &mid = newPoints[newNumPoints++];
+
+		dot = dists[i] / ( dists[i] - dists[i+1] );
+		for ( j = 0; j < 3; j++ ) {
+			// avoid round off error when possible
+			if ( plane.Normal()[j] == 1.0f ) {
+				mid[j] = plane.Dist();
+			} else if ( plane.Normal()[j] == -1.0f ) {
+				mid[j] = -plane.Dist();
+			} else {
+				mid[j] = p1[j] + dot * ( p2[j] - p1[j] );
+			}
+		}
+	}
+
+	w.numPoints = newNumPoints;
+	memcpy( w.points, newPoints, newNumPoints * sizeof( idVec3 ) );
+
+	return true;
+}
+
+/*
+===================
+R_ClipPortalWindingToPlanes
+
+Clips the winding to the back sides of the planes, the planes of a portal
+stack have the visible side at the back.
+===================
+*/
+static bool R_ClipPortalWindingToPlanes( portalWinding_t &w, const idPlane *planes, const int numPlanes, const float epsilon ) {
+	for ( int i = 0; i < numPlanes; i++ ) {
+		if ( !R_ClipPortalWinding( w, -planes[i], epsilon ) ) {
+			return false;
+		}
+	}
+	return w.numPoints != 0;
+}
+
+
+/*
+===================
+idRenderWorldLocal::ScreenRectFromPoints
 ===================
 */
-idScreenRect idRenderWorldLocal::ScreenRectFromWinding( const idWinding *w, viewEntity_t *space ) {
+idScreenRect idRenderWorldLocal::ScreenRectFromPoints( const idVec3 *points, int numPoints, viewEntity_t *space ) {
 	idScreenRect	r;
 	int				i;
 	idVec3			v;
@@ -75,8 +203,8 @@ idScreenRect idRenderWorldLocal::ScreenRectFromWinding( const idWinding *w, view
 	float			windowX, windowY;
 
 	r.Clear();
-	for ( i = 0 ; i < w->GetNumPoints() ; i++ ) {
-		R_LocalPointToGlobal( space->modelMatrix, (*w)[i].ToVec3(), v );
+	for ( i = 0 ; i < numPoints ; i++ ) {
+		R_LocalPointToGlobal( space->modelMatrix, points[i], v );
 		R_GlobalToNormalizedDeviceCoordinates( v, ndc );
 
 		windowX = 0.5f * ( 1.0f + ndc[0] ) * ( tr.viewDef->viewport.x2 - tr.viewDef->viewport.x1 );
@@ -161,12 +289,25 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 	int				i, j;
 	idVec3			v1, v2;
 	int				addPlanes;
-	idFixedWinding	w;		// we won't overflow because MAX_PORTAL_PLANES = 20
+	portalWinding_t	w;
 
 	area = &portalAreas[ areaNum ];
 
 	// cull models and lights to the current collection of planes
 	AddAreaRefs( areaNum, ps );
+	tr.pc.c_portalAreas++;
+
+	// remember the planes for the next view from the same place
+	if ( portalVisRecord ) {
+		portalVisArea_t &visArea = portalVisRecord->areas.Alloc();
+		visArea.areaNum = areaNum;
+		visArea.rect = ps->rect;
+		visArea.firstPlane = portalVisRecord->areaPlanes.Num();
+		visArea.numPlanes = ps->numPortalPlanes;
+		for ( i = 0; i < ps->numPortalPlanes; i++ ) {
+			portalVisRecord->areaPlanes.Append( ps->portalPlanes[i] );
+		}
+	}
 
 	if ( areaScreenRect[areaNum].IsEmpty() ) {
 		areaScreenRect[areaNum] = ps->rect;
@@ -211,16 +352,18 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 		}
 
 		// clip the portal winding to all of the planes
-		w = *p->w;
-		for ( j = 0; j < ps->numPortalPlanes; j++ ) {
-			if ( !w.ClipInPlace( -ps->portalPlanes[j], 0 ) ) {
-				break;
-			}
-		}
-		if ( !w.GetNumPoints() ) {
+		R_PortalWindingFromWinding( w, *p->w );
+		tr.pc.c_portalClips++;
+		if ( !R_ClipPortalWindingToPlanes( w, ps->portalPlanes, ps->numPortalPlanes, 0.0f ) ) {
 			continue;	// portal not visible
 		}
 
+		// the fog can change every frame, so a flood that looked at it can't be reused
+		if ( p->doublePortal->fogLight && portalVisRecord ) {
+			portalVisRecord->valid = false;
+			portalVisRecord = NULL;
+		}
+
 		// see if it is fogged out
 		if ( PortalIsFoggedOut( p ) ) {
 			continue;
@@ -232,7 +375,7 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 
 		// find the screen pixel bounding box of the remaining portal
 		// so we can scissor things outside it
-		newStack.rect = ScreenRectFromWinding( &w, &tr.identitySpace );
+		newStack.rect = ScreenRectFromPoints( w.points, w.numPoints, &tr.identitySpace );
 
 		// slop might have spread it a pixel outside, so trim it back
 		newStack.rect.Intersect( ps->rect );
@@ -240,7 +383,7 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 		// generate a set of clipping planes that will further restrict
 		// the visible view beyond just the scissor rect
 
-		addPlanes = w.GetNumPoints();
+		addPlanes = w.numPoints;
 		if ( addPlanes > MAX_PORTAL_PLANES ) {
 			addPlanes = MAX_PORTAL_PLANES;
 		}
@@ -248,12 +391,12 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 		newStack.numPortalPlanes = 0;
 		for ( i = 0; i < addPlanes; i++ ) {
 			j = i+1;
-			if ( j == w.GetNumPoints() ) {
+			if ( j == w.numPoints ) {
 				j = 0;
 			}
 
-			v1 = origin - w[i].ToVec3();
-			v2 = origin - w[j].ToVec3();
+			v1 = origin - w.points[i];
+			v2 = origin - w.points[j];
 
 			newStack.portalPlanes[newStack.numPortalPlanes].Normal().Cross( v2, v1 );
 
@@ -314,9 +457,108 @@ void idRenderWorldLocal::FlowViewThroughPortals( const idVec3 origin, int numPla
 			areaScreenRect[i].Clear();
 		}
 
+		tr.pc.c_portalViewFlows++;
+
+		bool hit;
+		portalVisCache_t *cache = FindPortalVisCache( origin, numPlanes, planes, hit );
+
+		if ( hit ) {
+			// the same view as before, only the entities and lights need to be culled again
+			tr.pc.c_portalViewCacheHits++;
+			for ( i = 0; i < cache->areas.Num(); i++ ) {
+				const portalVisArea_t &visArea = cache->areas[i];
+
+				ps.rect = visArea.rect;
+				ps.numPortalPlanes = visArea.numPlanes;
+				memcpy( ps.portalPlanes, &cache->areaPlanes[visArea.firstPlane], visArea.numPlanes * sizeof( idPlane ) );
+
+				AddAreaRefs( visArea.areaNum, &ps );
+				tr.pc.c_portalAreas++;
+
+				if ( areaScreenRect[visArea.areaNum].IsEmpty() ) {
+					areaScreenRect[visArea.areaNum] = visArea.rect;
+				} else {
+					areaScreenRect[visArea.areaNum].Union( visArea.rect );
+				}
+			}
+			return;
+		}
+
 		// flood out through portals, setting area viewCount
+		portalVisRecord = cache;
 		FloodViewThroughArea_r( origin, tr.viewDef->areaNum, &ps );
+		portalVisRecord = NULL;
+	}
+}
+
+/*
+=======================
+FindPortalVisCache
+
+Returns the cache entry of an earlier view with the same origin, planes and
+projection if the portals haven't changed since. Otherwise an entry is set
+up for the flood to record into and hit is false, NULL if caching is off.
+=======================
+*/
+portalVisCache_t *idRenderWorldLocal::FindPortalVisCache( const idVec3 &origin, int numPlanes, const idPlane *planes, bool &hit ) {
+	portalVisCache_t	*cache, *oldest;
+	int					i;
+
+	hit = false;
+
+	if ( !r_usePortalCache.GetBool() || numPlanes > 6 ) {
+		return NULL;
+	}
+
+	oldest = &portalVisCache[0];
+	for ( i = 0; i < MAX_PORTAL_VIS_CACHE; i++ ) {
+		cache = &portalVisCache[i];
+		if ( !cache->valid || cache->generation != portalVisGeneration ) {
+			cache->valid = false;
+			if ( oldest->valid ) {
+				oldest = cache;
+			}
+			continue;
+		}
+		if ( oldest->valid && cache->lastUsedFrame < oldest->lastUsedFrame ) {
+			oldest = cache;
+		}
+		if ( cache->areaNum != tr.viewDef->areaNum || cache->numPlanes != numPlanes || cache->origin != origin ) {
+			continue;
+		}
+		if ( memcmp( cache->planes, planes, numPlanes * sizeof( idPlane ) ) != 0 ) {
+			continue;
+		}
+		if ( !cache->scissor.Equals( tr.viewDef->scissor ) || !cache->viewport.Equals( tr.viewDef->viewport ) ) {
+			continue;
+		}
+		if ( memcmp( cache->modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( cache->modelViewMatrix ) ) != 0 ||
+			memcmp( cache->projectionMatrix, tr.viewDef->projectionMatrix, sizeof( cache->projectionMatrix ) ) != 0 ) {
+			continue;
+		}
+		cache->lastUsedFrame = tr.frameCount;
+		hit = true;
+		return cache;
 	}
+
+	// set up the least recently used entry for the flood, it only
+	// becomes valid if nothing during the flood made it uncacheable
+	cache = oldest;
+	cache->valid = true;
+	cache->lastUsedFrame = tr.frameCount;
+	cache->generation = portalVisGeneration;
+	cache->areaNum = tr.viewDef->areaNum;
+	cache->origin = origin;
+	cache->numPlanes = numPlanes;
+	memcpy( cache->planes, planes, numPlanes * sizeof( idPlane ) );
+	cache->scissor = tr.viewDef->scissor;
+	cache->viewport = tr.viewDef->viewport;
+	memcpy( cache->modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( cache->modelViewMatrix ) );
+	memcpy( cache->projectionMatrix, tr.viewDef->projectionMatrix, sizeof( cache->projectionMatrix ) );
+	cache->areas.SetNum( 0, false );
+	cache->areaPlanes.SetNum( 0, false );
+
+	return cache;
 }
 
 //==================================================================================================
@@ -337,12 +579,13 @@ void idRenderWorldLocal::FloodLightThroughArea_r( idRenderLightLocal *light, int
 	int				i, j;
 	idVec3			v1, v2;
 	int				addPlanes;
-	idFixedWinding	w;		// we won't overflow because MAX_PORTAL_PLANES = 20
+	portalWinding_t	w;
 
 	area = &portalAreas[ areaNum ];
 
 	// add an areaRef
 	AddLightRefToArea( light, area );
+	light->flowCacheAreas.Append( areaNum );
 
 	// go through all the portals
 	for ( p = area->portals; p; p = p->next ) {
@@ -376,23 +619,14 @@ void idRenderWorldLocal::FloodLightThroughArea_r( idRenderLightLocal *light, int
 		}
 
 		// clip the portal winding to all of the planes
-		w = *p->w;
-		for ( j = 0; j < ps->numPortalPlanes; j++ ) {
-			if ( !w.ClipInPlace( -ps->portalPlanes[j], 0 ) ) {
-				break;
-			}
-		}
-		if ( !w.GetNumPoints() ) {
+		R_PortalWindingFromWinding( w, *p->w );
+		tr.pc.c_portalClips++;
+		if ( !R_ClipPortalWindingToPlanes( w, ps->portalPlanes, ps->numPortalPlanes, 0.0f ) ) {
 			continue;	// portal not visible
 		}
 		// also always clip to the original light planes, because they aren't
 		// necessarily extending to infinitiy like a view frustum
-		for ( j = 0; j < firstPortalStack->numPortalPlanes; j++ ) {
-			if ( !w.ClipInPlace( -firstPortalStack->portalPlanes[j], 0 ) ) {
-				break;
-			}
-		}
-		if ( !w.GetNumPoints() ) {
+		if ( !R_ClipPortalWindingToPlanes( w, firstPortalStack->portalPlanes, firstPortalStack->numPortalPlanes, 0.0f ) ) {
 			continue;	// portal not visible
 		}
 
@@ -403,7 +637,7 @@ void idRenderWorldLocal::FloodLightThroughArea_r( idRenderLightLocal *light, int
 		// generate a set of clipping planes that will further restrict
 		// the visible view beyond just the scissor rect
 
-		addPlanes = w.GetNumPoints();
+		addPlanes = w.numPoints;
 		if ( addPlanes > MAX_PORTAL_PLANES ) {
 			addPlanes = MAX_PORTAL_PLANES;
 		}
@@ -411,12 +645,12 @@ void idRenderWorldLocal::FloodLightThroughArea_r( idRenderLightLocal *light, int
 		newStack.numPortalPlanes = 0;
 		for ( i = 0; i < addPlanes; i++ ) {
 			j = i+1;
-			if ( j == w.GetNumPoints() ) {
+			if ( j == w.numPoints ) {
 				j = 0;
 			}
 
-			v1 = light->globalLightOrigin - w[i].ToVec3();
-			v2 = light->globalLightOrigin - w[j].ToVec3();
+			v1 = light->globalLightOrigin - w.points[i];
+			v2 = light->globalLightOrigin - w.points[j];
 
 			newStack.portalPlanes[newStack.numPortalPlanes].Normal().Cross( v2, v1 );
 
@@ -441,6 +675,9 @@ FlowLightThroughPortals
 Adds an arearef in each area that the light center flows into.
 This can only be used for shadow casting lights that have a generated
 prelight, because shadows are cast from back side which may not be in visible areas.
+
+The flow doesn't depend on the portal states, so if the light origin and
+frustum are the same as the last time, the areas it went into are reused.
 =======================
 */
 void idRenderWorldLocal::FlowLightThroughPortals( idRenderLightLocal *light ) {
@@ -453,6 +690,17 @@ void idRenderWorldLocal::FlowLightThroughPortals( idRenderLightLocal *light ) {
 		return;
 	}
 
+	tr.pc.c_portalLightFlows++;
+
+	if ( r_usePortalCache.GetBool() && light->flowCacheValid && light->flowCacheOrigin == light->globalLightOrigin
+			&& memcmp( light->flowCacheFrustum, light->frustum, sizeof( light->frustum ) ) == 0 ) {
+		tr.pc.c_portalLightCacheHits++;
+		for ( i = 0; i < light->flowCacheAreas.Num(); i++ ) {
+			AddLightRefToArea( light, &portalAreas[ light->flowCacheAreas[i] ] );
+		}
+		return;
+	}
+
 	memset( &ps, 0, sizeof( ps ) );
 
 	ps.numPortalPlanes = 6;
@@ -460,7 +708,13 @@ void idRenderWorldLocal::FlowLightThroughPortals( idRenderLightLocal *light ) {
 		ps.portalPlanes[i] = light->frustum[i];
 	}
 
+	light->flowCacheAreas.SetNum( 0, false );
+
 	FloodLightThroughArea_r( light, light->areaNum, &ps );
+
+	light->flowCacheValid = true;
+	light->flowCacheOrigin = light->globalLightOrigin;
+	memcpy( light->flowCacheFrustum, light->frustum, sizeof( light->frustum ) );
 }
 
 //======================================================================================================
@@ -647,7 +901,7 @@ bool idRenderWorldLocal::CullLightByPortals( const idRenderLightLocal *light, co
 	int				i, j;
 	const srfTriangles_t	*tri;
 	float			d;
-	idFixedWinding	w;		// we won't overflow because MAX_PORTAL_PLANES = 20
+	portalWinding_t	w;
 
 	if ( r_useLightCulling.GetInteger() == 0 ) {
 		return false;
@@ -672,16 +926,10 @@ bool idRenderWorldLocal::CullLightByPortals( const idRenderLightLocal *light, co
 				continue;
 			}
 
-			w = *ow;
+			R_PortalWindingFromWinding( w, *ow );
 
 			// now check the winding against each of the portalStack planes
-			for ( j = 0; j < ps->numPortalPlanes - 1; j++ ) {
-				if ( !w.ClipInPlace( -ps->portalPlanes[j] ) ) {
-					break;
-				}
-			}
-
-			if ( w.GetNumPoints() ) {
+			if ( R_ClipPortalWindingToPlanes( w, ps->portalPlanes, ps->numPortalPlanes - 1, ON_EPSILON ) ) {
 				// part of the winding is visible through the portalStack,
 				// so the light is not culled
 				return false;
@@ -1004,6 +1252,9 @@ void		idRenderWorldLocal::SetPortalState( qhandle_t portal, int blockTypes ) {
 	}
 	doublePortals[portal-1].blockingBits = blockTypes;
 
+	// views through this portal see something else now
+	InvalidatePortalVisCache();
+
 	// leave the connectedAreaGroup the same on one side,
 	// then flood fill from the other side with a new number for each changed attribute
 	for ( int i = 0 ; i < NUM_PORTAL_ATTRIBUTES ; i++ ) {
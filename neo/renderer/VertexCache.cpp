@@ -270,6 +270,9 @@ void idVertexCache::Init() {
 
 	vboMax = 0;
 
+	listNum = 0;
+	tempFrameNum = 1;
+
 	// Allocate the temporary buffers (number of temporary buffers is NUM_VERTEX_FRAMES)
 	for (int i = 0; i < NUM_VERTEX_FRAMES; i++) {
 		tempBuffers[i] = CreateTempVbo(frameBytes, false);
@@ -490,7 +493,9 @@ void idVertexCache::Touch(vertCache_t* block) {
 		common->FatalError("idVertexCache Touch: freed pointer");
 	}
 	if (block->tag == TAG_TEMP) {
-		common->FatalError("idVertexCache Touch: temporary pointer");
+		// frame temps live until the end of the frame anyway, there is
+		// nothing to keep from being purged
+		return;
 	}
 
 	block->frameUsed = currentFrame;
@@ -556,28 +561,56 @@ there may still be future references to dynamically created surfaces.
 */
 vertCache_t* idVertexCache::AllocFrameTemp(void* data, int size, bool indexBuffer) {
 	vertCache_t* block;
+	void* memory;
 
 	if (size <= 0) {
 		common->Error("idVertexCache::AllocFrameTemp: size = %i\n", size);
 	}
 
+	block = AllocFrameTempMemory(size, indexBuffer, &memory);
+	if (!block) {
+		// if we don't have enough room in the temp block, allocate a static block,
+		// but immediately free it so it will get freed at the next frame
+		Alloc(data, size, &block, indexBuffer);
+		Free(block);
+		return block;
+	}
+
+	// copy the data
+	memcpy(memory, data, size);
+
+	return block;
+}
+
+/*
+===========
+idVertexCache::AllocFrameTempMemory
+
+Reserves frame temp space without filling it, the caller writes the data
+to the returned memory before the frame is handed to the back end. This
+lets the data be built in place, possibly on another thread.
+
+Returns NULL if there is no room left in the temp block this frame.
+===========
+*/
+vertCache_t* idVertexCache::AllocFrameTempMemory(int size, bool indexBuffer, void** memory) {
+	vertCache_t* block;
+
+	if (size <= 0) {
+		common->Error("idVertexCache::AllocFrameTempMemory: size = %i\n", size);
+	}
+
+	*memory = NULL;
+
 	if (indexBuffer) {
 		if (dynamicAllocThisFrame_Index[listNum] + size > frameBytes) {
-			// if we don't have enough room in the temp block, allocate a static block,
-			// but immediately free it so it will get freed at the next frame
 			tempOverflow = true;
-			Alloc(data, size, &block, indexBuffer);
-			Free(block);
-			return block;
+			return NULL;
 		}
 	} else {
 		if (dynamicAllocThisFrame[listNum] + size > frameBytes) {
-			// if we don't have enough room in the temp block, allocate a static block,
-			// but immediately free it so it will get freed at the next frame
 			tempOverflow = true;
-			Alloc(data, size, &block, indexBuffer);
-			Free(block);
-			return block;
+			return NULL;
 		}
 	}
 
@@ -655,17 +688,14 @@ vertCache_t* idVertexCache::AllocFrameTemp(void* data, int size, bool indexBuffe
 	block->user = NULL;
 	block->frameUsed = 0;
 
-	// copy the data
 	if (indexBuffer) {
 		block->vbo = tempIndexBuffers[listNum]->vbo;
-        memcpy( (char*)tempIndexBuffers[listNum]->frontEndMemory + block->offset, data, size);
-        block->frontEndMemory = tempIndexBuffers[listNum]->frontEndMemory;
-    } else {
-    	block->vbo = tempBuffers[listNum]->vbo;
-        memcpy( (char*)tempBuffers[listNum]->frontEndMemory + block->offset, data, size);
-        block->frontEndMemory = tempBuffers[listNum]->frontEndMemory;
+		block->frontEndMemory = tempIndexBuffers[listNum]->frontEndMemory;
+	} else {
+		block->vbo = tempBuffers[listNum]->vbo;
+		block->frontEndMemory = tempBuffers[listNum]->frontEndMemory;
 	}
-
+	*memory = (char*)block->frontEndMemory + block->offset;
 
 	return block;
 }
@@ -768,7 +798,10 @@ void idVertexCache::EndFrame() {
 
 	currentFrame = tr.frameCount;
 
-	listNum = currentFrame % NUM_VERTEX_FRAMES;
+	// step once per submitted frame, in lock step with the frame data ring.
+	// tr.frameCount doesn't move for screenshot and capture submissions
+	listNum = ( listNum + 1 ) % NUM_VERTEX_FRAMES;
+	tempFrameNum++;
 
 	staticAllocThisFrame = 0;
 	staticCountThisFrame = 0;
@@ -823,6 +856,16 @@ int idVertexCache::GetListNum()
 	return listNum;
 }
 
+/*
+=============
+idVertexCache::GetTempFrameNum
+=============
+*/
+int idVertexCache::GetTempFrameNum()
+{
+	return tempFrameNum;
+}
+
 /*
 =============
 idVertexCache::List
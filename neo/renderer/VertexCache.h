@@ -31,7 +31,8 @@ If you have questions concerning this license or the applicable additional terms
 
 // vertex cache calls should only be made by the front end
 
-const int NUM_VERTEX_FRAMES = 2;
+// one temp list per frameData_t in the ring, must match NUM_FRAME_DATA
+const int NUM_VERTEX_FRAMES = 3;
 
 typedef enum {
 	TAG_FREE,
@@ -85,8 +86,14 @@ public:
 	// As with Position(), this may not actually be a pointer you can access.
 	vertCache_t *AllocFrameTemp(void *data, int bytes, bool indexBuffer);
 
+	// like AllocFrameTemp, but leaves the space for the caller to fill
+	// through *memory before the frame is finished.
+	// will return NULL if there is no room left in the temp buffer, there
+	// is no static fallback since nothing has been copied yet
+	vertCache_t *AllocFrameTempMemory(int bytes, bool indexBuffer, void **memory);
+
 	// notes that a buffer is used this frame, so it can't be purged
-	// out from under the GPU
+	// out from under the GPU, frame temps are ignored
 	void Touch(vertCache_t *buffer);
 
 	// this block won't have to zero a buffer pointer when it is purged,
@@ -105,6 +112,10 @@ public:
 	void UnbindVertex();
 
 	int GetListNum();
+
+	// counts the submitted frames, a frame temp allocation is only valid
+	// while this is the same as when it was made
+	int GetTempFrameNum();
 	// listVertexCache calls this
 	void List();
 
@@ -132,6 +143,7 @@ private:
 
 	int currentFrame;      // for purgable block tracking
 	int listNum;        // currentFrame % NUM_VERTEX_FRAMES, determines which tempBuffers to use
+	int tempFrameNum;   // steps with listNum, starts at 1 so 0 can mean no temp allocation
 
 	int staticAllocMaximum;
 	int dynamicAllocMaximum;
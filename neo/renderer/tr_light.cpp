@@ -58,8 +58,15 @@ bool R_CreateAmbientCache(srfTriangles_t* tri, bool needsLighting) {
 		common->Error("R_CreateAmbientCache: Tri have no vertices\n");
 		return false;
 	}
+
+	// a frame temp cache from an earlier frame has already been reused, build a new one
+	if ( tri->ambientCacheFrame && tri->ambientCacheFrame != vertexCache.GetTempFrameNum() ) {
+		tri->ambientCache = NULL;
+		tri->ambientCacheFrame = 0;
+	}
+
 	// If there is no ambient cache, let's compute it
-	else if ( !tri->ambientCache ) {
+	if ( !tri->ambientCache ) {
 		// we are going to use it for drawing, so make sure we have the tangents and normals
 		if ( needsLighting && !tri->tangentsCalculated ) {
 			R_DeriveTangents(tri);
@@ -661,11 +668,15 @@ R_CalcLightScissorRectangle
 
 The light screen bounds will be used to crop the scissor rect during
 stencil clears and interaction drawing
+
+Only reads the light and the view, so it can be run from a worker thread.
+nearClipped is set when c_clippedLight should count the light, cleared
+when c_unclippedLight should, and left alone otherwise
 ==================
 */
 int	c_clippedLight, c_unclippedLight;
 
-idScreenRect	R_CalcLightScissorRectangle( viewLight_t *vLight ) {
+static idScreenRect	R_CalcLightScissorRectangle( viewLight_t *vLight, int &nearClipped ) {
 	idScreenRect	r;
 	srfTriangles_t *tri;
 	idPlane			eye, clip;
@@ -691,7 +702,7 @@ idScreenRect	R_CalcLightScissorRectangle( viewLight_t *vLight ) {
 
 		// if it is near clipped, clip the winding polygons to the view frustum
 		if ( clip[3] <= 1 ) {
-			c_clippedLight++;
+			nearClipped = 1;
 			if ( r_useClippedLightScissors.GetInteger() ) {
 				return R_ClippedLightScissorRectangle( vLight );
 			} else {
@@ -724,11 +735,28 @@ idScreenRect	R_CalcLightScissorRectangle( viewLight_t *vLight ) {
 	// add the fudge boundary
 	r.Expand();
 
-	c_unclippedLight++;
+	nearClipped = 0;
 
 	return r;
 }
 
+/*
+=================
+R_CalcLightScissorJob
+=================
+*/
+typedef struct {
+	viewLight_t *		vLight;
+	idScreenRect		scissorRect;
+	int					nearClipped;	// -1 if not counted
+} lightScissorJob_t;
+
+static void R_CalcLightScissorJob( void *data, int index ) {
+	lightScissorJob_t *job = &( (lightScissorJob_t *)data )[index];
+	job->nearClipped = -1;
+	job->scissorRect = R_CalcLightScissorRectangle( job->vLight, job->nearClipped );
+}
+
 /*
 =================
 R_AddLightSurfaces
@@ -751,10 +779,27 @@ void R_AddLightSurfaces( void ) {
 	viewLight_t		*vLight;
 	idRenderLightLocal *light;
 	viewLight_t		**ptr;
+	lightScissorJob_t *scissorJobs = NULL;
+	int				numLights = 0;
+	int				lightNum;
+
+	// the light scissor rects only depend on the light and the view, so calculate them
+	// all up front where they can be spread over the worker threads
+	if ( r_useLightScissors.GetBool() ) {
+		for ( vLight = tr.viewDef->viewLights; vLight; vLight = vLight->next ) {
+			numLights++;
+		}
+		scissorJobs = (lightScissorJob_t *)R_FrameAlloc( numLights * sizeof( scissorJobs[0] ) );
+		numLights = 0;
+		for ( vLight = tr.viewDef->viewLights; vLight; vLight = vLight->next ) {
+			scissorJobs[numLights++].vLight = vLight;
+		}
+		R_ParallelFor( R_CalcLightScissorJob, scissorJobs, numLights, "lightScissors" );
+	}
 
 	// go through each visible light, possibly removing some from the list
 	ptr = &tr.viewDef->viewLights;
-	while ( *ptr ) {
+	for ( lightNum = 0; *ptr; lightNum++ ) {
 		vLight = *ptr;
 		light = vLight->lightDef;
 
@@ -832,12 +877,19 @@ void R_AddLightSurfaces( void ) {
 			}
 		}
 
-		if ( r_useLightScissors.GetBool() ) {
-			// calculate the screen area covered by the light frustum
+		if ( scissorJobs ) {
+			// the screen area covered by the light frustum
 			// which will be used to crop the stencil cull
-			idScreenRect scissorRect = R_CalcLightScissorRectangle( vLight );
+			assert( scissorJobs[lightNum].vLight == vLight );
 			// intersect with the portal crossing scissor rectangle
-			vLight->scissorRect.Intersect( scissorRect );
+			vLight->scissorRect.Intersect( scissorJobs[lightNum].scissorRect );
+
+			// the counters are kept here, the jobs can't share them
+			if ( scissorJobs[lightNum].nearClipped == 1 ) {
+				c_clippedLight++;
+			} else if ( scissorJobs[lightNum].nearClipped == 0 ) {
+				c_unclippedLight++;
+			}
 
 			if ( r_showLightScissors.GetBool() ) {
 				R_ShowColoredScreenRect( vLight->scissorRect, light->index );
@@ -967,6 +1019,94 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 	return update;
 }
 
+static bool							skinningBatch;
+static idList<idRenderEntityLocal *>	skinningBatchDefs;
+
+/*
+===================
+R_BeginSkinningBatch
+===================
+*/
+void R_BeginSkinningBatch( void ) {
+	assert( !skinningBatch );
+	skinningBatch = true;
+}
+
+/*
+===================
+R_SkinningBatchOpen
+===================
+*/
+bool R_SkinningBatchOpen( void ) {
+	return skinningBatch;
+}
+
+/*
+===================
+R_FinishEntityDefDynamicModel
+
+Adds the overlays once the dynamic model has its vertexes
+===================
+*/
+static void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( !def->cachedDynamicModel ) {
+		return;
+	}
+
+	// add any overlays to the snapshot of the dynamic model
+	if ( def->overlay && !r_skipOverlays.GetBool() ) {
+		def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+	} else {
+		idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+	}
+
+	if ( r_checkBounds.GetBool() ) {
+		idBounds b = def->cachedDynamicModel->Bounds();
+		if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+				b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+				b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+				b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+				b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+				b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+			common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+		}
+	}
+}
+
+/*
+===================
+R_FlushSkinningBatch
+
+Skins everything queued so far and finishes the entities that were
+waiting for it.  This is also done early if anything needs one of the
+pending models before the batch would normally be flushed.
+===================
+*/
+void R_FlushSkinningBatch( void ) {
+	if ( !skinningBatch ) {
+		return;
+	}
+
+	R_RunMD5SkinJobs();
+
+	for ( int i = 0; i < skinningBatchDefs.Num(); i++ ) {
+		idRenderEntityLocal *def = skinningBatchDefs[i];
+		def->dynamicModelPending = false;
+		R_FinishEntityDefDynamicModel( def );
+	}
+	skinningBatchDefs.SetNum( 0, false );
+}
+
+/*
+===================
+R_EndSkinningBatch
+===================
+*/
+void R_EndSkinningBatch( void ) {
+	R_FlushSkinningBatch();
+	skinningBatch = false;
+}
+
 /*
 ===================
 R_EntityDefDynamicModel
@@ -980,6 +1120,11 @@ it and any necessary overlays
 idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	bool callbackUpdate;
 
+	// something other than the batch wants the model
+	if ( def->dynamicModelPending ) {
+		R_FlushSkinningBatch();
+	}
+
 	// allow deferred entities to construct themselves
 	if ( def->parms.callback ) {
 		callbackUpdate = R_IssueEntityDefCallback( def );
@@ -1010,26 +1155,12 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
 		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
 
-		if ( def->cachedDynamicModel ) {
-
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
-
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
-			}
+		if ( skinningBatch && def->cachedDynamicModel ) {
+			// the vertexes aren't there yet
+			def->dynamicModelPending = true;
+			skinningBatchDefs.Append( def );
+		} else {
+			R_FinishEntityDefDynamicModel( def );
 		}
 
 		def->dynamicModel = def->cachedDynamicModel;
@@ -1339,6 +1470,42 @@ idScreenRect R_CalcEntityScissorRectangle( viewEntity_t *vEntity ) {
 	return R_ScreenRectFromViewFrustumBounds( bounds );
 }
 
+/*
+===================
+R_CalcEntityScissorJob
+===================
+*/
+static void R_CalcEntityScissorJob( void *data, int index ) {
+	viewEntity_t *vEntity = ( (viewEntity_t **)data )[index];
+
+	// calculate the screen area covered by the entity
+	// intersect with the portal crossing scissor rectangle
+	vEntity->scissorRect.Intersect( R_CalcEntityScissorRectangle( vEntity ) );
+}
+
+/*
+===================
+R_PrepareInteractionsJob
+
+Does the view frustum culling of all the active interactions of an entity.
+Each interaction belongs to a single entity, so entities can be prepared in parallel.
+===================
+*/
+static void R_PrepareInteractionsJob( void *data, int index ) {
+	viewEntity_t *vEntity = ( (viewEntity_t **)data )[index];
+
+	if ( !vEntity ) {
+		return;
+	}
+
+	for ( idInteraction *inter = vEntity->entityDef->firstInteraction; inter != NULL && !inter->IsEmpty(); inter = inter->entityNext ) {
+		if ( inter->lightDef->viewCount != tr.viewCount ) {
+			continue;
+		}
+		inter->PrepareForView( tr.viewDef->viewFrustum );
+	}
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1348,111 +1515,225 @@ interactions get created.  This is all done on a sort-by-model basis
 to keep source data in cache (most likely L2) as any interactions and
 shadows are generated, since dynamic models will typically be lit by
 two or more lights.
+
+The entities are walked twice, first to add the ambient surfaces and then
+to add the interactions, with the pure culling math done in parallel in
+between.  Everything that allocates or links surfaces is still done in
+viewEntity order, so the output is the same with or without worker threads.
+There are no per-thread frame allocators: R_FrameAlloc is a plain bump
+pointer, the vertex cache keeps a single LRU, tr.sortOffset decides the
+draw order of equal sort surfaces, and R_AddDrawSurf evaluates registers
+that can query sound emitters, so moving those into jobs would need a
+merge step that reproduces the serial order exactly.
+
+With r_parallelSkinning, the MD5 models of the visible entities are all
+instantiated first and skinned together, and the ambient surfaces are
+added after that.
+
+With r_parallelShadows, the shadow volumes that have to be built for the
+interactions are built together, and the shadow surfaces of those
+interactions are linked after that.
 ===================
 */
 void R_AddModelSurfaces( void ) {
 	viewEntity_t		*vEntity;
 	idInteraction		*inter, *next;
 	idRenderModel		*model;
+	viewEntity_t		**entities;
+	viewEntity_t		**prepare;
+	viewEntity_t		**ambient;
+	viewEntity_t		*lastEntity;
+	int					numEntities, i;
+	bool				batchSkinning;
+	bool				batchShadows;
 
 	// clear the ambient surface list
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
-	// go through each entity that is either visible to the view, or to
-	// any light that intersects the view (for shadows)
+	numEntities = 0;
 	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		numEntities++;
+	}
+	if ( !numEntities ) {
+		return;
+	}
 
-		if ( r_useEntityScissors.GetBool() ) {
-			// calculate the screen area covered by the entity
-			idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
-			// intersect with the portal crossing scissor rectangle
-			vEntity->scissorRect.Intersect( scissorRect );
+	// entities[i] is cleared if the entity won't add interactions,
+	// prepare[i] is cleared if the interactions can't be culled ahead of time
+	entities = (viewEntity_t **)R_FrameAlloc( numEntities * sizeof( entities[0] ) );
+	prepare = (viewEntity_t **)R_FrameAlloc( numEntities * sizeof( prepare[0] ) );
+	ambient = (viewEntity_t **)R_ClearedFrameAlloc( numEntities * sizeof( ambient[0] ) );
 
-			if ( r_showEntityScissors.GetBool() ) {
-				R_ShowColoredScreenRect( vEntity->scissorRect, vEntity->entityDef->index );
-			}
-		}
+	numEntities = 0;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		entities[numEntities++] = vEntity;
+	}
+	lastEntity = entities[numEntities - 1];
 
-		float oldFloatTime = 0.0f;
-		int oldTime = 0;
+	if ( r_useEntityScissors.GetBool() ) {
+		R_ParallelFor( R_CalcEntityScissorJob, entities, numEntities, "entityScissors" );
+	}
 
-		game->SelectTimeGroup( vEntity->entityDef->parms.timeGroup );
+	batchSkinning = r_parallelSkinning.GetBool();
+	if ( batchSkinning ) {
+		R_BeginSkinningBatch();
+	}
 
-		if ( vEntity->entityDef->parms.timeGroup ) {
-			oldFloatTime = tr.viewDef->floatTime;
-			oldTime = tr.viewDef->renderView.time;
+	// go through each entity that is either visible to the view, or to
+	// any light that intersects the view (for shadows)
+	for ( i = 0; i < numEntities; i++ ) {
+		vEntity = entities[i];
+		prepare[i] = vEntity;
 
-			tr.viewDef->floatTime = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup ) * 0.001;
-			tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
+		if ( r_useEntityScissors.GetBool() && r_showEntityScissors.GetBool() ) {
+			R_ShowColoredScreenRect( vEntity->scissorRect, vEntity->entityDef->index );
 		}
 
+		game->SelectTimeGroup( vEntity->entityDef->parms.timeGroup );
+
 		if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 1 ) {
-			if ( vEntity->entityDef->parms.timeGroup ) {
-				tr.viewDef->floatTime = oldFloatTime;
-				tr.viewDef->renderView.time = oldTime;
-			}
+			entities[i] = prepare[i] = NULL;
 			continue;
 		} else if ( !tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 2 ) {
-			if ( vEntity->entityDef->parms.timeGroup ) {
-				tr.viewDef->floatTime = oldFloatTime;
-				tr.viewDef->renderView.time = oldTime;
-			}
+			entities[i] = prepare[i] = NULL;
 			continue;
 		}
 
+		// in xray subviews only the xray entities get their interactions
+		if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex != 2 ) {
+			prepare[i] = NULL;
+		}
+
 		// add the ambient surface if it has a visible rectangle
 		if ( !vEntity->scissorRect.IsEmpty() ) {
+			float oldFloatTime = 0.0f;
+			int oldTime = 0;
+
+			if ( vEntity->entityDef->parms.timeGroup ) {
+				oldFloatTime = tr.viewDef->floatTime;
+				oldTime = tr.viewDef->renderView.time;
+
+				tr.viewDef->floatTime = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup ) * 0.001;
+				tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
+			}
+
 			model = R_EntityDefDynamicModel( vEntity->entityDef );
 			if ( model == NULL || model->NumSurfaces() <= 0 ) {
-				if ( vEntity->entityDef->parms.timeGroup ) {
-					tr.viewDef->floatTime = oldFloatTime;
-					tr.viewDef->renderView.time = oldTime;
+				entities[i] = prepare[i] = NULL;
+			} else {
+				ambient[i] = vEntity;
+				if ( !batchSkinning ) {
+					R_AddAmbientDrawsurfs( vEntity );
 				}
-				continue;
+				tr.pc.c_visibleViewEntities++;
 			}
 
-			R_AddAmbientDrawsurfs( vEntity );
-			tr.pc.c_visibleViewEntities++;
+			if ( vEntity->entityDef->parms.timeGroup ) {
+				tr.viewDef->floatTime = oldFloatTime;
+				tr.viewDef->renderView.time = oldTime;
+			}
 		} else {
 			tr.pc.c_shadowViewEntities++;
+
+			// the deferred entity callback of a shadow-only entity is only issued
+			// while adding its interactions, so they can't be culled before that
+			if ( vEntity->entityDef->parms.callback ) {
+				prepare[i] = NULL;
+			}
 		}
+	}
 
-		//
-		// for all the entity / light interactions on this entity, add them to the view
-		//
-		if ( tr.viewDef->isXraySubview ) {
-			if ( vEntity->entityDef->parms.xrayIndex == 2 ) {
-				for ( inter = vEntity->entityDef->firstInteraction; inter != NULL && !inter->IsEmpty(); inter = next ) {
-					next = inter->entityNext;
-					if ( inter->lightDef->viewCount != tr.viewCount ) {
-						continue;
-					}
-					inter->AddActiveInteraction();
-				}
+	if ( batchSkinning ) {
+		R_EndSkinningBatch();
+
+		for ( i = 0; i < numEntities; i++ ) {
+			vEntity = ambient[i];
+			if ( !vEntity ) {
+				continue;
 			}
-		} else {
-			// all empty interactions are at the end of the list so once the
-			// first is encountered all the remaining interactions are empty
-			for ( inter = vEntity->entityDef->firstInteraction; inter != NULL && !inter->IsEmpty(); inter = next ) {
-				next = inter->entityNext;
-
-				// skip any lights that aren't currently visible
-				// this is run after any lights that are turned off have already
-				// been removed from the viewLights list, and had their viewCount cleared
-				if ( inter->lightDef->viewCount != tr.viewCount ) {
-					continue;
-				}
-				inter->AddActiveInteraction();
+
+			float oldFloatTime = 0.0f;
+			int oldTime = 0;
+
+			game->SelectTimeGroup( vEntity->entityDef->parms.timeGroup );
+
+			if ( vEntity->entityDef->parms.timeGroup ) {
+				oldFloatTime = tr.viewDef->floatTime;
+				oldTime = tr.viewDef->renderView.time;
+
+				tr.viewDef->floatTime = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup ) * 0.001;
+				tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
+			}
+
+			R_AddAmbientDrawsurfs( vEntity );
+
+			if ( vEntity->entityDef->parms.timeGroup ) {
+				tr.viewDef->floatTime = oldFloatTime;
+				tr.viewDef->renderView.time = oldTime;
+			}
+		}
+	}
+
+	R_ParallelFor( R_PrepareInteractionsJob, prepare, numEntities, "prepareInteractions" );
+
+	batchShadows = r_parallelShadows.GetBool();
+	if ( batchShadows ) {
+		R_BeginShadowBatch();
+	}
+
+	//
+	// for all the entity / light interactions, add them to the view
+	//
+	for ( i = 0; i < numEntities; i++ ) {
+		vEntity = entities[i];
+		if ( !vEntity ) {
+			continue;
+		}
+
+		if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex != 2 ) {
+			continue;
+		}
+
+		float oldFloatTime = 0.0f;
+		int oldTime = 0;
+
+		game->SelectTimeGroup( vEntity->entityDef->parms.timeGroup );
+
+		if ( vEntity->entityDef->parms.timeGroup ) {
+			oldFloatTime = tr.viewDef->floatTime;
+			oldTime = tr.viewDef->renderView.time;
+
+			tr.viewDef->floatTime = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup ) * 0.001;
+			tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
+		}
+
+		// all empty interactions are at the end of the list so once the
+		// first is encountered all the remaining interactions are empty
+		for ( inter = vEntity->entityDef->firstInteraction; inter != NULL && !inter->IsEmpty(); inter = next ) {
+			next = inter->entityNext;
+
+			// skip any lights that aren't currently visible
+			// this is run after any lights that are turned off have already
+			// been removed from the viewLights list, and had their viewCount cleared
+			if ( inter->lightDef->viewCount != tr.viewCount ) {
+				continue;
 			}
+			inter->AddActiveInteraction();
 		}
 
 		if ( vEntity->entityDef->parms.timeGroup ) {
 			tr.viewDef->floatTime = oldFloatTime;
 			tr.viewDef->renderView.time = oldTime;
 		}
+	}
 
+	if ( batchShadows ) {
+		R_EndShadowBatch();
 	}
+
+	// leave the game with the time group of the last entity selected, as a single pass would
+	game->SelectTimeGroup( lastEntity->entityDef->parms.timeGroup );
 }
 
 /*
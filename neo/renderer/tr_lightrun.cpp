@@ -583,6 +583,7 @@ void R_CreateLightDefFogPortals( idRenderLightLocal *ldef ) {
 				dp->fogLight = ldef;
 				dp->nextFoggedPortal = ldef->foggedPortals;
 				ldef->foggedPortals = dp;
+				ldef->world->InvalidatePortalVisCache();
 			}
 		}
 	}
@@ -602,6 +603,9 @@ void R_FreeLightDefDerivedData( idRenderLightLocal *ldef ) {
 	for ( doublePortal_t *dp = ldef->foggedPortals ; dp ; dp = dp->nextFoggedPortal ) {
 		dp->fogLight = NULL;
 	}
+	if ( ldef->foggedPortals ) {
+		ldef->world->InvalidatePortalVisCache();
+	}
 
 	// free all the interactions
 	while ( ldef->firstInteraction != NULL ) {
@@ -636,6 +640,11 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool
 	int i;
 	areaReference_t	*ref, *next;
 
+	// don't pull the model or the joints out from under a skinning job
+	if ( def->dynamicModelPending ) {
+		R_FlushSkinningBatch();
+	}
+
 	// demo playback needs to free the joints, while normal play
 	// leaves them in the control of the game
 	if ( session->readDemo ) {
@@ -699,6 +708,10 @@ R_FreeEntityDefDerivedData
 ==================
 */
 void R_ClearEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( def->dynamicModelPending ) {
+		R_FlushSkinningBatch();
+	}
+
 	// free all the interaction surfaces
 	for( idInteraction *inter = def->firstInteraction; inter != NULL && !inter->IsEmpty(); inter = inter->entityNext ) {
 		inter->FreeSurfaces();
@@ -777,6 +790,9 @@ void R_FreeDerivedData( void ) {
 			R_FreeLightDefDerivedData( light );
 		}
 	}
+
+	// the cached shadow volumes are keyed on the models
+	R_PurgeShadowCache();
 }
 
 /*
@@ -804,6 +820,9 @@ void R_CheckForEntityDefsUsingModel( idRenderModel *model ) {
 			}
 		}
 	}
+
+	// the cached shadow volumes are keyed on the model pointer
+	R_PurgeShadowCacheModel( model );
 }
 
 /*
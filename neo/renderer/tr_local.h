@@ -242,6 +242,13 @@ public:
 	idInteraction *			lastInteraction;
 
 	struct doublePortal_s *	foggedPortals;
+
+	// areas the last portal flow from the light center went into, the flow
+	// is only done again when the light origin or frustum changes
+	bool					flowCacheValid;
+	idVec3					flowCacheOrigin;
+	idPlane					flowCacheFrustum[6];
+	idList<int>				flowCacheAreas;
 };
 
 
@@ -275,6 +282,8 @@ public:
 	int						dynamicModelFrameCount;	// continuously animating dynamic models will recreate
 													// dynamicModel if this doesn't == tr.viewCount
 	idRenderModel *			cachedDynamicModel;
+	bool					dynamicModelPending;	// instantiated in a skinning batch, overlays and
+													// bounds checks wait for R_FlushSkinningBatch
 
 	idBounds				referenceBounds;		// the local bounds used to place entityRefs, either from parms or a model
 
@@ -555,6 +564,10 @@ typedef struct {
 
 extern	frameData_t	*frameData;
 
+// the front end builds into one frameData_t while the backend works through
+// the ones queued before it, r_frameQueueDepth sets how many may be in flight
+const int NUM_FRAME_DATA = 3;		// must match NUM_VERTEX_FRAMES
+
 //=======================================================================
 
 void R_ClearCommandChain( void );
@@ -584,6 +597,7 @@ typedef struct {
 	int		c_createInteractions;	// number of calls to idInteraction::CreateInteraction
 	int		c_createLightTris;
 	int		c_createShadowVolumes;
+	int		c_shadowCacheHits, c_shadowCacheMisses;
 	int		c_generateMd5;
 	int		c_entityDefCallbacks;
 	int		c_alloc, c_free;	// counts for R_StaticAllc/R_StaticFree
@@ -597,7 +611,14 @@ typedef struct {
 	int		c_tangentIndexes;	// R_DeriveTangents()
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
 	int		c_guiSurfs;
+	int		c_portalViewFlows, c_portalViewCacheHits;	// FlowViewThroughPortals
+	int		c_portalLightFlows, c_portalLightCacheHits;	// FlowLightThroughPortals
+	int		c_portalAreas;		// areas reached by the view flows
+	int		c_portalClips;		// portal windings clipped to a portal stack
 	int		frontEndMsec;		// sum of time in all RE_RenderScene's in a frame
+	int		c_queueStalls, queueStallMsec;		// front end waiting for a free frame in the backend queue
+	int		c_imageStalls, imageStallMsec;		// front end waiting for the backend to load queued images
+	int		readbackStallMsec;					// front end waiting for glReadPixels
 } performanceCounters_t;
 
 const int MAX_MULTITEXTURE_UNITS =	8;
@@ -660,6 +681,24 @@ const int MAX_GUI_SURFACES	= 1024;		// default size of the drawSurfs list for gu
 typedef struct {
 	int		x, y, width, height;	// these are in physical, OpenGL Y-at-bottom pixels
 } renderCrop_t;
+
+// everything the backend needs to run one queued frame
+typedef struct {
+	frameData_t *		frameData;
+	int					vertList;		// vertex cache temp list the frame was built in
+
+	// image work queued while the frame was built, taken from globalImages
+	// when the frame is submitted so it can't run ahead of earlier frames
+	idList<idImage *>	imagesAlloc;
+	idList<idImage *>	imagesPurge;
+	bool				imagePhase;		// set if the front end waits for the image work, the
+										// background load uploads are only done then
+
+	// set if the backend should read back pixels after the frame
+	renderCrop_t *		pixelsCrop;
+	byte *				pixels;
+} backendFrame_t;
+
 static const int	MAX_RENDER_CROPS = 8;
 
 /*
@@ -723,37 +762,39 @@ public:
 
 	bool					multithreadActive = false;
 
-	bool 					useSpinLock = true;
-	int						spinLockDelay = 1000;
-
-	volatile bool			backendThreadRun = false;
-	volatile bool			backendFinished = true;
-	volatile bool			imagesFinished = false;
-
 	volatile bool			backendThreadShutdown = false;
 
-	volatile frameData_t	*fdToRender = NULL;
-	volatile int			vertListToRender = 0;
+	// frame n goes in frameQueue[n % NUM_FRAME_DATA]. the counters are
+	// only touched under CRITICAL_SECTION_BACKEND, framesQueued by the
+	// front end and framesDone / imagesDone by the backend
+	backendFrame_t			frameQueue[NUM_FRAME_DATA];
+	int						framesQueued = 0;
+	int						framesDone = 0;
+	int						imagesDone = 0;		// frames whose image work has been done
 
-	// These are set if the backend should save pixels
-	volatile renderCrop_t	*pixelsCrop = NULL;
-	volatile byte           *pixels = NULL;
+	// r_showBackendStall, time the backend thread sat waiting for the front end
+	volatile int			backendIdleMsec = 0;
 
 	// For FPS limiting
 	unsigned int lastRenderTime = 0;
 
-	// The backend task
-	void					BackendThreadTask();
+	// The backend task, runs frame frameQueue[frameNum % NUM_FRAME_DATA]
+	void					BackendThreadTask( int frameNum );
 
 	// The backend thread
 	void					BackendThread();
 
-	// Start (and create) the back thread
+	// Queue the next frame and start (and create) the back thread
 	void					BackendThreadExecute();
 
-	// Wait for backend thread to finish
+	// Wait for backend thread to finish all queued frames
 	void					BackendThreadWait();
 
+	// Wait until the backend has finished numFrames frames, or done the image work for them
+	void					BackendWaitForFrames( int numFrames );
+	void					BackendWaitForImages( int numFrames );
+	int						BackendFramesDone();
+
 	void					BackendThreadShutdown();
 
 	// Call this to render the current command buffer.
@@ -886,6 +927,9 @@ extern idCVar r_useCachedDynamicModels;	// 1 = cache snapshots of dynamic models
 extern idCVar r_useInfiniteFarZ;		// 1 = use the no-far-clip-plane trick
 extern idCVar r_useScissor;				// 1 = scissor clip as portals and lights are processed
 extern idCVar r_usePortals;				// 1 = use portals to perform area culling, otherwise draw everything
+extern idCVar r_usePortalCache;			// reuse the portal flow of earlier views and lights that didn't move
+extern idCVar r_useShadowCache;			// reuse the shadow volumes of surfaces and lights that didn't move
+extern idCVar r_shadowCacheSize;		// MB of shadow volumes kept for reuse
 extern idCVar r_useStateCaching;		// avoid redundant state changes in GL_*() calls
 extern idCVar r_useVertexBuffers;		// if 0, don't use ARB_vertex_buffer_object for vertexes
 extern idCVar r_useIndexBuffers;		// if 0, don't use ARB_vertex_buffer_object for indexes
@@ -926,6 +970,7 @@ extern idCVar r_showUnsmoothedTangents;	// highlight geometry rendered with unsm
 extern idCVar r_showSilhouette;			// highlight edges that are casting shadow planes
 extern idCVar r_showVertexColor;		// draws all triangles with the solid vertex color
 extern idCVar r_showUpdates;			// report entity and light updates and ref counts
+extern idCVar r_showPortalFlow;		// report portal flows, clipped portals and portal cache hits
 extern idCVar r_showDemo;				// report reads and writes to the demo file
 extern idCVar r_showDynamic;			// report stats on dynamic surface generation
 extern idCVar r_showIntensity;			// draw the screen colors based on intensity, red = 0, green = 128, blue = 255
@@ -985,9 +1030,17 @@ extern idCVar r_debugRenderToTexture;
 
 
 extern idCVar r_multithread;			// enable multithread
+extern idCVar r_frameQueueDepth;		// frames in the front end / backend pipeline
+extern idCVar r_showBackendStall;		// print where the front end waited on the backend
+extern idCVar r_parallelFrontEnd;		// spread front end culling over the job system
+extern idCVar r_parallelSkinning;		// skin the visible MD5 models together on the job system
+extern idCVar r_parallelShadows;		// build the shadow volumes of a view together on the job system
+extern idCVar r_parallelParticles;	// create the particles of big stages in chunks on the job system
+extern idCVar r_checkParticles;		// compare the chunked particles against CreateParticle
 extern idCVar r_noLight;				// no lighting
 extern idCVar r_useETC1;				// ETC1 compression
 extern idCVar r_useETC1Cache;			// use ETC1 cache
+extern idCVar r_useBinaryProc;			// load maps from .bproc files
 extern idCVar r_maxFps;
 /*
 ====================================================================
@@ -1166,6 +1219,14 @@ void R_ListRenderEntityDefs_f( const idCmdArgs &args );
 bool R_IssueEntityDefCallback( idRenderEntityLocal *def );
 idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def );
 
+// while a skinning batch is open, MD5 models are instantiated with their
+// surfaces set up but not skinned, R_FlushSkinningBatch skins all of them
+// on the job threads and finishes the entities
+void R_BeginSkinningBatch( void );
+bool R_SkinningBatchOpen( void );
+void R_FlushSkinningBatch( void );
+void R_EndSkinningBatch( void );
+
 viewEntity_t *R_SetEntityDefViewEntity( idRenderEntityLocal *def );
 viewLight_t *R_SetLightDefViewLight( idRenderLightLocal *def );
 
@@ -1339,6 +1400,51 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 									 const srfTriangles_t *tri, const idRenderLightLocal *light,
 									 shadowGen_t optimize, srfCullInfo_t &cullInfo );
 
+// a shadow volume that isn't in a srfTriangles_t yet
+typedef struct {
+	int						numVerts;
+	shadowCache_t *			verts;					// NULL for turbo shadows, they use the ambient surface shadow cache
+	int						numIndexes;
+	glIndex_t *				indexes;
+	int						numShadowIndexesNoFrontCaps;
+	int						numShadowIndexesNoCaps;
+	int						shadowCapPlaneBits;
+} shadowVolume_t;
+
+// R_CreateShadowVolume is R_BuildShadowVolume followed by R_AllocShadowVolumeTris,
+// the build doesn't use the triangle allocators, so it can be run on the job threads
+bool R_BuildShadowVolume( const idRenderEntityLocal *ent,
+						 const srfTriangles_t *tri, const idRenderLightLocal *light,
+						 shadowGen_t optimize, srfCullInfo_t &cullInfo, shadowVolume_t &vol );
+srfTriangles_t *R_AllocShadowVolumeTris( const shadowVolume_t &vol );
+
+// thread safe copy of a built volume, freed with R_FreeShadowVolume
+shadowVolume_t *R_CopyShadowVolume( const shadowVolume_t &vol );
+void R_FreeShadowVolume( shadowVolume_t *vol );
+
+// everything that shapes the shadow volume of a model surface
+typedef struct {
+	const idRenderModel *	model;
+	const idDeclSkin *		customSkin;
+	const idMaterial *		customShader;
+	int						surfaceNum;
+	int						numVerts;
+	int						numIndexes;
+	int						flags;					// shadowGen_t and the turbo shadow options
+	unsigned int			jointsCrc;				// pose of MD5 models
+	unsigned int			lightCrc;				// light origin and frustums
+	float					modelMatrix[16];
+} shadowCacheKey_t;
+
+bool R_ShadowCacheKey( const idRenderEntityLocal *ent, int surfaceNum,
+					  const srfTriangles_t *tri, const idRenderLightLocal *light,
+					  shadowGen_t optimize, shadowCacheKey_t &key );
+bool R_FindCachedShadowVolume( const shadowCacheKey_t &key, srfTriangles_t **shadowTris );
+void R_CacheShadowVolume( const shadowCacheKey_t &key, shadowVolume_t *volume );
+void R_PurgeShadowCache( void );
+void R_PurgeShadowCacheModel( const idRenderModel *model );
+void R_ShadowCacheMemory( int &numVolumes, int &bytes );
+
 /*
 ============================================================
 
@@ -1354,6 +1460,9 @@ calling this function may modify "facing" based on culling
 srfTriangles_t *R_CreateVertexProgramTurboShadowVolume(const idRenderEntityLocal *ent,
         const srfTriangles_t *tri, const idRenderLightLocal *light,
         srfCullInfo_t &cullInfo);
+bool R_BuildVertexProgramTurboShadowVolume( const idRenderEntityLocal *ent,
+        const srfTriangles_t *tri, const idRenderLightLocal *light,
+        srfCullInfo_t &cullInfo, shadowVolume_t &vol );
 
 /*srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 									 const srfTriangles_t *tri, const idRenderLightLocal *light,
@@ -1411,6 +1520,7 @@ srfTriangles_t *	R_MergeTriangles( const srfTriangles_t *tri1, const srfTriangle
 // if the deformed verts have significant enough texture coordinate changes to reverse the texture
 // polarity of a triangle, the tangents will be incorrect
 void				R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes = true );
+void				R_DeriveTangentsNoAlloc( srfTriangles_t *tri );
 
 // deformable meshes precalculate as much as possible from a base frame, then generate
 // complete srfTriangles_t from just a new set of vertexes
@@ -1471,6 +1581,12 @@ void *R_FrameAlloc( int bytes );
 void *R_ClearedFrameAlloc( int bytes );
 void R_FrameFree( void *data );
 
+// runs function( data, i ) for 0 <= i < count on the front end worker threads
+void R_ParallelFor( xparallelJob_t function, void *data, int count, const char *name );
+
+// skins the MD5 surfaces queued while a skinning batch was open, Model_md5.cpp
+void R_RunMD5SkinJobs( void );
+
 void *R_StaticAlloc( int bytes );		// just malloc with error checking
 void *R_ClearedStaticAlloc( int bytes );	// with memset
 void R_StaticFree( void *data );
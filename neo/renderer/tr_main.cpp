@@ -38,7 +38,6 @@ If you have questions concerning this license or the applicable additional terms
 
 //====================================================================
 
-extern const unsigned int      NUM_FRAME_DATA = 2;
 extern frameData_t	           *smpFrameData[NUM_FRAME_DATA];
 extern volatile unsigned int   smpFrame;
 
@@ -459,6 +458,27 @@ void R_FrameFree( void *data ) {
 }
 
 
+/*
+==================
+R_ParallelFor
+
+Front end work that doesn't allocate or link anything can be spread
+over the job system worker threads.  The caller is responsible for keeping every
+index independent of the others, so the results don't depend on the
+number of threads.
+==================
+*/
+void R_ParallelFor( xparallelJob_t function, void *data, int count, const char *name ) {
+	if ( r_parallelFrontEnd.GetBool() && count > 1 ) {
+		Sys_ParallelFor( function, data, count, name );
+		return;
+	}
+
+	for ( int i = 0; i < count; i++ ) {
+		function( data, i );
+	}
+}
+
 
 //==========================================================================
 
@@ -27,6 +27,8 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/geometry/JointTransform.h"
+#include "idlib/hashing/CRC32.h"
 
 #include "renderer/tr_local.h"
 
@@ -125,27 +127,32 @@ If a high order bit is clear, the point is outside the plane (definately negativ
 //#define	LIGHT_CLIP_EPSILON	0.001f
 #define	LIGHT_CLIP_EPSILON		0.1f
 
+// all the working state is per thread, so shadow volumes can be built on the job threads
+
 #define	MAX_CLIP_SIL_EDGES		2048
-static int	numClipSilEdges;
-static int	clipSilEdges[MAX_CLIP_SIL_EDGES][2];
+static thread_local int	numClipSilEdges;
+static thread_local int	clipSilEdges[MAX_CLIP_SIL_EDGES][2];
 
 // facing will be 0 if forward facing, 1 if backwards facing
 // grabbed with alloca
-static byte	*globalFacing;
+static thread_local byte	*globalFacing;
 
 // faceCastsShadow will be 1 if the face is in the projection
 // and facing the apropriate direction
-static byte	*faceCastsShadow;
+static thread_local byte	*faceCastsShadow;
 
-static int	*remap;
+static thread_local int	*remap;
 
+// the output buffers are allocated the first time a thread builds a shadow
+// volume, and are kept for the life of the thread
 #define	MAX_SHADOW_INDEXES		0x18000
 #define	MAX_SHADOW_VERTS		0x18000
-static int	numShadowIndexes;
-static glIndex_t	shadowIndexes[MAX_SHADOW_INDEXES];
-static int	numShadowVerts;
-static idVec4	shadowVerts[MAX_SHADOW_VERTS];
-static bool overflowed;
+static thread_local int	numShadowIndexes;
+static thread_local glIndex_t	*shadowIndexes;
+static thread_local int	numShadowVerts;
+static thread_local idVec4	*shadowVerts;
+static thread_local glIndex_t	*sortedShadowIndexes;	// the output of R_BuildShadowVolume
+static thread_local bool overflowed;
 
 idPlane	pointLightFrustums[6][6] = {
 	{
@@ -200,7 +207,7 @@ idPlane	pointLightFrustums[6][6] = {
 	},
 };
 
-int	c_caps, c_sils;
+static thread_local int	c_caps, c_sils;
 
 typedef struct {
 	int		frontCapStart;
@@ -208,8 +215,8 @@ typedef struct {
 	int		silStart;
 	int		end;
 } indexRef_t;
-static indexRef_t	indexRef[6];
-static int indexFrustumNumber;		// which shadow generating side of a light the indexRef is for
+static thread_local indexRef_t	indexRef[6];
+static thread_local int indexFrustumNumber;		// which shadow generating side of a light the indexRef is for
 
 /*
 ===============
@@ -1131,9 +1138,11 @@ void R_MakeShadowFrustums( idRenderLightLocal *light ) {
 
 /*
 =================
-R_CreateShadowVolume
+R_BuildShadowVolume
 
-The returned surface will have a valid bounds and radius for culling.
+The volume is left in the memory of the calling thread, and is only valid
+until the next volume is built on that thread.  Nothing is allocated from
+the triangle allocators, so this can be run on the job threads.
 
 Triangles are clipped to the light frustum before projecting.
 
@@ -1146,7 +1155,7 @@ The worst case index count is much larger, when the 7 vertex clipped triangle
 needs 15 indexes for the front, 15 for the back, and 42 (a quad on seven sides)
 for the sides, for a total of 72 indexes from the original 3.  Ouch.
 
-NULL may be returned if the surface doesn't create a shadow volume at all,
+false may be returned if the surface doesn't create a shadow volume at all,
 as with a single face that the light is behind.
 
 If an edge is within an epsilon of the border of the volume, it must be treated
@@ -1155,20 +1164,19 @@ as if it was culled for edges, because the sil edge will have been
 generated by the triangle irregardless of if it actually was a sil edge.
 =================
 */
-srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
-									 const srfTriangles_t *tri, const idRenderLightLocal *light,
-									 shadowGen_t optimize, srfCullInfo_t &cullInfo ) {
+bool R_BuildShadowVolume( const idRenderEntityLocal *ent,
+						 const srfTriangles_t *tri, const idRenderLightLocal *light,
+						 shadowGen_t optimize, srfCullInfo_t &cullInfo, shadowVolume_t &vol ) {
 	int		i, j;
 	idVec3	lightOrigin;
-	srfTriangles_t	*newTri;
 	int		capPlaneBits;
 
 	if ( !r_shadows.GetBool() ) {
-		return NULL;
+		return false;
 	}
 
 	if ( tri->numSilEdges == 0 || tri->numIndexes == 0 || tri->numVerts == 0 ) {
-		return NULL;
+		return false;
 	}
 
 	if ( tri->numIndexes < 0 ) {
@@ -1179,13 +1187,11 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 		common->Error( "R_CreateShadowVolume: tri->numVerts = %i", tri->numVerts );
 	}
 
-	tr.pc.c_createShadowVolumes++;
-
 	// use the fast infinite projection in dynamic situations, which
 	// trades somewhat more overdraw and no cap optimizations for
 	// a very simple generation process
 	if ( optimize == SG_DYNAMIC && r_useTurboShadow.GetBool() ) {
-			return R_CreateVertexProgramTurboShadowVolume( ent, tri, light, cullInfo );
+		return R_BuildVertexProgramTurboShadowVolume( ent, tri, light, cullInfo, vol );
 	}
 
 	R_CalcInteractionFacing( ent, tri, light, cullInfo );
@@ -1197,7 +1203,13 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 	}
 	if ( allFront ) {
 		// if no faces are the right direction, don't make a shadow at all
-		return NULL;
+		return false;
+	}
+
+	if ( !shadowVerts ) {
+		shadowVerts = (idVec4 *)Mem_Alloc16( MAX_SHADOW_VERTS * sizeof( shadowVerts[0] ) );
+		shadowIndexes = (glIndex_t *)Mem_Alloc16( MAX_SHADOW_INDEXES * sizeof( shadowIndexes[0] ) );
+		sortedShadowIndexes = (glIndex_t *)Mem_Alloc16( MAX_SHADOW_INDEXES * sizeof( sortedShadowIndexes[0] ) );
 	}
 
 	// clear the shadow volume
@@ -1249,7 +1261,7 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 		// if we couldn't make a complete shadow volume, it is better to
 		// not draw one at all, avoiding streamer problems
 		if ( overflowed ) {
-			return NULL;
+			return false;
 		}
 
 		if ( indexFrustumNumber != oldFrustumNumber ) {
@@ -1263,7 +1275,7 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 	// if no faces have been defined for the shadow volume,
 	// there won't be anything at all
 	if ( numShadowIndexes == 0 ) {
-		return NULL;
+		return false;
 	}
 
 	// this should have been prevented by the overflowed flag, so if it ever happens,
@@ -1272,56 +1284,424 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 		common->FatalError( "Shadow volume exceeded allocation" );
 	}
 
+	vol.numVerts = numShadowVerts;
+	vol.verts = (shadowCache_t *)shadowVerts;
+	vol.indexes = sortedShadowIndexes;
+
+	if ( 1 /* sortCapIndexes */ ) {
+		vol.shadowCapPlaneBits = capPlaneBits;
+
+		// copy the sil indexes first
+		vol.numShadowIndexesNoCaps = 0;
+		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
+			int	c = indexRef[i].end - indexRef[i].silStart;
+			SIMDProcessor->Memcpy( vol.indexes+vol.numShadowIndexesNoCaps,
+									shadowIndexes+indexRef[i].silStart, c * sizeof( vol.indexes[0] ) );
+			vol.numShadowIndexesNoCaps += c;
+		}
+		// copy rear cap indexes next
+		vol.numShadowIndexesNoFrontCaps = vol.numShadowIndexesNoCaps;
+		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
+			int	c = indexRef[i].silStart - indexRef[i].rearCapStart;
+			SIMDProcessor->Memcpy( vol.indexes+vol.numShadowIndexesNoFrontCaps,
+									shadowIndexes+indexRef[i].rearCapStart, c * sizeof( vol.indexes[0] ) );
+			vol.numShadowIndexesNoFrontCaps += c;
+		}
+		// copy front cap indexes last
+		vol.numIndexes = vol.numShadowIndexesNoFrontCaps;
+		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
+			int	c = indexRef[i].rearCapStart - indexRef[i].frontCapStart;
+			SIMDProcessor->Memcpy( vol.indexes+vol.numIndexes,
+									shadowIndexes+indexRef[i].frontCapStart, c * sizeof( vol.indexes[0] ) );
+			vol.numIndexes += c;
+		}
+
+	} else {
+		vol.shadowCapPlaneBits = 63;	// we don't have optimized index lists
+		vol.numIndexes = vol.numShadowIndexesNoFrontCaps = vol.numShadowIndexesNoCaps = numShadowIndexes;
+		SIMDProcessor->Memcpy( vol.indexes, shadowIndexes, numShadowIndexes * sizeof( vol.indexes[0] ) );
+	}
+
+	return true;
+}
+
+/*
+=================
+R_AllocShadowVolumeTris
+
+Turbo shadow volumes have no verts of their own, the shadow cache
+of the ambient surface is used for them.
+=================
+*/
+srfTriangles_t *R_AllocShadowVolumeTris( const shadowVolume_t &vol ) {
+	srfTriangles_t	*newTri;
+
 	// allocate a new surface for the shadow volume
 	newTri = R_AllocStaticTriSurf();
 
 	// we might consider setting this, but it would only help for
 	// large lights that are partially off screen
+	// the turbo shadows extend to infinity, so they can't have bounds
 	newTri->bounds.Clear();
 
 	// copy off the verts and indexes
-	newTri->numVerts = numShadowVerts;
-	newTri->numIndexes = numShadowIndexes;
+	newTri->numVerts = vol.numVerts;
+	newTri->numIndexes = vol.numIndexes;
+	newTri->numShadowIndexesNoFrontCaps = vol.numShadowIndexesNoFrontCaps;
+	newTri->numShadowIndexesNoCaps = vol.numShadowIndexesNoCaps;
+	newTri->shadowCapPlaneBits = vol.shadowCapPlaneBits;
 
 	// the shadow verts will go into a main memory buffer as well as a vertex
 	// cache buffer, so they can be copied back if they are purged
-	R_AllocStaticTriSurfShadowVerts( newTri, newTri->numVerts );
-	SIMDProcessor->Memcpy( newTri->shadowVertexes, shadowVerts, newTri->numVerts * sizeof( newTri->shadowVertexes[0] ) );
+	if ( vol.verts ) {
+		R_AllocStaticTriSurfShadowVerts( newTri, newTri->numVerts );
+		SIMDProcessor->Memcpy( newTri->shadowVertexes, vol.verts, newTri->numVerts * sizeof( newTri->shadowVertexes[0] ) );
+	}
 
 	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
+	SIMDProcessor->Memcpy( newTri->indexes, vol.indexes, newTri->numIndexes * sizeof( newTri->indexes[0] ) );
 
-	if ( 1 /* sortCapIndexes */ ) {
-		newTri->shadowCapPlaneBits = capPlaneBits;
+	return newTri;
+}
 
-		// copy the sil indexes first
-		newTri->numShadowIndexesNoCaps = 0;
-		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
-			int	c = indexRef[i].end - indexRef[i].silStart;
-			SIMDProcessor->Memcpy( newTri->indexes+newTri->numShadowIndexesNoCaps,
-									shadowIndexes+indexRef[i].silStart, c * sizeof( newTri->indexes[0] ) );
-			newTri->numShadowIndexesNoCaps += c;
+/*
+=================
+R_CreateShadowVolume
+
+The returned surface will have a valid bounds and radius for culling.
+
+NULL may be returned if the surface doesn't create a shadow volume at all.
+=================
+*/
+srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
+									 const srfTriangles_t *tri, const idRenderLightLocal *light,
+									 shadowGen_t optimize, srfCullInfo_t &cullInfo ) {
+	shadowVolume_t	vol;
+
+	tr.pc.c_createShadowVolumes++;
+
+	if ( !R_BuildShadowVolume( ent, tri, light, optimize, cullInfo, vol ) ) {
+		return NULL;
+	}
+	return R_AllocShadowVolumeTris( vol );
+}
+
+/*
+===============================================================================
+
+	Shadow volume cache
+
+	The shadow volumes of an interaction are thrown away whenever the entity
+	or the light is updated, which the game does every frame for anything that
+	is active, and for every new snapshot of an animated model, even when
+	nothing that shapes the shadow has changed.  The volumes of static models
+	and of MD5 models are kept here, keyed on the model surface, the joints,
+	the entity placement and the light origin and frustums, so an interaction
+	that is recreated with the same geometry copies the old volume instead of
+	building it again.
+
+	The least recently used volumes are dropped when the cache grows
+	past r_shadowCacheSize.
+
+===============================================================================
+*/
+
+typedef struct shadowCacheEntry_s {
+	shadowCacheKey_t			key;
+	unsigned int				hash;
+	shadowVolume_t *			volume;		// NULL if the surface doesn't cast a shadow
+	int							size;
+	struct shadowCacheEntry_s *	hashNext;
+	struct shadowCacheEntry_s *	lruPrev;	// most recently used at the head
+	struct shadowCacheEntry_s *	lruNext;
+} shadowCacheEntry_t;
+
+#define	SHADOW_CACHE_HASH_SIZE	1024
+
+static shadowCacheEntry_t *		shadowCacheHash[SHADOW_CACHE_HASH_SIZE];
+static shadowCacheEntry_t		shadowCacheLRU;
+static int						shadowCacheEntries;
+static int						shadowCacheMemory;
+
+/*
+=================
+R_ShadowCacheKey
+
+Returns false if the shadow volume can't be cached, which is the case for
+models that are instantiated from more than their joints, and for models
+whose surfaces the game rebuilds in place, like the brittle fracture shards
+or anything generated through a callback.
+=================
+*/
+bool R_ShadowCacheKey( const idRenderEntityLocal *ent, int surfaceNum,
+					  const srfTriangles_t *tri, const idRenderLightLocal *light,
+					  shadowGen_t optimize, shadowCacheKey_t &key ) {
+	unsigned int	crc;
+	int				i;
+
+	if ( !r_useShadowCache.GetBool() ) {
+		return false;
+	}
+
+	const idRenderModel *model = ent->parms.hModel;
+
+	// the geometry of models that didn't come from a file can change without the counts changing
+	if ( ent->parms.callback || !model->IsReloadable() ) {
+		return false;
+	}
+
+	memset( &key, 0, sizeof( key ) );
+
+	if ( model->IsDynamicModel() != DM_STATIC ) {
+		// the surfaces of a suppressed MD5 model depend on the view
+		if ( model->IsDynamicModel() != DM_CACHED || !ent->parms.joints || ent->parms.numJoints <= 0 || ent->parms.suppressSurfaceInViewID ) {
+			return false;
 		}
-		// copy rear cap indexes next
-		newTri->numShadowIndexesNoFrontCaps = newTri->numShadowIndexesNoCaps;
-		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
-			int	c = indexRef[i].silStart - indexRef[i].rearCapStart;
-			SIMDProcessor->Memcpy( newTri->indexes+newTri->numShadowIndexesNoFrontCaps,
-									shadowIndexes+indexRef[i].rearCapStart, c * sizeof( newTri->indexes[0] ) );
-			newTri->numShadowIndexesNoFrontCaps += c;
+		key.jointsCrc = CRC32_BlockChecksum( ent->parms.joints, ent->parms.numJoints * sizeof( ent->parms.joints[0] ) );
+	}
+
+	key.model = model;
+	key.customSkin = ent->parms.customSkin;
+	key.customShader = ent->parms.customShader;
+	key.surfaceNum = surfaceNum;
+	key.numVerts = tri->numVerts;
+	key.numIndexes = tri->numIndexes;
+	key.flags = optimize;
+	if ( optimize == SG_DYNAMIC && r_useTurboShadow.GetBool() ) {
+		key.flags |= 2;
+		if ( r_useShadowProjectedCull.GetBool() ) {
+			key.flags |= 4;
 		}
-		// copy front cap indexes last
-		newTri->numIndexes = newTri->numShadowIndexesNoFrontCaps;
-		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
-			int	c = indexRef[i].rearCapStart - indexRef[i].frontCapStart;
-			SIMDProcessor->Memcpy( newTri->indexes+newTri->numIndexes,
-									shadowIndexes+indexRef[i].frontCapStart, c * sizeof( newTri->indexes[0] ) );
-			newTri->numIndexes += c;
+	}
+	memcpy( key.modelMatrix, ent->modelMatrix, sizeof( key.modelMatrix ) );
+
+	// everything of the light that goes into the volume
+	CRC32_InitChecksum( crc );
+	CRC32_UpdateChecksum( crc, light->globalLightOrigin.ToFloatPtr(), sizeof( light->globalLightOrigin ) );
+	CRC32_UpdateChecksum( crc, light->frustum, sizeof( light->frustum ) );
+	CRC32_UpdateChecksum( crc, &light->numShadowFrustums, sizeof( light->numShadowFrustums ) );
+	for ( i = 0; i < light->numShadowFrustums; i++ ) {
+		const shadowFrustum_t *frust = &light->shadowFrustums[i];
+		int clipped = frust->makeClippedPlanes;
+		CRC32_UpdateChecksum( crc, &frust->numPlanes, sizeof( frust->numPlanes ) );
+		CRC32_UpdateChecksum( crc, &clipped, sizeof( clipped ) );
+		CRC32_UpdateChecksum( crc, frust->planes, frust->numPlanes * sizeof( frust->planes[0] ) );
+	}
+	CRC32_FinishChecksum( crc );
+	key.lightCrc = crc;
+
+	return true;
+}
+
+/*
+=================
+R_UnlinkShadowCacheEntry
+=================
+*/
+static void R_UnlinkShadowCacheEntry( shadowCacheEntry_t *entry ) {
+	entry->lruPrev->lruNext = entry->lruNext;
+	entry->lruNext->lruPrev = entry->lruPrev;
+}
+
+/*
+=================
+R_LinkShadowCacheEntry
+
+Links at the head of the LRU list
+=================
+*/
+static void R_LinkShadowCacheEntry( shadowCacheEntry_t *entry ) {
+	if ( !shadowCacheLRU.lruNext ) {
+		shadowCacheLRU.lruNext = shadowCacheLRU.lruPrev = &shadowCacheLRU;
+	}
+	entry->lruPrev = &shadowCacheLRU;
+	entry->lruNext = shadowCacheLRU.lruNext;
+	entry->lruPrev->lruNext = entry;
+	entry->lruNext->lruPrev = entry;
+}
+
+/*
+=================
+R_FreeShadowCacheEntry
+=================
+*/
+static void R_FreeShadowCacheEntry( shadowCacheEntry_t *entry ) {
+	shadowCacheEntry_t **prev;
+
+	for ( prev = &shadowCacheHash[ entry->hash & ( SHADOW_CACHE_HASH_SIZE - 1 ) ]; *prev != entry; prev = &(*prev)->hashNext ) {
+	}
+	*prev = entry->hashNext;
+
+	R_UnlinkShadowCacheEntry( entry );
+
+	shadowCacheEntries--;
+	shadowCacheMemory -= entry->size;
+
+	R_FreeShadowVolume( entry->volume );
+	Mem_Free( entry );
+}
+
+/*
+=================
+R_FindCachedShadowVolume
+
+Returns true if the volume was found, *shadowTris is then set to a new
+copy of it, or NULL if the surface doesn't cast a shadow.
+=================
+*/
+bool R_FindCachedShadowVolume( const shadowCacheKey_t &key, srfTriangles_t **shadowTris ) {
+	shadowCacheEntry_t *entry;
+
+	unsigned int hash = CRC32_BlockChecksum( &key, sizeof( key ) );
+
+	for ( entry = shadowCacheHash[ hash & ( SHADOW_CACHE_HASH_SIZE - 1 ) ]; entry; entry = entry->hashNext ) {
+		if ( entry->hash == hash && !memcmp( &entry->key, &key, sizeof( key ) ) ) {
+			break;
 		}
+	}
+	if ( !entry ) {
+		tr.pc.c_shadowCacheMisses++;
+		return false;
+	}
+	tr.pc.c_shadowCacheHits++;
 
-	} else {
-		newTri->shadowCapPlaneBits = 63;	// we don't have optimized index lists
-		SIMDProcessor->Memcpy( newTri->indexes, shadowIndexes, newTri->numIndexes * sizeof( newTri->indexes[0] ) );
+	R_UnlinkShadowCacheEntry( entry );
+	R_LinkShadowCacheEntry( entry );
+
+	*shadowTris = entry->volume ? R_AllocShadowVolumeTris( *entry->volume ) : NULL;
+	return true;
+}
+
+/*
+=================
+R_CacheShadowVolume
+
+Takes over the volume, which should be a R_CopyShadowVolume copy.
+A NULL volume is cached for a surface that doesn't cast a shadow.
+=================
+*/
+void R_CacheShadowVolume( const shadowCacheKey_t &key, shadowVolume_t *volume ) {
+	shadowCacheEntry_t *entry;
+
+	unsigned int hash = CRC32_BlockChecksum( &key, sizeof( key ) );
+	int size = sizeof( *entry );
+	if ( volume ) {
+		size += sizeof( *volume ) + volume->numIndexes * sizeof( volume->indexes[0] );
+		if ( volume->verts ) {
+			size += volume->numVerts * sizeof( volume->verts[0] );
+		}
 	}
 
-	return newTri;
+	int maxMemory = r_shadowCacheSize.GetInteger() * 1024 * 1024;
+
+	// a surface that was queued twice in the same batch is already there
+	for ( entry = shadowCacheHash[ hash & ( SHADOW_CACHE_HASH_SIZE - 1 ) ]; entry; entry = entry->hashNext ) {
+		if ( entry->hash == hash && !memcmp( &entry->key, &key, sizeof( key ) ) ) {
+			break;
+		}
+	}
+	if ( entry || size > maxMemory ) {
+		R_FreeShadowVolume( volume );
+		return;
+	}
+
+	// make room by dropping the least recently used volumes
+	while ( shadowCacheEntries > 0 && shadowCacheMemory + size > maxMemory ) {
+		R_FreeShadowCacheEntry( shadowCacheLRU.lruPrev );
+	}
+
+	entry = (shadowCacheEntry_t *)Mem_Alloc( sizeof( *entry ) );
+	entry->key = key;
+	entry->hash = hash;
+	entry->volume = volume;
+	entry->size = size;
+	entry->hashNext = shadowCacheHash[ hash & ( SHADOW_CACHE_HASH_SIZE - 1 ) ];
+	shadowCacheHash[ hash & ( SHADOW_CACHE_HASH_SIZE - 1 ) ] = entry;
+	R_LinkShadowCacheEntry( entry );
+
+	shadowCacheEntries++;
+	shadowCacheMemory += size;
+}
+
+/*
+=================
+R_PurgeShadowCache
+
+The keys reference models, so this has to be done whenever models may be freed
+=================
+*/
+void R_PurgeShadowCache( void ) {
+	while ( shadowCacheEntries > 0 ) {
+		R_FreeShadowCacheEntry( shadowCacheLRU.lruPrev );
+	}
+}
+
+/*
+=================
+R_PurgeShadowCacheModel
+
+Drops the volumes of a single model before it is freed, so a model that is
+allocated at the same address later can't match them
+=================
+*/
+void R_PurgeShadowCacheModel( const idRenderModel *model ) {
+	shadowCacheEntry_t *entry, *next;
+
+	if ( !shadowCacheEntries ) {
+		return;
+	}
+
+	for ( entry = shadowCacheLRU.lruNext; entry != &shadowCacheLRU; entry = next ) {
+		next = entry->lruNext;
+		if ( entry->key.model == model ) {
+			R_FreeShadowCacheEntry( entry );
+		}
+	}
+}
+
+/*
+=================
+R_ShadowCacheMemory
+=================
+*/
+void R_ShadowCacheMemory( int &numVolumes, int &bytes ) {
+	numVolumes = shadowCacheEntries;
+	bytes = shadowCacheMemory;
+}
+
+/*
+=================
+R_CopyShadowVolume
+
+Copies a volume out of the memory of the thread that built it, into
+a single block that is freed with R_FreeShadowVolume.  Thread safe.
+=================
+*/
+shadowVolume_t *R_CopyShadowVolume( const shadowVolume_t &vol ) {
+	int header = ( sizeof( vol ) + 15 ) & ~15;
+	int vertBytes = vol.verts ? vol.numVerts * sizeof( vol.verts[0] ) : 0;
+	int indexBytes = vol.numIndexes * sizeof( vol.indexes[0] );
+
+	byte *block = (byte *)Mem_Alloc16( header + vertBytes + indexBytes );
+
+	shadowVolume_t *copy = (shadowVolume_t *)block;
+	*copy = vol;
+	copy->verts = vol.verts ? (shadowCache_t *)( block + header ) : NULL;
+	copy->indexes = (glIndex_t *)( block + header + vertBytes );
+
+	if ( vertBytes ) {
+		SIMDProcessor->Memcpy( copy->verts, vol.verts, vertBytes );
+	}
+	SIMDProcessor->Memcpy( copy->indexes, vol.indexes, indexBytes );
+
+	return copy;
+}
+
+/*
+=================
+R_FreeShadowVolume
+=================
+*/
+void R_FreeShadowVolume( shadowVolume_t *vol ) {
+	Mem_Free16( vol );
 }
@@ -346,7 +346,11 @@ void R_FreeStaticTriSurfVertexCaches( srfTriangles_t *tri ) {
 	// If there is no ambient(ie. parent) surface, then we are sure the cache is private
 	if ( tri->ambientSurface == NULL ) {
 		// this is a real model surface
-		if (tri->ambientCache) {
+		if ( tri->ambientCacheFrame ) {
+			// frame temp memory goes away by itself
+			tri->ambientCache = NULL;
+			tri->ambientCacheFrame = 0;
+		} else if (tri->ambientCache) {
 		vertexCache.Free( tri->ambientCache );
 		tri->ambientCache = NULL;
 	}
@@ -381,43 +385,46 @@ void R_ReallyFreeStaticTriSurf( srfTriangles_t *tri ) {
 
 	R_FreeStaticTriSurfVertexCaches( tri );
 
-	if ( tri->verts != NULL ) {
-		// R_CreateLightTris points tri->verts at the verts of the ambient surface
-		if ( tri->ambientSurface == NULL || tri->verts != tri->ambientSurface->verts ) {
-			triVertexAllocator.Free( tri->verts );
+	// the arrays of world surfaces loaded from a .bproc belong to the mapping
+	if ( !tri->mappedSurface ) {
+		if ( tri->verts != NULL ) {
+			// R_CreateLightTris points tri->verts at the verts of the ambient surface
+			if ( tri->ambientSurface == NULL || tri->verts != tri->ambientSurface->verts ) {
+				triVertexAllocator.Free( tri->verts );
+			}
 		}
-	}
 
-	if ( !tri->deformedSurface ) {
-		if ( tri->indexes != NULL ) {
-			// if a surface is completely inside a light volume R_CreateLightTris points tri->indexes at the indexes of the ambient surface
-			if ( tri->ambientSurface == NULL || tri->indexes != tri->ambientSurface->indexes ) {
-				triIndexAllocator.Free( tri->indexes );
+		if ( !tri->deformedSurface ) {
+			if ( tri->indexes != NULL ) {
+				// if a surface is completely inside a light volume R_CreateLightTris points tri->indexes at the indexes of the ambient surface
+				if ( tri->ambientSurface == NULL || tri->indexes != tri->ambientSurface->indexes ) {
+					triIndexAllocator.Free( tri->indexes );
+				}
+			}
+			if ( tri->silIndexes != NULL ) {
+				triSilIndexAllocator.Free( tri->silIndexes );
+			}
+			if ( tri->silEdges != NULL ) {
+				triSilEdgeAllocator.Free( tri->silEdges );
+			}
+			if ( tri->dominantTris != NULL ) {
+				triDominantTrisAllocator.Free( tri->dominantTris );
+			}
+			if ( tri->mirroredVerts != NULL ) {
+				triMirroredVertAllocator.Free( tri->mirroredVerts );
+			}
+			if ( tri->dupVerts != NULL ) {
+				triDupVertAllocator.Free( tri->dupVerts );
 			}
 		}
-		if ( tri->silIndexes != NULL ) {
-			triSilIndexAllocator.Free( tri->silIndexes );
-		}
-		if ( tri->silEdges != NULL ) {
-			triSilEdgeAllocator.Free( tri->silEdges );
-		}
-		if ( tri->dominantTris != NULL ) {
-			triDominantTrisAllocator.Free( tri->dominantTris );
-		}
-		if ( tri->mirroredVerts != NULL ) {
-			triMirroredVertAllocator.Free( tri->mirroredVerts );
-		}
-		if ( tri->dupVerts != NULL ) {
-			triDupVertAllocator.Free( tri->dupVerts );
-		}
-	}
 
-	if ( tri->facePlanes != NULL ) {
-		triPlaneAllocator.Free( tri->facePlanes );
-	}
+		if ( tri->facePlanes != NULL ) {
+			triPlaneAllocator.Free( tri->facePlanes );
+		}
 
-	if ( tri->shadowVertexes != NULL ) {
-		triShadowVertexAllocator.Free( tri->shadowVertexes );
+		if ( tri->shadowVertexes != NULL ) {
+			triShadowVertexAllocator.Free( tri->shadowVertexes );
+		}
 	}
 
 #ifdef _DEBUG
@@ -433,7 +440,7 @@ R_CheckStaticTriSurfMemory
 ==============
 */
 void R_CheckStaticTriSurfMemory( const srfTriangles_t *tri ) {
-	if ( !tri ) {
+	if ( !tri || tri->mappedSurface ) {
 		return;
 	}
 
@@ -1667,9 +1674,6 @@ Builds tangents, normals, and face planes
 ==================
 */
 void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
-	int				i;
-	idPlane			*planes;
-
 	if ( tri->dominantTris != NULL ) {
 		R_DeriveUnsmoothedTangents( tri );
 		return;
@@ -1684,6 +1688,32 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 	if ( !tri->facePlanes && allocFacePlanes ) {
 		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
 	}
+
+	R_DeriveTangentsNoAlloc( tri );
+}
+
+/*
+==================
+R_DeriveTangentsNoAlloc
+
+R_DeriveTangents without the allocation and the counters, so it can be
+run on a job thread.  The face planes are only built if the surface
+already has room for them.
+==================
+*/
+void R_DeriveTangentsNoAlloc( srfTriangles_t *tri ) {
+	int				i;
+	idPlane			*planes;
+
+	if ( tri->dominantTris != NULL ) {
+		R_DeriveUnsmoothedTangents( tri );
+		return;
+	}
+
+	if ( tri->tangentsCalculated ) {
+		return;
+	}
+
 	planes = tri->facePlanes;
 
 #if 1
@@ -33,18 +33,25 @@ If you have questions concerning this license or the applicable additional terms
 int	c_turboUsedVerts;
 int c_turboUnusedVerts;
 
+// the indexes built by R_BuildVertexProgramTurboShadowVolume, per thread so
+// the volumes can be built on the job threads
+static thread_local glIndex_t *	turboShadowIndexes;
+static thread_local int			maxTurboShadowIndexes;
+
 /*
 =====================
-R_CreateVertexProgramTurboShadowVolume
+R_BuildVertexProgramTurboShadowVolume
+
+The indexes are left in the memory of the calling thread, and are only valid
+until the next volume is built on that thread.
 
 are dangling edges that are outside the light frustum still making planes?
 =====================
 */
-srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLocal *ent,
-														const srfTriangles_t *tri, const idRenderLightLocal *light,
-														srfCullInfo_t &cullInfo ) {
+bool R_BuildVertexProgramTurboShadowVolume( const idRenderEntityLocal *ent,
+											const srfTriangles_t *tri, const idRenderLightLocal *light,
+											srfCullInfo_t &cullInfo, shadowVolume_t &vol ) {
 	int		i, j;
-	srfTriangles_t	*newTri;
 	silEdge_t	*sil;
 	const glIndex_t *indexes;
 	const byte *facing;
@@ -89,23 +96,17 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 
 	if ( !numShadowingFaces ) {
 		// no faces are inside the light frustum and still facing the right way
-		return NULL;
+		return false;
 	}
 
-	// shadowVerts will be NULL on these surfaces, so the shadowVerts will be taken from the ambient surface
-	newTri = R_AllocStaticTriSurf();
-
-	newTri->numVerts = tri->numVerts * 2;
-
-	// alloc the max possible size
-#ifdef USE_TRI_DATA_ALLOCATOR
-	R_AllocStaticTriSurfIndexes( newTri, ( numShadowingFaces + tri->numSilEdges ) * 6 );
-	glIndex_t *tempIndexes = newTri->indexes;
-	glIndex_t *shadowIndexes = newTri->indexes;
-#else
-	glIndex_t *tempIndexes = (glIndex_t *)_alloca16( tri->numSilEdges * 6 * sizeof( tempIndexes[0] ) );
-	glIndex_t *shadowIndexes = tempIndexes;
-#endif
+	// make room for the max possible size
+	int maxIndexes = ( numShadowingFaces + tri->numSilEdges ) * 6;
+	if ( maxIndexes > maxTurboShadowIndexes ) {
+		Mem_Free16( turboShadowIndexes );
+		maxTurboShadowIndexes = ( maxIndexes + 0xfff ) & ~0xfff;
+		turboShadowIndexes = (glIndex_t *)Mem_Alloc16( maxTurboShadowIndexes * sizeof( turboShadowIndexes[0] ) );
+	}
+	glIndex_t *shadowIndexes = turboShadowIndexes;
 
 	// create new triangles along sil planes
 	for ( sil = tri->silEdges, i = tri->numSilEdges; i > 0; i--, sil++ ) {
@@ -133,29 +134,20 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 		shadowIndexes += 6;
 	}
 
-	int	numShadowIndexes = shadowIndexes - tempIndexes;
-
-	// we aren't bothering to separate front and back caps on these
-	newTri->numIndexes = newTri->numShadowIndexesNoFrontCaps = numShadowIndexes + numShadowingFaces * 6;
-	newTri->numShadowIndexesNoCaps = numShadowIndexes;
-	newTri->shadowCapPlaneBits = SHADOW_CAP_INFINITE;
+	int	numShadowIndexes = shadowIndexes - turboShadowIndexes;
 
-#ifdef USE_TRI_DATA_ALLOCATOR
-	// decrease the size of the memory block to only store the used indexes
-	R_ResizeStaticTriSurfIndexes( newTri, newTri->numIndexes );
-#else
-	// allocate memory for the indexes
-	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
-	// copy the indexes we created for the sil planes
-	SIMDProcessor->Memcpy( newTri->indexes, tempIndexes, numShadowIndexes * sizeof( tempIndexes[0] ) );
-#endif
+	// shadowVerts will be NULL on these surfaces, so the shadowVerts will be taken from the ambient surface
+	vol.numVerts = tri->numVerts * 2;
+	vol.verts = NULL;
+	vol.indexes = turboShadowIndexes;
 
-	// these have no effect, because they extend to infinity
-	newTri->bounds.Clear();
+	// we aren't bothering to separate front and back caps on these
+	vol.numIndexes = vol.numShadowIndexesNoFrontCaps = numShadowIndexes + numShadowingFaces * 6;
+	vol.numShadowIndexesNoCaps = numShadowIndexes;
+	vol.shadowCapPlaneBits = SHADOW_CAP_INFINITE;
 
 	// put some faces on the model and some on the distant projection
 	indexes = tri->indexes;
-	shadowIndexes = newTri->indexes + numShadowIndexes;
 	for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
 		if ( facing[j] ) {
 			continue;
@@ -174,7 +166,23 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 		shadowIndexes += 6;
 	}
 
-	return newTri;
+	return true;
+}
+
+/*
+=====================
+R_CreateVertexProgramTurboShadowVolume
+=====================
+*/
+srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLocal *ent,
+														const srfTriangles_t *tri, const idRenderLightLocal *light,
+														srfCullInfo_t &cullInfo ) {
+	shadowVolume_t	vol;
+
+	if ( !R_BuildVertexProgramTurboShadowVolume( ent, tri, light, cullInfo, vol ) ) {
+		return NULL;
+	}
+	return R_AllocShadowVolumeTris( vol );
 }
 
 /*
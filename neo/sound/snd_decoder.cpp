@@ -283,6 +283,48 @@ int idWaveFile::CloseOGG( void ) {
 }
 
 
+/*
+===================================================================================
+
+  Decode ahead.
+
+  Streamed OGG channels read their sample front to back, one mix buffer at a
+  time. Once a decoder is read like that it takes a ring from a fixed pool and
+  the decode thread keeps DECODE_AHEAD_BUFFERS mix buffers of 44kHz samples
+  decoded past the last read, so the mixer only has to copy them out. Reads the
+  ring can't serve are decoded in place like before, those that continue the
+  stream are counted as underruns. The rings are guarded by CRITICAL_SECTION_ONE
+  like the rest of the decoder state. The thread decodes with a private decoder
+  for each ring into a buffer of its own without the lock, and only takes it to
+  look at the ring and to append a finished mix buffer.
+
+===================================================================================
+*/
+
+const int DECODE_AHEAD_BUFFERS				= 4;
+const int DECODE_AHEAD_SAMPLES				= DECODE_AHEAD_BUFFERS * MIXBUFFER_SAMPLES * 2;	// stereo
+const int MAX_DECODE_AHEAD_CHANNELS			= 8;
+
+class idSampleDecoderLocal;
+
+typedef struct decodeAhead_s {
+	idSampleDecoderLocal *	decoder;			// NULL when the ring is free
+	int						offset44k;			// sample offset of the first sample in the ring
+	int						count44k;			// number of samples in the ring
+	int						first;				// index of the first sample in the ring
+	int						serial;				// changed whenever the ring is reset or given away
+	bool					busy;				// the thread is decoding the sample of the ring
+	idSampleDecoderLocal *	reader;				// private decoder of the thread, never used by the mixer
+	int						readerSerial;		// serial the reader is positioned for
+	float					samples[DECODE_AHEAD_SAMPLES];
+} decodeAhead_t;
+
+static decodeAhead_t *		decodeAhead;		// MAX_DECODE_AHEAD_CHANNELS rings, NULL if disabled
+static xthreadInfo			decodeThread;
+static volatile bool		decodeThreadExit;
+static int					numDecodeAheadReads;
+static int					numDecodeUnderruns;
+
 /*
 ===================================================================================
 
@@ -302,6 +344,9 @@ public:
 	int						DecodePCM( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 	int						DecodeOGG( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 
+	int						ReadAhead( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
+	static bool				DecodeAhead( decodeAhead_t *ring );
+
 private:
 	bool					failed;				// set if decoding failed
 	int						lastFormat;			// last format being decoded
@@ -310,10 +355,37 @@ private:
 	int						lastDecodeTime;		// last time decoding sound
 
 	stb_vorbis*				stbv;				// stb_vorbis (Ogg) handle, using lastSample->nonCacheData
+	decodeAhead_t *			ahead;				// ring filled by the decode thread while streaming
 };
 
 idBlockAlloc<idSampleDecoderLocal, 64>		sampleDecoderAllocator;
 
+/*
+====================
+DecodeAheadThread
+====================
+*/
+static int DecodeAheadThread( void *parms ) {
+	bool busy;
+	int i;
+
+	while ( !decodeThreadExit ) {
+		Sys_WaitForEvent( TRIGGER_EVENT_TWO );
+
+		// fill the rings round robin so one stream can't starve the others
+		do {
+			busy = false;
+			for ( i = 0; i < MAX_DECODE_AHEAD_CHANNELS && !decodeThreadExit; i++ ) {
+				if ( idSampleDecoderLocal::DecodeAhead( &decodeAhead[i] ) ) {
+					busy = true;
+				}
+			}
+		} while ( busy && !decodeThreadExit );
+	}
+
+	return 0;
+}
+
 /*
 ====================
 idSampleDecoder::Init
@@ -323,6 +395,21 @@ void idSampleDecoder::Init( void ) {
 	decoderMemoryAllocator.Init();
 	decoderMemoryAllocator.SetLockMemory( true );
 	decoderMemoryAllocator.SetFixedBlocks( idSoundSystemLocal::s_realTimeDecoding.GetBool() ? 10 : 1 );
+
+	numDecodeAheadReads = 0;
+	numDecodeUnderruns = 0;
+
+	// without real time decoding the OGG samples are turned into PCM when they're loaded
+	if ( idSoundSystemLocal::s_realTimeDecoding.GetBool() && idSoundSystemLocal::s_decodeAhead.GetBool() ) {
+		decodeAhead = (decodeAhead_t *)Mem_Alloc16( MAX_DECODE_AHEAD_CHANNELS * sizeof( decodeAhead_t ) );
+		memset( decodeAhead, 0, MAX_DECODE_AHEAD_CHANNELS * sizeof( decodeAhead_t ) );
+		for ( int i = 0; i < MAX_DECODE_AHEAD_CHANNELS; i++ ) {
+			decodeAhead[i].reader = sampleDecoderAllocator.Alloc();
+			decodeAhead[i].reader->Clear();
+		}
+		decodeThreadExit = false;
+		Sys_CreateThread( DecodeAheadThread, NULL, decodeThread, "soundDecoder" );
+	}
 }
 
 /*
@@ -331,6 +418,20 @@ idSampleDecoder::Shutdown
 ====================
 */
 void idSampleDecoder::Shutdown( void ) {
+	if ( decodeThread.threadHandle ) {
+		decodeThreadExit = true;
+		Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+		Sys_DestroyThread( decodeThread );
+	}
+	if ( decodeAhead != NULL ) {
+		for ( int i = 0; i < MAX_DECODE_AHEAD_CHANNELS; i++ ) {
+			decodeAhead[i].reader->ClearDecoder();
+			sampleDecoderAllocator.Free( decodeAhead[i].reader );
+		}
+		Mem_Free16( decodeAhead );
+		decodeAhead = NULL;
+	}
+
 	decoderMemoryAllocator.Shutdown();
 	sampleDecoderAllocator.Shutdown();
 }
@@ -375,6 +476,24 @@ int idSampleDecoder::GetUsedBlockMemory( void ) {
 	return decoderMemoryAllocator.GetUsedBlockMemory();
 }
 
+/*
+====================
+idSampleDecoder::GetNumDecodeAheadReads
+====================
+*/
+int idSampleDecoder::GetNumDecodeAheadReads( void ) {
+	return numDecodeAheadReads;
+}
+
+/*
+====================
+idSampleDecoder::GetNumUnderruns
+====================
+*/
+int idSampleDecoder::GetNumUnderruns( void ) {
+	return numDecodeUnderruns;
+}
+
 /*
 ====================
 idSampleDecoderLocal::Clear
@@ -387,16 +506,32 @@ void idSampleDecoderLocal::Clear( void ) {
 	lastSampleOffset = 0;
 	lastDecodeTime = 0;
 	stbv = NULL;
+	ahead = NULL;
 }
 
 /*
 ====================
 idSampleDecoderLocal::ClearDecoder
+
+  Must not be called with CRITICAL_SECTION_ONE held, it may have to let the
+  decode thread finish with the sample.
 ====================
 */
 void idSampleDecoderLocal::ClearDecoder( void ) {
 	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
 
+	// give the ring back, the sample can be purged once this returns
+	if ( ahead != NULL ) {
+		ahead->decoder = NULL;
+		ahead->serial++;
+		while ( ahead->busy ) {
+			Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+			Sys_Sleep( 0 );
+			Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+		}
+		ahead = NULL;
+	}
+
 	switch( lastFormat ) {
 		case WAVE_FORMAT_TAG_PCM: {
 			break;
@@ -459,7 +594,11 @@ void idSampleDecoderLocal::Decode( idSoundSample *sample, int sampleOffset44k, i
 			break;
 		}
 		case WAVE_FORMAT_TAG_OGG: {
-			readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+			if ( decodeAhead != NULL ) {
+				readSamples44k = ReadAhead( sample, sampleOffset44k, sampleCount44k, dest );
+			} else {
+				readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+			}
 			break;
 		}
 		default: {
@@ -637,3 +776,153 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 
 	return ( readSamples << shift );
 }
+
+/*
+====================
+idSampleDecoderLocal::ReadAhead
+
+  Serves a read from the decode ahead ring as far as it goes and decodes the
+  rest in place. Called with CRITICAL_SECTION_ONE held.
+====================
+*/
+int idSampleDecoderLocal::ReadAhead( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) {
+	int i, readSamples44k, len;
+
+	if ( ahead == NULL ) {
+		// a read that continues where the last one stopped is a stream, try to get a ring for it
+		int shift = 22050 / sample->objectInfo.nSamplesPerSec;
+		bool stream = ( lastSample == sample && lastFormat == WAVE_FORMAT_TAG_OGG && sampleOffset44k == ( lastSampleOffset << shift ) );
+
+		readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+
+		if ( stream && !failed ) {
+			for ( i = 0; i < MAX_DECODE_AHEAD_CHANNELS; i++ ) {
+				if ( decodeAhead[i].decoder == NULL ) {
+					ahead = &decodeAhead[i];
+					ahead->decoder = this;
+					ahead->offset44k = sampleOffset44k + readSamples44k;
+					ahead->count44k = 0;
+					ahead->first = 0;
+					ahead->serial++;
+					Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+					break;
+				}
+			}
+		}
+		return readSamples44k;
+	}
+
+	if ( sampleOffset44k != ahead->offset44k ) {
+		readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+
+		// reads a little behind the ring are the amplitude checks for shakes,
+		// anything else means the channel jumped so the ring is useless now
+		if ( sampleOffset44k > ahead->offset44k || sampleOffset44k < ahead->offset44k - DECODE_AHEAD_SAMPLES ) {
+			ahead->offset44k = sampleOffset44k + readSamples44k;
+			ahead->count44k = 0;
+			ahead->first = 0;
+			ahead->serial++;
+			Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+		}
+		return readSamples44k;
+	}
+
+	// copy out what the decode thread got done
+	readSamples44k = Min( sampleCount44k, ahead->count44k );
+	for ( i = 0; i < readSamples44k; i += len ) {
+		len = Min( readSamples44k - i, DECODE_AHEAD_SAMPLES - ahead->first );
+		memcpy( dest + i, ahead->samples + ahead->first, len * sizeof( dest[0] ) );
+		ahead->first = ( ahead->first + len ) % DECODE_AHEAD_SAMPLES;
+	}
+	ahead->count44k -= readSamples44k;
+	ahead->offset44k += readSamples44k;
+
+	if ( readSamples44k < sampleCount44k ) {
+		// the thread has its own decoder, so this seeks to the end of the ring first
+		len = DecodeOGG( sample, ahead->offset44k, sampleCount44k - readSamples44k, dest + readSamples44k );
+		ahead->offset44k += len;
+		readSamples44k += len;
+		if ( len > 0 ) {
+			numDecodeUnderruns++;
+		}
+	} else {
+		numDecodeAheadReads++;
+	}
+
+	Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+
+	return readSamples44k;
+}
+
+/*
+====================
+idSampleDecoderLocal::DecodeAhead
+
+  Decodes one more mix buffer for the ring, returns false if there was
+  nothing to do. Runs on the decode thread. The lock is only held to see what
+  the ring needs and to append the samples, the decode itself is done by the
+  reader of the ring into a buffer on the stack of the thread.
+====================
+*/
+bool idSampleDecoderLocal::DecodeAhead( decodeAhead_t *ring ) {
+	ALIGN16( float samples[MIXBUFFER_SAMPLES] );
+	idSampleDecoderLocal *decoder;
+	idSoundSample *sample;
+	int i, end, count, serial, readSamples44k, len;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+
+	decoder = ring->decoder;
+	if ( decoder == NULL || decoder->failed || decoder->lastSample == NULL || decoder->lastFormat != WAVE_FORMAT_TAG_OGG ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+		return false;
+	}
+
+	sample = decoder->lastSample;
+	serial = ring->serial;
+	end = ring->offset44k + ring->count44k;
+
+	// whole stereo frames at 11kHz, the tail of the sample is left to the mixer
+	count = Min( MIXBUFFER_SAMPLES, DECODE_AHEAD_SAMPLES - ring->count44k );
+	count = Min( count, sample->LengthIn44kHzSamples() - end );
+	count &= ~7;
+
+	// a reader that failed is left alone until the ring is reset
+	if ( count <= 0 || ( ring->readerSerial == serial && ring->reader->failed ) ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+		return false;
+	}
+
+	// ClearDecoder waits for this before the sample can go away
+	ring->busy = true;
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
+	if ( ring->readerSerial != serial || ring->reader->lastSample != sample ) {
+		ring->reader->ClearDecoder();
+		ring->readerSerial = serial;
+	}
+
+	readSamples44k = ring->reader->DecodeOGG( sample, end, count, samples );
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+
+	ring->busy = false;
+
+	// drop the samples if the mixer reset the ring or gave it away meanwhile
+	if ( ring->serial != serial || ring->offset44k + ring->count44k != end ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+		return true;
+	}
+
+	for ( i = 0; i < readSamples44k; i += len ) {
+		int last = ( ring->first + ring->count44k ) % DECODE_AHEAD_SAMPLES;
+		len = Min( readSamples44k - i, DECODE_AHEAD_SAMPLES - last );
+		memcpy( ring->samples + last, samples + i, len * sizeof( samples[0] ) );
+		ring->count44k += len;
+	}
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
+	return ( readSamples44k > 0 );
+}
@@ -495,6 +495,7 @@ public:
 		missedWindow = 0;
 		missedUpdateWindow = 0;
 		activeSounds = 0;
+		decoderUnderruns = 0;
 	}
 	int		rinuse;
 	int		runs;
@@ -502,6 +503,7 @@ public:
 	int		missedWindow;
 	int		missedUpdateWindow;
 	int		activeSounds;
+	int		decoderUnderruns;
 };
 
 typedef struct soundPortalTrace_s {
@@ -792,6 +794,7 @@ public:
 	static idCVar			s_force22kHz;
 	static idCVar			s_clipVolumes;
 	static idCVar			s_realTimeDecoding;
+	static idCVar			s_decodeAhead;
 	static idCVar			s_useEAXReverb;
 	static idCVar			s_decompressionLimit;
 
@@ -870,6 +873,8 @@ public:
 	static void				Free( idSampleDecoder *decoder );
 	static int				GetNumUsedBlocks( void );
 	static int				GetUsedBlockMemory( void );
+	static int				GetNumDecodeAheadReads( void );	// streamed reads served by the decode thread
+	static int				GetNumUnderruns( void );		// streamed reads it fell behind on
 
 	virtual					~idSampleDecoder( void ) {}
 	virtual void			Decode( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) = 0;
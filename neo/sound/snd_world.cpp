@@ -498,6 +498,15 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float *final
 	int i, j;
 	idSoundEmitterLocal *sound;
 
+	// streamed channels the decode thread couldn't keep ahead of
+	int underruns = idSampleDecoder::GetNumUnderruns();
+	if ( underruns != soundSystemLocal.soundStats.decoderUnderruns ) {
+		if ( idSoundSystemLocal::s_showStartSound.GetInteger() ) {
+			common->Printf( "sound: %d decoder underruns\n", underruns - soundSystemLocal.soundStats.decoderUnderruns );
+		}
+		soundSystemLocal.soundStats.decoderUnderruns = underruns;
+	}
+
 	// if noclip flying outside the world, leave silence
 	if ( listenerArea == -1 ) {
 		alListenerf( AL_GAIN, 0.0f );
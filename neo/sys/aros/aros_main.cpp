@@ -288,6 +288,35 @@ ID_TIME_T Sys_FileTimeStamp(FILE * fp) {
     return st.st_mtime;
 }
 
+// no mmap, read the file instead
+const void *Sys_MapFile( const char *path, int *size ) {
+    FILE *fp;
+    long length;
+    void *data;
+
+    *size = 0;
+    fp = fopen( path, "rb" );
+    if ( !fp ) {
+        return NULL;
+    }
+    fseek( fp, 0, SEEK_END );
+    length = ftell( fp );
+    fseek( fp, 0, SEEK_SET );
+    data = ( length > 0 ) ? malloc( length ) : NULL;
+    if ( !data || fread( data, 1, length, fp ) != (size_t)length ) {
+        free( data );
+        fclose( fp );
+        return NULL;
+    }
+    fclose( fp );
+    *size = length;
+    return data;
+}
+
+void Sys_UnmapFile( const void *data, int size ) {
+    free( const_cast<void *>( data ) );
+}
+
 bool Sys_FPU_StackIsEmpty( void ) {
     bug("[ADoom3] %s()\n", __PRETTY_FUNCTION__);
 
@@ -29,6 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #include <float.h>
 
 #include <SDL_cpuinfo.h>
+#include <SDL_version.h>
 
 // MSVC header intrin.h uses strcmp and errors out when not set
 #define IDSTR_NO_REDIRECT
@@ -73,33 +74,51 @@ static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 #endif
 	*a = *b = *c = *d = 0;
 
+	// the sub-leaf in ecx is only used by some of the leaves, leaf 7 needs it to be 0
 	__asm__ volatile
 	(	"mov %%" REG_b ", %%" REG_S "\n\t"
 		"cpuid\n\t"
 		"xchg %%" REG_b ", %%" REG_S
 		:	"=a" (*a), "=S" (*b),
 			"=c" (*c), "=d" (*d)
-		: "0" (index));
+		: "0" (index), "2" (0));
+}
+
+static inline unsigned int GetXCR0() {
+	unsigned int a, d;
+
+	// xgetbv, spelled out for assemblers that don't know it
+	__asm__ volatile ( ".byte 0x0f, 0x01, 0xd0" : "=a" (a), "=d" (d) : "c" (0) );
+	return a;
 }
 #elif defined(_MSC_VER)
 #include <intrin.h>
 static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 	int info[4] = { };
 
-	// VS2005 and up
-	__cpuid(info, index);
+	// VS2008 SP1 and up, leaf 7 needs the sub-leaf to be 0
+	__cpuidex(info, index, 0);
 
 	*a = info[0];
 	*b = info[1];
 	*c = info[2];
 	*d = info[3];
 }
+
+static inline unsigned int GetXCR0() {
+	return (unsigned int)_xgetbv(0);
+}
 #else
 #error unsupported compiler
 #endif
 
 #define c_SSE3		(1 << 0)
+#define c_FMA3		(1 << 12)
+#define c_OSXSAVE	(1 << 27)
+#define c_AVX		(1 << 28)
 #define d_FXSAVE	(1 << 24)
+#define b7_AVX2		(1 << 5)
+#define XCR0_XMM_YMM	( (1 << 1) | (1 << 2) )
 
 static inline bool HasDAZ() {
 	int a, b, c, d;
@@ -125,6 +144,31 @@ static inline bool HasSSE3() {
 	return (c & c_SSE3) == c_SSE3;
 }
 
+// AVX2 and FMA3 can only be used if the OS saves the upper halves
+// of the ymm registers on context switches
+static inline bool HasAVX2(bool *fma3) {
+	int a, b, c, d;
+
+	*fma3 = false;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 7)
+		return false;
+
+	CPUid(1, &a, &b, &c, &d);
+	if ((c & (c_OSXSAVE | c_AVX)) != (c_OSXSAVE | c_AVX))
+		return false;
+
+	if ((GetXCR0() & XCR0_XMM_YMM) != XCR0_XMM_YMM)
+		return false;
+
+	*fma3 = (c & c_FMA3) == c_FMA3;
+
+	CPUid(7, &a, &b, &c, &d);
+
+	return (b & b7_AVX2) == b7_AVX2;
+}
+
 #define MXCSR_DAZ	(1 << 6)
 #define MXCSR_FTZ	(1 << 15)
 
@@ -214,11 +258,25 @@ int Sys_GetProcessorId( void ) {
 	// there is no SDL_HasSSE3() in SDL 1.2
 	if (HasSSE3())
 		flags |= CPUID_SSE3;
+
+	bool fma3;
+	if (HasAVX2(&fma3))
+		flags |= CPUID_AVX2;
+	if (fma3)
+		flags |= CPUID_FMA3;
 #endif
 
 	if (SDL_HasAltiVec())
 		flags |= CPUID_ALTIVEC;
 
+#if defined(__aarch64__) || defined(_M_ARM64)
+	flags |= CPUID_NEON;
+#elif SDL_VERSION_ATLEAST(2, 0, 6)
+	// 32 bit arm only has it from armv7 on, and not even always there
+	if (SDL_HasNEON())
+		flags |= CPUID_NEON;
+#endif
+
 	return flags;
 }
 
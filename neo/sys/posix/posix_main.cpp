@@ -176,6 +176,46 @@ void Sys_Mkdir( const char *path ) {
 	mkdir(path, 0777);
 }
 
+/*
+================
+Sys_MapFile
+================
+*/
+const void *Sys_MapFile( const char *path, int *size ) {
+	struct stat st;
+	void *data;
+	int fd;
+
+	*size = 0;
+	fd = open( path, O_RDONLY );
+	if ( fd == -1 ) {
+		return NULL;
+	}
+	if ( fstat( fd, &st ) == -1 || st.st_size <= 0 || st.st_size > INT_MAX ) {
+		close( fd );
+		return NULL;
+	}
+	data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	// the mapping keeps the file referenced
+	close( fd );
+	if ( data == MAP_FAILED ) {
+		return NULL;
+	}
+	*size = st.st_size;
+	return data;
+}
+
+/*
+================
+Sys_UnmapFile
+================
+*/
+void Sys_UnmapFile( const void *data, int size ) {
+	if ( data ) {
+		munmap( const_cast<void *>( data ), size );
+	}
+}
+
 /*
 ================
 Sys_ListFiles
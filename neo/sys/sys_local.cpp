@@ -113,6 +113,14 @@ sysEvent_t idSysLocal::GenerateMouseMoveEvent( int deltax, int deltay ) {
 	return ev;
 }
 
+int idSysLocal::NumWorkerThreads( void ) {
+	return Sys_NumWorkerThreads();
+}
+
+void idSysLocal::ParallelFor( xparallelJob_t function, void *data, int count, const char *name ) {
+	Sys_ParallelFor( function, data, count, name );
+}
+
 /*
 =================
 Sys_TimeStampToStr
@@ -64,6 +64,9 @@ public:
 
 	virtual void			OpenURL( const char *url, bool quit );
 	virtual void			StartProcess( const char *exeName, bool quit );
+
+	virtual int				NumWorkerThreads( void );
+	virtual void			ParallelFor( xparallelJob_t function, void *data, int count, const char *name );
 };
 
 #endif /* !__SYS_LOCAL__ */
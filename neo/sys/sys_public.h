@@ -41,6 +41,9 @@ typedef enum {
 	CPUID_SSE2							= 0x00080,	// Streaming SIMD Extensions 2
 	CPUID_SSE3							= 0x00100,	// Streaming SIMD Extentions 3 aka Prescott's New Instructions
 	CPUID_ALTIVEC						= 0x00200,	// AltiVec
+	CPUID_AVX2							= 0x00400,	// Advanced Vector Extensions 2, only set if the OS saves the ymm registers
+	CPUID_FMA3							= 0x00800,	// Fused Multiply-Add, same
+	CPUID_NEON							= 0x01000,	// ARM Advanced SIMD, always there on arm64
 } cpuidSimd_t;
 
 typedef enum {
@@ -201,6 +204,10 @@ void			Sys_ShowConsole( int visLevel, bool quitOnClose );
 
 void			Sys_Mkdir( const char *path );
 ID_TIME_T			Sys_FileTimeStamp( FILE *fp );
+// maps a whole file read only, NULL if it can't be opened or is empty
+// where mapping isn't supported the file is read into memory instead
+const void *	Sys_MapFile( const char *path, int *size );
+void			Sys_UnmapFile( const void *data, int size );
 // NOTE: do we need to guarantee the same output on all platforms?
 const char *	Sys_TimeStampToStr( ID_TIME_T timeStamp );
 
@@ -323,14 +330,16 @@ extern void Sys_ShutdownThreads();
 
 bool Sys_IsMainThread();
 
-const int MAX_CRITICAL_SECTIONS		= 5;
+const int MAX_CRITICAL_SECTIONS		= 7;
 
 enum {
 	CRITICAL_SECTION_ZERO = 0,
 	CRITICAL_SECTION_ONE,
 	CRITICAL_SECTION_TWO,
 	CRITICAL_SECTION_THREE,
-	CRITICAL_SECTION_SYS
+	CRITICAL_SECTION_BACKEND,
+	CRITICAL_SECTION_SYS,
+	CRITICAL_SECTION_FILESYSTEM
 };
 
 void				Sys_EnterCriticalSection( int index = CRITICAL_SECTION_ZERO );
@@ -351,6 +360,57 @@ enum {
 void				Sys_WaitForEvent( int index = TRIGGER_EVENT_ZERO );
 void				Sys_TriggerEvent( int index = TRIGGER_EVENT_ZERO );
 
+/*
+==============================================================
+
+	Job system
+
+	A pool of worker threads that any thread can hand small jobs to.
+	Jobs are tracked by a caller owned xjobGroup_t, which can be waited
+	on and can have a continuation that runs once all its jobs are done.
+	Jobs may only allocate from the idHeap if it is built with USE_MT_HEAP,
+	and the game code is only called by the jobs the game itself hands out
+	through idSys::ParallelFor.
+
+==============================================================
+*/
+
+const int MAX_WORKER_THREADS		= 16;
+
+typedef void (*xjob_t)( void *data );
+
+typedef struct {
+	const char *	name;				// for profiling, used for jobs that don't have their own name
+	int				pending;			// unfinished jobs, only touched by the job system
+	xjob_t			continuation;
+	void *			continuationData;
+	const char *	continuationName;
+} xjobGroup_t;
+
+// (re)starts the pool of worker threads, -1 starts one per core besides the
+// main thread and 0 stops all workers
+void				Sys_StartWorkerThreads( int numThreads );
+int					Sys_NumWorkerThreads( void );
+
+void				Sys_InitJobGroup( xjobGroup_t &group, const char *name );
+// without worker threads the jobs only run once somebody waits on the group
+void				Sys_SubmitJob( xjobGroup_t &group, xjob_t function, void *data, const char *name = NULL );
+// runs as the last job of the group once all jobs submitted so far are done,
+// right away if they already are. it may submit more jobs to the same group
+void				Sys_SetJobContinuation( xjobGroup_t &group, xjob_t function, void *data, const char *name = NULL );
+// runs queued jobs on the calling thread until the group and its continuation are done
+void				Sys_WaitJobGroup( xjobGroup_t &group );
+bool				Sys_JobGroupFinished( xjobGroup_t &group );
+void				Sys_PrintJobThreads( void );
+
+typedef void (*xparallelJob_t)( void *data, int index );
+
+// calls function( data, i ) for every 0 <= i < count, spread over the worker threads
+// and the calling thread. returns once all calls have finished.
+// the calls run in no particular order, so they must not depend on each other.
+// may be called from inside a job
+void				Sys_ParallelFor( xparallelJob_t function, void *data, int count, const char *name = "parallelFor" );
+
 /*
 ==============================================================
 
@@ -382,6 +442,10 @@ public:
 
 	virtual void			OpenURL( const char *url, bool quit ) = 0;
 	virtual void			StartProcess( const char *exePath, bool quit ) = 0;
+
+	// the job system for the game, see Sys_ParallelFor
+	virtual int				NumWorkerThreads( void ) = 0;
+	virtual void			ParallelFor( xparallelJob_t function, void *data, int count, const char *name ) = 0;
 };
 
 extern idSys *				sys;
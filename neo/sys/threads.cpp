@@ -56,6 +56,14 @@ static bool			waiting[MAX_TRIGGER_EVENTS] = { };
 static xthreadInfo	*thread[MAX_THREADS] = { };
 static size_t		thread_count = 0;
 
+// job system, idle workers and Sys_WaitJobGroup sleep on workerWake
+static SDL_mutex	*workerMutex = NULL;
+static SDL_cond		*workerWake = NULL;
+
+static bool Sys_InitJobQueues();
+static void Sys_ShutdownJobQueues();
+static void Sys_StopWorkerThreads();
+
 static bool mainThreadIDset = false;
 static SDL_threadID mainThreadID = -1;
 
@@ -114,6 +122,15 @@ void Sys_InitThreads() {
 		thread[i] = NULL;
 
 	thread_count = 0;
+
+	// job system, the worker threads are started by Sys_StartWorkerThreads
+	workerMutex = SDL_CreateMutex();
+	workerWake = SDL_CreateCond();
+
+	if (!workerMutex || !workerWake || !Sys_InitJobQueues()) {
+		Sys_Printf("ERROR: SDL_CreateMutex/SDL_CreateCond failed for the job system\n");
+		return;
+	}
 }
 
 /*
@@ -122,6 +139,15 @@ Sys_ShutdownThreads
 ==================
 */
 void Sys_ShutdownThreads() {
+	// job system
+	Sys_StopWorkerThreads();
+	Sys_ShutdownJobQueues();
+
+	SDL_DestroyCond(workerWake);
+	SDL_DestroyMutex(workerMutex);
+	workerWake = NULL;
+	workerMutex = NULL;
+
 	// threads
 	for (int i = 0; i < MAX_THREADS; i++) {
 		if (!thread[i])
@@ -347,3 +373,520 @@ bool Sys_IsMainThread() {
 	// any threads yet so it should be the main thread
 	return true;
 }
+
+/*
+======================================================
+job system
+
+every worker thread owns a queue of jobs, jobs submitted from a worker go to
+its own queue and are run newest first, idle threads steal the oldest jobs
+from the other queues. all threads that aren't workers share queue 0.
+the queues are only touched under their own lock, the counters and the job
+groups are protected by workerMutex. the lock order is always workerMutex
+first, then a queue lock.
+======================================================
+*/
+
+const int MAX_QUEUED_JOBS			= 256;	// per queue, must be a power of two
+const int MAX_JOB_QUEUES			= MAX_WORKER_THREADS + 1;
+const int MAX_PARALLEL_FOR_CHUNKS	= 64;
+
+typedef struct {
+	xjob_t			function;
+	void			*data;
+	const char		*name;
+	xjobGroup_t		*group;
+} job_t;
+
+typedef struct {
+	SDL_mutex		*lock;
+	job_t			jobs[MAX_QUEUED_JOBS];
+	int				top;		// oldest job, stolen by other threads
+	int				bottom;		// one past the newest job, popped by the owner
+
+	// stats for listJobThreads
+	const char * volatile currentJob;
+	int				jobsRun;
+	int				jobsStolen;
+} jobQueue_t;
+
+static jobQueue_t		jobQueues[MAX_JOB_QUEUES];
+
+static xthreadInfo		workerThread[MAX_WORKER_THREADS] = { };
+static SDL_threadID		workerThreadId[MAX_WORKER_THREADS] = { };
+static char				workerName[MAX_WORKER_THREADS][16];
+static int				worker_count = 0;
+
+static bool				workerShutdown = false;
+static int				queuedJobs = 0;
+static int				sleepingThreads = 0;
+
+static void Sys_FinishJob(xjobGroup_t *group);
+
+/*
+==================
+Sys_InitJobQueues
+==================
+*/
+static bool Sys_InitJobQueues() {
+	for (int i = 0; i < MAX_JOB_QUEUES; i++) {
+		memset(&jobQueues[i], 0, sizeof(jobQueues[i]));
+		jobQueues[i].lock = SDL_CreateMutex();
+
+		if (!jobQueues[i].lock)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+==================
+Sys_ShutdownJobQueues
+==================
+*/
+static void Sys_ShutdownJobQueues() {
+	for (int i = 0; i < MAX_JOB_QUEUES; i++) {
+		SDL_DestroyMutex(jobQueues[i].lock);
+		jobQueues[i].lock = NULL;
+	}
+}
+
+/*
+==================
+Sys_JobQueueIndex
+queue owned by the calling thread
+==================
+*/
+static int Sys_JobQueueIndex() {
+	SDL_threadID id = SDL_ThreadID();
+
+	for (int i = 0; i < worker_count; i++) {
+		if (workerThreadId[i] == id)
+			return i + 1;
+	}
+
+	return 0;
+}
+
+/*
+==================
+Sys_PushJob
+returns false if the queue is full
+==================
+*/
+static bool Sys_PushJob(int queueIndex, const job_t &job) {
+	jobQueue_t &queue = jobQueues[queueIndex];
+
+	SDL_LockMutex(queue.lock);
+
+	if (queue.bottom - queue.top >= MAX_QUEUED_JOBS) {
+		SDL_UnlockMutex(queue.lock);
+		return false;
+	}
+
+	queue.jobs[queue.bottom & (MAX_QUEUED_JOBS - 1)] = job;
+	queue.bottom++;
+
+	SDL_UnlockMutex(queue.lock);
+
+	return true;
+}
+
+/*
+==================
+Sys_TakeJob
+pops the newest job from our own queue, or steals the oldest one from another queue
+==================
+*/
+static bool Sys_TakeJob(int queueIndex, job_t &job) {
+	jobQueue_t &own = jobQueues[queueIndex];
+
+	SDL_LockMutex(own.lock);
+	if (own.bottom > own.top) {
+		own.bottom--;
+		job = own.jobs[own.bottom & (MAX_QUEUED_JOBS - 1)];
+		SDL_UnlockMutex(own.lock);
+		return true;
+	}
+	SDL_UnlockMutex(own.lock);
+
+	for (int i = 1; i <= worker_count; i++) {
+		jobQueue_t &victim = jobQueues[(queueIndex + i) % (worker_count + 1)];
+
+		SDL_LockMutex(victim.lock);
+		if (victim.bottom > victim.top) {
+			job = victim.jobs[victim.top & (MAX_QUEUED_JOBS - 1)];
+			victim.top++;
+			SDL_UnlockMutex(victim.lock);
+			own.jobsStolen++;
+			return true;
+		}
+		SDL_UnlockMutex(victim.lock);
+	}
+
+	return false;
+}
+
+/*
+==================
+Sys_QueueJob
+workerMutex must be held
+==================
+*/
+static void Sys_QueueJob(const job_t &job) {
+	job.group->pending++;
+
+	if (Sys_PushJob(Sys_JobQueueIndex(), job) || Sys_PushJob(0, job)) {
+		queuedJobs++;
+
+		if (sleepingThreads)
+			SDL_CondBroadcast(workerWake);
+		return;
+	}
+
+	// all queues are full, just run it right here
+	job.group->pending--;
+
+	SDL_UnlockMutex(workerMutex);
+	job.function(job.data);
+	SDL_LockMutex(workerMutex);
+
+	job.group->pending++;
+	Sys_FinishJob(job.group);
+}
+
+/*
+==================
+Sys_FinishJob
+workerMutex must be held
+==================
+*/
+static void Sys_FinishJob(xjobGroup_t *group) {
+	assert(group->pending > 0);
+
+	if (--group->pending > 0)
+		return;
+
+	if (group->continuation) {
+		job_t next;
+
+		next.function = group->continuation;
+		next.data = group->continuationData;
+		next.name = group->continuationName;
+		next.group = group;
+
+		group->continuation = NULL;
+		group->continuationData = NULL;
+		group->continuationName = NULL;
+
+		Sys_QueueJob(next);
+		return;
+	}
+
+	// wake up anyone in Sys_WaitJobGroup
+	if (sleepingThreads)
+		SDL_CondBroadcast(workerWake);
+}
+
+/*
+==================
+Sys_RunOneJob
+returns false if there was nothing to do
+==================
+*/
+static bool Sys_RunOneJob(int queueIndex) {
+	job_t job;
+
+	if (!Sys_TakeJob(queueIndex, job))
+		return false;
+
+	SDL_LockMutex(workerMutex);
+	queuedJobs--;
+	SDL_UnlockMutex(workerMutex);
+
+	jobQueue_t &queue = jobQueues[queueIndex];
+
+	queue.currentJob = job.name;
+	job.function(job.data);
+	queue.currentJob = NULL;
+	queue.jobsRun++;
+
+	SDL_LockMutex(workerMutex);
+	Sys_FinishJob(job.group);
+	SDL_UnlockMutex(workerMutex);
+
+	return true;
+}
+
+/*
+==================
+Sys_WorkerThread
+==================
+*/
+static int Sys_WorkerThread(void *parms) {
+	int index = (int)(intptr_t)parms;
+
+	workerThreadId[index] = SDL_ThreadID();
+
+	SDL_LockMutex(workerMutex);
+
+	while (!workerShutdown || queuedJobs > 0) {
+		if (queuedJobs <= 0) {
+			sleepingThreads++;
+			SDL_CondWait(workerWake, workerMutex);
+			sleepingThreads--;
+			continue;
+		}
+
+		SDL_UnlockMutex(workerMutex);
+		Sys_RunOneJob(index + 1);
+		SDL_LockMutex(workerMutex);
+	}
+
+	SDL_UnlockMutex(workerMutex);
+
+	return 0;
+}
+
+/*
+==================
+Sys_StopWorkerThreads
+runs whatever is still queued, then stops the workers
+==================
+*/
+static void Sys_StopWorkerThreads() {
+	if (!worker_count)
+		return;
+
+	SDL_LockMutex(workerMutex);
+	workerShutdown = true;
+	SDL_CondBroadcast(workerWake);
+	SDL_UnlockMutex(workerMutex);
+
+	for (int i = 0; i < worker_count; i++) {
+		Sys_DestroyThread(workerThread[i]);
+		workerThreadId[i] = 0;
+	}
+
+	worker_count = 0;
+	workerShutdown = false;
+}
+
+/*
+==================
+Sys_StartWorkerThreads
+==================
+*/
+void Sys_StartWorkerThreads(int numThreads) {
+	assert(Sys_IsMainThread());
+
+	if (numThreads < 0) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		// one per core, the main thread takes the last one
+		numThreads = SDL_GetCPUCount() - 1;
+#else
+		numThreads = 0;
+#endif
+	}
+
+	numThreads = idMath::ClampInt(0, MAX_WORKER_THREADS, numThreads);
+	if (numThreads == worker_count || !workerMutex)
+		return;
+
+	Sys_StopWorkerThreads();
+
+	for (int i = 0; i < MAX_JOB_QUEUES; i++) {
+		jobQueues[i].jobsRun = 0;
+		jobQueues[i].jobsStolen = 0;
+	}
+
+	// worker_count is only raised once the thread is running, so the
+	// stealing loops never look at a queue without an owner
+	for (int i = 0; i < numThreads; i++) {
+		idStr::snPrintf(workerName[i], sizeof(workerName[i]), "worker%d", i);
+		Sys_CreateThread(Sys_WorkerThread, (void *)(intptr_t)i, workerThread[i], workerName[i]);
+		if (!workerThread[i].threadHandle)
+			break;
+
+		SDL_LockMutex(workerMutex);
+		worker_count++;
+		SDL_UnlockMutex(workerMutex);
+	}
+
+	common->Printf("Started %d job worker threads\n", worker_count);
+}
+
+/*
+==================
+Sys_NumWorkerThreads
+==================
+*/
+int Sys_NumWorkerThreads() {
+	return worker_count;
+}
+
+/*
+==================
+Sys_InitJobGroup
+==================
+*/
+void Sys_InitJobGroup(xjobGroup_t &group, const char *name) {
+	group.name = name;
+	group.pending = 0;
+	group.continuation = NULL;
+	group.continuationData = NULL;
+	group.continuationName = NULL;
+}
+
+/*
+==================
+Sys_SubmitJob
+==================
+*/
+void Sys_SubmitJob(xjobGroup_t &group, xjob_t function, void *data, const char *name) {
+	job_t job;
+
+	job.function = function;
+	job.data = data;
+	job.name = name ? name : group.name;
+	job.group = &group;
+
+	SDL_LockMutex(workerMutex);
+	Sys_QueueJob(job);
+	SDL_UnlockMutex(workerMutex);
+}
+
+/*
+==================
+Sys_SetJobContinuation
+==================
+*/
+void Sys_SetJobContinuation(xjobGroup_t &group, xjob_t function, void *data, const char *name) {
+	SDL_LockMutex(workerMutex);
+
+	assert(!group.continuation);
+
+	if (group.pending > 0) {
+		group.continuation = function;
+		group.continuationData = data;
+		group.continuationName = name ? name : group.name;
+	} else {
+		// everything is done already, so it's simply the next job
+		job_t job;
+
+		job.function = function;
+		job.data = data;
+		job.name = name ? name : group.name;
+		job.group = &group;
+
+		Sys_QueueJob(job);
+	}
+
+	SDL_UnlockMutex(workerMutex);
+}
+
+/*
+==================
+Sys_WaitJobGroup
+helps out with queued jobs until every job of the group and its continuation are done
+==================
+*/
+void Sys_WaitJobGroup(xjobGroup_t &group) {
+	int queueIndex = Sys_JobQueueIndex();
+
+	SDL_LockMutex(workerMutex);
+
+	while (group.pending > 0) {
+		if (queuedJobs > 0) {
+			SDL_UnlockMutex(workerMutex);
+			Sys_RunOneJob(queueIndex);
+			SDL_LockMutex(workerMutex);
+			continue;
+		}
+
+		sleepingThreads++;
+		SDL_CondWait(workerWake, workerMutex);
+		sleepingThreads--;
+	}
+
+	SDL_UnlockMutex(workerMutex);
+}
+
+/*
+==================
+Sys_JobGroupFinished
+==================
+*/
+bool Sys_JobGroupFinished(xjobGroup_t &group) {
+	SDL_LockMutex(workerMutex);
+	bool finished = group.pending == 0;
+	SDL_UnlockMutex(workerMutex);
+
+	return finished;
+}
+
+/*
+==================
+Sys_PrintJobThreads
+==================
+*/
+void Sys_PrintJobThreads() {
+	common->Printf("%d job worker threads, %d jobs queued\n", worker_count, queuedJobs);
+
+	for (int i = 0; i <= worker_count; i++) {
+		const jobQueue_t &queue = jobQueues[i];
+		const char *current = queue.currentJob;
+
+		common->Printf("%-10s %8d run %8d stolen  %s\n", i ? workerName[i - 1] : "other",
+					   queue.jobsRun, queue.jobsStolen, current ? current : "<idle>");
+	}
+}
+
+/*
+==================
+Sys_ParallelFor
+==================
+*/
+typedef struct {
+	xparallelJob_t	function;
+	void			*data;
+	int				start;
+	int				end;
+} parallelForChunk_t;
+
+static void Sys_ParallelForJob(void *data) {
+	parallelForChunk_t *chunk = (parallelForChunk_t *)data;
+
+	for (int i = chunk->start; i < chunk->end; i++)
+		chunk->function(chunk->data, i);
+}
+
+void Sys_ParallelFor(xparallelJob_t function, void *data, int count, const char *name) {
+	if (count <= 0)
+		return;
+
+	if (!worker_count || count == 1) {
+		for (int i = 0; i < count; i++)
+			function(data, i);
+		return;
+	}
+
+	// a few chunks per thread so uneven work still balances out
+	int numChunks = Min(count, Min((worker_count + 1) * 4, MAX_PARALLEL_FOR_CHUNKS));
+	parallelForChunk_t chunks[MAX_PARALLEL_FOR_CHUNKS];
+	xjobGroup_t group;
+
+	Sys_InitJobGroup(group, name);
+
+	for (int i = 0; i < numChunks; i++) {
+		chunks[i].function = function;
+		chunks[i].data = data;
+		chunks[i].start = (int)((long long)count * i / numChunks);
+		chunks[i].end = (int)((long long)count * (i + 1) / numChunks);
+
+		Sys_SubmitJob(group, Sys_ParallelForJob, &chunks[i], name);
+	}
+
+	Sys_WaitJobGroup(group);
+}
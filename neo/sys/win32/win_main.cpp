@@ -317,6 +317,51 @@ ID_TIME_T Sys_FileTimeStamp( FILE *fp ) {
 	return (long) st.st_mtime;
 }
 
+/*
+=================
+Sys_MapFile
+=================
+*/
+const void *Sys_MapFile( const char *path, int *size ) {
+	HANDLE file, mapping;
+	LARGE_INTEGER fileSize;
+	void *data;
+
+	*size = 0;
+	file = CreateFile( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return NULL;
+	}
+	if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart <= 0 || fileSize.QuadPart > INT_MAX ) {
+		CloseHandle( file );
+		return NULL;
+	}
+	mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( file );
+	if ( !mapping ) {
+		return NULL;
+	}
+	// the view keeps the mapping referenced
+	data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( mapping );
+	if ( !data ) {
+		return NULL;
+	}
+	*size = (int)fileSize.QuadPart;
+	return data;
+}
+
+/*
+=================
+Sys_UnmapFile
+=================
+*/
+void Sys_UnmapFile( const void *data, int size ) {
+	if ( data ) {
+		UnmapViewOfFile( data );
+	}
+}
+
 /*
 ==============
 Sys_Cwd
@@ -47,7 +47,12 @@ idAASBuild::idAASBuild
 ============
 */
 idAASBuild::idAASBuild( void ) {
+	aasSettings = NULL;
 	file = NULL;
+	mapFile = NULL;
+	leakBSP = NULL;
+	phaseStartTime = 0;
+	memset( phaseMsec, 0, sizeof( phaseMsec ) );
 	procNodes = NULL;
 	numProcNodes = 0;
 	numGravitationalSubdivisions = 0;
@@ -76,6 +81,16 @@ void idAASBuild::Shutdown( void ) {
 		delete file;
 		file = NULL;
 	}
+	if ( mapFile ) {
+		delete mapFile;
+		mapFile = NULL;
+	}
+	mapBrushes.Free();
+	entityClassNames.Clear();
+	if ( leakBSP ) {
+		delete leakBSP;
+		leakBSP = NULL;
+	}
 	DeleteProcBSP();
 	numGravitationalSubdivisions = 0;
 	numMergedLeafNodes = 0;
@@ -293,7 +308,7 @@ void idAASBuild::ClipBrushSidesWithProcBSP( idBrushList &brushList ) {
 		}
 	}
 
-	common->Printf( "%6d brush sides clipped\n", clippedSides );
+	AASPrintf( "%6d brush sides clipped\n", clippedSides );
 }
 
 /*
@@ -548,7 +563,7 @@ idAASBuild::AddBrushesForMapFile
 idBrushList idAASBuild::AddBrushesForMapFile( const idMapFile * mapFile, idBrushList brushList ) {
 	int i;
 
-	common->Printf( "[Brush Load]\n" );
+	AASPrintf( "[Brush Load]\n" );
 
 	brushList = AddBrushesForMapEntity( mapFile->GetEntity( 0 ), 0, brushList );
 
@@ -560,7 +575,7 @@ idBrushList idAASBuild::AddBrushesForMapFile( const idMapFile * mapFile, idBrush
 		}
 	}
 
-	common->Printf( "%6d brushes\n", brushList.Num() );
+	AASPrintf( "%6d brushes\n", brushList.Num() );
 
 	return brushList;
 }
@@ -633,28 +648,64 @@ void idAASBuild::ChangeMultipleBoundingBoxContents_r( idBrushBSPNode *node, int
 	}
 }
 
+static const char *aasBuildPhaseNames[AAS_NUM_PHASES] = {
+	"map loading",
+	"bsp",
+	"subdivision",
+	"storing file",
+	"reachability",
+	"clusters",
+	"optimizing",
+	"writing file"
+};
+
 /*
 ============
-idAASBuild::Build
+idAASBuild::EndPhase
+
+  adds the time since the last phase ended to the phase
 ============
 */
-bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
-	int i, bit, mask, startTime;
-	idMapFile * mapFile;
-	idBrushList brushList;
-	idList<idBrushList*> expandedBrushes;
-	idBrush *b;
-	idBrushBSP bsp;
-	idStr name;
-	idAASReach reach;
-	idAASCluster cluster;
-	idStrList entityClassNames;
+void idAASBuild::EndPhase( aasBuildPhase_t phase ) {
+	int time = Sys_Milliseconds();
+	phaseMsec[phase] += time - phaseStartTime;
+	phaseStartTime = time;
+}
 
-	startTime = Sys_Milliseconds();
+/*
+============
+idAASBuild::PrintPhaseTimes
+============
+*/
+void idAASBuild::PrintPhaseTimes( void ) const {
+	int i, total;
+
+	total = 0;
+	for ( i = 0; i < AAS_NUM_PHASES; i++ ) {
+		AASPrintf( "%7.2f seconds for %s\n", phaseMsec[i] * 0.001f, aasBuildPhaseNames[i] );
+		total += phaseMsec[i];
+	}
+	AASPrintf( "%6d seconds to create AAS\n", total / 1000 );
+}
+
+/*
+============
+idAASBuild::LoadMap
+
+  loads everything that needs the file system and the decls, returns true
+  without a map when there are no entities that use the AAS file
+============
+*/
+bool idAASBuild::LoadMap( const idStr &fileName, const idAASSettings *settings ) {
+	idStr name;
 
 	Shutdown();
 
+	memset( phaseMsec, 0, sizeof( phaseMsec ) );
+	phaseStartTime = Sys_Milliseconds();
+
 	aasSettings = settings;
+	mapFileName = fileName;
 
 	name = fileName;
 	name.SetFileExtension( "map" );
@@ -662,6 +713,7 @@ bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
 	mapFile = new idMapFile;
 	if ( !mapFile->Parse( name ) ) {
 		delete mapFile;
+		mapFile = NULL;
 		common->Error( "Couldn't load map file: '%s'", name.c_str() );
 		return false;
 	}
@@ -669,29 +721,63 @@ bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
 	// check if this map has any entities that use this AAS file
 	if ( !CheckForEntities( mapFile, entityClassNames ) ) {
 		delete mapFile;
+		mapFile = NULL;
 		common->Printf( "no entities in map that use %s\n", settings->fileExtension.c_str() );
 		return true;
 	}
 
 	// load map file brushes
-	brushList = AddBrushesForMapFile( mapFile, brushList );
+	mapBrushes = AddBrushesForMapFile( mapFile, mapBrushes );
 
 	// if empty map
-	if ( brushList.Num() == 0 ) {
+	if ( mapBrushes.Num() == 0 ) {
 		delete mapFile;
+		mapFile = NULL;
 		common->Error( "%s is empty", name.c_str() );
 		return false;
 	}
 
 	// merge as many brushes as possible before expansion
-	brushList.Merge( MergeAllowed );
+	mapBrushes.Merge( MergeAllowed );
 
 	// if there is a .proc file newer than the .map file
 	if ( LoadProcBSP( fileName, mapFile->GetFileTime() ) ) {
-		ClipBrushSidesWithProcBSP( brushList );
+		ClipBrushSidesWithProcBSP( mapBrushes );
 		DeleteProcBSP();
 	}
 
+	EndPhase( AAS_PHASE_LOAD );
+
+	return true;
+}
+
+/*
+============
+idAASBuild::Compile
+
+  only touches the build itself so the different bounding boxes can be
+  compiled at the same time, unless a brush map is written
+============
+*/
+bool idAASBuild::Compile( void ) {
+	int i, bit, mask;
+	idBrushList brushList;
+	idList<idBrushList*> expandedBrushes;
+	idBrush *b;
+	idBrushBSP *bsp;
+	idAASReach reach;
+	idAASCluster cluster;
+
+	if ( !mapFile ) {
+		return true;
+	}
+
+	phaseStartTime = Sys_Milliseconds();
+
+	// the bsp takes ownership of the brushes
+	brushList = mapBrushes;
+	mapBrushes.Clear();
+
 	// make copies of the brush list
 	expandedBrushes.Append( &brushList );
 	for ( i = 1; i < aasSettings->numBoundingBoxes; i++ ) {
@@ -715,79 +801,141 @@ bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
 		delete expandedBrushes[i];
 	}
 
+	bsp = new idBrushBSP;
+
 	if ( aasSettings->writeBrushMap ) {
-		bsp.WriteBrushMap( fileName, "_" + aasSettings->fileExtension, AREACONTENTS_SOLID );
+		bsp->WriteBrushMap( mapFileName, "_" + aasSettings->fileExtension, AREACONTENTS_SOLID );
 	}
 
 	// build BSP tree from brushes
-	bsp.Build( brushList, AREACONTENTS_SOLID, ExpandedChopAllowed, ExpandedMergeAllowed );
+	bsp->Build( brushList, AREACONTENTS_SOLID, ExpandedChopAllowed, ExpandedMergeAllowed );
 
 	// only solid nodes with all bits set for all bounding boxes need to stay solid
-	ChangeMultipleBoundingBoxContents_r( bsp.GetRootNode(), mask );
+	ChangeMultipleBoundingBoxContents_r( bsp->GetRootNode(), mask );
 
 	// portalize the bsp tree
-	bsp.Portalize();
+	bsp->Portalize();
 
 	// remove subspaces not reachable by entities
-	if ( !bsp.RemoveOutside( mapFile, AREACONTENTS_SOLID, entityClassNames ) ) {
-		bsp.LeakFile( name );
-		delete mapFile;
-		common->Printf( "%s has no outside", name.c_str() );
+	if ( !bsp->RemoveOutside( mapFile, AREACONTENTS_SOLID, entityClassNames ) ) {
+		// the leak file is written with the AAS file
+		leakBSP = bsp;
+		EndPhase( AAS_PHASE_BSP );
 		return false;
 	}
 
+	EndPhase( AAS_PHASE_BSP );
+
 	// gravitational subdivision
-	GravitationalSubdivision( bsp );
+	GravitationalSubdivision( *bsp );
 
 	// merge portals where possible
-	bsp.MergePortals( AREACONTENTS_SOLID );
+	bsp->MergePortals( AREACONTENTS_SOLID );
 
 	// melt portal windings
-	bsp.MeltPortals( AREACONTENTS_SOLID );
+	bsp->MeltPortals( AREACONTENTS_SOLID );
 
 	if ( aasSettings->writeBrushMap ) {
-		WriteLedgeMap( fileName, "_" + aasSettings->fileExtension + "_ledge" );
+		WriteLedgeMap( mapFileName, "_" + aasSettings->fileExtension + "_ledge" );
 	}
 
 	// ledge subdivisions
-	LedgeSubdivision( bsp );
+	LedgeSubdivision( *bsp );
 
 	// merge leaf nodes
-	MergeLeafNodes( bsp );
+	MergeLeafNodes( *bsp );
 
 	// merge portals where possible
-	bsp.MergePortals( AREACONTENTS_SOLID );
+	bsp->MergePortals( AREACONTENTS_SOLID );
 
 	// melt portal windings
-	bsp.MeltPortals( AREACONTENTS_SOLID );
+	bsp->MeltPortals( AREACONTENTS_SOLID );
+
+	EndPhase( AAS_PHASE_SUBDIVISION );
 
 	// store the file from the bsp tree
-	StoreFile( bsp );
+	StoreFile( *bsp );
 	file->settings = *aasSettings;
 
+	delete bsp;
+
+	EndPhase( AAS_PHASE_STORE );
+
 	// calculate reachability
 	reach.Build( mapFile, file );
 
+	EndPhase( AAS_PHASE_REACHABILITY );
+
 	// build clusters
 	cluster.Build( file );
 
+	EndPhase( AAS_PHASE_CLUSTERS );
+
 	// optimize the file
 	if ( !aasSettings->noOptimize ) {
 		file->Optimize();
 	}
 
+	EndPhase( AAS_PHASE_OPTIMIZE );
+
+	return true;
+}
+
+/*
+============
+idAASBuild::WriteFile
+============
+*/
+bool idAASBuild::WriteFile( void ) {
+	idStr name;
+
+	if ( !mapFile ) {
+		return true;
+	}
+
+	phaseStartTime = Sys_Milliseconds();
+
+	name = mapFileName;
+	name.SetFileExtension( "map" );
+
+	if ( leakBSP ) {
+		leakBSP->LeakFile( name );
+		delete leakBSP;
+		leakBSP = NULL;
+		delete mapFile;
+		mapFile = NULL;
+		common->Printf( "%s has no outside", name.c_str() );
+		return false;
+	}
+
 	// write the file
 	name.SetFileExtension( aasSettings->fileExtension );
 	file->Write( name, mapFile->GetGeometryCRC() );
 
 	// delete the map file
 	delete mapFile;
+	mapFile = NULL;
+
+	EndPhase( AAS_PHASE_WRITE );
 
-	common->Printf( "%6d seconds to create AAS\n", (Sys_Milliseconds() - startTime) / 1000 );
+	PrintPhaseTimes();
 
 	return true;
 }
 
+/*
+============
+idAASBuild::Build
+============
+*/
+bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
+	if ( !LoadMap( fileName, settings ) ) {
+		return false;
+	}
+	Compile();
+	return WriteFile();
+}
+
 /*
 ============
 idAASBuild::BuildReachability
@@ -837,7 +985,7 @@ bool idAASBuild::BuildReachability( const idStr &fileName, const idAASSettings *
 	// delete the map file
 	delete mapFile;
 
-	common->Printf( "%6d seconds to calculate reachability\n", (Sys_Milliseconds() - startTime) / 1000 );
+	AASPrintf( "%6d seconds to calculate reachability\n", (Sys_Milliseconds() - startTime) / 1000 );
 
 	return true;
 }
@@ -873,6 +1021,87 @@ int ParseOptions( const idCmdArgs &args, idAASSettings &settings ) {
 	return args.Argc() - 1;
 }
 
+typedef struct aasBuildJob_s {
+	idAASBuild				build;
+	idStr					log;
+	idStr					error;
+} aasBuildJob_t;
+
+/*
+============
+CompileAASJob
+============
+*/
+static void CompileAASJob( void *data, int index ) {
+	aasBuildJob_t *job = &static_cast<aasBuildJob_t *>( data )[index];
+
+	// other jobs can run on this thread while it waits for a job group
+	idStr *oldLog = AASSetThreadLog( &job->log );
+	try {
+		job->build.Compile();
+	} catch ( idException &ex ) {
+		job->error = ex.error;
+	}
+	AASSetThreadLog( oldLog );
+}
+
+/*
+============
+BuildAASFiles
+
+  builds the AAS files for all the bounding box settings of a map, the files
+  are compiled at the same time and their output is printed one after the other
+============
+*/
+static void BuildAASFiles( const idStr &mapName, const idList<idAASSettings> &settings ) {
+	int i;
+	bool parallel;
+	aasBuildJob_t *jobs;
+
+	// brush maps are written while compiling
+	parallel = true;
+	for ( i = 0; i < settings.Num(); i++ ) {
+		if ( settings[i].writeBrushMap ) {
+			parallel = false;
+		}
+	}
+
+	if ( !parallel || settings.Num() < 2 ) {
+		idAASBuild aas;
+
+		for ( i = 0; i < settings.Num(); i++ ) {
+			if ( i ) {
+				common->Printf( "=======================================================\n" );
+			}
+			aas.Build( mapName, &settings[i] );
+		}
+		return;
+	}
+
+	jobs = new aasBuildJob_t[settings.Num()];
+
+	for ( i = 0; i < settings.Num(); i++ ) {
+		jobs[i].build.LoadMap( mapName, &settings[i] );
+	}
+
+	Sys_ParallelFor( CompileAASJob, jobs, settings.Num(), "CompileAAS" );
+
+	for ( i = 0; i < settings.Num(); i++ ) {
+		if ( i ) {
+			common->Printf( "=======================================================\n" );
+		}
+		AASPrintLog( jobs[i].log );
+		if ( jobs[i].error.Length() ) {
+			idStr error = jobs[i].error;
+			delete[] jobs;
+			common->Error( "%s", error.c_str() );
+		}
+		jobs[i].build.WriteFile();
+	}
+
+	delete[] jobs;
+}
+
 /*
 ============
 RunAAS_f
@@ -880,8 +1109,7 @@ RunAAS_f
 */
 void RunAAS_f( const idCmdArgs &args ) {
 	int i;
-	idAASBuild aas;
-	idAASSettings settings;
+	idList<idAASSettings> settings;
 	idStr mapName;
 
 	if ( args.Argc() <= 1 ) {
@@ -903,27 +1131,27 @@ void RunAAS_f( const idCmdArgs &args ) {
 		common->Error( "Unable to find entityDef for 'aas_types'" );
 	}
 
+	i = args.Argc() - 1;
 	const idKeyValue *kv = dict->MatchPrefix( "type" );
 	while( kv != NULL ) {
 		const idDict *settingsDict = gameEdit->FindEntityDefDict( kv->GetValue(), false );
 		if ( !settingsDict ) {
 			common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
 		} else {
-			settings.FromDict( kv->GetValue(), settingsDict );
-			i = ParseOptions( args, settings );
-			mapName = args.Argv(i);
-			mapName.BackSlashesToSlashes();
-			if ( mapName.Icmpn( "maps/", 4 ) != 0 ) {
-				mapName = "maps/" + mapName;
-			}
-			aas.Build( mapName, &settings );
+			idAASSettings &typeSettings = settings.Alloc();
+			typeSettings.FromDict( kv->GetValue(), settingsDict );
+			i = ParseOptions( args, typeSettings );
 		}
-
 		kv = dict->MatchPrefix( "type", kv );
-		if ( kv ) {
-			common->Printf( "=======================================================\n" );
-		}
 	}
+
+	mapName = args.Argv(i);
+	mapName.BackSlashesToSlashes();
+	if ( mapName.Icmpn( "maps/", 4 ) != 0 ) {
+		mapName = "maps/" + mapName;
+	}
+	BuildAASFiles( mapName, settings );
+
 	common->SetRefreshOnPrint( false );
 	common->PrintWarnings();
 }
@@ -935,8 +1163,7 @@ RunAASDir_f
 */
 void RunAASDir_f( const idCmdArgs &args ) {
 	int i;
-	idAASBuild aas;
-	idAASSettings settings;
+	idList<idAASSettings> settings;
 	idFileList *mapFiles;
 
 	if ( args.Argc() <= 1 ) {
@@ -954,6 +1181,17 @@ void RunAASDir_f( const idCmdArgs &args ) {
 		common->Error( "Unable to find entityDef for 'aas_types'" );
 	}
 
+	const idKeyValue *kv = dict->MatchPrefix( "type" );
+	while( kv != NULL ) {
+		const idDict *settingsDict = gameEdit->FindEntityDefDict( kv->GetValue(), false );
+		if ( !settingsDict ) {
+			common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
+		} else {
+			settings.Alloc().FromDict( kv->GetValue(), settingsDict );
+		}
+		kv = dict->MatchPrefix( "type", kv );
+	}
+
 	// scan for .map files
 	mapFiles = fileSystem->ListFiles( idStr("maps/") + args.Argv(1), ".map" );
 
@@ -962,22 +1200,7 @@ void RunAASDir_f( const idCmdArgs &args ) {
 		if ( i ) {
 			common->Printf( "=======================================================\n" );
 		}
-
-		const idKeyValue *kv = dict->MatchPrefix( "type" );
-		while( kv != NULL ) {
-			const idDict *settingsDict = gameEdit->FindEntityDefDict( kv->GetValue(), false );
-			if ( !settingsDict ) {
-				common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
-			} else {
-				settings.FromDict( kv->GetValue(), settingsDict );
-				aas.Build( idStr( "maps/" ) + args.Argv( 1 ) + "/" + mapFiles->GetFile( i ), &settings );
-			}
-
-			kv = dict->MatchPrefix( "type", kv );
-			if ( kv ) {
-				common->Printf( "=======================================================\n" );
-			}
-		}
+		BuildAASFiles( idStr( "maps/" ) + args.Argv( 1 ) + "/" + mapFiles->GetFile( i ), settings );
 	}
 
 	fileSystem->FreeFileList( mapFiles );
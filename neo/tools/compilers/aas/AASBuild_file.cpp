@@ -41,10 +41,11 @@ If you have questions concerning this license or the applicable additional terms
 #define AAS_PLANE_DIST_EPSILON			0.01f
 
 
-idHashIndex *aas_vertexHash;
-idHashIndex *aas_edgeHash;
-idBounds aas_vertexBounds;
-int aas_vertexShift;
+// the AAS files for the different bounding boxes are stored in parallel
+static thread_local idHashIndex *aas_vertexHash;
+static thread_local idHashIndex *aas_edgeHash;
+static thread_local idBounds aas_vertexBounds;
+static thread_local int aas_vertexShift;
 
 /*
 ================
@@ -460,7 +461,7 @@ bool idAASBuild::StoreFile( const idBrushBSP &bsp ) {
 	aasArea_t area;
 	aasNode_t node;
 
-	common->Printf( "[Store AAS]\n" );
+	AASPrintf( "[Store AAS]\n" );
 
 	SetupHash();
 	ClearHash( bsp.GetTreeBounds() );
@@ -495,7 +496,7 @@ bool idAASBuild::StoreFile( const idBrushBSP &bsp ) {
 
 	ShutdownHash();
 
-	common->Printf( "\r%6d areas\n", file->areas.Num() );
+	AASPrintf( "\r%6d areas\n", file->areas.Num() );
 
 	return true;
 }
@@ -348,10 +348,10 @@ idAASBuild::GravitationalSubdivision
 void idAASBuild::GravitationalSubdivision( idBrushBSP &bsp ) {
 	numGravitationalSubdivisions = 0;
 
-	common->Printf( "[Gravitational Subdivision]\n" );
+	AASPrintf( "[Gravitational Subdivision]\n" );
 
 	SetPortalFlags_r( bsp.GetRootNode() );
 	GravSubdiv_r( bsp.GetRootNode() );
 
-	common->Printf( "\r%6d subdivisions\n", numGravitationalSubdivisions );
+	AASPrintf( "\r%6d subdivisions\n", numGravitationalSubdivisions );
 }
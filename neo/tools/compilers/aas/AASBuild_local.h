@@ -70,6 +70,19 @@ public:
 };
 
 
+typedef enum {
+	AAS_PHASE_LOAD,
+	AAS_PHASE_BSP,
+	AAS_PHASE_SUBDIVISION,
+	AAS_PHASE_STORE,
+	AAS_PHASE_REACHABILITY,
+	AAS_PHASE_CLUSTERS,
+	AAS_PHASE_OPTIMIZE,
+	AAS_PHASE_WRITE,
+	AAS_NUM_PHASES
+} aasBuildPhase_t;
+
+
 class idAASBuild {
 
 public:
@@ -79,9 +92,22 @@ public:
 	bool					BuildReachability( const idStr &fileName, const idAASSettings *settings );
 	void					Shutdown( void );
 
+							// Build split up so the files for several bounding boxes can be compiled
+							// at the same time, only Compile may be run on another thread
+	bool					LoadMap( const idStr &fileName, const idAASSettings *settings );
+	bool					Compile( void );
+	bool					WriteFile( void );
+
 private:
 	const idAASSettings *	aasSettings;
 	idAASFileLocal *		file;
+	idStr					mapFileName;
+	idMapFile *				mapFile;
+	idBrushList				mapBrushes;
+	idStrList				entityClassNames;
+	idBrushBSP *			leakBSP;
+	int						phaseStartTime;
+	int						phaseMsec[AAS_NUM_PHASES];
 	aasProcNode_t *			procNodes;
 	int						numProcNodes;
 	int						numGravitationalSubdivisions;
@@ -90,6 +116,10 @@ private:
 	idList<idLedge>			ledgeList;
 	idBrushMap *			ledgeMap;
 
+private:
+	void					EndPhase( aasBuildPhase_t phase );
+	void					PrintPhaseTimes( void ) const;
+
 private:	// map loading
 	void					ParseProcNodes( idLexer *src );
 	bool					LoadProcBSP( const char *name, ID_TIME_T minFileTime );
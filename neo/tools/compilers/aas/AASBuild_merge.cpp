@@ -152,11 +152,11 @@ idAASBuild::MergeLeafNodes
 void idAASBuild::MergeLeafNodes( idBrushBSP &bsp ) {
 	numMergedLeafNodes = 0;
 
-	common->Printf( "[Merge Leaf Nodes]\n" );
+	AASPrintf( "[Merge Leaf Nodes]\n" );
 
 	MergeLeafNodes_r( bsp, bsp.GetRootNode() );
 	bsp.GetRootNode()->RemoveFlagRecurse( NODE_DONE );
 	bsp.PruneMergedTree_r( bsp.GetRootNode() );
 
-	common->Printf( "\r%6d leaf nodes merged\n", numMergedLeafNodes );
+	AASPrintf( "\r%6d leaf nodes merged\n", numMergedLeafNodes );
 }
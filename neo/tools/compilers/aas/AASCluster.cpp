@@ -48,7 +48,7 @@ bool idAASCluster::UpdatePortal( int areaNum, int clusterNum ) {
 	}
 
 	if ( portalNum >= file->portals.Num() ) {
-		common->Error( "no portal for area %d", areaNum );
+		AASError( "no portal for area %d", areaNum );
 		return true;
 	}
 
@@ -105,7 +105,7 @@ bool idAASCluster::FloodClusterAreas_r( int areaNum, int clusterNum ) {
 			return true;
 		}
 		// there's a reachability going from one cluster to another only in one direction
-		common->Error( "cluster %d touched cluster %d at area %d\r\n", clusterNum, file->areas[areaNum].cluster, areaNum );
+		AASError( "cluster %d touched cluster %d at area %d\r\n", clusterNum, file->areas[areaNum].cluster, areaNum );
 		return false;
 	}
 
@@ -248,6 +248,15 @@ void idAASCluster::NumberClusterAreas( int clusterNum ) {
 	}
 }
 
+/*
+================
+idAASCluster::NumberClusterAreasJob
+================
+*/
+void idAASCluster::NumberClusterAreasJob( void *data, int index ) {
+	static_cast<idAASCluster *>( data )->NumberClusterAreas( index + 1 );
+}
+
 /*
 ================
 idAASCluster::FindClusters
@@ -288,10 +297,12 @@ bool idAASCluster::FindClusters( void ) {
 		if ( !FloodClusterAreas_r( i, clusterNum ) ) {
 			return false;
 		}
-
-		// number the cluster areas
-		NumberClusterAreas( clusterNum );
 	}
+
+	// number the cluster areas, the clusters don't share any areas and each
+	// touches only its own side of a portal so they can be numbered in parallel
+	Sys_ParallelFor( NumberClusterAreasJob, this, file->clusters.Num() - 1, "AASNumberClusterAreas" );
+
 	return true;
 }
 
@@ -452,7 +463,7 @@ void idAASCluster::RemoveInvalidPortals( void ) {
 		}
 	}
 
-	common->Printf( "\r%6d invalid portals removed\n", numInvalidPortals );
+	AASPrintf( "\r%6d invalid portals removed\n", numInvalidPortals );
 }
 
 /*
@@ -462,7 +473,7 @@ idAASCluster::Build
 */
 bool idAASCluster::Build( idAASFileLocal *file ) {
 
-	common->Printf( "[Clustering]\n" );
+	AASPrintf( "[Clustering]\n" );
 
 	this->file = file;
 	this->noFaceFlood = true;
@@ -477,7 +488,7 @@ bool idAASCluster::Build( idAASFileLocal *file ) {
 		// create the portals from the portal areas
 		CreatePortals();
 
-		common->Printf( "\r%6d", file->portals.Num() );
+		AASPrintf( "\r%6d", file->portals.Num() );
 
 		// find the clusters
 		if ( !FindClusters() ) {
@@ -492,11 +503,11 @@ bool idAASCluster::Build( idAASFileLocal *file ) {
 		break;
 	}
 
-	common->Printf( "\r%6d portals\n", file->portals.Num() );
-	common->Printf( "%6d clusters\n", file->clusters.Num() );
+	AASPrintf( "\r%6d portals\n", file->portals.Num() );
+	AASPrintf( "%6d clusters\n", file->clusters.Num() );
 
 	for ( int i = 0; i < file->clusters.Num(); i++ ) {
-		common->Printf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
+		AASPrintf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
 	}
 
 	file->ReportRoutingEfficiency();
@@ -513,7 +524,7 @@ bool idAASCluster::BuildSingleCluster( idAASFileLocal *file ) {
 	int i, numAreas;
 	aasCluster_t cluster;
 
-	common->Printf( "[Clustering]\n" );
+	AASPrintf( "[Clustering]\n" );
 
 	this->file = file;
 
@@ -541,11 +552,11 @@ bool idAASCluster::BuildSingleCluster( idAASFileLocal *file ) {
 	}
 	file->clusters.Append( cluster );
 
-	common->Printf( "%6d portals\n", file->portals.Num() );
-	common->Printf( "%6d clusters\n", file->clusters.Num() );
+	AASPrintf( "%6d portals\n", file->portals.Num() );
+	AASPrintf( "%6d clusters\n", file->clusters.Num() );
 
 	for ( i = 0; i < file->clusters.Num(); i++ ) {
-		common->Printf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
+		AASPrintf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
 	}
 
 	file->ReportRoutingEfficiency();
@@ -54,6 +54,7 @@ private:
 	bool					FloodClusterAreas_r( int areaNum, int clusterNum );
 	void					RemoveAreaClusterNumbers( void );
 	void					NumberClusterAreas( int clusterNum );
+	static void				NumberClusterAreasJob( void *data, int index );
 	bool					FindClusters( void );
 	void					CreatePortals( void );
 	bool					TestPortals( void );
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "framework/DeclEntityDef.h"
 
 #include "tools/compilers/aas/AASFile_local.h"
+#include "tools/compilers/aas/Brush.h"
 
 /*
 ===============================================================================
@@ -1230,9 +1231,9 @@ idAASFileLocal::PrintInfo
 ================
 */
 void idAASFileLocal::PrintInfo( void ) const {
-	common->Printf( "%6d KB file size\n", MemorySize() >> 10 );
-	common->Printf( "%6d areas\n", areas.Num() );
-	common->Printf( "%6d max tree depth\n", MaxTreeDepth() );
+	AASPrintf( "%6d KB file size\n", MemorySize() >> 10 );
+	AASPrintf( "%6d areas\n", areas.Num() );
+	AASPrintf( "%6d max tree depth\n", MaxTreeDepth() );
 	ReportRoutingEfficiency();
 }
 
@@ -1271,9 +1272,9 @@ void idAASFileLocal::ReportRoutingEfficiency( void ) const {
 	}
 	total += numReachableAreas * portals.Num();
 
-	common->Printf( "%6d reachable areas\n", numReachableAreas );
-	common->Printf( "%6d reachabilities\n", NumReachabilities() );
-	common->Printf( "%6d KB max routing cache\n", ( total * 3 ) >> 10 );
+	AASPrintf( "%6d reachable areas\n", numReachableAreas );
+	AASPrintf( "%6d reachabilities\n", NumReachabilities() );
+	AASPrintf( "%6d KB max routing cache\n", ( total * 3 ) >> 10 );
 }
 
 /*
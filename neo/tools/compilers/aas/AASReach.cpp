@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 
+#include "tools/compilers/aas/Brush.h"
 #include "tools/compilers/aas/AASReach.h"
 
 #define INSIDEUNITS							2.0f
@@ -93,7 +94,6 @@ void idAASReach::AddReachabilityToArea( idReachability *reach, int areaNum ) {
 	area = &file->areas[areaNum];
 	reach->next = area->reach;
 	area->reach = reach;
-	numReachabilities++;
 }
 
 /*
@@ -864,44 +864,31 @@ void idAASReach::FlagReachableAreas( idAASFileLocal *file ) {
 		numReachableAreas++;
 	}
 
-	common->Printf( "%6d reachable areas\n", numReachableAreas );
+	AASPrintf( "%6d reachable areas\n", numReachableAreas );
 }
 
 /*
 ================
-idAASReach::Build
+idAASReach::AreaReachabilityJob
+
+  reachabilities are only ever added to and looked up in the list of the area
+  they start in, so every area can be done on its own and the lists come out
+  exactly as when the areas are done one after the other
 ================
 */
-bool idAASReach::Build( const idMapFile *mapFile, idAASFileLocal *file ) {
-	int i, j, lastPercent, percent;
-
-	this->mapFile = mapFile;
-	this->file = file;
-	numReachabilities = 0;
+void idAASReach::AreaReachabilityJob( void *data, int index ) {
+	idAASReach *self = static_cast<idAASReach *>( data );
+	idAASFileLocal *file = self->file;
+	int i, j;
 
-	common->Printf( "[Reachability]\n" );
+	i = index + 1;
 
-	// delete all existing reachabilities
-	file->DeleteReachabilities();
-
-	FlagReachableAreas( file );
+	if ( file->areas[i].flags & AREA_REACHABLE_WALK ) {
 
-	for ( i = 1; i < file->areas.Num(); i++ ) {
-		if ( !( file->areas[i].flags & AREA_REACHABLE_WALK ) ) {
-			continue;
-		}
 		if ( file->GetSettings().allowSwimReachabilities ) {
-			Reachability_Swim( i );
-		}
-		Reachability_EqualFloorHeight( i );
-	}
-
-	lastPercent = -1;
-	for ( i = 1; i < file->areas.Num(); i++ ) {
-
-		if ( !( file->areas[i].flags & AREA_REACHABLE_WALK ) ) {
-			continue;
+			self->Reachability_Swim( i );
 		}
+		self->Reachability_EqualFloorHeight( i );
 
 		for ( j = 0; j < file->areas.Num(); j++ ) {
 			if ( i == j ) {
@@ -912,32 +899,44 @@ bool idAASReach::Build( const idMapFile *mapFile, idAASFileLocal *file ) {
 				continue;
 			}
 
-			if ( ReachabilityExists( i, j ) ) {
+			if ( self->ReachabilityExists( i, j ) ) {
 				continue;
 			}
-			if ( Reachability_Step_Barrier_WaterJump_WalkOffLedge( i, j ) ) {
+			if ( self->Reachability_Step_Barrier_WaterJump_WalkOffLedge( i, j ) ) {
 				continue;
 			}
 		}
 
-		//Reachability_WalkOffLedge( i );
-
-		percent = 100 * i / file->areas.Num();
-		if ( percent > lastPercent ) {
-			common->Printf( "\r%6d%%", percent );
-			lastPercent = percent;
-		}
+		//self->Reachability_WalkOffLedge( i );
 	}
 
 	if ( file->GetSettings().allowFlyReachabilities ) {
-		for ( i = 1; i < file->areas.Num(); i++ ) {
-			Reachability_Fly( i );
-		}
+		self->Reachability_Fly( i );
 	}
+}
+
+/*
+================
+idAASReach::Build
+================
+*/
+bool idAASReach::Build( const idMapFile *mapFile, idAASFileLocal *file ) {
+
+	this->mapFile = mapFile;
+	this->file = file;
+
+	AASPrintf( "[Reachability]\n" );
+
+	// delete all existing reachabilities
+	file->DeleteReachabilities();
+
+	FlagReachableAreas( file );
+
+	Sys_ParallelFor( AreaReachabilityJob, this, file->areas.Num() - 1, "AASReachability" );
 
 	file->LinkReversedReachability();
 
-	common->Printf( "\r%6d reachabilities\n", numReachabilities );
+	AASPrintf( "%6d reachabilities\n", file->NumReachabilities() );
 
 	return true;
 }
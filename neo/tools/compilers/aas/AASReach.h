@@ -48,7 +48,6 @@ public:
 private:
 	const idMapFile *		mapFile;
 	idAASFileLocal *		file;
-	int						numReachabilities;
 	bool					allowSwimReachabilities;
 	bool					allowFlyReachabilities;
 
@@ -64,6 +63,7 @@ private:	// reachability
 	void					Reachability_EqualFloorHeight( int areaNum );
 	bool					Reachability_Step_Barrier_WaterJump_WalkOffLedge( int fromAreaNum, int toAreaNum );
 	void					Reachability_WalkOffLedge( int areaNum );
+	static void				AreaReachabilityJob( void *data, int index );
 
 };
 
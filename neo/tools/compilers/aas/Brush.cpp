@@ -41,6 +41,112 @@ If you have questions concerning this license or the applicable additional terms
 
 //#define OUTPUT_CHOP_STATS
 
+static thread_local idStr *aasThreadLog;
+
+/*
+============
+AASSetThreadLog
+
+  while set, the compiler output of the calling thread is appended to the log
+  instead of going to the console, the log is printed once the thread is done.
+  returns the previous log so it can be restored
+============
+*/
+idStr *AASSetThreadLog( idStr *log ) {
+	idStr *oldLog = aasThreadLog;
+	aasThreadLog = log;
+	return oldLog;
+}
+
+/*
+============
+AASPrintLog
+
+  prints a thread log line by line so long logs are not cut off
+============
+*/
+void AASPrintLog( const idStr &log ) {
+	const char *s;
+	char buf[MAX_STRING_CHARS];
+	int len;
+
+	for ( s = log.c_str(); *s; s += len ) {
+		for ( len = 0; s[len] && len < (int)sizeof( buf ) - 1; len++ ) {
+			if ( s[len] == '\n' ) {
+				len++;
+				break;
+			}
+		}
+		memcpy( buf, s, len );
+		buf[len] = '\0';
+		common->Printf( "%s", buf );
+	}
+}
+
+/*
+============
+AASPrintf
+============
+*/
+void AASPrintf( const char *fmt, ... ) {
+	va_list argPtr;
+	char buf[MAX_STRING_CHARS];
+
+	va_start( argPtr, fmt );
+	idStr::vsnPrintf( buf, sizeof( buf ), fmt, argPtr );
+	va_end( argPtr );
+
+	if ( aasThreadLog ) {
+		aasThreadLog->Append( buf );
+	} else {
+		common->Printf( "%s", buf );
+	}
+}
+
+/*
+============
+AASWarning
+============
+*/
+void AASWarning( const char *fmt, ... ) {
+	va_list argPtr;
+	char buf[MAX_STRING_CHARS];
+
+	va_start( argPtr, fmt );
+	idStr::vsnPrintf( buf, sizeof( buf ), fmt, argPtr );
+	va_end( argPtr );
+
+	if ( aasThreadLog ) {
+		aasThreadLog->Append( S_COLOR_YELLOW "WARNING: " S_COLOR_RED );
+		aasThreadLog->Append( buf );
+		aasThreadLog->Append( "\n" );
+	} else {
+		common->Warning( "%s", buf );
+	}
+}
+
+/*
+============
+AASError
+
+  while a thread log is set the error is only thrown, common->Error
+  must be called from the thread that started the compile
+============
+*/
+void AASError( const char *fmt, ... ) {
+	va_list argPtr;
+	char buf[MAX_STRING_CHARS];
+
+	va_start( argPtr, fmt );
+	idStr::vsnPrintf( buf, sizeof( buf ), fmt, argPtr );
+	va_end( argPtr );
+
+	if ( aasThreadLog ) {
+		throw idException( buf );
+	}
+	common->Error( "%s", buf );
+}
+
 /*
 ============
 DisplayRealTimeString
@@ -49,9 +155,14 @@ DisplayRealTimeString
 void DisplayRealTimeString( const char *string, ... ) {
 	va_list argPtr;
 	char buf[MAX_STRING_CHARS];
-	static int lastUpdateTime;
+	static thread_local int lastUpdateTime;
 	int time;
 
+	// progress counters are useless in a log that is printed afterwards
+	if ( aasThreadLog ) {
+		return;
+	}
+
 	time = Sys_Milliseconds();
 	if ( time > lastUpdateTime + OUTPUT_UPDATE_TIME ) {
 		va_start( argPtr, string );
@@ -292,7 +403,7 @@ void idBrush::BoundBrush( const idBrush *original ) {
 			bm->WriteBrush( original );
 			delete bm;
 		}
-		common->Error( "idBrush::BoundBrush: brush %d on entity %d without windings", primitiveNum, entityNum );
+		AASError( "idBrush::BoundBrush: brush %d on entity %d without windings", primitiveNum, entityNum );
 	}
 
 	for ( i = 0; i < 3; i++ ) {
@@ -302,7 +413,7 @@ void idBrush::BoundBrush( const idBrush *original ) {
 				bm->WriteBrush( original );
 				delete bm;
 			}
-			common->Error( "idBrush::BoundBrush: brush %d on entity %d is unbounded", primitiveNum, entityNum );
+			AASError( "idBrush::BoundBrush: brush %d on entity %d is unbounded", primitiveNum, entityNum );
 		}
 	}
 }
@@ -708,7 +819,7 @@ int idBrush::Split( const idPlane &plane, int planeNum, idBrush **front, idBrush
 		}
 		else if ( mid->IsHuge() ) {
 			// if the winding is huge then the brush is unbounded
-			common->Warning( "brush %d on entity %d is unbounded"
+			AASWarning( "brush %d on entity %d is unbounded"
 						"( %1.2f %1.2f %1.2f )-( %1.2f %1.2f %1.2f )-( %1.2f %1.2f %1.2f )", primitiveNum, entityNum,
 							bounds[0][0], bounds[0][1], bounds[0][2], bounds[1][0], bounds[1][1], bounds[1][2],
 							bounds[1][0]-bounds[0][0], bounds[1][1]-bounds[0][1], bounds[1][2]-bounds[0][2] );
@@ -971,7 +1082,7 @@ void idBrush::ExpandForAxialBox( const idBounds &bounds ) {
 	}
 
 	if ( !CreateWindings() ) {
-		common->Error( "idBrush::ExpandForAxialBox: brush %d on entity %d imploded", primitiveNum, entityNum );
+		AASError( "idBrush::ExpandForAxialBox: brush %d on entity %d imploded", primitiveNum, entityNum );
 	}
 
 	/*
@@ -1274,8 +1385,8 @@ void idBrushList::Chop( bool (*ChopAllowed)( idBrush *b1, idBrush *b2 ) ) {
 	idPlaneSet planeList;
 
 #ifdef OUTPUT_CHOP_STATS
-	common->Printf( "[Brush CSG]\n");
-	common->Printf( "%6d original brushes\n", this->Num() );
+	AASPrintf( "[Brush CSG]\n");
+	AASPrintf( "%6d original brushes\n", this->Num() );
 #endif
 
 	CreatePlaneList( planeList );
@@ -1386,7 +1497,7 @@ void idBrushList::Chop( bool (*ChopAllowed)( idBrush *b1, idBrush *b2 ) ) {
 	*this = keep;
 
 #ifdef OUTPUT_CHOP_STATS
-	common->Printf( "\r%6d output brushes\n", Num() );
+	AASPrintf( "\r%6d output brushes\n", Num() );
 #endif
 }
 
@@ -1401,8 +1512,8 @@ void idBrushList::Merge( bool (*MergeAllowed)( idBrush *b1, idBrush *b2 ) ) {
 	idBrush *b1, *b2, *nextb2;
 	int numMerges;
 
-	common->Printf( "[Brush Merge]\n");
-	common->Printf( "%6d original brushes\n", Num() );
+	AASPrintf( "[Brush Merge]\n");
+	AASPrintf( "%6d original brushes\n", Num() );
 
 	CreatePlaneList( planeList );
 
@@ -1428,7 +1539,7 @@ void idBrushList::Merge( bool (*MergeAllowed)( idBrush *b1, idBrush *b2 ) ) {
 		}
 	}
 
-	common->Printf( "\r%6d brushes merged\n", numMerges );
+	AASPrintf( "\r%6d brushes merged\n", numMerges );
 }
 
 /*
@@ -1512,7 +1623,7 @@ idBrushMap::idBrushMap( const idStr &fileName, const idStr &ext ) {
 	qpath += ext;
 	qpath.SetFileExtension( "map" );
 
-	common->Printf( "writing %s...\n", qpath.c_str() );
+	AASPrintf( "writing %s...\n", qpath.c_str() );
 
 	fp = fileSystem->OpenFileWrite( qpath, "fs_devpath" );
 	if ( !fp ) {
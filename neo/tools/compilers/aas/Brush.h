@@ -51,6 +51,13 @@ class idBrushList;
 
 void DisplayRealTimeString( const char *string, ... ) id_attribute((format(printf,1,2)));
 
+// compiler output that can be buffered per thread when building in parallel
+idStr *AASSetThreadLog( idStr *log );
+void AASPrintLog( const idStr &log );
+void AASPrintf( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void AASWarning( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void AASError( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+
 
 //===============================================================
 //
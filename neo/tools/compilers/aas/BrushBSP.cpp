@@ -79,7 +79,7 @@ idBrushBSPPortal::AddToNodes
 */
 void idBrushBSPPortal::AddToNodes( idBrushBSPNode *front, idBrushBSPNode *back ) {
 	if ( nodes[0] || nodes[1] ) {
-		common->Error( "AddToNode: already included" );
+		AASError( "AddToNode: already included" );
 	}
 
 	assert( front && back );
@@ -107,7 +107,7 @@ void idBrushBSPPortal::RemoveFromNode( idBrushBSPNode *l ) {
 	{
 		t = *pp;
 		if ( !t ) {
-			common->Error( "idBrushBSPPortal::RemoveFromNode: portal not in node" );
+			AASError( "idBrushBSPPortal::RemoveFromNode: portal not in node" );
 		}
 
 		if ( t == this ) {
@@ -121,7 +121,7 @@ void idBrushBSPPortal::RemoveFromNode( idBrushBSPNode *l ) {
 			pp = &t->next[1];
 		}
 		else {
-			common->Error( "idBrushBSPPortal::RemoveFromNode: portal not bounding node" );
+			AASError( "idBrushBSPPortal::RemoveFromNode: portal not bounding node" );
 		}
 	}
 
@@ -134,7 +134,7 @@ void idBrushBSPPortal::RemoveFromNode( idBrushBSPNode *l ) {
 		nodes[1] = NULL;
 	}
 	else {
-		common->Error( "idBrushBSPPortal::RemoveFromNode: mislinked portal" );
+		AASError( "idBrushBSPPortal::RemoveFromNode: mislinked portal" );
 	}
 }
 
@@ -857,8 +857,8 @@ idBrushBSPNode *idBrushBSP::ProcessGridCell( idBrushBSPNode *node, int skipConte
 	bool *testedPlanes;
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
-	common->Printf( "[Grid Cell %d]\n", ++numGridCells );
-	common->Printf( "%6d brushes\n", node->brushList.Num() );
+	AASPrintf( "[Grid Cell %d]\n", ++numGridCells );
+	AASPrintf( "%6d brushes\n", node->brushList.Num() );
 #endif
 
 	numGridCellSplits = 0;
@@ -873,7 +873,7 @@ idBrushBSPNode *idBrushBSP::ProcessGridCell( idBrushBSPNode *node, int skipConte
 	node->brushList.CreatePlaneList( planeList );
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
-	common->Printf( "[Grid Cell BSP]\n" );
+	AASPrintf( "[Grid Cell BSP]\n" );
 #endif
 
 	testedPlanes = new bool[planeList.Num()];
@@ -883,7 +883,7 @@ idBrushBSPNode *idBrushBSP::ProcessGridCell( idBrushBSPNode *node, int skipConte
 	delete[] testedPlanes;
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
-	common->Printf( "\r%6d splits\n", numGridCellSplits );
+	AASPrintf( "\r%6d splits\n", numGridCellSplits );
 #endif
 
 	return node;
@@ -965,8 +965,8 @@ void idBrushBSP::Build( idBrushList brushList, int skipContents,
 	int i;
 	idList<idBrushBSPNode *> gridCells;
 
-	common->Printf( "[Brush BSP]\n" );
-	common->Printf( "%6d brushes\n", brushList.Num() );
+	AASPrintf( "[Brush BSP]\n" );
+	AASPrintf( "%6d brushes\n", brushList.Num() );
 
 	BrushChopAllowed = ChopAllowed;
 	BrushMergeAllowed = MergeAllowed;
@@ -981,22 +981,22 @@ void idBrushBSP::Build( idBrushList brushList, int skipContents,
 
 	BuildGrid_r( gridCells, root );
 
-	common->Printf( "\r%6d grid cells\n", gridCells.Num() );
+	AASPrintf( "\r%6d grid cells\n", gridCells.Num() );
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
 	for ( i = 0; i < gridCells.Num(); i++ ) {
 		ProcessGridCell( gridCells[i], skipContents );
 	}
 #else
-	common->Printf( "\r%6d %%", 0 );
+	AASPrintf( "\r%6d %%", 0 );
 	for ( i = 0; i < gridCells.Num(); i++ ) {
 		DisplayRealTimeString( "\r%6d", i * 100 / gridCells.Num() );
 		ProcessGridCell( gridCells[i], skipContents );
 	}
-	common->Printf( "\r%6d %%\n", 100 );
+	AASPrintf( "\r%6d %%\n", 100 );
 #endif
 
-	common->Printf( "\r%6d splits\n", numSplits );
+	AASPrintf( "\r%6d splits\n", numSplits );
 
 	if ( brushMap ) {
 		delete brushMap;
@@ -1067,9 +1067,9 @@ idBrushBSP::PruneTree
 */
 void idBrushBSP::PruneTree( int contents ) {
 	numPrunedSplits = 0;
-	common->Printf( "[Prune BSP]\n" );
+	AASPrintf( "[Prune BSP]\n" );
 	PruneTree_r( root, contents );
-	common->Printf( "%6d splits pruned\n", numPrunedSplits );
+	AASPrintf( "%6d splits pruned\n", numPrunedSplits );
 }
 
 /*
@@ -1128,7 +1128,7 @@ void idBrushBSP::MakeNodePortal( idBrushBSPNode *node ) {
 			w = w->Clip( -p->plane, 0.1f );
 		}
 		else {
-			common->Error( "MakeNodePortal: mislinked portal" );
+			AASError( "MakeNodePortal: mislinked portal" );
 		}
 	}
 
@@ -1175,7 +1175,7 @@ void idBrushBSP::SplitNodePortals( idBrushBSPNode *node ) {
 			side = 1;
 		}
 		else {
-			common->Error( "idBrushBSP::SplitNodePortals: mislinked portal" );
+			AASError( "idBrushBSP::SplitNodePortals: mislinked portal" );
 			return;
 		}
 		nextPortal = p->next[side];
@@ -1265,7 +1265,7 @@ void idBrushBSP::MakeTreePortals_r( idBrushBSPNode *node ) {
 
 	for ( i = 0; i < 3; i++ ) {
 		if ( bounds[0][i] < MIN_WORLD_COORD || bounds[1][i] > MAX_WORLD_COORD ) {
-			common->Warning( "node with unbounded volume" );
+			AASWarning( "node with unbounded volume" );
 			break;
 		}
 	}
@@ -1297,7 +1297,7 @@ void idBrushBSP::MakeOutsidePortals( void ) {
 
 	for ( i = 0; i < 3; i++ ) {
 		if ( bounds[0][i] > bounds[1][i] ) {
-			common->Error( "empty BSP tree" );
+			AASError( "empty BSP tree" );
 		}
 	}
 
@@ -1341,12 +1341,12 @@ idBrushBSP::Portalize
 ============
 */
 void idBrushBSP::Portalize( void ) {
-	common->Printf( "[Portalize BSP]\n" );
-	common->Printf( "%6d nodes\n", (numSplits - numPrunedSplits) * 2 + 1 );
+	AASPrintf( "[Portalize BSP]\n" );
+	AASPrintf( "%6d nodes\n", (numSplits - numPrunedSplits) * 2 + 1 );
 	numPortals = 0;
 	MakeOutsidePortals();
 	MakeTreePortals_r( root );
-	common->Printf( "\r%6d nodes portalized\n", numPortals );
+	AASPrintf( "\r%6d nodes portalized\n", numPortals );
 }
 
 /*
@@ -1372,7 +1372,7 @@ void idBrushBSP::LeakFile( const idStr &fileName ) {
 	qpath = fileName;
 	qpath.SetFileExtension( "lin" );
 
-	common->Printf( "writing %s...\n", qpath.c_str() );
+	AASPrintf( "writing %s...\n", qpath.c_str() );
 
 	lineFile = fileSystem->OpenFileWrite( qpath, "fs_devpath" );
 	if ( !lineFile ) {
@@ -1416,11 +1416,11 @@ void idBrushBSP::FloodThroughPortals_r( idBrushBSPNode *node, int contents, int
 	int s;
 
 	if ( !node ) {
-		common->Error( "FloodThroughPortals_r: NULL node\n" );
+		AASError( "FloodThroughPortals_r: NULL node\n" );
 	}
 
 	if ( node->occupied ) {
-		common->Error( "FloodThroughPortals_r: node already occupied\n" );
+		AASError( "FloodThroughPortals_r: node already occupied\n" );
 	}
 	node->occupied = depth;
 
@@ -1540,10 +1540,10 @@ bool idBrushBSP::FloodFromEntities( const idMapFile *mapFile, int contents, cons
 	}
 
 	if ( !inside ) {
-		common->Warning( "no entities inside" );
+		AASWarning( "no entities inside" );
 	}
 	else if ( outside->occupied ) {
-		common->Warning( "reached outside from entity %d (%s)", i, classname.c_str() );
+		AASWarning( "reached outside from entity %d (%s)", i, classname.c_str() );
 	}
 
 	return ( inside && !outside->occupied );
@@ -1586,7 +1586,7 @@ idBrushBSP::RemoveOutside
 ============
 */
 bool idBrushBSP::RemoveOutside( const idMapFile *mapFile, int contents, const idStrList &classNames ) {
-	common->Printf( "[Remove Outside]\n" );
+	AASPrintf( "[Remove Outside]\n" );
 
 	solidLeafNodes = outsideLeafNodes = insideLeafNodes = 0;
 
@@ -1596,9 +1596,9 @@ bool idBrushBSP::RemoveOutside( const idMapFile *mapFile, int contents, const id
 
 	RemoveOutside_r( root, contents );
 
-	common->Printf( "%6d solid leaf nodes\n", solidLeafNodes );
-	common->Printf( "%6d outside leaf nodes\n", outsideLeafNodes );
-	common->Printf( "%6d inside leaf nodes\n", insideLeafNodes );
+	AASPrintf( "%6d solid leaf nodes\n", solidLeafNodes );
+	AASPrintf( "%6d outside leaf nodes\n", outsideLeafNodes );
+	AASPrintf( "%6d inside leaf nodes\n", insideLeafNodes );
 
 	//PruneTree( contents );
 
@@ -1809,10 +1809,10 @@ idBrushBSP::MergePortals
 */
 void idBrushBSP::MergePortals( int skipContents ) {
 	numMergedPortals = 0;
-	common->Printf( "[Merge Portals]\n" );
+	AASPrintf( "[Merge Portals]\n" );
 	SetPortalPlanes();
 	MergePortals_r( root, skipContents );
-	common->Printf( "%6d portals merged\n", numMergedPortals );
+	AASPrintf( "%6d portals merged\n", numMergedPortals );
 }
 
 /*
@@ -2140,9 +2140,9 @@ void idBrushBSP::MeltPortals( int skipContents ) {
 	idVectorSet<idVec3,3> vertexList;
 
 	numInsertedPoints = 0;
-	common->Printf( "[Melt Portals]\n" );
+	AASPrintf( "[Melt Portals]\n" );
 	RemoveColinearPoints_r( root, skipContents );
 	MeltPortals_r( root, skipContents, vertexList );
 	root->RemoveFlagRecurse( NODE_DONE );
-	common->Printf( "\r%6d points inserted\n", numInsertedPoints );
+	AASPrintf( "\r%6d points inserted\n", numInsertedPoints );
 }
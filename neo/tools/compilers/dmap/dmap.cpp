@@ -33,6 +33,152 @@ If you have questions concerning this license or the applicable additional terms
 
 dmapGlobals_t	dmapGlobals;
 
+/*
+============
+DmapPrintf
+============
+*/
+static thread_local idStr *	dmapJobLog;		// set while a DmapParallelFor job runs
+
+void DmapPrintf( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( dmapJobLog ) {
+		dmapJobLog->Append( text );
+	} else {
+		common->Printf( "%s", text );
+	}
+}
+
+/*
+============
+DmapError
+
+  common->Error isn't safe on a job thread, so inside a job the error
+  is only thrown and DmapParallelFor raises it once all jobs are done
+============
+*/
+void DmapError( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( dmapJobLog ) {
+		throw idException( text );
+	}
+	common->Error( "%s", text );
+}
+
+typedef struct {
+	xparallelJob_t	function;
+	void *			data;
+	idStr *			logs;
+	idStr *			errors;
+} dmapParallelFor_t;
+
+/*
+============
+DmapParallelJob
+============
+*/
+static void DmapParallelJob( void *data, int index ) {
+	dmapParallelFor_t *pf = (dmapParallelFor_t *)data;
+
+	// the calling thread runs jobs as well, so a job may start while another is waiting
+	idStr *oldLog = dmapJobLog;
+	dmapJobLog = &pf->logs[index];
+	try {
+		pf->function( pf->data, index );
+	} catch ( idException &ex ) {
+		pf->errors[index] = ex.error;
+	}
+	dmapJobLog = oldLog;
+}
+
+/*
+============
+DmapParallelFor
+============
+*/
+void DmapParallelFor( xparallelJob_t function, void *data, int count, const char *name ) {
+	int i;
+
+	// the debug drawing goes straight to the window
+	if ( dmapGlobals.noThreads || dmapGlobals.drawflag || count < 2 ) {
+		for ( i = 0 ; i < count ; i++ ) {
+			function( data, i );
+		}
+		return;
+	}
+
+	dmapParallelFor_t pf;
+	pf.function = function;
+	pf.data = data;
+	pf.logs = new idStr[count];
+	pf.errors = new idStr[count];
+
+	Sys_ParallelFor( DmapParallelJob, &pf, count, name );
+
+	// print line by line, a whole log can be longer than a single print
+	for ( i = 0 ; i < count ; i++ ) {
+		const char *s = pf.logs[i].c_str();
+		while ( *s ) {
+			const char *end = strchr( s, '\n' );
+			int len = Min( end ? (int)( end - s ) + 1 : (int)strlen( s ), MAX_STRING_CHARS - 1 );
+			common->Printf( "%s", idStr( s, 0, len ).c_str() );
+			s += len;
+		}
+	}
+	delete[] pf.logs;
+
+	// raise the error of the lowest index, the same one a serial run would hit first
+	idStr error;
+	for ( i = 0 ; i < count ; i++ ) {
+		if ( pf.errors[i].Length() ) {
+			error = pf.errors[i];
+			break;
+		}
+	}
+	delete[] pf.errors;
+
+	if ( error.Length() ) {
+		common->Error( "%s", error.c_str() );
+	}
+}
+
+static const char *dmapStageNames[DMAP_NUM_STAGES] = {
+	"bsp",
+	"portals",
+	"flood fill",
+	"clip sides",
+	"areas",
+	"primitives in areas",
+	"prelight",
+	"optimize",
+	"global t junctions"
+};
+
+/*
+============
+EndStage
+
+Adds the time since start to the stage and restarts the clock
+============
+*/
+static void EndStage( dmapStage_t stage, int &start ) {
+	int end = Sys_Milliseconds();
+	dmapGlobals.stageMsec[stage] += end - start;
+	start = end;
+}
+
 /*
 ============
 ProcessModel
@@ -40,15 +186,20 @@ ProcessModel
 */
 bool ProcessModel( uEntity_t *e, bool floodFill ) {
 	bspface_t	*faces;
+	int			start;
+
+	start = Sys_Milliseconds();
 
 	// build a bsp tree using all of the sides
 	// of all of the structural brushes
 	faces = MakeStructuralBspFaceList ( e->primitives );
 	e->tree = FaceBSP( faces );
+	EndStage( DMAP_STAGE_BSP, start );
 
 	// create portals at every leaf intersection
 	// to allow flood filling
 	MakeTreePortals( e->tree );
+	EndStage( DMAP_STAGE_PORTALS, start );
 
 	// classify the leafs as opaque or areaportal
 	FilterBrushesIntoTree( e );
@@ -69,26 +220,31 @@ bool ProcessModel( uEntity_t *e, bool floodFill ) {
 			return false;
 		}
 	}
+	EndStage( DMAP_STAGE_FLOOD, start );
 
 	// get minimum convex hulls for each visible side
 	// this must be done before creating area portals,
 	// because the visible hull is used as the portal
 	ClipSidesByTree( e );
+	EndStage( DMAP_STAGE_CLIP_SIDES, start );
 
 	// determine areas before clipping tris into the
 	// tree, so tris will never cross area boundaries
 	FloodAreas( e );
+	EndStage( DMAP_STAGE_AREAS, start );
 
 	// we now have a BSP tree with solid and non-solid leafs marked with areas
 	// all primitives will now be clipped into this, throwing away
 	// fragments in the solid areas
 	PutPrimitivesInAreas( e );
+	EndStage( DMAP_STAGE_PRIMITIVES, start );
 
 	// now build shadow volumes for the lights and split
 	// the optimize lists by the light beam trees
 	// so there won't be unneeded overdraw in the static
 	// case
 	Prelight( e );
+	EndStage( DMAP_STAGE_PRELIGHT, start );
 
 	// optimizing is a superset of fixing tjunctions
 	if ( !dmapGlobals.noOptimize ) {
@@ -96,9 +252,11 @@ bool ProcessModel( uEntity_t *e, bool floodFill ) {
 	} else  if ( !dmapGlobals.noTJunc ) {
 		FixEntityTjunctions( e );
 	}
+	EndStage( DMAP_STAGE_OPTIMIZE, start );
 
 	// now fix t junctions across areas
 	FixGlobalTjunctions( e );
+	EndStage( DMAP_STAGE_GLOBAL_TJUNC, start );
 
 	return true;
 }
@@ -153,6 +311,7 @@ void DmapHelp( void ) {
 	"noCurves          = don't process curves\n"
 	"noCM              = don't create collision map\n"
 	"noAAS             = don't create AAS files\n"
+	"noThreads         = process areas and lights on the main thread only\n"
 
 	);
 }
@@ -188,6 +347,8 @@ void ResetDmapGlobals( void ) {
 	dmapGlobals.drawflag = false;
 	dmapGlobals.totalShadowTriangles = 0;
 	dmapGlobals.totalShadowVerts = 0;
+	dmapGlobals.noThreads = false;
+	memset( dmapGlobals.stageMsec, 0, sizeof( dmapGlobals.stageMsec ) );
 }
 
 /*
@@ -283,6 +444,9 @@ void Dmap( const idCmdArgs &args ) {
 		} else if ( !idStr::Icmp( s, "noAAS" ) ) {
 			noAAS = true;
 			common->Printf( "noAAS = true\n" );
+		} else if ( !idStr::Icmp( s, "noThreads" ) ) {
+			common->Printf( "noThreads = true\n" );
+			dmapGlobals.noThreads = true;
 		} else if ( !idStr::Icmp( s, "editorOutput" ) ) {
 #ifdef _WIN32
 			com_outputMsg = true;
@@ -343,6 +507,11 @@ void Dmap( const idCmdArgs &args ) {
 	common->Printf( "%i total shadow triangles\n", dmapGlobals.totalShadowTriangles );
 	common->Printf( "%i total shadow verts\n", dmapGlobals.totalShadowVerts );
 
+	common->Printf( "-----------------------\n" );
+	for ( i = 0 ; i < DMAP_NUM_STAGES ; i++ ) {
+		common->Printf( "%7.2f seconds for %s\n", dmapGlobals.stageMsec[i] * 0.001f, dmapStageNames[i] );
+	}
+
 	end = Sys_Milliseconds();
 	common->Printf( "-----------------------\n" );
 	common->Printf( "%5.0f seconds for dmap\n", ( end - start ) * 0.001f );
@@ -223,6 +223,19 @@ typedef struct optimizeGroup_s {
 
 // dmap.cpp
 
+typedef enum {
+	DMAP_STAGE_BSP,
+	DMAP_STAGE_PORTALS,
+	DMAP_STAGE_FLOOD,
+	DMAP_STAGE_CLIP_SIDES,
+	DMAP_STAGE_AREAS,
+	DMAP_STAGE_PRIMITIVES,
+	DMAP_STAGE_PRELIGHT,
+	DMAP_STAGE_OPTIMIZE,
+	DMAP_STAGE_GLOBAL_TJUNC,
+	DMAP_NUM_STAGES
+} dmapStage_t;
+
 typedef enum {
 	SO_NONE,			// 0
 	SO_MERGE_SURFACES,	// 1
@@ -263,17 +276,30 @@ typedef struct {
 	shadowOptLevel_t	shadowOptLevel;
 	bool	noShadow;			// don't create optimized shadow volumes
 
+	bool	noThreads;			// process areas and lights one after another
+
 	idBounds	drawBounds;
 	bool	drawflag;
 
 	int		totalShadowTriangles;
 	int		totalShadowVerts;
+
+	int		stageMsec[DMAP_NUM_STAGES];	// wall clock time summed over all entities
 } dmapGlobals_t;
 
 extern dmapGlobals_t dmapGlobals;
 
 int FindFloatPlane( const idPlane &plane, bool *fixedDegeneracies = NULL );
 
+// calls function( data, i ) for every area or light, spread over the job threads.
+// the jobs must not change the plane list or anything shared between the indexes,
+// and should print with DmapPrintf, which is buffered per index and printed in
+// index order once all jobs are done, so the output doesn't depend on the threads.
+// errors inside a job must go through DmapError, they are raised after the jobs
+void	DmapParallelFor( xparallelJob_t function, void *data, int count, const char *name );
+void	DmapPrintf( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void	DmapError( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+
 
 //=============================================================================
 
@@ -49,15 +49,17 @@ If you have questions concerning this license or the applicable additional terms
 
 */
 
-idBounds	optBounds;
+// the work buffers are per thread, so areas and lights can be optimized
+// in parallel, they are only allocated while OptimizeGroupList runs
+static thread_local idBounds	optBounds;
 
 #define	MAX_OPT_VERTEXES	0x10000
-int			numOptVerts;
-optVertex_t optVerts[MAX_OPT_VERTEXES];
+static thread_local int			numOptVerts;
+static thread_local optVertex_t *optVerts;
 
 #define	MAX_OPT_EDGES		0x40000
-static	int		numOptEdges;
-static	optEdge_t	optEdges[MAX_OPT_EDGES];
+static thread_local int			numOptEdges;
+static thread_local optEdge_t *	optEdges;
 
 static bool IsTriangleValid( const optVertex_t *v1, const optVertex_t *v2, const optVertex_t *v3 );
 static bool IsTriangleDegenerate( const optVertex_t *v1, const optVertex_t *v2, const optVertex_t *v3 );
@@ -83,7 +85,7 @@ static void ValidateEdgeCounts( optIsland_t *island ) {
 			} else if ( e->v2 == vert ) {
 				e = e->v2link;
 			} else {
-				common->Error( "ValidateEdgeCounts: mislinked" );
+				DmapError( "ValidateEdgeCounts: mislinked" );
 			}
 		}
 		if ( c != 2 && c != 0 ) {
@@ -103,7 +105,7 @@ static optEdge_t	*AllocEdge( void ) {
 	optEdge_t	*e;
 
 	if ( numOptEdges == MAX_OPT_EDGES ) {
-		common->Error( "MAX_OPT_EDGES" );
+		DmapError( "MAX_OPT_EDGES" );
 	}
 	e = &optEdges[ numOptEdges ];
 	numOptEdges++;
@@ -133,7 +135,7 @@ static	void RemoveEdgeFromVert( optEdge_t *e1, optVertex_t *vert ) {
 			} else if ( e1->v2 == vert ) {
 				*prev = e1->v2link;
 			} else {
-				common->Error( "RemoveEdgeFromVert: vert not found" );
+				DmapError( "RemoveEdgeFromVert: vert not found" );
 			}
 			return;
 		}
@@ -143,7 +145,7 @@ static	void RemoveEdgeFromVert( optEdge_t *e1, optVertex_t *vert ) {
 		} else if ( e->v2 == vert ) {
 			prev = &e->v2link;
 		} else {
-			common->Error( "RemoveEdgeFromVert: vert not found" );
+			DmapError( "RemoveEdgeFromVert: vert not found" );
 		}
 	}
 }
@@ -166,7 +168,7 @@ static	void UnlinkEdge( optEdge_t *e, optIsland_t *island ) {
 		}
 	}
 
-	common->Error( "RemoveEdgeFromIsland: couldn't free edge" );
+	DmapError( "RemoveEdgeFromIsland: couldn't free edge" );
 }
 
 
@@ -205,7 +207,7 @@ static optVertex_t *FindOptVertex( idDrawVert *v, optimizeGroup_t *opt ) {
 	}
 
 	if ( numOptVerts >= MAX_OPT_VERTEXES ) {
-		common->Error( "MAX_OPT_VERTEXES" );
+		DmapError( "MAX_OPT_VERTEXES" );
 		return NULL;
 	}
 
@@ -580,8 +582,8 @@ static	void AddInteriorEdges( optIsland_t *island ) {
 	}
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i tested segments\n", numLengths );
-		common->Printf( "%6i added interior edges\n", c_addedEdges );
+		DmapPrintf( "%6i tested segments\n", numLengths );
+		DmapPrintf( "%6i added interior edges\n", c_addedEdges );
 	}
 
 	Mem_Free( lengths );
@@ -625,7 +627,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 		} else if ( e->v2 == v2 ) {
 			e = e->v2link;
 		} else {
-			common->Error( "RemoveIfColinear: mislinked edge" );
+			DmapError( "RemoveIfColinear: mislinked edge" );
 			return;
 		}
 	}
@@ -638,7 +640,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 	if ( !e2 ) {
 		// this may still happen legally when a tiny triangle is
 		// the only thing in a group
-		common->Printf( "WARNING: vertex with only one edge\n" );
+		DmapPrintf( "WARNING: vertex with only one edge\n" );
 		return;
 	}
 
@@ -647,7 +649,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 	} else if ( e1->v2 == v2 ) {
 		v1 = e1->v1;
 	} else {
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		DmapError( "RemoveIfColinear: mislinked edge" );
 		return;
 	}
 	if ( e2->v1 == v2 ) {
@@ -655,12 +657,12 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 	} else if ( e2->v2 == v2 ) {
 		v3 = e2->v1;
 	} else {
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		DmapError( "RemoveIfColinear: mislinked edge" );
 		return;
 	}
 
 	if ( v1 == v3 ) {
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		DmapError( "RemoveIfColinear: mislinked edge" );
 		return;
 	}
 
@@ -704,7 +706,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 
 	// v2 should have no edges now
 	if ( v2->edges ) {
-		common->Error( "RemoveIfColinear: didn't remove properly" );
+		DmapError( "RemoveIfColinear: didn't remove properly" );
 		return;
 	}
 
@@ -757,7 +759,7 @@ static	void CombineColinearEdges( optIsland_t *island ) {
 		c_edges++;
 	}
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i original exterior edges\n", c_edges );
+		DmapPrintf( "%6i original exterior edges\n", c_edges );
 	}
 
 	for ( ov = island->verts ; ov ; ov = ov->islandLink ) {
@@ -769,7 +771,7 @@ static	void CombineColinearEdges( optIsland_t *island ) {
 		c_edges++;
 	}
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i optimized exterior edges\n", c_edges );
+		DmapPrintf( "%6i optimized exterior edges\n", c_edges );
 	}
 }
 
@@ -905,7 +907,7 @@ static void LinkTriToEdge( optTri_t *optTri, optEdge_t *edge ) {
 		|| ( edge->v1 == optTri->v[1] && edge->v2 == optTri->v[2] )
 		|| ( edge->v1 == optTri->v[2] && edge->v2 == optTri->v[0] ) ) {
 		if ( edge->backTri ) {
-			common->Printf( "Warning: LinkTriToEdge: already in use\n" );
+			DmapPrintf( "Warning: LinkTriToEdge: already in use\n" );
 			return;
 		}
 		edge->backTri = optTri;
@@ -915,13 +917,13 @@ static void LinkTriToEdge( optTri_t *optTri, optEdge_t *edge ) {
 		|| ( edge->v1 == optTri->v[2] && edge->v2 == optTri->v[1] )
 		|| ( edge->v1 == optTri->v[0] && edge->v2 == optTri->v[2] ) ) {
 		if ( edge->frontTri ) {
-			common->Printf( "Warning: LinkTriToEdge: already in use\n" );
+			DmapPrintf( "Warning: LinkTriToEdge: already in use\n" );
 			return;
 		}
 		edge->frontTri = optTri;
 		return;
 	}
-	common->Error( "LinkTriToEdge: edge not found on tri" );
+	DmapError( "LinkTriToEdge: edge not found on tri" );
 }
 
 /*
@@ -940,7 +942,7 @@ static void CreateOptTri( optVertex_t *first, optEdge_t *e1, optEdge_t *e2, optI
 	} else if ( e1->v2 == first ) {
 		second = e1->v1;
 	} else {
-		common->Error( "CreateOptTri: mislinked edge" );
+		DmapError( "CreateOptTri: mislinked edge" );
 		return;
 	}
 
@@ -949,12 +951,12 @@ static void CreateOptTri( optVertex_t *first, optEdge_t *e1, optEdge_t *e2, optI
 	} else if ( e2->v2 == first ) {
 		third = e2->v1;
 	} else {
-		common->Error( "CreateOptTri: mislinked edge" );
+		DmapError( "CreateOptTri: mislinked edge" );
 		return;
 	}
 
 	if ( !IsTriangleValid( first, second, third ) ) {
-		common->Error( "CreateOptTri: invalid" );
+		DmapError( "CreateOptTri: invalid" );
 		return;
 	}
 
@@ -985,13 +987,13 @@ static void CreateOptTri( optVertex_t *first, optEdge_t *e1, optEdge_t *e2, optI
 		} else if ( opposite->v2 == second ) {
 			opposite = opposite->v2link;
 		} else {
-			common->Error( "BuildOptTriangles: mislinked edge" );
+			DmapError( "BuildOptTriangles: mislinked edge" );
 			return;
 		}
 	}
 
 	if ( !opposite ) {
-		common->Printf( "Warning: BuildOptTriangles: couldn't locate opposite\n" );
+		DmapPrintf( "Warning: BuildOptTriangles: couldn't locate opposite\n" );
 		return;
 	}
 
@@ -1067,7 +1069,7 @@ static void ReportNearbyVertexes( const optVertex_t *v, const optIsland_t *islan
 	float		d;
 	idVec3		vec;
 
-	common->Printf( "verts near 0x%p (%f, %f)\n", v,  v->pv[0], v->pv[1] );
+	DmapPrintf( "verts near 0x%p (%f, %f)\n", v,  v->pv[0], v->pv[1] );
 	for ( ov = island->verts ; ov ; ov = ov->islandLink ) {
 		if ( ov == v ) {
 			continue;
@@ -1077,7 +1079,7 @@ static void ReportNearbyVertexes( const optVertex_t *v, const optIsland_t *islan
 
 		d = vec.Length();
 		if ( d < 1 ) {
-			common->Printf( "0x%p = (%f, %f)\n", ov, ov->pv[0], ov->pv[1] );
+			DmapPrintf( "0x%p = (%f, %f)\n", ov, ov->pv[0], ov->pv[1] );
 		}
 	}
 }
@@ -1139,7 +1141,7 @@ for ( e1 = ov->edges ; e1 ; e1 = e1Next ) {
 				second = e1->v1;
 				e1Next = e1->v2link;
 			} else {
-				common->Error( "BuildOptTriangles: mislinked edge" );
+				DmapError( "BuildOptTriangles: mislinked edge" );
 			}
 
 			// if the vertex has already been used, it can't be used again
@@ -1155,7 +1157,7 @@ for ( e1 = ov->edges ; e1 ; e1 = e1Next ) {
 					third = e2->v1;
 					e2Next = e2->v2link;
 				} else {
-					common->Error( "BuildOptTriangles: mislinked edge" );
+					DmapError( "BuildOptTriangles: mislinked edge" );
 				}
 				if ( e2 == e1 ) {
 					continue;
@@ -1181,7 +1183,7 @@ for ( e1 = ov->edges ; e1 ; e1 = e1Next ) {
 						middle = check->v1;
 						checkNext = check->v2link;
 					} else {
-						common->Error( "BuildOptTriangles: mislinked edge" );
+						DmapError( "BuildOptTriangles: mislinked edge" );
 					}
 
 					if ( check == e1 || check == e2 ) {
@@ -1245,7 +1247,7 @@ static	void	RegenerateTriangles( optIsland_t *island ) {
 		if ( plane.Normal() * dmapGlobals.mapPlanes[ island->group->planeNum ].Normal() <= 0 ) {
 			// this can happen reasonably when a triangle is nearly degenerate in
 			// optimization planar space, and winds up being degenerate in 3D space
-			common->Printf( "WARNING: backwards triangle generated!\n" );
+			DmapPrintf( "WARNING: backwards triangle generated!\n" );
 			// discard it
 			FreeTri( tri );
 			continue;
@@ -1259,7 +1261,7 @@ static	void	RegenerateTriangles( optIsland_t *island ) {
 	FreeOptTriangles( island );
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i tris out\n", c_out );
+		DmapPrintf( "%6i tris out\n", c_out );
 	}
 }
 
@@ -1307,8 +1309,8 @@ static	void RemoveInteriorEdges( optIsland_t *island ) {
 	}
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i original interior edges\n", c_interiorEdges );
-		common->Printf( "%6i original exterior edges\n", c_exteriorEdges );
+		DmapPrintf( "%6i original interior edges\n", c_interiorEdges );
+		DmapPrintf( "%6i original exterior edges\n", c_exteriorEdges );
 	}
 }
 
@@ -1336,7 +1338,7 @@ void AddEdgeIfNotAlready( optVertex_t *v1, optVertex_t *v2 ) {
 		} else if ( e->v2 == v1 ) {
 			e = e->v2link;
 		} else {
-			common->Error( "SplitEdgeByList: bad edge link" );
+			DmapError( "SplitEdgeByList: bad edge link" );
 		}
 	}
 
@@ -1383,8 +1385,8 @@ typedef struct edgeCrossing_s {
 	optVertex_t		*ov;
 } edgeCrossing_t;
 
-static	originalEdges_t	*originalEdges;
-static	int				numOriginalEdges;
+static thread_local originalEdges_t	*originalEdges;
+static thread_local int				numOriginalEdges;
 
 /*
 =================
@@ -1397,7 +1399,7 @@ static void AddOriginalTriangle( optVertex_t *v[3] ) {
 	// if this triangle is backwards (possible with epsilon issues)
 	// ignore it completely
 	if ( !IsTriangleValid( v[0], v[1], v[2] ) ) {
-		common->Printf( "WARNING: backwards triangle in input!\n" );
+		DmapPrintf( "WARNING: backwards triangle in input!\n" );
 		return;
 	}
 
@@ -1441,8 +1443,8 @@ static	void AddOriginalEdges( optimizeGroup_t *opt ) {
 	int				numTris;
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "----\n" );
-		common->Printf( "%6i original tris\n", CountTriList( opt->triList ) );
+		DmapPrintf( "----\n" );
+		DmapPrintf( "%6i original tris\n", CountTriList( opt->triList ) );
 	}
 
 	optBounds.Clear();
@@ -1479,12 +1481,14 @@ void SplitOriginalEdgesAtCrossings( optimizeGroup_t *opt ) {
 	// linked to the vertexes
 
 	// debug drawing bounds
-	dmapGlobals.drawBounds = optBounds;
+	if ( dmapGlobals.drawflag ) {
+		dmapGlobals.drawBounds = optBounds;
 
-	dmapGlobals.drawBounds[0][0] -= 2;
-	dmapGlobals.drawBounds[0][1] -= 2;
-	dmapGlobals.drawBounds[1][0] += 2;
-	dmapGlobals.drawBounds[1][1] += 2;
+		dmapGlobals.drawBounds[0][0] -= 2;
+		dmapGlobals.drawBounds[0][1] -= 2;
+		dmapGlobals.drawBounds[1][0] += 2;
+		dmapGlobals.drawBounds[1][1] += 2;
+	}
 
 	// generate crossing points between all the original edges
 	crossings = (edgeCrossing_t **)Mem_ClearedAlloc( numOriginalEdges * sizeof( *crossings ) );
@@ -1638,16 +1642,16 @@ common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i
 		for ( j = i+1 ; j < numOptEdges ; j++ ) {
 			if ( ( optEdges[i].v1 == optEdges[j].v1 && optEdges[i].v2 == optEdges[j].v2 )
 				|| ( optEdges[i].v1 == optEdges[j].v2 && optEdges[i].v2 == optEdges[j].v1 ) ) {
-				common->Printf( "duplicated optEdge\n" );
+				DmapPrintf( "duplicated optEdge\n" );
 			}
 		}
 	}
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i original edges\n", numOriginalEdges );
-		common->Printf( "%6i edges after splits\n", numOptEdges );
-		common->Printf( "%6i original vertexes\n", numOriginalVerts );
-		common->Printf( "%6i vertexes after splits\n", numOptVerts );
+		DmapPrintf( "%6i original edges\n", numOriginalEdges );
+		DmapPrintf( "%6i edges after splits\n", numOptEdges );
+		DmapPrintf( "%6i original vertexes\n", numOriginalVerts );
+		DmapPrintf( "%6i vertexes after splits\n", numOptVerts );
 	}
 }
 
@@ -1696,8 +1700,8 @@ static void CullUnusedVerts( optIsland_t *island ) {
 	}
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i verts kept\n", c_keep );
-		common->Printf( "%6i verts freed\n", c_free );
+		DmapPrintf( "%6i verts kept\n", c_keep );
+		DmapPrintf( "%6i verts freed\n", c_free );
 	}
 }
 
@@ -1785,7 +1789,7 @@ static void AddVertexToIsland_r( optVertex_t *vert, optIsland_t *island ) {
 			e = e->v2link;
 			continue;
 		}
-		common->Error( "AddVertexToIsland_r: mislinked vert" );
+		DmapError( "AddVertexToIsland_r: mislinked vert" );
 	}
 
 }
@@ -1825,7 +1829,7 @@ static void SeparateIslands( optimizeGroup_t *opt ) {
 		OptimizeIsland( &island );
 	}
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i islands\n", numIslands );
+		DmapPrintf( "%6i islands\n", numIslands );
 	}
 }
 #endif
@@ -1963,6 +1967,9 @@ void	OptimizeGroupList( optimizeGroup_t *groupList ) {
 		return;
 	}
 
+	optVerts = (optVertex_t *)Mem_Alloc( MAX_OPT_VERTEXES * sizeof( *optVerts ) );
+	optEdges = (optEdge_t *)Mem_Alloc( MAX_OPT_EDGES * sizeof( *optEdges ) );
+
 	c_in = CountGroupListTris( groupList );
 
 	// optimize and remove colinear edges, which will
@@ -1979,23 +1986,37 @@ void	OptimizeGroupList( optimizeGroup_t *groupList ) {
 
 	SetGroupTriPlaneNums( groupList );
 
-	common->Printf( "----- OptimizeAreaGroups Results -----\n" );
-	common->Printf( "%6i tris in\n", c_in );
-	common->Printf( "%6i tris after edge removal optimization\n", c_edge );
-	common->Printf( "%6i tris after final t junction fixing\n", c_tjunc2 );
+	Mem_Free( optVerts );
+	Mem_Free( optEdges );
+	optVerts = NULL;
+	optEdges = NULL;
+
+	DmapPrintf( "----- OptimizeAreaGroups Results -----\n" );
+	DmapPrintf( "%6i tris in\n", c_in );
+	DmapPrintf( "%6i tris after edge removal optimization\n", c_edge );
+	DmapPrintf( "%6i tris after final t junction fixing\n", c_tjunc2 );
 }
 
 
+/*
+==================
+OptimizeAreaJob
+==================
+*/
+static void OptimizeAreaJob( void *data, int index ) {
+	uEntity_t *e = (uEntity_t *)data;
+
+	OptimizeGroupList( e->areas[index].groups );
+}
+
 /*
 ==================
 OptimizeEntity
+
+The areas don't share any triangles, so they are optimized in parallel
 ==================
 */
 void	OptimizeEntity( uEntity_t *e ) {
-	int		i;
-
 	common->Printf( "----- OptimizeEntity -----\n" );
-	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		OptimizeGroupList( e->areas[i].groups );
-	}
+	DmapParallelFor( OptimizeAreaJob, e, e->numAreas, "OptimizeEntity" );
 }
@@ -292,7 +292,7 @@ static void ClipTriangle_r( const shadowTri_t *tri, int startTri, int skipTri, i
 
 	// this fragment is frontmost, so add it to the output list
 	if ( numOutputTris == MAX_SHADOW_TRIS ) {
-		common->Error( "numOutputTris == MAX_SHADOW_TRIS" );
+		DmapError( "numOutputTris == MAX_SHADOW_TRIS" );
 	}
 
 	outputTris[numOutputTris] = *tri;
@@ -512,7 +512,7 @@ static void GenerateSilEdges( void ) {
 		}
 
 		if ( numSilEdges == MAX_SIL_EDGES ) {
-			common->Error( "numSilEdges == MAX_SIL_EDGES" );
+			DmapError( "numSilEdges == MAX_SIL_EDGES" );
 		}
 		silEdges[numSilEdges].index[0] = v1;
 		silEdges[numSilEdges].index[1] = v2;
@@ -579,7 +579,7 @@ SaveQuad
 static void SaveQuad( silPlane_t *silPlane, silQuad_t &quad ) {
 	// this fragment is a final fragment
 	if ( numSilQuads == MAX_SIL_QUADS ) {
-		common->Error( "numSilQuads == MAX_SIL_QUADS" );
+		DmapError( "numSilQuads == MAX_SIL_QUADS" );
 	}
 	silQuads[numSilQuads] = quad;
 	silQuads[numSilQuads].nextQuad = silPlane->fragmentedQuads;
@@ -669,7 +669,7 @@ static void FragmentSilQuad( silQuad_t quad, silPlane_t *silPlane,
 				float f2 = d3 / ( d3 - d4 );
 f = f2;
 				if ( f <= 0.0001 || f >= 0.9999 ) {
-					common->Error( "Bad silQuad fraction" );
+					DmapError( "Bad silQuad fraction" );
 				}
 
 				// finding uniques may be causing problems here
@@ -763,7 +763,7 @@ static void FragmentSilQuads( void ) {
 			quad.nearV[0] = e1->index[0];
 			quad.nearV[1] = e1->index[1];
 			if ( e1->index[0] == e1->index[1] ) {
-				common->Error( "FragmentSilQuads: degenerate edge" );
+				DmapError( "FragmentSilQuads: degenerate edge" );
 			}
 			quad.farV[0] = e1->index[0] + numUniquedBeforeProjection;
 			quad.farV[1] = e1->index[1] + numUniquedBeforeProjection;
@@ -845,7 +845,7 @@ static void EmitFragmentedSilQuads( void ) {
 				// emit a sil quad all the way to the projection plane
 				int index = ret.totalIndexes;
 				if ( index + 6 > maxRetIndexes ) {
-					common->Error( "maxRetIndexes exceeded" );
+					DmapError( "maxRetIndexes exceeded" );
 				}
 				ret.indexes[index+0] = f1->nearV[0];
 				ret.indexes[index+1] = f1->nearV[1];
@@ -871,7 +871,7 @@ static void EmitFragmentedSilQuads( void ) {
 			for ( mtri = groups[j].triList ; mtri ; mtri = mtri->next ) {
 				for ( k = 0 ; k < 3 ; k++ ) {
 					if ( ret.totalIndexes == maxRetIndexes ) {
-						common->Error( "maxRetIndexes exceeded" );
+						DmapError( "maxRetIndexes exceeded" );
 					}
 					ret.indexes[ret.totalIndexes] = FindUniqueVert( mtri->v[k].xyz );
 					ret.totalIndexes++;
@@ -926,7 +926,7 @@ static int FindUniqueVert( idVec3 &v ) {
 		}
 	}
 	if ( numUniqued == maxUniqued ) {
-		common->Error( "FindUniqueVert: numUniqued == maxUniqued" );
+		DmapError( "FindUniqueVert: numUniqued == maxUniqued" );
 	}
 	uniqued[numUniqued] = v;
 	numUniqued++;
@@ -971,7 +971,7 @@ static void ProjectUniqued( idVec3 projectionOrigin, idPlane projectionPlane ) {
 	R_LightProjectionMatrix( projectionOrigin, projectionPlane, mat );
 
 	if ( numUniqued * 2 > maxUniqued ) {
-		common->Error( "ProjectUniqued: numUniqued * 2 > maxUniqued" );
+		DmapError( "ProjectUniqued: numUniqued * 2 > maxUniqued" );
 	}
 
 	// this is goofy going back and forth between the spaces,
@@ -1145,7 +1145,7 @@ void CleanupOptimizedShadowTris( srfTriangles_t *tri ) {
 
 	for ( i = 0 ; i < tri->numIndexes ; i++ ) {
 		if ( tri->indexes[i] > tri->numVerts || tri->indexes[i] < 0 ) {
-			common->Error( "CleanupOptimizedShadowTris: index out of range" );
+			DmapError( "CleanupOptimizedShadowTris: index out of range" );
 		}
 	}
 
@@ -1211,18 +1211,13 @@ void CleanupOptimizedShadowTris( srfTriangles_t *tri ) {
 CreateLightShadow
 
 This is called from dmap in util/surface.cpp
-shadowerGroups should be exactly clipped to the light frustum before calling.
-shadowerGroups is optimized by this function, but the contents can be freed, because the returned
+shadowerGroups should be exactly clipped to the light frustum and optimized before calling,
+which is done for all lights in parallel. The contents can be freed, because the returned
 lightShadow_t list is a further culling and optimization of the data.
 ========================
 */
 srfTriangles_t *CreateLightShadow( optimizeGroup_t *shadowerGroups, const mapLight_t *light ) {;
 
-	common->Printf( "----- CreateLightShadow %p -----\n", light );
-
-	// optimize all the groups
-	OptimizeGroupList( shadowerGroups );
-
 	// combine all the triangles into one list
 	mapTri_t	*combined;
 
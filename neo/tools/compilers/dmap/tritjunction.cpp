@@ -93,11 +93,12 @@ typedef struct hashVert_s {
 	int					iv[3];
 } hashVert_t;
 
-static idBounds	hashBounds;
-static idVec3	hashScale;
-static hashVert_t	*hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
-static int		numHashVerts, numTotalVerts;
-static int		hashIntMins[3], hashIntScale[3];
+// per thread, so the areas can be fixed in parallel
+static thread_local idBounds	hashBounds;
+static thread_local idVec3	hashScale;
+static thread_local hashVert_t	*hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
+static thread_local int		numHashVerts, numTotalVerts;
+static thread_local int		hashIntMins[3], hashIntScale[3];
 
 /*
 ===============
@@ -482,8 +483,8 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 	startCount = CountGroupListTris( groupList );
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "----- FixAreaGroupsTjunctions -----\n" );
-		common->Printf( "%6i triangles in\n", startCount );
+		DmapPrintf( "----- FixAreaGroupsTjunctions -----\n" );
+		DmapPrintf( "%6i triangles in\n", startCount );
 	}
 
 	HashTriangles( groupList );
@@ -505,23 +506,30 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 
 	endCount = CountGroupListTris( groupList );
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i triangles out\n", endCount );
+		DmapPrintf( "%6i triangles out\n", endCount );
 	}
 }
 
 
+/*
+==================
+FixAreaTjunctionsJob
+==================
+*/
+static void FixAreaTjunctionsJob( void *data, int index ) {
+	uEntity_t *e = (uEntity_t *)data;
+
+	FixAreaGroupsTjunctions( e->areas[index].groups );
+	FreeTJunctionHash();
+}
+
 /*
 ==================
 FixEntityTjunctions
 ==================
 */
 void	FixEntityTjunctions( uEntity_t *e ) {
-	int		i;
-
-	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		FixAreaGroupsTjunctions( e->areas[i].groups );
-		FreeTJunctionHash();
-	}
+	DmapParallelFor( FixAreaTjunctionsJob, e, e->numAreas, "FixEntityTjunctions" );
 }
 
 /*
@@ -205,7 +205,7 @@ mapTri_t *TriListForSide( const side_t *s, const idWinding *w ) {
 				// copy normal
 				dv->normal = dmapGlobals.mapPlanes[s->planenum].Normal();
 				if ( dv->normal.Length() < 0.9 || dv->normal.Length() > 1.1 ) {
-					common->Error( "Bad normal in TriListForSide" );
+					DmapError( "Bad normal in TriListForSide" );
 				}
 			}
 		}
@@ -242,7 +242,7 @@ mapTri_t *TriListForSide( const side_t *s, const idWinding *w ) {
 				// copy normal
 				dv->normal = dmapGlobals.mapPlanes[s->planenum].Normal();
 				if ( dv->normal.Length() < 0.9f || dv->normal.Length() > 1.1f ) {
-					common->Error( "Bad normal in TriListForSide" );
+					DmapError( "Bad normal in TriListForSide" );
 				}
 			}
 		}
@@ -785,14 +785,23 @@ static void BoundOptimizeGroup( optimizeGroup_t *group ) {
 	}
 }
 
+typedef struct {
+	uEntity_t *			entity;
+	mapLight_t *		light;
+	optimizeGroup_t *	shadowerGroups;
+	bool				hasPerforatedSurface;
+} lightShadowers_t;
+
 /*
 ====================
-BuildLightShadows
+GatherLightShadowers
 
-Build the beam tree and shadow volume surface for a light
+Build an optimized group list of all the triangles that will contribute to
+the shadow volume of a light, leaving the original triangles alone.
+Only reads the area groups, so all the lights can be gathered in parallel.
 ====================
 */
-static void BuildLightShadows( uEntity_t *e, mapLight_t *light ) {
+static void GatherLightShadowers( lightShadowers_t *ls ) {
 	int			i;
 	optimizeGroup_t	*group;
 	mapTri_t	*tri;
@@ -800,12 +809,8 @@ static void BuildLightShadows( uEntity_t *e, mapLight_t *light ) {
 	optimizeGroup_t		*shadowerGroups;
 	idVec3		lightOrigin;
 	bool		hasPerforatedSurface = false;
-
-	//
-	// build a group list of all the triangles that will contribute to
-	// the optimized shadow volume, leaving the original triangles alone
-	//
-
+	uEntity_t	*e = ls->entity;
+	mapLight_t	*light = ls->light;
 
 	// shadowers will contain all the triangles that will contribute to the
 	// shadow volume
@@ -883,36 +888,68 @@ static void BuildLightShadows( uEntity_t *e, mapLight_t *light ) {
 		}
 	}
 
+	DmapPrintf( "----- CreateLightShadow %p -----\n", light );
+
+	// optimize all the groups
+	OptimizeGroupList( shadowerGroups );
+
+	ls->shadowerGroups = shadowerGroups;
+	ls->hasPerforatedSurface = hasPerforatedSurface;
+}
+
+/*
+====================
+GatherLightShadowersJob
+====================
+*/
+static void GatherLightShadowersJob( void *data, int index ) {
+	GatherLightShadowers( (lightShadowers_t *)data + index );
+}
+
+/*
+====================
+BuildLightShadows
+
+Build the shadow volume surface for a light from the gathered shadowers.
+The shadow volume code isn't thread safe and adds planes, so this is done
+for one light after the other.
+====================
+*/
+static void BuildLightShadows( lightShadowers_t *ls ) {
+	mapLight_t	*light = ls->light;
+
 	// take the shadower group list and create a beam tree and shadow volume
-	light->shadowTris = CreateLightShadow( shadowerGroups, light );
+	light->shadowTris = CreateLightShadow( ls->shadowerGroups, light );
 
-	if ( light->shadowTris && hasPerforatedSurface ) {
+	if ( light->shadowTris && ls->hasPerforatedSurface ) {
 		// can't ever remove front faces, because we can see through some of them
 		light->shadowTris->numShadowIndexesNoCaps = light->shadowTris->numShadowIndexesNoFrontCaps =
 			light->shadowTris->numIndexes;
 	}
 
 	// we don't need the original shadower triangles for anything else
-	FreeOptimizeGroupList( shadowerGroups );
+	FreeOptimizeGroupList( ls->shadowerGroups );
+	ls->shadowerGroups = NULL;
 }
 
 
 /*
 ====================
-CarveGroupsByLight
+CarveAreaByLights
 
-Divide each group into an inside group and an outside group, based
-on which fragments are illuminated by the light's beam tree
+Divide each group of an area into an inside group and an outside group for
+every light, based on which fragments are illuminated by the light's beam tree.
+The areas don't share any groups, so they can be carved in parallel.
 ====================
 */
-static void CarveGroupsByLight( uEntity_t *e, mapLight_t *light ) {
+static void CarveAreaByLights( uArea_t *area ) {
 	int			i;
 	optimizeGroup_t	*group, *newGroup, *carvedGroups, *nextGroup;
 	mapTri_t	*tri, *inside, *outside;
-	uArea_t		*area;
+	mapLight_t	*light;
 
-	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		area = &e->areas[i];
+	for ( i = 0 ; i < dmapGlobals.mapLights.Num() ; i++ ) {
+		light = dmapGlobals.mapLights[i];
 		carvedGroups = NULL;
 
 		// we will be either freeing or reassigning the groups as we go
@@ -929,7 +966,7 @@ static void CarveGroupsByLight( uEntity_t *e, mapLight_t *light ) {
 			}
 
 			if ( group->numGroupLights == MAX_GROUP_LIGHTS ) {
-				common->Error( "MAX_GROUP_LIGHTS around %f %f %f",
+				DmapError( "MAX_GROUP_LIGHTS around %f %f %f",
 					 group->triList->v[0].xyz[0], group->triList->v[0].xyz[1], group->triList->v[0].xyz[2] );
 			}
 
@@ -984,6 +1021,17 @@ static void CarveGroupsByLight( uEntity_t *e, mapLight_t *light ) {
 	}
 }
 
+/*
+====================
+CarveAreaJob
+====================
+*/
+static void CarveAreaJob( void *data, int index ) {
+	uEntity_t *e = (uEntity_t *)data;
+
+	CarveAreaByLights( &e->areas[index] );
+}
+
 /*
 =====================
 Prelight
@@ -995,7 +1043,6 @@ optimization won't cross light bounds
 void Prelight( uEntity_t *e ) {
 	int			i;
 	int			start, end;
-	mapLight_t	*light;
 
 	// don't prelight anything but the world entity
 	if ( dmapGlobals.entityNum != 0 ) {
@@ -1015,11 +1062,23 @@ void Prelight( uEntity_t *e ) {
 			}
 		}
 
-		for ( i = 0 ; i < dmapGlobals.mapLights.Num() ; i++ ) {
-			light = dmapGlobals.mapLights[i];
-			BuildLightShadows( e, light );
+		int numLights = dmapGlobals.mapLights.Num();
+		lightShadowers_t *shadowers = (lightShadowers_t *)Mem_ClearedAlloc( numLights * sizeof( *shadowers ) );
+		for ( i = 0 ; i < numLights ; i++ ) {
+			shadowers[i].entity = e;
+			shadowers[i].light = dmapGlobals.mapLights[i];
 		}
 
+		DmapParallelFor( GatherLightShadowersJob, shadowers, numLights, "GatherLightShadowers" );
+
+		end = Sys_Milliseconds();
+		common->Printf( "%5.1f seconds for GatherLightShadowers\n", ( end - start ) / 1000.0 );
+
+		for ( i = 0 ; i < numLights ; i++ ) {
+			BuildLightShadows( &shadowers[i] );
+		}
+		Mem_Free( shadowers );
+
 		end = Sys_Milliseconds();
 		common->Printf( "%5.1f seconds for BuildLightShadows\n", ( end - start ) / 1000.0 );
 	}
@@ -1030,10 +1089,7 @@ void Prelight( uEntity_t *e ) {
 		start = Sys_Milliseconds();
 		// now subdivide the optimize groups into additional groups for
 		// each light that illuminates them
-		for ( i = 0 ; i < dmapGlobals.mapLights.Num() ; i++ ) {
-			light = dmapGlobals.mapLights[i];
-			CarveGroupsByLight( e, light );
-		}
+		DmapParallelFor( CarveAreaJob, e, e->numAreas, "CarveGroupsByLight" );
 
 		end = Sys_Milliseconds();
 		common->Printf( "%5.1f seconds for CarveGroupsByLight\n", ( end - start ) / 1000.0 );